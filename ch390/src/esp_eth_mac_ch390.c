@@ -12,6 +12,7 @@
 #include <sys/cdefs.h>
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "eth_spi_transmit.h"
 #include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_check.h"
@@ -55,6 +56,7 @@ static const char *TAG = "ch390.mac";
 
 #define CH390_HASH_FILTER_TABLE_SIZE        (64)
 #define CH390_BCAST_HASH_VALUE              (63) // MAR7 bit7 - broadcast control bit
+#define CH390_ETH_MAC_RX_BUF_SIZE_AUTO      (0)
 
 typedef struct {
     uint8_t flag;
@@ -63,9 +65,14 @@ typedef struct {
     uint8_t length_high;
 } ch390_rx_header_t;
 
+typedef struct {
+    uint32_t frame_len;
+} __attribute__((packed)) ch390_auto_buf_info_t;
+
 typedef struct {
     spi_device_handle_t hdl;
     SemaphoreHandle_t lock;
+    uint32_t queued_min_len;
 } eth_spi_info_t;
 
 typedef struct {
@@ -87,8 +94,7 @@ typedef struct {
     uint32_t                poll_period_ms;
     uint8_t                 addr[ETH_ADDR_LEN];
     bool                    flow_ctrl_enabled;
-    uint8_t                 *rx_buffer;
-    uint32_t                rx_len;
+    eth_rx_pool_handle_t    rx_pool;
     uint8_t                 hash_filter_cnt[CH390_HASH_FILTER_TABLE_SIZE];
 } emac_ch390_t;
 
@@ -126,6 +132,7 @@ static void *CH390_SPI_INIT(const void *spi_config)
     /* create mutex */
     spi->lock = xSemaphoreCreateMutex();
     ESP_GOTO_ON_FALSE(spi->lock, NULL, err, TAG, "create lock failed");
+    spi->queued_min_len = ch390_config->spi_queued_min_len;
 
     ret = spi;
     return ret;
@@ -163,7 +170,7 @@ static inline esp_err_t CH390_SPI_WRITE(void *spi_ctx, uint32_t cmd, uint32_t ad
         .tx_buffer = value
     };
     if (CH390_SPI_LOCK(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -186,7 +193,7 @@ static inline esp_err_t CH390_SPI_READ(void *spi_ctx, uint32_t cmd, uint32_t add
         .rx_buffer = value
     };
     if (CH390_SPI_LOCK(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -784,10 +791,15 @@ err:
     return ret;
 }
 
-static esp_err_t emac_ch390_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *length)
+/**
+ * @brief Read header of the next frame, the RX memory pointer is left at the frame data
+ *
+ * @param[out] frame_len length of the frame including CRC, 0 when no frame is waiting
+ */
+static esp_err_t ch390_peek_frame(emac_ch390_t *emac, uint32_t *frame_len)
 {
     esp_err_t ret = ESP_OK;
-    emac_ch390_t *emac = __containerof(mac, emac_ch390_t, parent);
+    *frame_len = 0;
 
     uint8_t ready;
     /* dummy read, get the most updated data */
@@ -796,37 +808,74 @@ static esp_err_t emac_ch390_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *
 
     // if ready != 1 or 0 reset device
     if (ready & CH390_PKT_ERR) {
-        emac_ch390_stop(mac);
+        emac_ch390_stop(&emac->parent);
         esp_rom_delay_us(1000);
-        emac_ch390_start(mac);
+        emac_ch390_start(&emac->parent);
 
         ESP_LOGE(TAG, "PACK ERR");
         return ESP_ERR_INVALID_RESPONSE;
-    } else {
+    }
+    if (ready & CH390_PKT_RDY) {
         __attribute__((aligned(4))) ch390_rx_header_t rx_header; // SPI driver needs the rx buffer 4 byte align
+        ESP_GOTO_ON_ERROR(ch390_io_memory_read(emac, (uint8_t *) & (rx_header), sizeof(rx_header)),
+                          err, TAG, "peek rx header failed");
+        uint32_t length = (rx_header.length_high << 8) + rx_header.length_low;
+        if (rx_header.status & RSR_ERR_MASK) {
+            ch390_drop_frame(emac, length);
+            return ESP_ERR_INVALID_RESPONSE;
+        } else if (length < ETH_MIN_PACKET_SIZE || length > ETH_MAX_PACKET_SIZE) {
+            /* runt frames are not passed by RCR, the header is corrupted, so reset rx memory pointer */
+            ESP_GOTO_ON_ERROR(ch390_io_register_write(emac, CH390_MPTRCR, MPTRCR_RST_RX), err, TAG, "reset rx pointer failed");
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+        *frame_len = length;
+    }
+err:
+    return ret;
+}
 
-        if (ready & CH390_PKT_RDY) {
-            ESP_GOTO_ON_ERROR(ch390_io_memory_read(emac, (uint8_t *) & (rx_header), sizeof(rx_header)),
-                              err, TAG, "peek rx header failed");
-            *length = (rx_header.length_high << 8) + rx_header.length_low;
-            if (rx_header.status & RSR_ERR_MASK) {
-                ch390_drop_frame(emac, *length);
-                *length = 0;
-                return ESP_ERR_INVALID_RESPONSE;
-            } else if (*length > ETH_MAX_PACKET_SIZE) {
-                /* reset rx memory pointer */
-                ESP_GOTO_ON_ERROR(ch390_io_register_write(emac, CH390_MPTRCR, MPTRCR_RST_RX), err, TAG, "reset rx pointer failed");
-                return ESP_ERR_INVALID_RESPONSE;
-            } else {
-                ESP_GOTO_ON_ERROR(ch390_io_memory_read(emac, buf, *length), err, TAG, "read rx data failed");
-                *length -= ETH_CRC_LEN;
-            }
+static esp_err_t emac_ch390_alloc_recv_buf(emac_ch390_t *emac, uint8_t **buf, uint32_t *length)
+{
+    esp_err_t ret = ESP_OK;
+    uint32_t frame_len = 0;
+    *buf = NULL;
+
+    ESP_GOTO_ON_ERROR(ch390_peek_frame(emac, &frame_len), err, TAG, "peek frame failed");
+    if (frame_len) {
+        /* the frame is read including CRC, so the buffer has to hold it too */
+        *buf = eth_rx_pool_alloc(emac->rx_pool, frame_len);
+        if (*buf != NULL) {
+            ch390_auto_buf_info_t *buff_info = (ch390_auto_buf_info_t *)*buf;
+            buff_info->frame_len = frame_len;
         } else {
-            *length = 0;
+            ch390_drop_frame(emac, frame_len);
+            ret = ESP_ERR_NO_MEM;
         }
-        return ESP_OK;
     }
+err:
+    *length = frame_len;
+    return ret;
+}
 
+static esp_err_t emac_ch390_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *length)
+{
+    esp_err_t ret = ESP_OK;
+    emac_ch390_t *emac = __containerof(mac, emac_ch390_t, parent);
+    uint32_t frame_len = 0;
+
+    if (*length != CH390_ETH_MAC_RX_BUF_SIZE_AUTO) {
+        ESP_GOTO_ON_ERROR(ch390_peek_frame(emac, &frame_len), err, TAG, "peek frame failed");
+        if (frame_len == 0) {
+            goto err;
+        }
+    } else {
+        /* header was already read by emac_ch390_alloc_recv_buf() */
+        ch390_auto_buf_info_t *buff_info = (ch390_auto_buf_info_t *)buf;
+        frame_len = buff_info->frame_len;
+    }
+    ESP_GOTO_ON_ERROR(ch390_io_memory_read(emac, buf, frame_len), err, TAG, "read rx data failed");
+    *length = frame_len - ETH_CRC_LEN;
+    return ESP_OK;
 err:
     *length = 0;
     return ret;
@@ -904,25 +953,26 @@ static void emac_ch390_task(void *arg)
         /* packet received */
         if (status & ISR_PR) {
             do {
-                if (emac->parent.receive(&emac->parent, emac->rx_buffer, &emac->rx_len) == ESP_OK) {
-                    if (emac->rx_len == 0) {
-                        break;
-                    } else {
-                        ESP_LOGD(TAG, "receive len=%lu", emac->rx_len);
-
-                        /* allocate memory and check whether allocation failed */
-                        buffer = malloc(emac->rx_len);
-                        if (buffer == NULL) {
-                            ESP_LOGE(TAG, "no memory for receive buffer");
-                            continue;
-                        }
-
-                        /* pass the buffer to stack (e.g. TCP/IP layer) */
-                        memcpy(buffer, emac->rx_buffer, emac->rx_len);
-                        emac->eth->stack_input(emac->eth, buffer, emac->rx_len);
-                    }
+                /* read the frame length at first, so the frame can be read straight into the buffer passed to stack */
+                uint32_t frame_len = 0;
+                esp_err_t ret = emac_ch390_alloc_recv_buf(emac, &buffer, &frame_len);
+                if (ret == ESP_ERR_NO_MEM) {
+                    ESP_LOGE(TAG, "no memory for receive buffer");
+                    continue;
+                } else if (ret != ESP_OK) {
+                    ESP_LOGE(TAG, "frame read from module failed");
+                    break;
+                } else if (buffer == NULL) {
+                    break;
+                }
+                uint32_t buf_len = CH390_ETH_MAC_RX_BUF_SIZE_AUTO;
+                if (emac->parent.receive(&emac->parent, buffer, &buf_len) == ESP_OK) {
+                    ESP_LOGD(TAG, "receive len=%lu", buf_len);
+                    /* pass the buffer to stack (e.g. TCP/IP layer) */
+                    emac->eth->stack_input(emac->eth, buffer, buf_len);
                 } else {
                     ESP_LOGE(TAG, "frame read from module failed");
+                    eth_rx_pool_free(buffer);
                     break;
                 }
             } while (1);
@@ -939,7 +989,6 @@ static esp_err_t emac_ch390_del(esp_eth_mac_t *mac)
     }
     vTaskDelete(emac->rx_task_hdl);
     emac->spi.deinit(emac->spi.ctx);
-    heap_caps_free(emac->rx_buffer);
     free(emac);
     return ESP_OK;
 }
@@ -958,6 +1007,7 @@ esp_eth_mac_t *esp_eth_mac_new_ch390(const eth_ch390_config_t *ch390_config, con
     emac->sw_reset_timeout_ms = mac_config->sw_reset_timeout_ms;
     emac->int_gpio_num = ch390_config->int_gpio_num;
     emac->poll_period_ms = ch390_config->poll_period_ms;
+    emac->rx_pool = ch390_config->rx_pool;
     emac->parent.set_mediator = emac_ch390_set_mediator;
     emac->parent.init = emac_ch390_init;
     emac->parent.deinit = emac_ch390_deinit;
@@ -1010,9 +1060,6 @@ esp_eth_mac_t *esp_eth_mac_new_ch390(const eth_ch390_config_t *ch390_config, con
                                                    mac_config->rx_task_prio, &emac->rx_task_hdl, core_num);
     ESP_GOTO_ON_FALSE(xReturned == pdPASS, NULL, err, TAG, "create ch390 task failed");
 
-    emac->rx_buffer = heap_caps_malloc(ETH_MAX_PACKET_SIZE, MALLOC_CAP_DMA);
-    ESP_GOTO_ON_FALSE(emac->rx_buffer, NULL, err, TAG, "RX buffer allocation failed");
-
     if (emac->int_gpio_num < 0) {
         const esp_timer_create_args_t poll_timer_args = {
             .callback = ch390_poll_timer,
@@ -1032,7 +1079,6 @@ err:
         if (emac->spi.ctx) {
             emac->spi.deinit(emac->spi.ctx);
         }
-        heap_caps_free(emac->rx_buffer);
         free(emac);
     }
     return ret;
@@ -12,10 +12,53 @@
 #include "ethernet_init.h"
 #include "iperf_cmd.h"
 #include "sdkconfig.h"
+#if CONFIG_EXAMPLE_SKIP_OFFLOADED_CHECKSUMS
+#include <inttypes.h>
+#include "esp_netif_net_stack.h"
+#include "lwip/netif.h"
+#include "eth_offload.h"
+#endif
 
-#if CONFIG_EXAMPLE_ACT_AS_DHCP_SERVER
-
+#if CONFIG_EXAMPLE_ACT_AS_DHCP_SERVER || CONFIG_EXAMPLE_SKIP_OFFLOADED_CHECKSUMS
 static const char *TAG = "iperf_example";
+#endif
+
+#if CONFIG_EXAMPLE_SKIP_OFFLOADED_CHECKSUMS
+/**
+ * Turn off lwIP checksums of the interface which its MAC generates or verifies instead
+ */
+static void skip_offloaded_checksums(esp_netif_t *eth_netif, esp_eth_handle_t eth_handle)
+{
+    uint32_t offload = 0;
+    esp_eth_ioctl(eth_handle, ETH_OFFLOAD_CMD_G_CHECKSUM, &offload); // stays 0 if the MAC offloads nothing
+
+    u16_t chksum_flags = NETIF_CHECKSUM_ENABLE_ALL;
+    if (offload & ETH_CHECKSUM_OFFLOAD_TX_IP) {
+        chksum_flags &= ~NETIF_CHECKSUM_GEN_IP;
+    }
+    if (offload & ETH_CHECKSUM_OFFLOAD_TX_TCP) {
+        chksum_flags &= ~NETIF_CHECKSUM_GEN_TCP;
+    }
+    if (offload & ETH_CHECKSUM_OFFLOAD_TX_UDP) {
+        chksum_flags &= ~NETIF_CHECKSUM_GEN_UDP;
+    }
+    if (offload & ETH_CHECKSUM_OFFLOAD_TX_ICMP) {
+        chksum_flags &= ~NETIF_CHECKSUM_GEN_ICMP;
+    }
+    if (offload & ETH_CHECKSUM_OFFLOAD_RX_IP) {
+        chksum_flags &= ~NETIF_CHECKSUM_CHECK_IP;
+    }
+    if (offload & ETH_CHECKSUM_OFFLOAD_RX_TCP) {
+        chksum_flags &= ~NETIF_CHECKSUM_CHECK_TCP;
+    }
+    // fragments of IP datagrams pass the MAC without UDP and ICMP checksum checks, keep checking them in lwIP
+    NETIF_SET_CHECKSUM_CTRL((struct netif *)esp_netif_get_netif_impl(eth_netif), chksum_flags);
+    ESP_LOGI(TAG, "%s: checksum offload 0x%03" PRIx32 ", lwIP checksum flags 0x%04x",
+             esp_netif_get_desc(eth_netif), offload, chksum_flags);
+}
+#endif
+
+#if CONFIG_EXAMPLE_ACT_AS_DHCP_SERVER
 
 static void start_dhcp_server_after_connection(void *arg, esp_event_base_t base, int32_t id, void *event_data)
 {
@@ -77,6 +120,9 @@ void app_main(void)
         eth_netif_cfg.ip_info = &(ip_infos[i]);
         esp_netif_t *eth_netif = esp_netif_new(&cfg);
         ESP_ERROR_CHECK(esp_netif_attach(eth_netif, esp_eth_new_netif_glue(eth_handles[i])));
+#if CONFIG_EXAMPLE_SKIP_OFFLOADED_CHECKSUMS
+        skip_offloaded_checksums(eth_netif, eth_handles[i]);
+#endif
     }
     esp_event_handler_register(ETH_EVENT, ETHERNET_EVENT_CONNECTED, start_dhcp_server_after_connection, NULL);
     ESP_LOGI(TAG, "--------");
@@ -105,6 +151,9 @@ void app_main(void)
         eth_netif_cfg.route_prio -= i * 5;
         esp_netif_t *eth_netif = esp_netif_new(&cfg);
         ESP_ERROR_CHECK(esp_netif_attach(eth_netif, esp_eth_new_netif_glue(eth_handles[i])));
+#if CONFIG_EXAMPLE_SKIP_OFFLOADED_CHECKSUMS
+        skip_offloaded_checksums(eth_netif, eth_handles[i]);
+#endif
         esp_eth_start(eth_handles[i]);
     }
 #endif
@@ -0,0 +1,90 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""
+Throughput measurement of the iperf example against iperf 2 running on the runner host.
+
+The test doesn't judge the results, it logs them so that two driver revisions or configurations
+measured on the same setup can be compared, see "Measuring throughput" in README.md.
+"""
+import logging
+import socket
+import subprocess
+import time
+
+import pytest
+
+from idf_build_apps.constants import IDF_VERSION
+from packaging.version import Version
+from pytest_embedded import Dut
+from pytest_embedded_idf.utils import idf_parametrize
+
+HOST_IPERF = 'iperf'
+DURATION_S = 20
+UDP_BANDWIDTH = '100M'
+IPERF_RESULT = r'(\d+(?:\.\d+)?)\s*-\s*(\d+(?:\.\d+)?)\s+sec\s+([\d.]+)\s+Mbits/sec'
+
+# W5500 driver v2 requires IDF >= 6.0.
+_W5500_REQUIRES_IDF6 = pytest.mark.skipif(
+    IDF_VERSION < Version('6.0'),
+    reason='W5500 driver v2 requires IDF >= 6.0',
+)
+
+
+def _host_ip(dut_ip: str) -> str:
+    # the address of the host interface which routes to the DUT, no packet is sent
+    with socket.socket(socket.AF_INET, socket.SOCK_DGRAM) as so:
+        so.connect((dut_ip, 5001))
+        return str(so.getsockname()[0])
+
+
+def _dut_tx(dut: Dut, host_ip: str, udp: bool) -> float:
+    server_cmd = [HOST_IPERF, '-s'] + (['-u'] if udp else [])
+    with subprocess.Popen(server_cmd, stdout=subprocess.DEVNULL, stderr=subprocess.DEVNULL) as server:  # noqa: S603
+        try:
+            client_cmd = f'iperf -c {host_ip} -i {DURATION_S} -t {DURATION_S}'
+            if udp:
+                client_cmd += f' -u -b {UDP_BANDWIDTH.rstrip("M")}'
+            dut.write(client_cmd)
+            res = dut.expect(IPERF_RESULT, timeout=DURATION_S + 10)
+        finally:
+            server.terminate()
+    return float(res.group(3))
+
+
+def _dut_rx(dut: Dut, dut_ip: str, udp: bool) -> float:
+    dut.write(f'iperf -s -i {DURATION_S} -t {DURATION_S}' + (' -u' if udp else ''))
+    time.sleep(1)  # let the server socket open
+    client_cmd = [HOST_IPERF, '-c', dut_ip, '-t', str(DURATION_S)]
+    if udp:
+        client_cmd += ['-u', '-b', UDP_BANDWIDTH]
+    subprocess.run(client_cmd, capture_output=True, check=False, timeout=DURATION_S + 10)  # noqa: S603
+    res = dut.expect(IPERF_RESULT, timeout=10)
+    dut.write('iperf -a')
+    return float(res.group(3))
+
+
+@pytest.mark.parametrize(
+    'config',
+    [
+        pytest.param('w5500', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
+        pytest.param('w5500_async_tx', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
+        pytest.param('ch390', marks=[pytest.mark.eth_ch390]),
+        pytest.param('dm9051', marks=[pytest.mark.eth_dm9051]),
+        pytest.param('ksz8851snl', marks=[pytest.mark.eth_ksz8851snl]),
+        pytest.param('ksz8851snl_csum_offload', marks=[pytest.mark.eth_ksz8851snl]),
+    ],
+    indirect=True,
+)
+@idf_parametrize('target', ['esp32'], indirect=['target'])
+def test_eth_iperf(dut: Dut, config: str) -> None:
+    dut_ip = dut.expect(r'esp_netif_handlers: .+ ip: (\d+\.\d+\.\d+\.\d+),', timeout=60).group(1).decode()
+    dut.expect_exact('esp>')
+    host_ip = _host_ip(dut_ip)
+    results = {
+        'TCP TX': _dut_tx(dut, host_ip, udp=False),
+        'TCP RX': _dut_rx(dut, dut_ip, udp=False),
+        'UDP TX': _dut_tx(dut, host_ip, udp=True),
+        'UDP RX': _dut_rx(dut, dut_ip, udp=True),
+    }
+    for name, mbps in results.items():
+        logging.info('[%s] %s: %.2f Mbits/sec', config, name, mbps)
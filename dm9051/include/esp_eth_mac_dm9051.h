@@ -9,6 +9,7 @@
 
 #include "esp_eth_com.h"
 #include "esp_eth_mac_spi.h"
+#include "eth_rx_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +25,8 @@ typedef struct {
     spi_host_device_t spi_host_id;                      /*!< SPI peripheral (this field is invalid when custom SPI driver is defined) */
     spi_device_interface_config_t *spi_devcfg;          /*!< SPI device configuration (this field is invalid when custom SPI driver is defined) */
     eth_spi_custom_driver_config_t custom_spi_driver;   /*!< Custom SPI driver definitions */
+    eth_rx_pool_handle_t rx_pool;                       /*!< Pool to allocate received frames from, NULL to allocate them from heap. With a pool, attach the driver to its netif by eth_rx_pool_new_netif_glue() */
+    uint32_t spi_queued_min_len;                        /*!< Queue SPI transfers of at least this many bytes, so the calling task sleeps while they run, 0 to poll all transfers */
 } eth_dm9051_config_t;
 
 /**
@@ -37,6 +40,8 @@ typedef struct {
         .spi_host_id = spi_host,                \
         .spi_devcfg = spi_devcfg_p,             \
         .custom_spi_driver = ETH_DEFAULT_SPI,   \
+        .rx_pool = NULL,                        \
+        .spi_queued_min_len = 0,                \
     }
 
 /**
@@ -14,6 +14,7 @@
 #include "esp_private/gpio.h"
 #include "soc/io_mux_reg.h"
 #include "driver/spi_master.h"
+#include "eth_spi_transmit.h"
 #include "esp_attr.h"
 #include "esp_log.h"
 #include "esp_check.h"
@@ -39,8 +40,12 @@ static const char *TAG = "dm9051.mac";
 #define DM9051_RX_MEM_START_ADDR        (3072)
 #define DM9051_RX_MEM_MAX_SIZE          (16384)
 #define DM9051_RX_HDR_SIZE              (4)
+#define DM9051_TX_SLOTS                 (2)
+#define DM9051_TX_SLOT_TIMEOUT_MS       (10)
+#define DM9051_NSR_TX_END               (NSR_TX2END | NSR_TX1END)
 
 #define DM9051_HASH_FILTER_TABLE_SIZE   (64)
+#define DM9051_ETH_MAC_RX_BUF_SIZE_AUTO (0)
 
 typedef struct {
     uint8_t flag;        // 0 = no frame, 1 = frame received, others = possible memory pointer error or tcpip_checksum_offload status flag if enabled
@@ -49,9 +54,14 @@ typedef struct {
     uint8_t length_high; // High byte of received frame length
 } dm9051_rx_header_t;
 
+typedef struct {
+    uint32_t byte_count;
+} __attribute__((packed)) dm9051_auto_buf_info_t;
+
 typedef struct {
     spi_device_handle_t hdl;
     SemaphoreHandle_t lock;
+    uint32_t queued_min_len;
 } eth_spi_info_t;
 
 typedef struct {
@@ -76,7 +86,11 @@ typedef struct {
     bool packets_remain;
     bool flow_ctrl_enabled;
     uint8_t *rx_buffer;
+    eth_rx_pool_handle_t rx_pool;
     uint8_t hash_filter_cnt[DM9051_HASH_FILTER_TABLE_SIZE];
+    SemaphoreHandle_t tx_slot_sem;  // counts TX packet slots free to upload a frame to
+    portMUX_TYPE tx_end_lock;
+    uint8_t tx_end;                 // TX end flags collected from NSR reads, not yet released
 } emac_dm9051_t;
 
 static void *dm9051_spi_init(const void *spi_config)
@@ -103,6 +117,7 @@ static void *dm9051_spi_init(const void *spi_config)
     /* create mutex */
     spi->lock = xSemaphoreCreateMutex();
     ESP_GOTO_ON_FALSE(spi->lock, NULL, err, TAG, "create lock failed");
+    spi->queued_min_len = dm9051_config->spi_queued_min_len;
 
     ret = spi;
     return ret;
@@ -150,7 +165,7 @@ static esp_err_t dm9051_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, co
         .tx_buffer = value
     };
     if (dm9051_spi_lock(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -174,7 +189,7 @@ static esp_err_t dm9051_spi_read(void *spi_ctx, uint32_t cmd, uint32_t addr, voi
         .rx_buffer = value
     };
     if (dm9051_spi_lock(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -230,6 +245,63 @@ static esp_err_t dm9051_memory_read(emac_dm9051_t *emac, uint8_t *buffer, uint32
     return emac->spi.read(emac->spi.ctx, DM9051_SPI_RD, DM9051_MRCMD, buffer, len);
 }
 
+/**
+ * @brief read NSR, TX end flags are cleared by the read so collect them for dm9051_tx_release()
+ */
+static esp_err_t dm9051_nsr_read(emac_dm9051_t *emac, uint8_t *nsr)
+{
+    ESP_RETURN_ON_ERROR(dm9051_register_read(emac, DM9051_NSR, nsr), TAG, "read NSR failed");
+    if (*nsr & DM9051_NSR_TX_END) {
+        portENTER_CRITICAL(&emac->tx_end_lock);
+        emac->tx_end |= *nsr & DM9051_NSR_TX_END;
+        portEXIT_CRITICAL(&emac->tx_end_lock);
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief free TX packet slots of the frames reported as transmitted
+ */
+static void dm9051_tx_release(emac_dm9051_t *emac)
+{
+    portENTER_CRITICAL(&emac->tx_end_lock);
+    uint8_t tx_end = emac->tx_end;
+    emac->tx_end = 0;
+    portEXIT_CRITICAL(&emac->tx_end_lock);
+    if (tx_end & NSR_TX1END) {
+        xSemaphoreGive(emac->tx_slot_sem);
+    }
+    if (tx_end & NSR_TX2END) {
+        xSemaphoreGive(emac->tx_slot_sem);
+    }
+}
+
+/**
+ * @brief check for transmitted frames and free their TX packet slots
+ */
+static esp_err_t dm9051_tx_reap(emac_dm9051_t *emac)
+{
+    uint8_t nsr;
+    ESP_RETURN_ON_ERROR(dm9051_nsr_read(emac, &nsr), TAG, "read NSR failed");
+    dm9051_tx_release(emac);
+    return ESP_OK;
+}
+
+/**
+ * @brief mark both TX packet slots free, TX memory pointer has to be reset alongside
+ */
+static esp_err_t dm9051_tx_reset(emac_dm9051_t *emac)
+{
+    ESP_RETURN_ON_ERROR(dm9051_register_write(emac, DM9051_NSR, DM9051_NSR_TX_END), TAG, "write NSR failed");
+    portENTER_CRITICAL(&emac->tx_end_lock);
+    emac->tx_end = 0;
+    portEXIT_CRITICAL(&emac->tx_end_lock);
+    while (uxSemaphoreGetCount(emac->tx_slot_sem) < DM9051_TX_SLOTS) {
+        xSemaphoreGive(emac->tx_slot_sem);
+    }
+    return ESP_OK;
+}
+
 /**
  * @brief read mac address from internal registers
  */
@@ -437,10 +509,11 @@ static esp_err_t emac_dm9051_start(esp_eth_mac_t *mac)
     emac_dm9051_t *emac = __containerof(mac, emac_dm9051_t, parent);
     /* reset tx and rx memory pointer */
     ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_MPTRCR, MPTRCR_RST_RX | MPTRCR_RST_TX), err, TAG, "write MPTRCR failed");
+    ESP_GOTO_ON_ERROR(dm9051_tx_reset(emac), err, TAG, "reset tx slots failed");
     /* clear interrupt status */
     ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_ISR, ISR_CLR_STATUS), err, TAG, "write ISR failed");
-    /* enable only Rx related interrupts as others are processed synchronously */
-    ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_IMR, IMR_PAR | IMR_PRI), err, TAG, "write IMR failed");
+    /* enable Rx and Tx complete interrupts, link changes are processed by the PHY driver */
+    ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_IMR, IMR_PAR | IMR_PRI | IMR_PTI), err, TAG, "write IMR failed");
     /* enable rx */
     uint8_t rcr = 0;
     ESP_GOTO_ON_ERROR(dm9051_register_read(emac, DM9051_RCR, &rcr), err, TAG, "read RCR failed");
@@ -735,28 +808,38 @@ static esp_err_t emac_dm9051_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_t
     ESP_GOTO_ON_FALSE(length <= ETH_MAX_PACKET_SIZE, ESP_ERR_INVALID_ARG, err,
                       TAG, "frame size is too big (actual %" PRIu32 ", maximum %d)", length, ETH_MAX_PACKET_SIZE);
 
-    uint8_t reg_nsr = 0;
-    int64_t wait_time =  esp_timer_get_time();
-    do {
-        ESP_GOTO_ON_ERROR(dm9051_register_read(emac, DM9051_NSR, &reg_nsr), err, TAG, "read NSR failed");
-        reg_nsr &= (NSR_TX2END | NSR_TX1END);
-    } while ((!reg_nsr) && ((esp_timer_get_time() - wait_time) < 100));
-
-    if (!reg_nsr) {
-        ESP_LOGE(TAG, "last transmit still in progress, cannot send.");
-        return ESP_ERR_INVALID_STATE;
+    /* in polling mode the task may not run in time to free the slots, so check the status right away */
+    if (emac->int_gpio_num < 0 && uxSemaphoreGetCount(emac->tx_slot_sem) == 0) {
+        ESP_GOTO_ON_ERROR(dm9051_tx_reap(emac), err, TAG, "check tx status failed");
     }
-
-    if (reg_nsr == (NSR_TX2END | NSR_TX1END)) {
-        ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_MPTRCR, MPTRCR_RST_TX), err, TAG, "write MPTRCR failed");
+    if (xSemaphoreTake(emac->tx_slot_sem, pdMS_TO_TICKS(DM9051_TX_SLOT_TIMEOUT_MS)) != pdTRUE) {
+        /* Tx complete interrupt could have been missed */
+        ESP_GOTO_ON_ERROR(dm9051_tx_reap(emac), err, TAG, "check tx status failed");
+        if (xSemaphoreTake(emac->tx_slot_sem, 0) != pdTRUE) {
+            ESP_LOGE(TAG, "last transmit still in progress, cannot send.");
+            return ESP_ERR_INVALID_STATE;
+        }
     }
 
+    /* length and data of the frame have to be written in one go, auto transmit starts once the data is in */
+    if (!dm9051_mutex_lock(emac)) {
+        xSemaphoreGive(emac->tx_slot_sem);
+        return ESP_ERR_TIMEOUT;
+    }
+    /* the other slot is free too, i.e. nothing is being transmitted */
+    if (uxSemaphoreGetCount(emac->tx_slot_sem) == DM9051_TX_SLOTS - 1) {
+        ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_MPTRCR, MPTRCR_RST_TX), err_unlock, TAG, "write MPTRCR failed");
+    }
     /* set tx length */
-    ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_TXPLL, length & 0xFF), err, TAG, "write TXPLL failed");
-    ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_TXPLH, (length >> 8) & 0xFF), err, TAG, "write TXPLH failed");
-    /* copy data to tx memory */
-    ESP_GOTO_ON_ERROR(dm9051_memory_write(emac, buf, length), err, TAG, "write memory failed");
+    ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_TXPLL, length & 0xFF), err_unlock, TAG, "write TXPLL failed");
+    ESP_GOTO_ON_ERROR(dm9051_register_write(emac, DM9051_TXPLH, (length >> 8) & 0xFF), err_unlock, TAG, "write TXPLH failed");
+    /* copy data to tx memory, the slot is freed by the task once the frame is transmitted */
+    ESP_GOTO_ON_ERROR(dm9051_memory_write(emac, buf, length), err_unlock, TAG, "write memory failed");
+    dm9051_mutex_unlock(emac);
     return ESP_OK;
+err_unlock:
+    dm9051_mutex_unlock(emac);
+    xSemaphoreGive(emac->tx_slot_sem);
 err:
     return ret;
 }
@@ -790,17 +873,23 @@ err:
     return ret;
 }
 
-static esp_err_t dm9051_frame_to_rx_buffer(emac_dm9051_t *emac, uint16_t *size)
+/**
+ * @brief Read header of the next valid frame, the RX memory pointer is left at the frame data
+ *
+ * @param[out] size length of the frame including CRC, 0 when no frame is waiting
+ */
+static esp_err_t dm9051_peek_frame(emac_dm9051_t *emac, uint16_t *size)
 {
     esp_err_t ret = ESP_OK;
     uint8_t rxbyte = 0;
     __attribute__((aligned(4))) dm9051_rx_header_t header; // SPI driver needs the rx buffer 4 byte align
-    bool try_again = false;
+    bool try_again;
 
     do {
         *size = 0;
+        try_again = false;
         uint8_t reg_nsr = 0;
-        ESP_GOTO_ON_ERROR(dm9051_register_read(emac, DM9051_NSR, &reg_nsr), err, TAG, "read NSR failed");
+        ESP_GOTO_ON_ERROR(dm9051_nsr_read(emac, &reg_nsr), err, TAG, "read NSR failed");
         if (reg_nsr & NSR_RXRDY) {
             /* dummy read, get the most updated data */
             ESP_GOTO_ON_ERROR(dm9051_register_read(emac, DM9051_MRCMDX, &rxbyte), err, TAG, "read MRCMDX failed");
@@ -811,11 +900,9 @@ static esp_err_t dm9051_frame_to_rx_buffer(emac_dm9051_t *emac, uint16_t *size)
             }
             ESP_GOTO_ON_ERROR(dm9051_memory_read(emac, (uint8_t *)&header, sizeof(header)), err, TAG, "read rx header failed");
             uint16_t rx_len = header.length_low + (header.length_high << 8);
-            /* store the whole frame to preallocated memory */
-            if (rx_len <= ETH_MAX_PACKET_SIZE) {
-                ESP_GOTO_ON_ERROR(dm9051_memory_read(emac, emac->rx_buffer, rx_len), err, TAG, "read rx data failed");
-            } else {
-                /* we are out of sync or data is corrupted, there is no way how to fix position in rx fifo => flush all */
+            if (rx_len < ETH_MIN_PACKET_SIZE || rx_len > ETH_MAX_PACKET_SIZE) {
+                /* runt frames are not passed by RCR, so we are out of sync or data is corrupted, there is no way how to
+                 * fix position in rx fifo => flush all */
                 ESP_GOTO_ON_ERROR(dm9051_flush_recv_queue(emac), err, TAG, "flush rx queue failed");
                 ESP_GOTO_ON_FALSE(false, ESP_FAIL, err, TAG, "invalid frame length, reset rx fifo pointer");
             }
@@ -834,6 +921,29 @@ err:
     return ret;
 }
 
+static esp_err_t emac_dm9051_alloc_recv_buf(emac_dm9051_t *emac, uint8_t **buf, uint32_t *length)
+{
+    esp_err_t ret = ESP_OK;
+    uint16_t byte_count = 0;
+    *buf = NULL;
+
+    ESP_GOTO_ON_ERROR(dm9051_peek_frame(emac, &byte_count), err, TAG, "peek frame failed");
+    if (byte_count) {
+        /* the frame is read including CRC, so the buffer has to hold it too */
+        *buf = eth_rx_pool_alloc(emac->rx_pool, byte_count);
+        if (*buf != NULL) {
+            dm9051_auto_buf_info_t *buff_info = (dm9051_auto_buf_info_t *)*buf;
+            buff_info->byte_count = byte_count;
+        } else {
+            dm9051_skip_recv_frame(emac, byte_count);
+            ret = ESP_ERR_NO_MEM;
+        }
+    }
+err:
+    *length = byte_count;
+    return ret;
+}
+
 static esp_err_t emac_dm9051_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *length)
 {
     esp_err_t ret = ESP_OK;
@@ -841,20 +951,24 @@ static esp_err_t emac_dm9051_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t
     uint16_t byte_count = 0;
     emac->packets_remain = false;
 
-    /* always read the full frame to preallocated memory to simplify subsequent rx fifo pointer operations */
-    ESP_GOTO_ON_ERROR(dm9051_frame_to_rx_buffer(emac, &byte_count), err, TAG, "moving data to internal rx_buffer failed");
-    /* silently return when no frame is waiting */
-    if (!byte_count) {
-        goto err;
-    }
-    /* do not include 4 bytes CRC at the end */
-    uint16_t rx_len = byte_count - ETH_CRC_LEN;
-    if (buf == emac->rx_buffer) {
-        /* if we use internal buffer, we are done */
-        *length = rx_len;
+    ESP_GOTO_ON_FALSE(buf, ESP_ERR_INVALID_ARG, err, TAG, "buffer can't be NULL");
+    if (*length == DM9051_ETH_MAC_RX_BUF_SIZE_AUTO) {
+        /* header was already read by emac_dm9051_alloc_recv_buf(), read the frame straight into the final buffer */
+        dm9051_auto_buf_info_t *buff_info = (dm9051_auto_buf_info_t *)buf;
+        byte_count = buff_info->byte_count;
+        ESP_GOTO_ON_ERROR(dm9051_memory_read(emac, buf, byte_count), err, TAG, "read rx data failed");
+        /* do not include 4 bytes CRC at the end */
+        *length = byte_count - ETH_CRC_LEN;
     } else {
-        /* if frame to be copied to external buffer allocated by user */
-        ESP_GOTO_ON_FALSE(buf, ESP_ERR_INVALID_ARG, err, TAG, "buffer can't be NULL");
+        ESP_GOTO_ON_ERROR(dm9051_peek_frame(emac, &byte_count), err, TAG, "peek frame failed");
+        /* silently return when no frame is waiting */
+        if (!byte_count) {
+            goto err;
+        }
+        /* always read the full frame to preallocated memory to simplify subsequent rx fifo pointer operations */
+        ESP_GOTO_ON_ERROR(dm9051_memory_read(emac, emac->rx_buffer, byte_count), err, TAG, "read rx data failed");
+        /* do not include 4 bytes CRC at the end */
+        uint16_t rx_len = byte_count - ETH_CRC_LEN;
         /* frames larger than expected will be truncated */
         uint16_t copy_len = rx_len > *length ? *length : rx_len;
         memcpy(buf, emac->rx_buffer, copy_len);
@@ -862,7 +976,7 @@ static esp_err_t emac_dm9051_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t
     }
 
     uint8_t reg_nsr = 0;
-    ESP_GOTO_ON_ERROR(dm9051_register_read(emac, DM9051_NSR, &reg_nsr), err, TAG, "read NSR failed");
+    ESP_GOTO_ON_ERROR(dm9051_nsr_read(emac, &reg_nsr), err, TAG, "read NSR failed");
     emac->packets_remain = (reg_nsr & NSR_RXRDY);
     return ESP_OK;
 err:
@@ -938,25 +1052,42 @@ static void emac_dm9051_task(void *arg)
         /* packet received */
         if (status & ISR_PR) {
             do {
-                uint32_t buf_len;
-                if (emac->parent.receive(&emac->parent, emac->rx_buffer, &buf_len) == ESP_OK) {
+                /* read the frame length at first, so the frame can be read straight into the buffer passed to stack */
+                uint8_t *buffer = NULL;
+                uint32_t frame_len = 0;
+                emac->packets_remain = false;
+                esp_err_t ret = emac_dm9051_alloc_recv_buf(emac, &buffer, &frame_len);
+                if (ret == ESP_OK) {
                     /* if there is waiting frame */
-                    if (buf_len > 0) {
-                        uint8_t *buffer = malloc(buf_len);
-                        if (buffer == NULL) {
-                            ESP_LOGE(TAG, "no mem for receive buffer");
-                        } else {
-                            memcpy(buffer, emac->rx_buffer, buf_len);
+                    if (buffer != NULL) {
+                        uint32_t buf_len = DM9051_ETH_MAC_RX_BUF_SIZE_AUTO;
+                        if (emac->parent.receive(&emac->parent, buffer, &buf_len) == ESP_OK) {
                             ESP_LOGD(TAG, "receive len=%" PRIu32, buf_len);
                             /* pass the buffer to stack (e.g. TCP/IP layer) */
                             emac->eth->stack_input(emac->eth, buffer, buf_len);
+                        } else {
+                            ESP_LOGE(TAG, "frame read from module failed");
+                            eth_rx_pool_free(buffer);
                         }
                     }
+                } else if (ret == ESP_ERR_NO_MEM) {
+                    ESP_LOGE(TAG, "no mem for receive buffer");
+                    /* the frame was skipped, check whether other frames are waiting */
+                    emac->packets_remain = true;
                 } else {
                     ESP_LOGE(TAG, "frame read from module failed");
                 }
             } while (emac->packets_remain);
         }
+        /* packet transmitted */
+        if (status & ISR_PT) {
+            if (dm9051_tx_reap(emac) != ESP_OK) {
+                ESP_LOGE(TAG, "check tx status failed");
+            }
+        } else {
+            /* free slots of frames seen transmitted by NSR reads on the Rx path */
+            dm9051_tx_release(emac);
+        }
     }
     vTaskDelete(NULL);
 }
@@ -970,6 +1101,7 @@ static esp_err_t emac_dm9051_del(esp_eth_mac_t *mac)
     vTaskDelete(emac->rx_task_hdl);
     emac->spi.deinit(emac->spi.ctx);
     vSemaphoreDelete(emac->multi_reg_axs_mutex);
+    vSemaphoreDelete(emac->tx_slot_sem);
     heap_caps_free(emac->rx_buffer);
     free(emac);
     return ESP_OK;
@@ -988,6 +1120,7 @@ esp_eth_mac_t *esp_eth_mac_new_dm9051(const eth_dm9051_config_t *dm9051_config,
     emac->sw_reset_timeout_ms = mac_config->sw_reset_timeout_ms;
     emac->int_gpio_num = dm9051_config->int_gpio_num;
     emac->poll_period_ms = dm9051_config->poll_period_ms;
+    emac->rx_pool = dm9051_config->rx_pool;
     emac->parent.set_mediator = emac_dm9051_set_mediator;
     emac->parent.init = emac_dm9051_init;
     emac->parent.deinit = emac_dm9051_deinit;
@@ -1034,6 +1167,11 @@ esp_eth_mac_t *esp_eth_mac_new_dm9051(const eth_dm9051_config_t *dm9051_config,
     emac->multi_reg_axs_mutex = xSemaphoreCreateMutex();
     ESP_GOTO_ON_FALSE(emac->multi_reg_axs_mutex, NULL, err, TAG, "create multi registers access mutex failed");
 
+    /* both TX packet slots are free at start */
+    emac->tx_slot_sem = xSemaphoreCreateCounting(DM9051_TX_SLOTS, DM9051_TX_SLOTS);
+    ESP_GOTO_ON_FALSE(emac->tx_slot_sem, NULL, err, TAG, "create tx slot semaphore failed");
+    portMUX_INITIALIZE(&emac->tx_end_lock);
+
     /* create dm9051 task */
     BaseType_t core_num = tskNO_AFFINITY;
     if (mac_config->flags & ETH_MAC_FLAG_PIN_TO_CORE) {
@@ -1072,6 +1210,9 @@ err:
         if (emac->multi_reg_axs_mutex) {
             vSemaphoreDelete(emac->multi_reg_axs_mutex);
         }
+        if (emac->tx_slot_sem) {
+            vSemaphoreDelete(emac->tx_slot_sem);
+        }
         heap_caps_free(emac->rx_buffer);
         free(emac);
     }
@@ -12,7 +12,12 @@ extern "C" {
 
 #include "esp_eth_phy.h"
 #include "esp_eth_mac.h"
+#include "esp_idf_version.h"
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 3, 0)
+#include "esp_eth_mac_spi.h"
+#endif
 #include "driver/spi_master.h"
+#include "eth_rx_pool.h"
 
 #define CS_HOLD_TIME_MIN_NS 210
 
@@ -24,6 +29,11 @@ typedef struct {
     spi_host_device_t spi_host_id;              /*!< SPI peripheral */
     spi_device_interface_config_t *spi_devcfg;  /*!< SPI device configuration */
     int int_gpio_num;                           /*!< Interrupt GPIO number */
+    eth_rx_pool_handle_t rx_pool;               /*!< Pool to allocate received frames from, NULL to allocate them from heap. With a pool, attach the driver to its netif by eth_rx_pool_new_netif_glue() */
+    uint32_t spi_queued_min_len;                /*!< Queue SPI transfers of at least this many bytes, so the calling task sleeps while they run, 0 to poll all transfers */
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    eth_spi_custom_driver_config_t custom_spi_driver; /*!< Custom SPI driver definitions, left zeroed (as by ETH_ENC28J60_DEFAULT_CONFIG) for the default driver which uses spi_host_id, spi_devcfg and spi_queued_min_len */
+#endif
 } eth_enc28j60_config_t;
 
 /**
@@ -46,6 +56,8 @@ typedef enum {
         .spi_host_id = spi_host,                  \
         .spi_devcfg = spi_devcfg_p,               \
         .int_gpio_num = 4,                        \
+        .rx_pool = NULL,                          \
+        .spi_queued_min_len = 0,                  \
     }
 
 /**
@@ -21,6 +21,7 @@
 #include "freertos/semphr.h"
 #include "esp_eth_enc28j60.h"
 #include "enc28j60.h"
+#include "eth_spi_transmit.h"
 #include "sdkconfig.h"
 #include "esp_check.h"
 
@@ -56,15 +57,21 @@ static const char *TAG = "enc28j60";
 #define ENC28J60_BUFFER_SIZE (0x2000) // 8KB built-in buffer
 /**
  *  ______
- * |__TX__| TX: 2 KB : [0x1800, 0x2000)
+ * |_TX_1_| TX slot 1: 1.5 KB : [0x1A00, 0x2000)
+ * |_TX_0_| TX slot 0: 1.5 KB : [0x1400, 0x1A00)
  * |      |
- * |  RX  | RX: 6 KB : [0x0000, 0x1800)
+ * |  RX  | RX: 5 KB : [0x0000, 0x1400)
  * |______|
  *
+ * A frame is uploaded to one TX slot while the other one is being transmitted.
+ * Each slot holds the control byte, the frame and the transmit status vector.
  */
+#define ENC28J60_BUF_TX_SLOTS (2)
+#define ENC28J60_BUF_TX_SLOT_SIZE (0x600)
 #define ENC28J60_BUF_RX_START (0)
 #define ENC28J60_BUF_RX_END (ENC28J60_BUF_TX_START - 1)
-#define ENC28J60_BUF_TX_START ((ENC28J60_BUFFER_SIZE / 4) * 3)
+#define ENC28J60_BUF_TX_START (ENC28J60_BUFFER_SIZE - ENC28J60_BUF_TX_SLOTS * ENC28J60_BUF_TX_SLOT_SIZE)
+#define ENC28J60_BUF_TX_SLOT_START(slot) (ENC28J60_BUF_TX_START + (slot) * ENC28J60_BUF_TX_SLOT_SIZE)
 #define ENC28J60_BUF_TX_END (ENC28J60_BUFFER_SIZE - 1)
 
 #define ENC28J60_RSV_SIZE (6) // Receive Status Vector Size
@@ -105,22 +112,54 @@ typedef struct {
     uint8_t vlan_frame: 1;
 } enc28j60_tsv_t;
 
+/**
+ * @brief Registers only the host changes, their values are kept so they never need to be read back
+ */
+typedef struct {
+    uint8_t eie;
+    uint8_t erxfcon;
+    uint8_t macon3;
+    uint8_t eht[8];
+} enc28j60_shadow_regs_t;
+
+typedef struct {
+    spi_device_handle_t hdl;
+    uint32_t queued_min_len;
+} eth_spi_info_t;
+
+typedef struct {
+    void *ctx;
+    void *(*init)(const void *spi_config);
+    esp_err_t (*deinit)(void *spi_ctx);
+    esp_err_t (*read)(void *spi_ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t data_len);
+    esp_err_t (*write)(void *spi_ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t data_len);
+} eth_spi_custom_driver_t;
+
 typedef struct {
     esp_eth_mac_t parent;
     esp_eth_mediator_t *eth;
-    spi_device_handle_t spi_hdl;
+    eth_spi_custom_driver_t spi;
     SemaphoreHandle_t spi_lock;
     SemaphoreHandle_t reg_trans_lock;
     SemaphoreHandle_t tx_ready_sem;
+    SemaphoreHandle_t tx_write_lock;
+    SemaphoreHandle_t tx_state_lock;
     TaskHandle_t rx_task_hdl;
     uint32_t sw_reset_timeout_ms;
     uint32_t next_packet_ptr;
     uint32_t last_tsv_addr;
+    uint16_t tx_len[ENC28J60_BUF_TX_SLOTS];
+    uint8_t tx_busy;
+    int8_t tx_active;
+    int8_t tx_pending;
     int int_gpio_num;
     uint8_t addr[6];
     uint8_t last_bank;
+    uint8_t pkt_cnt;
     bool packets_remain;
+    enc28j60_shadow_regs_t shadow;
     eth_enc28j60_rev_t revision;
+    eth_rx_pool_handle_t rx_pool;
     uint8_t hash_filter_cnt[ENC28J60_HASH_FILTER_TABLE_SIZE];
 } emac_enc28j60_t;
 
@@ -144,6 +183,84 @@ static inline bool enc28j60_reg_trans_unlock(emac_enc28j60_t *emac)
     return xSemaphoreGive(emac->reg_trans_lock) == pdTRUE;
 }
 
+static void *enc28j60_spi_init(const void *spi_config)
+{
+    void *ret = NULL;
+    eth_enc28j60_config_t *enc28j60_config = (eth_enc28j60_config_t *)spi_config;
+    eth_spi_info_t *spi = calloc(1, sizeof(eth_spi_info_t));
+    MAC_CHECK(spi, "no memory for SPI context data", err, NULL);
+
+    /* SPI device init */
+    spi_device_interface_config_t spi_devcfg;
+    memcpy(&spi_devcfg, enc28j60_config->spi_devcfg, sizeof(spi_device_interface_config_t));
+    if (enc28j60_config->spi_devcfg->command_bits == 0 && enc28j60_config->spi_devcfg->address_bits == 0) {
+        /* configure default SPI frame format */
+        spi_devcfg.command_bits = 3;
+        spi_devcfg.address_bits = 5;
+    } else {
+        MAC_CHECK(enc28j60_config->spi_devcfg->command_bits == 3 || enc28j60_config->spi_devcfg->address_bits == 5,
+                  "incorrect SPI frame format (command_bits/address_bits)", err, NULL);
+    }
+    MAC_CHECK(spi_bus_add_device(enc28j60_config->spi_host_id, &spi_devcfg, &spi->hdl) == ESP_OK,
+              "adding device to SPI host #%d failed", err, NULL, enc28j60_config->spi_host_id + 1);
+    spi->queued_min_len = enc28j60_config->spi_queued_min_len;
+
+    ret = spi;
+    return ret;
+err:
+    free(spi);
+    return ret;
+}
+
+static esp_err_t enc28j60_spi_deinit(void *spi_ctx)
+{
+    esp_err_t ret = ESP_OK;
+    eth_spi_info_t *spi = (eth_spi_info_t *)spi_ctx;
+
+    spi_bus_remove_device(spi->hdl);
+    free(spi);
+    return ret;
+}
+
+static esp_err_t enc28j60_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, const void *value, uint32_t len)
+{
+    esp_err_t ret = ESP_OK;
+    eth_spi_info_t *spi = (eth_spi_info_t *)spi_ctx;
+
+    spi_transaction_t trans = {
+        .cmd = cmd,
+        .addr = addr,
+        .length = 8 * len,
+        .tx_buffer = value
+    };
+    if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
+        ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        ret = ESP_FAIL;
+    }
+    return ret;
+}
+
+static esp_err_t enc28j60_spi_read(void *spi_ctx, uint32_t cmd, uint32_t addr, void *value, uint32_t len)
+{
+    esp_err_t ret = ESP_OK;
+    eth_spi_info_t *spi = (eth_spi_info_t *)spi_ctx;
+
+    spi_transaction_t trans = {
+        .flags = len <= 4 ? SPI_TRANS_USE_RXDATA : 0, // registers are read directly into the transaction
+        .cmd = cmd,
+        .addr = addr,
+        .length = 8 * len,
+        .rx_buffer = value
+    };
+    if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
+        ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        ret = ESP_FAIL;
+    } else if (trans.flags & SPI_TRANS_USE_RXDATA) {
+        memcpy(value, trans.rx_data, len);
+    }
+    return ret;
+}
+
 /**
  * @brief ERXRDPT need to be set always at odd addresses
  */
@@ -161,14 +278,20 @@ static inline uint32_t enc28j60_next_ptr_align_odd(uint32_t next_packet_ptr, uin
 }
 
 /**
- * @brief Calculate wrap around when reading beyond the end of the RX buffer
+ * @brief Shadow copy of a register, NULL if the register is not shadowed
  */
-static inline uint32_t enc28j60_rx_packet_start(uint32_t start_addr, uint32_t off)
+static inline uint8_t *enc28j60_shadow_reg(emac_enc28j60_t *emac, uint16_t reg_addr)
 {
-    if (start_addr + off > ENC28J60_BUF_RX_END) {
-        return (start_addr + off) - (ENC28J60_BUF_RX_END - ENC28J60_BUF_RX_START + 1);
-    } else {
-        return start_addr + off;
+    if (reg_addr >= ENC28J60_EHT0 && reg_addr <= ENC28J60_EHT7) {
+        return &emac->shadow.eht[reg_addr - ENC28J60_EHT0];
+    }
+    switch (reg_addr) {
+    case ENC28J60_ERXFCON:
+        return &emac->shadow.erxfcon;
+    case ENC28J60_MACON3:
+        return &emac->shadow.macon3;
+    default:
+        return NULL;
     }
 }
 
@@ -178,19 +301,12 @@ static inline uint32_t enc28j60_rx_packet_start(uint32_t start_addr, uint32_t of
 static esp_err_t enc28j60_do_register_write(emac_enc28j60_t *emac, uint8_t reg_addr, uint8_t value)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_WCR, // Write control register
-        .addr = reg_addr,
-        .length = 8,
-        .flags = SPI_TRANS_USE_TXDATA,
-        .tx_data = {
-            [0] = value
-        }
-    };
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Write control register
+        if (emac->spi.write(emac->spi.ctx, ENC28J60_SPI_CMD_WCR, reg_addr, &value, 1) != ESP_OK) {
             ret = ESP_FAIL;
+        } else if (reg_addr == ENC28J60_EIE) {
+            emac->shadow.eie = value;
         }
         enc28j60_spi_unlock(emac);
     } else {
@@ -205,18 +321,15 @@ static esp_err_t enc28j60_do_register_write(emac_enc28j60_t *emac, uint8_t reg_a
 static esp_err_t enc28j60_do_register_read(emac_enc28j60_t *emac, bool is_eth_reg, uint8_t reg_addr, uint8_t *value)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_RCR, // Read control register
-        .addr = reg_addr,
-        .length = is_eth_reg ? 8 : 16, // read operation is different for ETH register and non-ETH register
-        .flags = SPI_TRANS_USE_RXDATA
-    };
+    uint8_t data[2];
+    // read operation is different for ETH register and non-ETH register, the latter is preceded by a dummy byte
+    uint32_t len = is_eth_reg ? 1 : 2;
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Read control register
+        if (emac->spi.read(emac->spi.ctx, ENC28J60_SPI_CMD_RCR, reg_addr, data, len) != ESP_OK) {
             ret = ESP_FAIL;
         } else {
-            *value = is_eth_reg ? trans.rx_data[0] : trans.rx_data[1];
+            *value = data[len - 1];
         }
         enc28j60_spi_unlock(emac);
     } else {
@@ -232,19 +345,12 @@ static esp_err_t enc28j60_do_register_read(emac_enc28j60_t *emac, bool is_eth_re
 static esp_err_t enc28j60_do_bitwise_set(emac_enc28j60_t *emac, uint8_t reg_addr, uint8_t mask)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_BFS, // Bit field set
-        .addr = reg_addr,
-        .length = 8,
-        .flags = SPI_TRANS_USE_TXDATA,
-        .tx_data = {
-            [0] = mask
-        }
-    };
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Bit field set
+        if (emac->spi.write(emac->spi.ctx, ENC28J60_SPI_CMD_BFS, reg_addr, &mask, 1) != ESP_OK) {
             ret = ESP_FAIL;
+        } else if (reg_addr == ENC28J60_EIE) {
+            emac->shadow.eie |= mask;
         }
         enc28j60_spi_unlock(emac);
     } else {
@@ -260,19 +366,12 @@ static esp_err_t enc28j60_do_bitwise_set(emac_enc28j60_t *emac, uint8_t reg_addr
 static esp_err_t enc28j60_do_bitwise_clr(emac_enc28j60_t *emac, uint8_t reg_addr, uint8_t mask)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_BFC, // Bit field clear
-        .addr = reg_addr,
-        .length = 8,
-        .flags = SPI_TRANS_USE_TXDATA,
-        .tx_data = {
-            [0] = mask
-        }
-    };
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Bit field clear
+        if (emac->spi.write(emac->spi.ctx, ENC28J60_SPI_CMD_BFC, reg_addr, &mask, 1) != ESP_OK) {
             ret = ESP_FAIL;
+        } else if (reg_addr == ENC28J60_EIE) {
+            emac->shadow.eie &= ~mask;
         }
         enc28j60_spi_unlock(emac);
     } else {
@@ -287,15 +386,9 @@ static esp_err_t enc28j60_do_bitwise_clr(emac_enc28j60_t *emac, uint8_t reg_addr
 static esp_err_t enc28j60_do_memory_write(emac_enc28j60_t *emac, uint8_t *buffer, uint32_t len)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_WBM, // Write buffer memory
-        .addr = 0x1A,
-        .length = len * 8,
-        .tx_buffer = buffer
-    };
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Write buffer memory
+        if (emac->spi.write(emac->spi.ctx, ENC28J60_SPI_CMD_WBM, 0x1A, buffer, len) != ESP_OK) {
             ret = ESP_FAIL;
         }
         enc28j60_spi_unlock(emac);
@@ -311,16 +404,9 @@ static esp_err_t enc28j60_do_memory_write(emac_enc28j60_t *emac, uint8_t *buffer
 static esp_err_t enc28j60_do_memory_read(emac_enc28j60_t *emac, uint8_t *buffer, uint32_t len)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_RBM, // Read buffer memory
-        .addr = 0x1A,
-        .length = len * 8,
-        .rx_buffer = buffer
-    };
-
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Read buffer memory
+        if (emac->spi.read(emac->spi.ctx, ENC28J60_SPI_CMD_RBM, 0x1A, buffer, len) != ESP_OK) {
             ret = ESP_FAIL;
         }
         enc28j60_spi_unlock(emac);
@@ -336,14 +422,16 @@ static esp_err_t enc28j60_do_memory_read(emac_enc28j60_t *emac, uint8_t *buffer,
 static esp_err_t enc28j60_do_reset(emac_enc28j60_t *emac)
 {
     esp_err_t ret = ESP_OK;
-    spi_transaction_t trans = {
-        .cmd = ENC28J60_SPI_CMD_SRC, // Soft reset
-        .addr = 0x1F,
-    };
     if (enc28j60_spi_lock(emac)) {
-        if (spi_device_polling_transmit(emac->spi_hdl, &trans) != ESP_OK) {
-            ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
+        // Soft reset
+        if (emac->spi.write(emac->spi.ctx, ENC28J60_SPI_CMD_SRC, 0x1F, NULL, 0) != ESP_OK) {
             ret = ESP_FAIL;
+        } else {
+            // registers are back at their reset values
+            emac->last_bank = 0;
+            emac->pkt_cnt = 0;
+            memset(&emac->shadow, 0, sizeof(emac->shadow));
+            emac->shadow.erxfcon = ERXFCON_UCEN | ERXFCON_CRCEN | ERXFCON_BCEN;
         }
         enc28j60_spi_unlock(emac);
     } else {
@@ -358,15 +446,27 @@ static esp_err_t enc28j60_do_reset(emac_enc28j60_t *emac)
 
 /**
  * @brief Switch ENC28J60 register bank
+ *
+ * Only the bank select bits which differ from the current bank are touched, so switching to or from bank 0
+ * takes a single SPI transaction.
  */
 static esp_err_t enc28j60_switch_register_bank(emac_enc28j60_t *emac, uint8_t bank)
 {
     esp_err_t ret = ESP_OK;
     if (bank != emac->last_bank) {
-        MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_ECON1, 0x03) == ESP_OK,
-                  "clear ECON1[1:0] failed", out, ESP_FAIL);
-        MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, bank & 0x03) == ESP_OK,
-                  "set ECON1[1:0] failed", out, ESP_FAIL);
+        uint8_t current = emac->last_bank & 0x03;
+        uint8_t clr_bits = emac->last_bank > 0x03 ? 0x03 : current & ~bank;
+        uint8_t set_bits = emac->last_bank > 0x03 ? bank & 0x03 : bank & ~current;
+        // the bank is unknown until both writes succeed
+        emac->last_bank = 0xFF;
+        if (clr_bits) {
+            MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_ECON1, clr_bits) == ESP_OK,
+                      "clear ECON1[1:0] failed", out, ESP_FAIL);
+        }
+        if (set_bits) {
+            MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, set_bits) == ESP_OK,
+                      "set ECON1[1:0] failed", out, ESP_FAIL);
+        }
         emac->last_bank = bank;
     }
 out:
@@ -384,6 +484,35 @@ static esp_err_t enc28j60_register_write(emac_enc28j60_t *emac, uint16_t reg_add
                   "switch bank failed", out, ESP_FAIL);
         MAC_CHECK(enc28j60_do_register_write(emac, reg_addr & 0xFF, value) == ESP_OK,
                   "write register failed", out, ESP_FAIL);
+        uint8_t *shadow = enc28j60_shadow_reg(emac, reg_addr);
+        if (shadow) {
+            *shadow = value;
+        }
+        enc28j60_reg_trans_unlock(emac);
+    } else {
+        ret = ESP_ERR_TIMEOUT;
+    }
+    return ret;
+out:
+    enc28j60_reg_trans_unlock(emac);
+    return ret;
+}
+
+/**
+ * @brief Write a 16-bit value to a low/high register pair, low byte first
+ *
+ * Both registers are in the same bank, so the bank is selected once for the pair.
+ */
+static esp_err_t enc28j60_register_write16(emac_enc28j60_t *emac, uint16_t reg_addr_low, uint16_t value)
+{
+    esp_err_t ret = ESP_OK;
+    if (enc28j60_reg_trans_lock(emac)) {
+        MAC_CHECK(enc28j60_switch_register_bank(emac, (reg_addr_low & 0xF00) >> 8) == ESP_OK,
+                  "switch bank failed", out, ESP_FAIL);
+        MAC_CHECK(enc28j60_do_register_write(emac, reg_addr_low & 0xFF, value & 0xFF) == ESP_OK,
+                  "write register failed", out, ESP_FAIL);
+        MAC_CHECK(enc28j60_do_register_write(emac, (reg_addr_low + 1) & 0xFF, (value & 0xFF00) >> 8) == ESP_OK,
+                  "write register failed", out, ESP_FAIL);
         enc28j60_reg_trans_unlock(emac);
     } else {
         ret = ESP_ERR_TIMEOUT;
@@ -395,11 +524,16 @@ out:
 }
 
 /**
- * @brief Read ENC28J60 register
+ * @brief Read ENC28J60 register, shadowed registers are not read from the chip
  */
 static esp_err_t enc28j60_register_read(emac_enc28j60_t *emac, uint16_t reg_addr, uint8_t *value)
 {
     esp_err_t ret = ESP_OK;
+    uint8_t *shadow = enc28j60_shadow_reg(emac, reg_addr);
+    if (shadow) {
+        *value = *shadow;
+        return ESP_OK;
+    }
     if (enc28j60_reg_trans_lock(emac)) {
         MAC_CHECK(enc28j60_switch_register_bank(emac, (reg_addr & 0xF00) >> 8) == ESP_OK,
                   "switch bank failed", out, ESP_FAIL);
@@ -421,10 +555,8 @@ out:
 static esp_err_t enc28j60_read_packet(emac_enc28j60_t *emac, uint32_t addr, uint8_t *packet, uint32_t len)
 {
     esp_err_t ret = ESP_OK;
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERDPTL, addr & 0xFF) == ESP_OK,
-              "write ERDPTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERDPTH, (addr & 0xFF00) >> 8) == ESP_OK,
-              "write ERDPTH failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ERDPTL, addr) == ESP_OK,
+              "write ERDPT failed", out, ESP_FAIL);
     MAC_CHECK(enc28j60_do_memory_read(emac, packet, len) == ESP_OK,
               "read memory failed", out, ESP_FAIL);
 out:
@@ -634,25 +766,13 @@ static esp_err_t enc28j60_setup_default(emac_enc28j60_t *emac)
     esp_err_t ret = ESP_OK;
 
     // set up receive buffer start + end
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXSTL, ENC28J60_BUF_RX_START & 0xFF) == ESP_OK,
-              "write ERXSTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXSTH, (ENC28J60_BUF_RX_START & 0xFF00) >> 8) == ESP_OK,
-              "write ERXSTH failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXNDL, ENC28J60_BUF_RX_END & 0xFF) == ESP_OK,
-              "write ERXNDL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXNDH, (ENC28J60_BUF_RX_END & 0xFF00) >> 8) == ESP_OK,
-              "write ERXNDH failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ERXSTL, ENC28J60_BUF_RX_START) == ESP_OK,
+              "write ERXST failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ERXNDL, ENC28J60_BUF_RX_END) == ESP_OK,
+              "write ERXND failed", out, ESP_FAIL);
     uint32_t erxrdpt = enc28j60_next_ptr_align_odd(ENC28J60_BUF_RX_START, ENC28J60_BUF_RX_START, ENC28J60_BUF_RX_END);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXRDPTL, erxrdpt & 0xFF) == ESP_OK,
-              "write ERXRDPTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXRDPTH, (erxrdpt & 0xFF00) >> 8) == ESP_OK,
-              "write ERXRDPTH failed", out, ESP_FAIL);
-
-    // set up transmit buffer start + end
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ETXSTL, ENC28J60_BUF_TX_START & 0xFF) == ESP_OK,
-              "write ETXSTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ETXSTH, (ENC28J60_BUF_TX_START & 0xFF00) >> 8) == ESP_OK,
-              "write ETXSTH failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ERXRDPTL, erxrdpt) == ESP_OK,
+              "write ERXRDPT failed", out, ESP_FAIL);
 
     // set up default filter mode: (unicast OR broadcast OR hash table) AND crc valid; multicast receive disabled by default
     MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXFCON, ERXFCON_UCEN | ERXFCON_CRCEN | ERXFCON_BCEN | ERXFCON_HTEN) == ESP_OK,
@@ -695,10 +815,8 @@ static esp_err_t emac_enc28j60_start(esp_eth_mac_t *mac)
     MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_RXEN) == ESP_OK,
               "set ECON1.RXEN failed", out, ESP_FAIL);
 
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERDPTL, 0x00) == ESP_OK,
-              "write ERDPTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERDPTH, 0x00) == ESP_OK,
-              "write ERDPTH failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ERDPTL, 0x0000) == ESP_OK,
+              "write ERDPT failed", out, ESP_FAIL);
 out:
     return ret;
 }
@@ -746,6 +864,172 @@ static inline esp_err_t emac_enc28j60_get_tsv(emac_enc28j60_t *emac, enc28j60_ts
     return enc28j60_read_packet(emac, emac->last_tsv_addr, (uint8_t *)tsv, ENC28J60_TSV_SIZE);
 }
 
+/**
+ * @brief Hand a TX slot back to transmit()
+ */
+static void enc28j60_tx_slot_release(emac_enc28j60_t *emac, int slot)
+{
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    emac->tx_busy &= ~(1 << slot);
+    xSemaphoreGive(emac->tx_state_lock);
+    xSemaphoreGive(emac->tx_ready_sem);
+}
+
+/**
+ * @brief Transmit the frame uploaded to a TX slot, the caller holds tx_state_lock
+ *
+ * ETXST/ETXND keep pointing to the slot until the next frame is started, so the errata #13 retransmit
+ * sends the same frame again.
+ */
+static esp_err_t enc28j60_tx_start(emac_enc28j60_t *emac, int slot)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t econ1 = 0;
+    uint32_t start = ENC28J60_BUF_TX_SLOT_START(slot);
+
+    MAC_CHECK(enc28j60_do_register_read(emac, true, ENC28J60_ECON1, &econ1) == ESP_OK,
+              "read ECON1 failed", out, ESP_FAIL);
+    MAC_CHECK(!(econ1 & ECON1_TXRTS), "last transmit still in progress", out, ESP_ERR_INVALID_STATE);
+
+    /* Set the start and end pointers to the frame in the slot */
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ETXSTL, start) == ESP_OK,
+              "write ETXST failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ETXNDL, start + emac->tx_len[slot]) == ESP_OK,
+              "write ETXND failed", out, ESP_FAIL);
+    emac->last_tsv_addr = start + emac->tx_len[slot] + 1;
+
+    /* enable Tx Interrupt to indicate next Tx ready state */
+    MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXIF) == ESP_OK,
+              "set EIR_TXIF failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_EIE, EIE_TXIE) == ESP_OK,
+              "set EIE_TXIE failed", out, ESP_FAIL);
+
+    /* issue tx polling command */
+    MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_TXRTS) == ESP_OK,
+              "set ECON1.TXRTS failed", out, ESP_FAIL);
+    emac->tx_active = slot;
+out:
+    return ret;
+}
+
+/**
+ * @brief Release the TX slot of the frame which has been transmitted and start the queued frame, if any
+ *
+ * The active frame is retired only once the chip is done with it (TXRTS clear), so a TXIF serviced late never retires
+ * a frame started meanwhile.
+ *
+ * @param slot slot whose frame is to be retired, it is left alone when another one is active; -1 for the active one
+ */
+static esp_err_t enc28j60_tx_complete(emac_enc28j60_t *emac, int slot)
+{
+    esp_err_t ret = ESP_OK;
+    uint8_t econ1 = 0;
+    uint8_t eir = 0;
+    int done = -1;
+    int failed = -1;
+
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    if (emac->tx_active < 0 || (slot >= 0 && emac->tx_active != slot)) {
+        goto out;
+    }
+    MAC_CHECK(enc28j60_do_register_read(emac, true, ENC28J60_ECON1, &econ1) == ESP_OK,
+              "read ECON1 failed", out, ESP_FAIL);
+    if (econ1 & ECON1_TXRTS) {
+        goto out;
+    }
+    if (slot >= 0) {
+        // a failed frame may be retried, that is up to the task servicing TXERIF
+        MAC_CHECK(enc28j60_do_register_read(emac, true, ENC28J60_EIR, &eir) == ESP_OK,
+                  "read EIR failed", out, ESP_FAIL);
+        if (eir & EIR_TXERIF) {
+            goto out;
+        }
+    }
+    done = emac->tx_active;
+    emac->tx_active = -1;
+    if (emac->tx_pending >= 0) {
+        int slot = emac->tx_pending;
+        emac->tx_pending = -1;
+        ret = enc28j60_tx_start(emac, slot);
+        if (ret != ESP_OK) {
+            failed = slot;
+        }
+    } else {
+        ret = enc28j60_do_bitwise_clr(emac, ENC28J60_EIE, EIE_TXIE);
+    }
+out:
+    xSemaphoreGive(emac->tx_state_lock);
+    if (done >= 0) {
+        enc28j60_tx_slot_release(emac, done);
+    }
+    if (failed >= 0) {
+        enc28j60_tx_slot_release(emac, failed);
+    }
+    return ret;
+}
+
+/**
+ * @brief Reset the transmit logic after a transmit error and retry the active frame on a late collision
+ *
+ * Done under tx_state_lock, so transmit() doesn't take TXRTS cleared by the error for the frame being done, and the
+ * retry sends the active slot as ETXST/ETXND are rewritten only when the next frame is started.
+ *
+ * @param[out] retried the active frame is being transmitted again
+ */
+static esp_err_t enc28j60_tx_error(emac_enc28j60_t *emac, bool *retried)
+{
+    esp_err_t ret = ESP_OK;
+    *retried = false;
+
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    // Errata #12/#13 workaround - reset Tx state machine
+    MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_TXRST) == ESP_OK,
+              "set TXRST failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_ECON1, ECON1_TXRST) == ESP_OK,
+              "clear TXRST failed", out, ESP_FAIL);
+
+    // Clear Tx Error Interrupt Flag
+    MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXERIF) == ESP_OK,
+              "clear TXERIF failed", out, ESP_FAIL);
+
+    // Errata #13 workaround (applicable only to B5 and B7 revisions)
+    if ((emac->revision == ENC28J60_REV_B5 || emac->revision == ENC28J60_REV_B7) && emac->tx_active >= 0) {
+        __attribute__((aligned(4))) enc28j60_tsv_t tx_status; // SPI driver needs the rx buffer 4 byte align
+        MAC_CHECK(emac_enc28j60_get_tsv(emac, &tx_status) == ESP_OK,
+                  "get Tx Status Vector failed", out, ESP_FAIL);
+        // Try to retransmit when late collision is indicated
+        if (tx_status.late_collision) {
+            // Clear Tx Interrupt status Flag (it was set along with the error)
+            MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXIF) == ESP_OK,
+                      "clear TXIF failed", out, ESP_FAIL);
+            MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_TXRTS) == ESP_OK,
+                      "set TXRTS failed", out, ESP_FAIL);
+            *retried = true;
+        }
+    }
+out:
+    xSemaphoreGive(emac->tx_state_lock);
+    return ret;
+}
+
+/**
+ * @brief Forget frames in TX slots, the chip has been reset
+ */
+static void enc28j60_tx_reset(emac_enc28j60_t *emac)
+{
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    uint8_t busy = emac->tx_busy;
+    emac->tx_busy = 0;
+    emac->tx_active = -1;
+    emac->tx_pending = -1;
+    xSemaphoreGive(emac->tx_state_lock);
+    for (int slot = 0; slot < ENC28J60_BUF_TX_SLOTS; slot++) {
+        if (busy & (1 << slot)) {
+            xSemaphoreGive(emac->tx_ready_sem);
+        }
+    }
+}
+
 static void enc28j60_isr_handler(void *arg)
 {
     emac_enc28j60_t *emac = (emac_enc28j60_t *)arg;
@@ -782,8 +1066,7 @@ loop_start:
         // read interrupt status
         MAC_CHECK_NO_RET(enc28j60_do_register_read(emac, true, ENC28J60_EIR, &status) == ESP_OK,
                          "read EIR failed", loop_end);
-        MAC_CHECK_NO_RET(enc28j60_do_register_read(emac, true, ENC28J60_EIE, &mask) == ESP_OK,
-                         "read EIE failed", loop_end);
+        mask = emac->shadow.eie;
         status &= mask;
 
         // When source of interrupt is unknown, try to check if there is packet waiting (Errata #6 workaround)
@@ -792,6 +1075,7 @@ loop_start:
             MAC_CHECK_NO_RET(enc28j60_register_read(emac, ENC28J60_EPKTCNT, &pk_counter) == ESP_OK,
                              "read EPKTCNT failed", loop_end);
             if (pk_counter > 0) {
+                emac->pkt_cnt = pk_counter;
                 status = EIR_PKTIF;
             } else {
                 goto loop_end;
@@ -802,7 +1086,7 @@ loop_start:
         if (status & EIR_PKTIF) {
             do {
                 length = ETH_MAX_PACKET_SIZE;
-                buffer = heap_caps_malloc(length, MALLOC_CAP_DMA);
+                buffer = emac->rx_pool ? eth_rx_pool_alloc(emac->rx_pool, length) : heap_caps_malloc(length, MALLOC_CAP_DMA);
                 if (!buffer) {
                     ESP_LOGE(TAG, "no mem for receive buffer");
                 } else if (emac->parent.receive(&emac->parent, buffer, &length) == ESP_OK) {
@@ -810,43 +1094,21 @@ loop_start:
                     if (length) {
                         emac->eth->stack_input(emac->eth, buffer, length);
                     } else {
-                        free(buffer);
+                        eth_rx_pool_free(buffer);
                     }
                 } else {
-                    free(buffer);
+                    eth_rx_pool_free(buffer);
                 }
             } while (emac->packets_remain);
         }
 
         // transmit error
         if (status & EIR_TXERIF) {
-            // Errata #12/#13 workaround - reset Tx state machine
-            MAC_CHECK_NO_RET(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_TXRST) == ESP_OK,
-                             "set TXRST failed", loop_end);
-            MAC_CHECK_NO_RET(enc28j60_do_bitwise_clr(emac, ENC28J60_ECON1, ECON1_TXRST) == ESP_OK,
-                             "clear TXRST failed", loop_end);
-
-            // Clear Tx Error Interrupt Flag
-            MAC_CHECK_NO_RET(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXERIF) == ESP_OK,
-                             "clear TXERIF failed", loop_end);
-
-            // Errata #13 workaround (applicable only to B5 and B7 revisions)
-            if (emac->revision == ENC28J60_REV_B5 || emac->revision == ENC28J60_REV_B7) {
-                __attribute__((aligned(4))) enc28j60_tsv_t tx_status; // SPI driver needs the rx buffer 4 byte align
-                MAC_CHECK_NO_RET(emac_enc28j60_get_tsv(emac, &tx_status) == ESP_OK,
-                                 "get Tx Status Vector failed", loop_end);
-                // Try to retransmit when late collision is indicated
-                if (tx_status.late_collision) {
-                    // Clear Tx Interrupt status Flag (it was set along with the error)
-                    MAC_CHECK_NO_RET(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXIF) == ESP_OK,
-                                     "clear TXIF failed", loop_end);
-                    // Enable global interrupt flag and try to retransmit
-                    MAC_CHECK_NO_RET(enc28j60_do_bitwise_set(emac, ENC28J60_EIE, EIE_INTIE) == ESP_OK,
-                                     "set INTIE failed", loop_end);
-                    MAC_CHECK_NO_RET(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_TXRTS) == ESP_OK,
-                                     "set TXRTS failed", loop_end);
-                    continue; // no need to handle Tx ready interrupt nor to enable global interrupt at this point
-                }
+            bool retried = false;
+            MAC_CHECK_NO_RET(enc28j60_tx_error(emac, &retried) == ESP_OK,
+                             "Tx error handling failed", loop_end);
+            if (retried) {
+                goto loop_end; // the Tx ready interrupt was set along with the error, no need to handle it
             }
         }
 
@@ -854,10 +1116,8 @@ loop_start:
         if (status & EIR_TXIF) {
             MAC_CHECK_NO_RET(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXIF) == ESP_OK,
                              "clear TXIF failed", loop_end);
-            MAC_CHECK_NO_RET(enc28j60_do_bitwise_clr(emac, ENC28J60_EIE, EIE_TXIE) == ESP_OK,
-                             "clear TXIE failed", loop_end);
-
-            xSemaphoreGive(emac->tx_ready_sem);
+            MAC_CHECK_NO_RET(enc28j60_tx_complete(emac, -1) == ESP_OK,
+                             "start of queued frame failed", loop_end);
         }
 loop_end:
         // restore global enable interrupt bit
@@ -992,27 +1252,33 @@ static esp_err_t emac_enc28j60_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32
 {
     esp_err_t ret = ESP_OK;
     emac_enc28j60_t *emac = __containerof(mac, emac_enc28j60_t, parent);
-    uint8_t econ1 = 0;
+    int slot = -1;
 
-    /* ENC28J60 may be a bottle neck in Eth communication. Hence we need to check if it is ready. */
+    MAC_CHECK(length <= ETH_MAX_PACKET_SIZE, "frame too long (%d)", err, ESP_ERR_INVALID_ARG, (int)length);
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    int active = emac->tx_active;
+    xSemaphoreGive(emac->tx_state_lock);
+    /* ENC28J60 may be a bottle neck in Eth communication. Hence we need to check if a TX slot is free. */
     if (xSemaphoreTake(emac->tx_ready_sem, pdMS_TO_TICKS(ENC28J60_TX_READY_TIMEOUT_MS)) == pdFALSE) {
         ESP_LOGW(TAG, "tx_ready_sem expired");
+        // TXIF may have been missed, retire the frame which has been active all the wait if the chip is done with it
+        if (active >= 0) {
+            MAC_CHECK(enc28j60_tx_complete(emac, active) == ESP_OK, "start of queued frame failed", err, ESP_FAIL);
+        }
+        MAC_CHECK(xSemaphoreTake(emac->tx_ready_sem, 0) == pdTRUE, "no free TX slot", err, ESP_ERR_TIMEOUT);
     }
-    MAC_CHECK(enc28j60_do_register_read(emac, true, ENC28J60_ECON1, &econ1) == ESP_OK,
-              "read ECON1 failed", out, ESP_FAIL);
-    MAC_CHECK(!(econ1 & ECON1_TXRTS), "last transmit still in progress", out, ESP_ERR_INVALID_STATE);
 
-    /* Set the write pointer to start of transmit buffer area */
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_EWRPTL, ENC28J60_BUF_TX_START & 0xFF) == ESP_OK,
-              "write EWRPTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_EWRPTH, (ENC28J60_BUF_TX_START & 0xFF00) >> 8) == ESP_OK,
-              "write EWRPTH failed", out, ESP_FAIL);
+    // frames are uploaded one by one, so they are also transmitted in the order they were passed in
+    MAC_CHECK(xSemaphoreTake(emac->tx_write_lock, pdMS_TO_TICKS(ENC28J60_TX_READY_TIMEOUT_MS)) == pdTRUE,
+              "TX write lock timeout", err_slot, ESP_ERR_TIMEOUT);
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    slot = (emac->tx_busy & 0x01) ? 1 : 0;
+    emac->tx_busy |= 1 << slot;
+    xSemaphoreGive(emac->tx_state_lock);
 
-    /* Set the end pointer to correspond to the packet size given */
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ETXNDL, (ENC28J60_BUF_TX_START + length) & 0xFF) == ESP_OK,
-              "write ETXNDL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ETXNDH, ((ENC28J60_BUF_TX_START + length) & 0xFF00) >> 8) == ESP_OK,
-              "write ETXNDH failed", out, ESP_FAIL);
+    /* Set the write pointer to start of the TX slot, the other slot may be being transmitted meanwhile */
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_EWRPTL, ENC28J60_BUF_TX_SLOT_START(slot)) == ESP_OK,
+              "write EWRPT failed", out, ESP_FAIL);
 
     /* copy data to tx memory */
     uint8_t per_pkt_control = 0; // MACON3 will be used to determine how the packet will be transmitted
@@ -1020,18 +1286,28 @@ static esp_err_t emac_enc28j60_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32
               "write packet control byte failed", out, ESP_FAIL);
     MAC_CHECK(enc28j60_do_memory_write(emac, buf, length) == ESP_OK,
               "buffer memory write failed", out, ESP_FAIL);
-    emac->last_tsv_addr = ENC28J60_BUF_TX_START + length + 1;
 
-    /* enable Tx Interrupt to indicate next Tx ready state */
-    MAC_CHECK(enc28j60_do_bitwise_clr(emac, ENC28J60_EIR, EIR_TXIF) == ESP_OK,
-              "set EIR_TXIF failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_EIE, EIE_TXIE) == ESP_OK,
-              "set EIE_TXIE failed", out, ESP_FAIL);
-
-    /* issue tx polling command */
-    MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON1, ECON1_TXRTS) == ESP_OK,
-              "set ECON1.TXRTS failed", out, ESP_FAIL);
+    /* start the frame right away if the transmitter is idle, queue it otherwise */
+    xSemaphoreTake(emac->tx_state_lock, portMAX_DELAY);
+    emac->tx_len[slot] = length;
+    if (emac->tx_active < 0) {
+        ret = enc28j60_tx_start(emac, slot);
+    } else {
+        emac->tx_pending = slot;
+    }
+    xSemaphoreGive(emac->tx_state_lock);
+    xSemaphoreGive(emac->tx_write_lock);
+    if (ret != ESP_OK) {
+        enc28j60_tx_slot_release(emac, slot);
+    }
+    return ret;
 out:
+    xSemaphoreGive(emac->tx_write_lock);
+    enc28j60_tx_slot_release(emac, slot);
+    return ret;
+err_slot:
+    xSemaphoreGive(emac->tx_ready_sem);
+err:
     return ret;
 }
 
@@ -1039,11 +1315,21 @@ static esp_err_t emac_enc28j60_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_
 {
     esp_err_t ret = ESP_OK;
     emac_enc28j60_t *emac = __containerof(mac, emac_enc28j60_t, parent);
-    uint8_t pk_counter = 0;
     uint16_t rx_len = 0;
     uint32_t next_packet_addr = 0;
     __attribute__((aligned(4))) enc28j60_rx_header_t header; // SPI driver needs the rx buffer 4 byte align
 
+    // EPKTCNT is in another bank than the RX pointers, so it is read once per batch of frames rather than per frame
+    if (emac->pkt_cnt == 0) {
+        MAC_CHECK(enc28j60_register_read(emac, ENC28J60_EPKTCNT, &emac->pkt_cnt) == ESP_OK,
+                  "read EPKTCNT failed", out, ESP_FAIL);
+        if (emac->pkt_cnt == 0) {
+            *length = 0;
+            emac->packets_remain = false;
+            return ESP_OK;
+        }
+    }
+
     // read packet header
     MAC_CHECK(enc28j60_read_packet(emac, emac->next_packet_ptr, (uint8_t *)&header, sizeof(header)) == ESP_OK,
               "read header failed", out, ESP_FAIL);
@@ -1052,26 +1338,32 @@ static esp_err_t emac_enc28j60_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_
     rx_len = header.length_low + (header.length_high << 8);
     next_packet_addr = header.next_packet_low + (header.next_packet_high << 8);
 
-    // read packet content
-    MAC_CHECK(enc28j60_read_packet(emac, enc28j60_rx_packet_start(emac->next_packet_ptr, ENC28J60_RSV_SIZE), buf, rx_len) == ESP_OK,
+    // read packet content, ERDPT already points right behind the header and wraps at the end of RX buffer by itself
+    MAC_CHECK(enc28j60_do_memory_read(emac, buf, rx_len) == ESP_OK,
               "read packet content failed", out, ESP_FAIL);
 
     // free receive buffer space
     uint32_t erxrdpt = enc28j60_next_ptr_align_odd(next_packet_addr, ENC28J60_BUF_RX_START, ENC28J60_BUF_RX_END);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXRDPTL, (erxrdpt & 0xFF)) == ESP_OK,
-              "write ERXRDPTL failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_write(emac, ENC28J60_ERXRDPTH, (erxrdpt & 0xFF00) >> 8) == ESP_OK,
-              "write ERXRDPTH failed", out, ESP_FAIL);
+    MAC_CHECK(enc28j60_register_write16(emac, ENC28J60_ERXRDPTL, erxrdpt) == ESP_OK,
+              "write ERXRDPT failed", out, ESP_FAIL);
     emac->next_packet_ptr = next_packet_addr;
 
     MAC_CHECK(enc28j60_do_bitwise_set(emac, ENC28J60_ECON2, ECON2_PKTDEC) == ESP_OK,
               "set ECON2.PKTDEC failed", out, ESP_FAIL);
-    MAC_CHECK(enc28j60_register_read(emac, ENC28J60_EPKTCNT, &pk_counter) == ESP_OK,
-              "read EPKTCNT failed", out, ESP_FAIL);
+    emac->pkt_cnt--;
+    if (emac->pkt_cnt == 0) {
+        // look for frames received meanwhile
+        MAC_CHECK(enc28j60_register_read(emac, ENC28J60_EPKTCNT, &emac->pkt_cnt) == ESP_OK,
+                  "read EPKTCNT failed", out, ESP_FAIL);
+    }
 
     *length = rx_len - 4; // subtract the CRC length
-    emac->packets_remain = pk_counter > 0;
+    emac->packets_remain = emac->pkt_cnt > 0;
+    return ESP_OK;
 out:
+    // resynchronize with EPKTCNT on the next call
+    emac->pkt_cnt = 0;
+    emac->packets_remain = false;
     return ret;
 }
 
@@ -1106,6 +1398,7 @@ static esp_err_t emac_enc28j60_init(esp_eth_mac_t *mac)
     MAC_CHECK(enc28j60_verify_id(emac) == ESP_OK, "verify chip ID failed", out, ESP_FAIL);
     /* default setup of internal registers */
     MAC_CHECK(enc28j60_setup_default(emac) == ESP_OK, "enc28j60 default setup failed", out, ESP_FAIL);
+    enc28j60_tx_reset(emac);
     /* clear multicast hash table */
     MAC_CHECK(enc28j60_clear_multicast_table(emac) == ESP_OK, "clear multicast table failed", out, ESP_FAIL);
 
@@ -1132,10 +1425,12 @@ static esp_err_t emac_enc28j60_del(esp_eth_mac_t *mac)
 {
     emac_enc28j60_t *emac = __containerof(mac, emac_enc28j60_t, parent);
     vTaskDelete(emac->rx_task_hdl);
-    spi_bus_remove_device(emac->spi_hdl);
+    emac->spi.deinit(emac->spi.ctx);
     vSemaphoreDelete(emac->spi_lock);
     vSemaphoreDelete(emac->reg_trans_lock);
     vSemaphoreDelete(emac->tx_ready_sem);
+    vSemaphoreDelete(emac->tx_write_lock);
+    vSemaphoreDelete(emac->tx_state_lock);
     free(emac);
     return ESP_OK;
 }
@@ -1150,25 +1445,37 @@ esp_eth_mac_t *esp_eth_mac_new_enc28j60(const eth_enc28j60_config_t *enc28j60_co
     MAC_CHECK(emac, "calloc emac failed", err, NULL);
     /* enc28j60 driver is interrupt driven */
     MAC_CHECK(enc28j60_config->int_gpio_num >= 0, "error interrupt gpio number", err, NULL);
-    /* SPI device init */
-    spi_device_interface_config_t spi_devcfg;
-    memcpy(&spi_devcfg, enc28j60_config->spi_devcfg, sizeof(spi_device_interface_config_t));
-    if (enc28j60_config->spi_devcfg->command_bits == 0 && enc28j60_config->spi_devcfg->address_bits == 0) {
-        /* configure default SPI frame format */
-        spi_devcfg.command_bits = 3;
-        spi_devcfg.address_bits = 5;
-    } else {
-        MAC_CHECK(enc28j60_config->spi_devcfg->command_bits == 3 || enc28j60_config->spi_devcfg->address_bits == 5,
-                  "incorrect SPI frame format (command_bits/address_bits)", err, NULL);
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 1, 0)
+    if (enc28j60_config->custom_spi_driver.init != NULL && enc28j60_config->custom_spi_driver.deinit != NULL
+            && enc28j60_config->custom_spi_driver.read != NULL && enc28j60_config->custom_spi_driver.write != NULL) {
+        ESP_LOGD(TAG, "Using user's custom SPI Driver");
+        emac->spi.init = enc28j60_config->custom_spi_driver.init;
+        emac->spi.deinit = enc28j60_config->custom_spi_driver.deinit;
+        emac->spi.read = enc28j60_config->custom_spi_driver.read;
+        emac->spi.write = enc28j60_config->custom_spi_driver.write;
+        /* Custom SPI driver device init */
+        MAC_CHECK((emac->spi.ctx = emac->spi.init(enc28j60_config->custom_spi_driver.config)) != NULL,
+                  "SPI initialization failed", err, NULL);
+    } else
+#endif
+    {
+        ESP_LOGD(TAG, "Using default SPI Driver");
+        emac->spi.init = enc28j60_spi_init;
+        emac->spi.deinit = enc28j60_spi_deinit;
+        emac->spi.read = enc28j60_spi_read;
+        emac->spi.write = enc28j60_spi_write;
+        /* SPI device init */
+        MAC_CHECK((emac->spi.ctx = emac->spi.init(enc28j60_config)) != NULL, "SPI initialization failed", err, NULL);
     }
-    MAC_CHECK(spi_bus_add_device(enc28j60_config->spi_host_id, &spi_devcfg, &emac->spi_hdl) == ESP_OK,
-              "adding device to SPI host #%d failed", err, NULL, enc28j60_config->spi_host_id + 1);
 
     emac->last_bank = 0xFF;
     emac->next_packet_ptr = ENC28J60_BUF_RX_START;
+    emac->tx_active = -1;
+    emac->tx_pending = -1;
     /* bind methods and attributes */
     emac->sw_reset_timeout_ms = mac_config->sw_reset_timeout_ms;
     emac->int_gpio_num = enc28j60_config->int_gpio_num;
+    emac->rx_pool = enc28j60_config->rx_pool;
     emac->parent.set_mediator = emac_enc28j60_set_mediator;
     emac->parent.init = emac_enc28j60_init;
     emac->parent.deinit = emac_enc28j60_deinit;
@@ -1195,9 +1502,13 @@ esp_eth_mac_t *esp_eth_mac_new_enc28j60(const eth_enc28j60_config_t *enc28j60_co
     MAC_CHECK(emac->spi_lock, "create spi lock failed", err, NULL);
     emac->reg_trans_lock = xSemaphoreCreateMutex();
     MAC_CHECK(emac->reg_trans_lock, "create register transaction lock failed", err, NULL);
-    emac->tx_ready_sem = xSemaphoreCreateBinary();
+    // counts free TX slots, so the first transmits are performed without waiting
+    emac->tx_ready_sem = xSemaphoreCreateCounting(ENC28J60_BUF_TX_SLOTS, ENC28J60_BUF_TX_SLOTS);
     MAC_CHECK(emac->tx_ready_sem, "create pkt transmit ready semaphore failed", err, NULL);
-    xSemaphoreGive(emac->tx_ready_sem); // ensures the first transmit is performed without waiting
+    emac->tx_write_lock = xSemaphoreCreateMutex();
+    MAC_CHECK(emac->tx_write_lock, "create TX write lock failed", err, NULL);
+    emac->tx_state_lock = xSemaphoreCreateMutex();
+    MAC_CHECK(emac->tx_state_lock, "create TX state lock failed", err, NULL);
     /* create enc28j60 task */
     BaseType_t core_num = tskNO_AFFINITY;
     if (mac_config->flags & ETH_MAC_FLAG_PIN_TO_CORE) {
@@ -1213,6 +1524,9 @@ err:
         if (emac->rx_task_hdl) {
             vTaskDelete(emac->rx_task_hdl);
         }
+        if (emac->spi.ctx) {
+            emac->spi.deinit(emac->spi.ctx);
+        }
         if (emac->spi_lock) {
             vSemaphoreDelete(emac->spi_lock);
         }
@@ -1222,6 +1536,12 @@ err:
         if (emac->tx_ready_sem) {
             vSemaphoreDelete(emac->tx_ready_sem);
         }
+        if (emac->tx_write_lock) {
+            vSemaphoreDelete(emac->tx_write_lock);
+        }
+        if (emac->tx_state_lock) {
+            vSemaphoreDelete(emac->tx_state_lock);
+        }
         free(emac);
     }
     return ret;
@@ -0,0 +1,364 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "enc28j60_model.h"
+
+/* The model is written against the datasheet, it intentionally doesn't share register definitions with the driver. */
+#define OP_RCR            (0x00)
+#define OP_RBM            (0x01)
+#define OP_WCR            (0x02)
+#define OP_WBM            (0x03)
+#define OP_BFS            (0x04)
+#define OP_BFC            (0x05)
+#define OP_SRC            (0x07)
+
+#define COMMON_REG_START  (0x1B) // EIE, EIR, ESTAT, ECON2 and ECON1 are mapped to all banks
+#define REG_EIE           (0x1B)
+#define REG_EIR           (0x1C)
+#define REG_ESTAT         (0x1D)
+#define REG_ECON2         (0x1E)
+#define REG_ECON1         (0x1F)
+#define EIE_INTIE         (0x80)
+#define EIR_TXIF          (0x08)
+#define EIR_TXERIF        (0x02)
+#define ESTAT_LATECOL     (0x10)
+#define ESTAT_TXABRT      (0x02)
+#define ECON2_PKTDEC      (0x40)
+#define ECON2_AUTOINC     (0x80)
+#define ECON1_TXRST       (0x80)
+#define ECON1_TXRTS       (0x08)
+#define ECON1_BSEL_MASK   (0x03)
+
+// bank 0
+#define REG_ERDPTL        (0x00)
+#define REG_EWRPTL        (0x02)
+#define REG_ETXSTL        (0x04)
+#define REG_ETXNDL        (0x06)
+#define REG_ERXSTL        (0x08)
+#define REG_ERXNDL        (0x0A)
+#define REG_ERXRDPTL      (0x0C)
+// bank 1
+#define REG_ERXFCON       (0x18)
+#define REG_EPKTCNT       (0x19)
+// bank 3
+#define REG_MISTAT        (0x0A)
+#define REG_EREVID        (0x12)
+
+#define ERXFCON_RESET     (0xA1) // UCEN | CRCEN | BCEN
+#define REVISION_B7       (0x06)
+#define RSV_RECEIVED_OK   (0x80) // RSV bit 23
+#define TSV_SIZE          (7)
+#define TSV_DONE          (0x80) // TSV bit 23
+#define TSV_LATE_COLL     (0x20) // TSV bit 29
+#define BUFFER_SIZE       (0x2000)
+#define BUFFER_MASK       (BUFFER_SIZE - 1)
+
+typedef struct {
+    uint8_t regs[4][32];
+    uint8_t mem[BUFFER_SIZE];
+    enc28j60_model_stats_t stats;
+} enc28j60_model_t;
+
+static enc28j60_model_t s_model;
+
+static uint8_t *reg_ptr(uint8_t bank, uint8_t addr)
+{
+    addr &= 0x1F;
+    return &s_model.regs[addr >= COMMON_REG_START ? 0 : bank & 0x03][addr];
+}
+
+static uint8_t cur_bank(void)
+{
+    return s_model.regs[0][REG_ECON1] & ECON1_BSEL_MASK;
+}
+
+/* MAC and MII registers shift out a dummy byte before the data */
+static bool is_mac_mii_reg(uint8_t bank, uint8_t addr)
+{
+    if (addr >= COMMON_REG_START) {
+        return false;
+    }
+    return bank == 2 || (bank == 3 && (addr <= 0x05 || addr == REG_MISTAT));
+}
+
+static uint16_t ptr_get(uint8_t addr_low)
+{
+    return (s_model.regs[0][addr_low] | (s_model.regs[0][addr_low + 1] << 8)) & BUFFER_MASK;
+}
+
+static void ptr_set(uint8_t addr_low, uint16_t value)
+{
+    s_model.regs[0][addr_low] = value & 0xFF;
+    s_model.regs[0][addr_low + 1] = (value >> 8) & 0x1F;
+}
+
+/* the read pointer and the receive logic wrap from ERXND back to ERXST */
+static uint16_t rx_ptr_next(uint16_t ptr)
+{
+    if (ptr == ptr_get(REG_ERXNDL)) {
+        return ptr_get(REG_ERXSTL);
+    }
+    return (ptr + 1) & BUFFER_MASK;
+}
+
+static void regs_reset(void)
+{
+    memset(s_model.regs, 0, sizeof(s_model.regs));
+    ptr_set(REG_ERDPTL, 0x05FA);
+    ptr_set(REG_ERXSTL, 0x05FA);
+    ptr_set(REG_ERXNDL, 0x1FFF);
+    ptr_set(REG_ERXRDPTL, 0x05FA);
+    s_model.regs[0][REG_ECON2] = ECON2_AUTOINC;
+    s_model.regs[1][REG_ERXFCON] = ERXFCON_RESET;
+    s_model.regs[3][REG_EREVID] = REVISION_B7;
+}
+
+void enc28j60_model_reset(void)
+{
+    memset(&s_model, 0, sizeof(s_model));
+    regs_reset();
+}
+
+void enc28j60_model_stats_clear(void)
+{
+    memset(&s_model.stats, 0, sizeof(s_model.stats));
+}
+
+const enc28j60_model_stats_t *enc28j60_model_stats(void)
+{
+    return &s_model.stats;
+}
+
+uint32_t enc28j60_model_reg_reads(uint16_t reg)
+{
+    uint8_t addr = reg & 0x1F;
+    return s_model.stats.reg_reads[addr >= COMMON_REG_START ? 0 : (reg >> 8) & 0x03][addr];
+}
+
+uint8_t enc28j60_model_reg_get(uint16_t reg)
+{
+    return *reg_ptr((reg >> 8) & 0x03, reg & 0x1F);
+}
+
+void enc28j60_model_reg_set(uint16_t reg, uint8_t value)
+{
+    *reg_ptr((reg >> 8) & 0x03, reg & 0x1F) = value;
+}
+
+uint8_t enc28j60_model_bank(void)
+{
+    return cur_bank();
+}
+
+uint16_t enc28j60_model_rx_frame_put(uint16_t addr, const uint8_t *frame, uint16_t len)
+{
+    // frames start at even addresses
+    uint16_t next = addr;
+    for (uint32_t i = 0; i < 6 + len; i++) {
+        next = rx_ptr_next(next);
+    }
+    if (next & 0x01) {
+        next = rx_ptr_next(next);
+    }
+    const uint8_t header[6] = { next & 0xFF, next >> 8, len & 0xFF, len >> 8, RSV_RECEIVED_OK, 0x00 };
+    uint16_t ptr = addr;
+    for (uint32_t i = 0; i < sizeof(header); i++) {
+        s_model.mem[ptr] = header[i];
+        ptr = rx_ptr_next(ptr);
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        s_model.mem[ptr] = frame[i];
+        ptr = rx_ptr_next(ptr);
+    }
+    return next;
+}
+
+/* INT is asserted while an enabled interrupt flag is set and INTIE allows it */
+static void update_int(void)
+{
+    uint8_t eie = s_model.regs[0][REG_EIE];
+    eth_spi_model_int_set((eie & EIE_INTIE) && (s_model.regs[0][REG_EIR] & eie & ~EIE_INTIE));
+}
+
+/* the frame between ETXST and ETXND goes out, the per packet control byte at ETXST is followed by the frame */
+static void tx_start(void)
+{
+    uint16_t start = ptr_get(REG_ETXSTL);
+    uint16_t len = (ptr_get(REG_ETXNDL) - start) & BUFFER_MASK;
+    if (s_model.stats.tx_starts < ENC28J60_MODEL_MAX_TX) {
+        enc28j60_model_tx_t *tx = &s_model.stats.txs[s_model.stats.tx_starts];
+        tx->start = start;
+        tx->len = len;
+        for (int i = 0; i < sizeof(tx->head); i++) {
+            tx->head[i] = s_model.mem[(start + 1 + i) & BUFFER_MASK];
+        }
+    }
+    s_model.stats.tx_starts++;
+}
+
+bool enc28j60_model_tx_done(enc28j60_model_tx_result_t result)
+{
+    eth_spi_model_lock();
+    uint8_t *econ1 = &s_model.regs[0][REG_ECON1];
+    bool busy = *econ1 & ECON1_TXRTS;
+    if (busy) {
+        uint16_t start = ptr_get(REG_ETXSTL);
+        uint16_t end = ptr_get(REG_ETXNDL);
+        uint16_t len = (end - start) & BUFFER_MASK;
+        bool late_coll = result == ENC28J60_MODEL_TX_LATE_COLLISION;
+        const uint8_t tsv[TSV_SIZE] = { len & 0xFF, len >> 8, late_coll ? 0 : TSV_DONE, late_coll ? TSV_LATE_COLL : 0,
+                                        len & 0xFF, len >> 8, 0
+                                      };
+        for (int i = 0; i < TSV_SIZE; i++) {
+            s_model.mem[(end + 1 + i) & BUFFER_MASK] = tsv[i];
+        }
+        *econ1 &= ~ECON1_TXRTS;
+        if (late_coll) {
+            s_model.regs[0][REG_ESTAT] |= ESTAT_LATECOL | ESTAT_TXABRT;
+            s_model.regs[0][REG_EIR] |= EIR_TXERIF | EIR_TXIF;
+        } else if (result == ENC28J60_MODEL_TX_OK) {
+            s_model.regs[0][REG_EIR] |= EIR_TXIF;
+        }
+        update_int();
+    }
+    eth_spi_model_unlock();
+    return busy;
+}
+
+static void bitwise_write(uint8_t addr, uint8_t mask, bool set)
+{
+    uint8_t bank = cur_bank();
+    uint8_t *reg = reg_ptr(bank, addr);
+    if (addr == REG_ECON1 && (mask & ECON1_BSEL_MASK)) {
+        s_model.stats.bank_selects++;
+        if (mask & ECON1_BSEL_MASK & (set ? bank : ~bank)) {
+            s_model.stats.redundant_selects++;
+        }
+    }
+    uint8_t old = *reg;
+    if (set) {
+        *reg |= mask;
+    } else {
+        *reg &= ~mask;
+    }
+    if (addr == REG_ECON1) {
+        // TXRST aborts the transmission in progress and keeps the transmit logic in reset
+        if (*reg & ECON1_TXRST) {
+            *reg &= ~ECON1_TXRTS;
+        } else if ((*reg & ECON1_TXRTS) && !(old & ECON1_TXRTS)) {
+            tx_start();
+        }
+    }
+    // PKTDEC decrements EPKTCNT and clears itself
+    if (addr == REG_ECON2 && (*reg & ECON2_PKTDEC)) {
+        *reg &= ~ECON2_PKTDEC;
+        if (s_model.regs[1][REG_EPKTCNT]) {
+            s_model.regs[1][REG_EPKTCNT]--;
+        }
+    }
+}
+
+static esp_err_t model_spi_read(void *ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len)
+{
+    uint8_t op = cmd & 0x07;
+    uint8_t bank = cur_bank();
+    uint8_t *rx = data;
+    addr &= 0x1F;
+
+    switch (op) {
+    case OP_RCR:
+        if (!rx || len == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        s_model.stats.reg_reads[addr >= COMMON_REG_START ? 0 : bank][addr]++;
+        memset(rx, 0, len);
+        if (is_mac_mii_reg(bank, addr)) {
+            if (len > 1) {
+                rx[1] = *reg_ptr(bank, addr);
+            }
+        } else {
+            rx[0] = *reg_ptr(bank, addr);
+        }
+        break;
+    case OP_RBM: {
+        if (!rx) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        bool autoinc = s_model.regs[0][REG_ECON2] & ECON2_AUTOINC;
+        uint16_t ptr = ptr_get(REG_ERDPTL);
+        for (uint32_t i = 0; i < len; i++) {
+            rx[i] = s_model.mem[ptr];
+            if (autoinc) {
+                ptr = rx_ptr_next(ptr);
+            }
+        }
+        ptr_set(REG_ERDPTL, ptr);
+        break;
+    }
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t model_spi_write(void *ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len)
+{
+    uint8_t op = cmd & 0x07;
+    uint8_t bank = cur_bank();
+    const uint8_t *tx = data;
+    addr &= 0x1F;
+
+    switch (op) {
+    case OP_WCR:
+        if (!tx || len == 0) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        if (addr == REG_ECON1) {
+            s_model.stats.bank_selects++;
+        }
+        *reg_ptr(bank, addr) = tx[0];
+        break;
+    case OP_BFS:
+    case OP_BFC:
+        if (!tx || len == 0 || is_mac_mii_reg(bank, addr)) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        bitwise_write(addr, tx[0], op == OP_BFS);
+        break;
+    case OP_WBM: {
+        if (!tx) {
+            return ESP_ERR_INVALID_ARG;
+        }
+        bool autoinc = s_model.regs[0][REG_ECON2] & ECON2_AUTOINC;
+        uint16_t ptr = ptr_get(REG_EWRPTL);
+        for (uint32_t i = 0; i < len; i++) {
+            s_model.mem[ptr] = tx[i];
+            if (autoinc) {
+                ptr = (ptr + 1) & BUFFER_MASK;
+            }
+        }
+        ptr_set(REG_EWRPTL, ptr);
+        break;
+    }
+    case OP_SRC:
+        regs_reset();
+        break;
+    default:
+        return ESP_ERR_INVALID_ARG;
+    }
+    update_int();
+    return ESP_OK;
+}
+
+static const eth_spi_model_t s_spi_model = {
+    .read = model_spi_read,
+    .write = model_spi_write,
+};
+
+eth_spi_custom_driver_config_t enc28j60_model_spi_driver(void)
+{
+    return eth_spi_model_driver(&s_spi_model);
+}
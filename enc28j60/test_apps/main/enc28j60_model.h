@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "eth_spi_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Register as the driver addresses it: bank in bits 9:8, MAC/MII register flag in bit 12, address in bits 4:0
+ */
+#define ENC28J60_MODEL_REG(bank, addr) ((uint16_t)(((bank) << 8) | (addr)))
+
+#define ENC28J60_MODEL_MAX_TX (16) /*!< Number of transmissions recorded by the model */
+
+/**
+ * @brief Transmission started by setting ECON1.TXRTS
+ */
+typedef struct {
+    uint16_t start;     /*!< ETXST, address of the per packet control byte */
+    uint16_t len;       /*!< Frame length, ETXND - ETXST */
+    uint8_t head[16];   /*!< First bytes of the frame */
+} enc28j60_model_tx_t;
+
+/**
+ * @brief How the transmission in progress ends
+ */
+typedef enum {
+    ENC28J60_MODEL_TX_OK,             /*!< Frame sent: TXRTS cleared, TXIF set */
+    ENC28J60_MODEL_TX_LOST_IRQ,       /*!< Frame sent: TXRTS cleared, but TXIF not set, as if the interrupt was lost */
+    ENC28J60_MODEL_TX_LATE_COLLISION, /*!< Frame aborted by a late collision: TXRTS cleared, TXERIF and TXIF set */
+} enc28j60_model_tx_result_t;
+
+/**
+ * @brief Statistics collected by the ENC28J60 model
+ */
+typedef struct {
+    uint32_t bank_selects;                      /*!< BFS/BFC/WCR transactions which wrote ECON1.BSEL */
+    uint32_t redundant_selects;                 /*!< BFS/BFC transactions which wrote an ECON1.BSEL bit to the value it already had */
+    uint32_t reg_reads[4][32];                  /*!< RCR transactions per bank and address, common registers are counted in bank 0 */
+    uint32_t tx_starts;                         /*!< Transmissions started */
+    enc28j60_model_tx_t txs[ENC28J60_MODEL_MAX_TX]; /*!< Transmissions in the order they were started */
+} enc28j60_model_stats_t;
+
+/**
+ * @brief Reset the model to the power on state and clear the statistics
+ */
+void enc28j60_model_reset(void);
+
+/**
+ * @brief Clear the statistics only
+ */
+void enc28j60_model_stats_clear(void);
+
+/**
+ * @brief Get the statistics collected since the last reset or clear
+ */
+const enc28j60_model_stats_t *enc28j60_model_stats(void);
+
+/**
+ * @brief Number of RCR transactions which read the given register
+ *
+ * @param reg register as the driver addresses it, see ENC28J60_MODEL_REG()
+ */
+uint32_t enc28j60_model_reg_reads(uint16_t reg);
+
+/**
+ * @brief Get a register value as held by the chip, without any SPI transaction
+ */
+uint8_t enc28j60_model_reg_get(uint16_t reg);
+
+/**
+ * @brief Set a register value as if the chip changed it, without any SPI transaction
+ */
+void enc28j60_model_reg_set(uint16_t reg, uint8_t value);
+
+/**
+ * @brief Bank currently selected by ECON1.BSEL
+ */
+uint8_t enc28j60_model_bank(void);
+
+/**
+ * @brief Put a frame into the receive buffer as the receive logic does: next packet pointer, receive status vector, frame
+ *
+ * The frame wraps from ERXND to ERXST. The caller accounts the frame in EPKTCNT.
+ *
+ * @param addr address of the next packet pointer, must be even
+ * @param frame frame with its CRC
+ * @param len length of the frame with its CRC
+ *
+ * @return address of the next frame
+ */
+uint16_t enc28j60_model_rx_frame_put(uint16_t addr, const uint8_t *frame, uint16_t len);
+
+/**
+ * @brief End the transmission in progress, write its status vector after ETXND and assert INT if enabled
+ *
+ * @return false when no transmission is in progress
+ */
+bool enc28j60_model_tx_done(enc28j60_model_tx_result_t result);
+
+/**
+ * @brief Custom SPI driver which executes the driver's transactions against the model
+ */
+eth_spi_custom_driver_config_t enc28j60_model_spi_driver(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,337 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_eth_driver.h"
+#include "esp_eth_enc28j60.h"
+#include "enc28j60.h"
+#include "enc28j60_model.h"
+#include "eth_spi_model.h"
+#include "unity.h"
+
+#define TEST_INT_GPIO   (4)
+#define TEST_RX_FRAMES  (4)
+#define TEST_FILL_LEN   (1000)
+#define TEST_TX_FRAMES  (3)
+#define TEST_TX_LEN     (200)
+
+static const uint16_t s_shadowed_regs[] = {
+    ENC28J60_EIE, ENC28J60_ERXFCON, ENC28J60_MACON3,
+    ENC28J60_EHT0, ENC28J60_EHT1, ENC28J60_EHT2, ENC28J60_EHT3,
+    ENC28J60_EHT4, ENC28J60_EHT5, ENC28J60_EHT6, ENC28J60_EHT7,
+};
+
+/**
+ * @brief Create and init the MAC with its SPI transactions going to the model, count those of the test task
+ */
+static esp_eth_mac_t *test_mac_new(void)
+{
+    eth_spi_model_reset();
+    enc28j60_model_reset();
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    eth_mac_config_t mac_config = ETH_MAC_DEFAULT_CONFIG();
+    eth_enc28j60_config_t enc28j60_config = ETH_ENC28J60_DEFAULT_CONFIG(SPI2_HOST, NULL);
+    enc28j60_config.int_gpio_num = TEST_INT_GPIO;
+    enc28j60_config.custom_spi_driver = enc28j60_model_spi_driver();
+    esp_eth_mac_t *mac = esp_eth_mac_new_enc28j60(&enc28j60_config, &mac_config);
+    TEST_ASSERT_NOT_NULL(mac);
+    TEST_ESP_OK(mac->set_mediator(mac, eth_spi_model_mediator()));
+    TEST_ESP_OK(mac->init(mac));
+    eth_spi_model_int_attach(TEST_INT_GPIO);
+    eth_spi_model_count_task(xTaskGetCurrentTaskHandle());
+    return mac;
+}
+
+static void test_mac_del(esp_eth_mac_t *mac)
+{
+    eth_spi_model_count_task(NULL);
+    TEST_ESP_OK(mac->deinit(mac));
+    TEST_ESP_OK(mac->del(mac));
+    gpio_uninstall_isr_service();
+}
+
+static uint16_t test_reg16_get(uint16_t reg_low)
+{
+    return enc28j60_model_reg_get(reg_low) | (enc28j60_model_reg_get(reg_low + 1) << 8);
+}
+
+static void test_fill_frame(uint8_t *frame, uint16_t len, uint8_t seed)
+{
+    for (int i = 0; i < len; i++) {
+        frame[i] = seed * 37 + i;
+    }
+}
+
+/**
+ * @brief Wait for the driver task to start the given number of transmissions in total
+ */
+static void test_wait_tx_starts(uint32_t count)
+{
+    for (int i = 0; i < 100 && enc28j60_model_stats()->tx_starts < count; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL_UINT32(count, enc28j60_model_stats()->tx_starts);
+}
+
+/**
+ * @brief Wait for the driver task to retire the last frame, it disables TXIE once no frame is queued
+ */
+static void test_wait_tx_idle(void)
+{
+    for (int i = 0; i < 100 && (enc28j60_model_reg_get(ENC28J60_EIE) & EIE_TXIE); i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    TEST_ASSERT_EQUAL_HEX8(0, enc28j60_model_reg_get(ENC28J60_EIE) & EIE_TXIE);
+}
+
+static void test_check_tx(uint32_t index, const uint8_t *frame)
+{
+    const enc28j60_model_tx_t *tx = &enc28j60_model_stats()->txs[index];
+    TEST_ASSERT_EQUAL_UINT16(TEST_TX_LEN, tx->len);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, tx->head, sizeof(tx->head));
+}
+
+TEST_CASE("shadowed registers are never read from the chip", "[enc28j60_model]")
+{
+    esp_eth_mac_t *mac = test_mac_new();
+    const uint8_t macon3 = MACON3_PADCFG0 | MACON3_TXCRCEN | MACON3_FRMLNEN;
+
+    // read-modify-write of the shadows leaves the chip registers as a read-modify-write of the chip would
+    TEST_ESP_OK(mac->set_duplex(mac, ETH_DUPLEX_FULL));
+    TEST_ASSERT_EQUAL_HEX8(macon3 | MACON3_FULDPX, enc28j60_model_reg_get(ENC28J60_MACON3));
+    TEST_ESP_OK(mac->set_duplex(mac, ETH_DUPLEX_HALF));
+    TEST_ASSERT_EQUAL_HEX8(macon3, enc28j60_model_reg_get(ENC28J60_MACON3));
+
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 5, 0)
+    const uint8_t erxfcon = ERXFCON_UCEN | ERXFCON_CRCEN | ERXFCON_BCEN | ERXFCON_HTEN;
+    TEST_ESP_OK(mac->set_all_multicast(mac, true));
+    TEST_ASSERT_EQUAL_HEX8(erxfcon | ERXFCON_MCEN, enc28j60_model_reg_get(ENC28J60_ERXFCON));
+    TEST_ESP_OK(mac->set_all_multicast(mac, false));
+    TEST_ASSERT_EQUAL_HEX8(erxfcon, enc28j60_model_reg_get(ENC28J60_ERXFCON));
+
+    // a hash table bit stays set until every address mapped to it is removed
+    uint8_t mdns_addr[ETH_ADDR_LEN] = { 0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb };
+    uint32_t bits_set = 0;
+    TEST_ESP_OK(mac->add_mac_filter(mac, mdns_addr));
+    TEST_ESP_OK(mac->add_mac_filter(mac, mdns_addr));
+    TEST_ESP_OK(mac->rm_mac_filter(mac, mdns_addr));
+    for (int i = 0; i < 8; i++) {
+        bits_set += __builtin_popcount(enc28j60_model_reg_get(ENC28J60_EHT0 + i));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, bits_set);
+    TEST_ESP_OK(mac->rm_mac_filter(mac, mdns_addr));
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_HEX8(0, enc28j60_model_reg_get(ENC28J60_EHT0 + i));
+    }
+#endif // ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 5, 0)
+
+    TEST_ESP_OK(mac->start(mac));
+    TEST_ASSERT_EQUAL_HEX8(EIE_PKTIE | EIE_INTIE | EIE_TXERIE, enc28j60_model_reg_get(ENC28J60_EIE));
+    TEST_ESP_OK(mac->stop(mac));
+    TEST_ASSERT_EQUAL_HEX8(0, enc28j60_model_reg_get(ENC28J60_EIE));
+    TEST_ESP_OK(mac->set_promiscuous(mac, true));
+    TEST_ASSERT_EQUAL_HEX8(0, enc28j60_model_reg_get(ENC28J60_ERXFCON));
+
+    for (size_t i = 0; i < sizeof(s_shadowed_regs) / sizeof(s_shadowed_regs[0]); i++) {
+        TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, enc28j60_model_reg_reads(s_shadowed_regs[i]), "shadowed register read by RCR");
+    }
+    // the revision is not shadowed, it is read exactly once
+    TEST_ASSERT_EQUAL_UINT32(1, enc28j60_model_reg_reads(ENC28J60_EREVID));
+    test_mac_del(mac);
+}
+
+TEST_CASE("bank switch touches only the differing select bits", "[enc28j60_model]")
+{
+    // init already switched through all the banks
+    esp_eth_mac_t *mac = test_mac_new();
+    uint32_t phy_reg = 0;
+
+    // registers of every bank: MAC (2), MII (2 and 3), receive filter (1) and the RX pointers (0)
+    TEST_ESP_OK(mac->set_duplex(mac, ETH_DUPLEX_FULL));
+    TEST_ESP_OK(mac->read_phy_reg(mac, 0, 0x00, &phy_reg));
+    TEST_ESP_OK(mac->set_promiscuous(mac, true));
+    TEST_ESP_OK(mac->set_promiscuous(mac, false));
+    TEST_ESP_OK(mac->start(mac));
+    TEST_ESP_OK(mac->stop(mac));
+    uint32_t length = ETH_MAX_PACKET_SIZE;
+    uint8_t buf[ETH_MAX_PACKET_SIZE];
+    TEST_ESP_OK(mac->receive(mac, buf, &length));
+    TEST_ASSERT_EQUAL_UINT32(0, length);
+
+    const enc28j60_model_stats_t *stats = enc28j60_model_stats();
+    TEST_ASSERT_GREATER_THAN_UINT32(0, stats->bank_selects);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->redundant_selects);
+    test_mac_del(mac);
+}
+
+TEST_CASE("frames in a batch take seven SPI transactions each", "[enc28j60_model]")
+{
+    static uint8_t s_frames[TEST_RX_FRAMES][ETH_MAX_PACKET_SIZE];
+    static uint8_t s_buf[ETH_MAX_PACKET_SIZE];
+    const uint16_t frame_len[TEST_RX_FRAMES] = { 60, 300, 1514, 100 };
+    esp_eth_mac_t *mac = test_mac_new();
+    const uint16_t rx_start = test_reg16_get(ENC28J60_ERXSTL);
+    const uint16_t rx_end = test_reg16_get(ENC28J60_ERXNDL);
+    uint32_t length;
+
+    // frames received and freed beforehand move the next packet pointer close to the end of the receive buffer
+    const uint16_t fill_end = rx_end + 1 - 512;
+    uint16_t addr = rx_start;
+    test_fill_frame(s_frames[0], TEST_FILL_LEN, 0xFF);
+    while (addr < fill_end) {
+        uint16_t fill_len = fill_end - addr - 6 < TEST_FILL_LEN ? fill_end - addr - 6 : TEST_FILL_LEN;
+        addr = enc28j60_model_rx_frame_put(addr, s_frames[0], fill_len);
+        enc28j60_model_reg_set(ENC28J60_EPKTCNT, 1);
+        length = sizeof(s_buf);
+        TEST_ESP_OK(mac->receive(mac, s_buf, &length));
+        TEST_ASSERT_EQUAL_UINT32(fill_len - 4, length);
+    }
+
+    // a frame in the middle of the batch wraps from ERXND to ERXST
+    uint16_t next[TEST_RX_FRAMES];
+    bool wrapped = false;
+    for (int i = 0; i < TEST_RX_FRAMES; i++) {
+        test_fill_frame(s_frames[i], frame_len[i] + 4, i);
+        next[i] = enc28j60_model_rx_frame_put(addr, s_frames[i], frame_len[i] + 4);
+        wrapped |= i > 0 && i < TEST_RX_FRAMES - 1 && next[i] < addr;
+        addr = next[i];
+    }
+    TEST_ASSERT_TRUE(wrapped);
+    enc28j60_model_reg_set(ENC28J60_EPKTCNT, TEST_RX_FRAMES);
+
+    uint32_t trans[TEST_RX_FRAMES];
+    enc28j60_model_stats_clear();
+    for (int i = 0; i < TEST_RX_FRAMES; i++) {
+        length = sizeof(s_buf);
+        eth_spi_model_count_task(xTaskGetCurrentTaskHandle());
+        TEST_ESP_OK(mac->receive(mac, s_buf, &length));
+        trans[i] = eth_spi_model_trans();
+        TEST_ASSERT_EQUAL_UINT32(frame_len[i], length);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(s_frames[i], s_buf, length);
+        // the space of the frame is freed, ERXRDPT stays odd
+        uint16_t erxrdpt = next[i] == rx_start ? rx_end : next[i] - 1;
+        TEST_ASSERT_EQUAL_UINT32(erxrdpt, test_reg16_get(ENC28J60_ERXRDPTL));
+        TEST_ASSERT_EQUAL_UINT8(TEST_RX_FRAMES - 1 - i, enc28j60_model_reg_get(ENC28J60_EPKTCNT));
+    }
+
+    // ERDPT (2), header, frame, ERXRDPT (2) and PKTDEC, all in bank 0 except ECON2 which is in every bank
+    for (int i = 1; i < TEST_RX_FRAMES - 1; i++) {
+        TEST_ASSERT_EQUAL_UINT32(7, trans[i]);
+    }
+    // EPKTCNT is read once at the start of the batch and once after its last frame, each read costs a bank switch
+    // to bank 1 and back at most
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(7 + 3, trans[0]);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(7 + 3, trans[TEST_RX_FRAMES - 1]);
+    TEST_ASSERT_EQUAL_UINT32(2, enc28j60_model_reg_reads(ENC28J60_EPKTCNT));
+
+    // an empty batch is found with a single read
+    length = sizeof(s_buf);
+    eth_spi_model_count_task(xTaskGetCurrentTaskHandle());
+    TEST_ESP_OK(mac->receive(mac, s_buf, &length));
+    TEST_ASSERT_EQUAL_UINT32(0, length);
+    TEST_ASSERT_EQUAL_UINT32(1, eth_spi_model_trans());
+    test_mac_del(mac);
+}
+
+TEST_CASE("queued frame starts only once the active one is done", "[enc28j60_model]")
+{
+    static uint8_t s_frames[TEST_TX_FRAMES][TEST_TX_LEN];
+    esp_eth_mac_t *mac = test_mac_new();
+    const enc28j60_model_stats_t *stats = enc28j60_model_stats();
+    TEST_ESP_OK(mac->start(mac));
+    for (int i = 0; i < TEST_TX_FRAMES; i++) {
+        test_fill_frame(s_frames[i], TEST_TX_LEN, i);
+    }
+
+    // the first frame goes out right away, the second one waits in the other slot
+    TEST_ESP_OK(mac->transmit(mac, s_frames[0], TEST_TX_LEN));
+    TEST_ESP_OK(mac->transmit(mac, s_frames[1], TEST_TX_LEN));
+    TEST_ASSERT_EQUAL_UINT32(1, stats->tx_starts);
+    test_check_tx(0, s_frames[0]);
+
+    // TXIF of the first frame starts the second one, the freed slot takes the third one
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_starts(2);
+    test_check_tx(1, s_frames[1]);
+    TEST_ASSERT_NOT_EQUAL(stats->txs[0].start, stats->txs[1].start);
+    TEST_ESP_OK(mac->transmit(mac, s_frames[2], TEST_TX_LEN));
+    TEST_ASSERT_EQUAL_UINT32(2, stats->tx_starts);
+
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_starts(3);
+    test_check_tx(2, s_frames[2]);
+    TEST_ASSERT_EQUAL_UINT16(stats->txs[0].start, stats->txs[2].start);
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_idle();
+    TEST_ASSERT_EQUAL_UINT32(3, stats->tx_starts);
+    test_mac_del(mac);
+}
+
+TEST_CASE("transmit retires a frame whose TXIF was lost only once it is sent", "[enc28j60_model]")
+{
+    static uint8_t s_frames[TEST_TX_FRAMES][TEST_TX_LEN];
+    esp_eth_mac_t *mac = test_mac_new();
+    const enc28j60_model_stats_t *stats = enc28j60_model_stats();
+    TEST_ESP_OK(mac->start(mac));
+    for (int i = 0; i < TEST_TX_FRAMES; i++) {
+        test_fill_frame(s_frames[i], TEST_TX_LEN, i);
+    }
+    TEST_ESP_OK(mac->transmit(mac, s_frames[0], TEST_TX_LEN));
+    TEST_ESP_OK(mac->transmit(mac, s_frames[1], TEST_TX_LEN));
+
+    // both slots are taken while the first frame is still being sent, nothing is retired on the timeout
+    TEST_ASSERT_EQUAL(ESP_ERR_TIMEOUT, mac->transmit(mac, s_frames[2], TEST_TX_LEN));
+    TEST_ASSERT_EQUAL_UINT32(1, stats->tx_starts);
+    TEST_ASSERT_EQUAL_HEX8(ECON1_TXRTS, enc28j60_model_reg_get(ENC28J60_ECON1) & ECON1_TXRTS);
+
+    // the first frame is sent but its TXIF is lost: the timeout retires it and starts the queued frame
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_LOST_IRQ));
+    TEST_ESP_OK(mac->transmit(mac, s_frames[2], TEST_TX_LEN));
+    TEST_ASSERT_EQUAL_UINT32(2, stats->tx_starts);
+    test_check_tx(1, s_frames[1]);
+
+    // the task then goes on with TXIF as usual
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_starts(3);
+    test_check_tx(2, s_frames[2]);
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_idle();
+    TEST_ASSERT_EQUAL_UINT32(3, stats->tx_starts);
+    test_mac_del(mac);
+}
+
+TEST_CASE("late collision retries the active frame, not the queued one", "[enc28j60_model]")
+{
+    static uint8_t s_frames[2][TEST_TX_LEN];
+    esp_eth_mac_t *mac = test_mac_new();
+    const enc28j60_model_stats_t *stats = enc28j60_model_stats();
+    TEST_ESP_OK(mac->start(mac));
+    for (int i = 0; i < 2; i++) {
+        test_fill_frame(s_frames[i], TEST_TX_LEN, i);
+    }
+    TEST_ESP_OK(mac->transmit(mac, s_frames[0], TEST_TX_LEN));
+    TEST_ESP_OK(mac->transmit(mac, s_frames[1], TEST_TX_LEN));
+
+    // errata #12/#13: the transmit logic is reset and the same slot is sent again, TXIF of the failure is dropped
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_LATE_COLLISION));
+    test_wait_tx_starts(2);
+    test_check_tx(1, s_frames[0]);
+    TEST_ASSERT_EQUAL_UINT16(stats->txs[0].start, stats->txs[1].start);
+    TEST_ASSERT_EQUAL_HEX8(0, enc28j60_model_reg_get(ENC28J60_EIR) & (EIR_TXERIF | EIR_TXIF));
+
+    // the queued frame follows the successful retry
+    vTaskDelay(pdMS_TO_TICKS(50));
+    TEST_ASSERT_EQUAL_UINT32(2, stats->tx_starts);
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_starts(3);
+    test_check_tx(2, s_frames[1]);
+    TEST_ASSERT_TRUE(enc28j60_model_tx_done(ENC28J60_MODEL_TX_OK));
+    test_wait_tx_idle();
+    test_mac_del(mac);
+}
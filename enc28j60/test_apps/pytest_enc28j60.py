@@ -0,0 +1,20 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""
+ENC28J60 driver tests against a register model, no Ethernet hardware is needed.
+"""
+
+import pytest
+
+from pytest_embedded import Dut
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default', 'esp32', marks=[pytest.mark.generic]),
+    ],
+    indirect=['target'],
+)
+def test_enc28j60_model(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='enc28j60_model')
@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_bit_defs.h"
+#include "esp_eth_com.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Checksums computed or verified by the MAC
+ *
+ * Checksums of frames which carry a fragment of an IP datagram are not covered, except the IP header checksum.
+ */
+typedef enum {
+    ETH_CHECKSUM_OFFLOAD_TX_IP   = BIT(0),  /*!< IPv4 header checksum of transmitted frames is generated */
+    ETH_CHECKSUM_OFFLOAD_TX_TCP  = BIT(1),  /*!< TCP checksum of transmitted frames is generated */
+    ETH_CHECKSUM_OFFLOAD_TX_UDP  = BIT(2),  /*!< UDP checksum of transmitted frames is generated */
+    ETH_CHECKSUM_OFFLOAD_TX_ICMP = BIT(3),  /*!< ICMP checksum of transmitted frames is generated */
+    ETH_CHECKSUM_OFFLOAD_RX_IP   = BIT(8),  /*!< Received frames with bad IPv4 header checksum are dropped */
+    ETH_CHECKSUM_OFFLOAD_RX_TCP  = BIT(9),  /*!< Received frames with bad TCP checksum are dropped */
+    ETH_CHECKSUM_OFFLOAD_RX_UDP  = BIT(10), /*!< Received frames with bad UDP checksum are dropped */
+    ETH_CHECKSUM_OFFLOAD_RX_ICMP = BIT(11), /*!< Received frames with bad ICMP checksum are dropped */
+} eth_checksum_offload_t;
+
+/**
+ * @brief Offset of the offload commands, they follow the frame timestamping commands
+ */
+#define ETH_OFFLOAD_CMDS_OFFSET (ETH_CMD_CUSTOM_MAC_CMDS_OFFSET + 0x900)
+
+/**
+ * @brief Offload commands, issued by esp_eth_ioctl() to MACs with offload support
+ *
+ * MACs without the support return ESP_ERR_INVALID_ARG, i.e. nothing is offloaded.
+ */
+typedef enum {
+    ETH_OFFLOAD_CMD_G_CHECKSUM = ETH_OFFLOAD_CMDS_OFFSET,   /*!< Get checksums offloaded to the MAC (uint32_t, eth_checksum_offload_t flags) */
+} eth_offload_io_cmd_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,40 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "driver/spi_master.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Run an SPI transaction, queued when it is long enough, polled otherwise
+ *
+ * Queued transactions (frame sized FIFO or buffer memory transfers) let the calling task sleep while DMA runs.
+ * Short ones (register accesses) are polled, since the interrupt round trip would outweigh their duration.
+ *
+ * @param hdl SPI device handle
+ * @param trans transaction to run
+ * @param len transaction length in bytes
+ * @param queued_min_len transactions of at least this many bytes are queued, 0 to poll all transactions
+ *
+ * @return result of spi_device_transmit() or spi_device_polling_transmit()
+ */
+static inline esp_err_t eth_spi_transmit(spi_device_handle_t hdl, spi_transaction_t *trans, uint32_t len, uint32_t queued_min_len)
+{
+    if (queued_min_len > 0 && len >= queued_min_len) {
+        return spi_device_transmit(hdl, trans);
+    }
+    return spi_device_polling_transmit(hdl, trans);
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_eth_com.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Time of the MAC clock
+ */
+typedef struct {
+    uint64_t seconds;       /*!< Seconds */
+    uint32_t nanoseconds;   /*!< Nanoseconds, less than one second */
+} eth_timestamp_t;
+
+/**
+ * @brief Receive timestamp callback
+ *
+ * Called from the driver task for every frame timestamped by the MAC, before the frame is passed to the stack.
+ *
+ * @param frame received frame
+ * @param length frame length
+ * @param ts time the frame was received at
+ * @param user_ctx user context from the configuration
+ */
+typedef void (*eth_timestamp_rx_cb_t)(const uint8_t *frame, uint32_t length, const eth_timestamp_t *ts, void *user_ctx);
+
+/**
+ * @brief Transmit frame selection callback
+ *
+ * Called for every frame being transmitted, from the context calling the transmit function. It must be short,
+ * e.g. match EtherType and PTP message type, and must not call the Ethernet driver.
+ *
+ * @param frame frame to transmit
+ * @param length frame length
+ * @param[out] tx_id identifier of the frame which is passed to the transmit timestamp callback
+ * @param user_ctx user context from the configuration
+ * @return true to timestamp the frame
+ */
+typedef bool (*eth_timestamp_tx_match_cb_t)(const uint8_t *frame, uint32_t length, uint32_t *tx_id, void *user_ctx);
+
+/**
+ * @brief Transmit timestamp callback
+ *
+ * Called from the driver task when the timestamp of a frame selected by the match callback is captured.
+ *
+ * @param tx_id frame identifier set by the match callback
+ * @param ts time the frame was transmitted at
+ * @param user_ctx user context from the configuration
+ */
+typedef void (*eth_timestamp_tx_cb_t)(uint32_t tx_id, const eth_timestamp_t *ts, void *user_ctx);
+
+/**
+ * @brief Frame timestamping configuration
+ */
+typedef struct {
+    eth_timestamp_rx_cb_t rx_cb;                /*!< Receive timestamp callback, NULL if not used */
+    eth_timestamp_tx_match_cb_t tx_match_cb;    /*!< Selects transmitted frames to timestamp, NULL to timestamp none */
+    eth_timestamp_tx_cb_t tx_cb;                /*!< Transmit timestamp callback, required with tx_match_cb */
+    void *user_ctx;                             /*!< User context passed to the callbacks */
+} eth_timestamp_config_t;
+
+/**
+ * @brief Offset of the frame timestamping commands
+ *
+ * Drivers number their own commands from ETH_CMD_CUSTOM_MAC_CMDS_OFFSET, commands shared by drivers use the upper half of the range.
+ */
+#define ETH_TIMESTAMP_CMDS_OFFSET (ETH_CMD_CUSTOM_MAC_CMDS_OFFSET + 0x800)
+
+/**
+ * @brief Frame timestamping commands, issued by esp_eth_ioctl() to MACs with timestamping support
+ *
+ * MACs without the support return ESP_ERR_INVALID_ARG.
+ */
+typedef enum {
+    ETH_TIMESTAMP_CMD_ENABLE = ETH_TIMESTAMP_CMDS_OFFSET,   /*!< Enable frame timestamping (eth_timestamp_config_t) */
+    ETH_TIMESTAMP_CMD_DISABLE,                              /*!< Disable frame timestamping */
+    ETH_TIMESTAMP_CMD_G_TIME,                               /*!< Get time of the MAC clock (eth_timestamp_t) */
+    ETH_TIMESTAMP_CMD_S_TIME,                               /*!< Set time of the MAC clock (eth_timestamp_t) */
+    ETH_TIMESTAMP_CMD_ADJ_TIME,                             /*!< Shift the MAC clock by signed nanoseconds (int64_t) */
+    ETH_TIMESTAMP_CMD_ADJ_FREQ,                             /*!< Tune the MAC clock rate by signed parts per billion (int32_t) */
+} eth_timestamp_io_cmd_t;
+
+#ifdef __cplusplus
+}
+#endif
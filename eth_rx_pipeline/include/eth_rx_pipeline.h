@@ -0,0 +1,126 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "esp_eth_com.h"
+#include "freertos/FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Handle of a receive pipeline
+ */
+typedef struct eth_rx_pipeline_s *eth_rx_pipeline_handle_t;
+
+/**
+ * @brief Receive pipeline configuration
+ */
+typedef struct {
+    uint32_t depth;             /*!< Frames which can wait for delivery while the driver reads the next ones,
+                                     0 to deliver frames from the driver task (statistics are still collected) */
+    uint32_t task_stack_size;   /*!< Stack size of the delivery task */
+    uint32_t task_prio;         /*!< Priority of the delivery task */
+    BaseType_t task_core;       /*!< Core the delivery task is pinned to, tskNO_AFFINITY to not pin it */
+} eth_rx_pipeline_config_t;
+
+/**
+ * @brief Default receive pipeline configuration
+ */
+#define ETH_RX_PIPELINE_DEFAULT_CONFIG()    \
+    {                                       \
+        .depth = 2,                         \
+        .task_stack_size = 4096,            \
+        .task_prio = 15,                    \
+        .task_core = tskNO_AFFINITY,        \
+    }
+
+/**
+ * @brief Receive pipeline statistics
+ */
+typedef struct {
+    uint32_t frames;            /*!< Frames delivered to the stack */
+    uint64_t bytes;             /*!< Bytes delivered to the stack */
+    uint32_t latency_avg_us;    /*!< Average time a frame waited in the pipeline, from being pushed to its delivery to the
+                                     stack starting, 0 with CONFIG_ETH_RX_PIPELINE_LATENCY_STATS disabled */
+    uint32_t latency_max_us;    /*!< Longest time a frame waited in the pipeline, see latency_avg_us */
+    uint32_t frames_per_sec;    /*!< Delivered frames per second since the statistics were reset */
+    uint32_t stall_cnt;         /*!< Frames the driver had to wait with because the pipeline was full */
+} eth_rx_pipeline_stats_t;
+
+/**
+ * @brief Create a receive pipeline
+ *
+ * The driver task reads frames from the device and pushes them to the pipeline, a separate task delivers them
+ * to the stack. Hence the device is read out over SPI while the previous frame is being processed by the stack.
+ *
+ * @param config pipeline configuration
+ * @param eth mediator the frames are delivered to
+ * @param[out] ret_pipeline created pipeline
+ * @return
+ *      - ESP_OK: pipeline created
+ *      - ESP_ERR_INVALID_ARG: invalid argument
+ *      - ESP_ERR_NO_MEM: not enough memory
+ */
+esp_err_t eth_rx_pipeline_new(const eth_rx_pipeline_config_t *config, esp_eth_mediator_t *eth, eth_rx_pipeline_handle_t *ret_pipeline);
+
+/**
+ * @brief Delete a receive pipeline
+ *
+ * Frames already pushed are delivered before the delivery task exits.
+ *
+ * @note The driver must not push frames anymore.
+ *
+ * @param pipeline pipeline to delete
+ * @return
+ *      - ESP_OK: pipeline deleted
+ *      - ESP_ERR_INVALID_ARG: pipeline is NULL
+ */
+esp_err_t eth_rx_pipeline_del(eth_rx_pipeline_handle_t pipeline);
+
+/**
+ * @brief Push a received frame for delivery to the stack
+ *
+ * Blocks while the pipeline is full, so a stack slower than the device throttles reading as without the pipeline.
+ * The pipeline takes ownership of the buffer.
+ *
+ * @param pipeline pipeline
+ * @param buffer received frame
+ * @param length frame length
+ * @return
+ *      - ESP_OK: frame queued for delivery
+ *      - ESP_ERR_INVALID_ARG: invalid argument
+ */
+esp_err_t eth_rx_pipeline_push(eth_rx_pipeline_handle_t pipeline, uint8_t *buffer, uint32_t length);
+
+/**
+ * @brief Get pipeline statistics
+ *
+ * @param pipeline pipeline
+ * @param[out] stats statistics
+ * @return
+ *      - ESP_OK: statistics read
+ *      - ESP_ERR_INVALID_ARG: invalid argument
+ */
+esp_err_t eth_rx_pipeline_get_stats(eth_rx_pipeline_handle_t pipeline, eth_rx_pipeline_stats_t *stats);
+
+/**
+ * @brief Reset pipeline statistics
+ *
+ * @param pipeline pipeline
+ * @return
+ *      - ESP_OK: statistics reset
+ *      - ESP_ERR_INVALID_ARG: invalid argument
+ */
+esp_err_t eth_rx_pipeline_clear_stats(eth_rx_pipeline_handle_t pipeline);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,184 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "sdkconfig.h"
+#include "eth_rx_pipeline.h"
+
+static const char *TAG = "eth_rx_pipeline";
+
+typedef struct {
+    uint8_t *buffer;        /*!< Received frame, NULL requests the delivery task to exit */
+    uint32_t length;        /*!< Frame length */
+#if CONFIG_ETH_RX_PIPELINE_LATENCY_STATS
+    int64_t push_time;      /*!< Time the frame was pushed, i.e. read from the device */
+#endif
+} eth_rx_pipeline_item_t;
+
+struct eth_rx_pipeline_s {
+    esp_eth_mediator_t *eth;
+    QueueHandle_t queue;
+    TaskHandle_t task_hdl;
+    SemaphoreHandle_t exit_sem;
+    portMUX_TYPE stats_lock;
+    int64_t stats_start;    /*!< Time the statistics were reset */
+    uint32_t frames;
+    uint64_t bytes;
+    uint64_t latency_sum_us;
+    uint32_t latency_max_us;
+    uint32_t stall_cnt;
+};
+
+static void eth_rx_pipeline_deliver(eth_rx_pipeline_handle_t pipeline, const eth_rx_pipeline_item_t *item)
+{
+    // only the time spent in the pipeline is measured, the stack may take the frame over and process it much later
+#if CONFIG_ETH_RX_PIPELINE_LATENCY_STATS
+    uint32_t latency_us = (uint32_t)(esp_timer_get_time() - item->push_time);
+#else
+    uint32_t latency_us = 0;
+#endif
+    portENTER_CRITICAL(&pipeline->stats_lock);
+    pipeline->frames++;
+    pipeline->bytes += item->length;
+    pipeline->latency_sum_us += latency_us;
+    if (latency_us > pipeline->latency_max_us) {
+        pipeline->latency_max_us = latency_us;
+    }
+    portEXIT_CRITICAL(&pipeline->stats_lock);
+
+    pipeline->eth->stack_input(pipeline->eth, item->buffer, item->length);
+}
+
+static void eth_rx_pipeline_task(void *arg)
+{
+    eth_rx_pipeline_handle_t pipeline = (eth_rx_pipeline_handle_t)arg;
+    eth_rx_pipeline_item_t item;
+    while (1) {
+        xQueueReceive(pipeline->queue, &item, portMAX_DELAY);
+        if (item.buffer == NULL) {
+            break;
+        }
+        eth_rx_pipeline_deliver(pipeline, &item);
+    }
+    xSemaphoreGive(pipeline->exit_sem);
+    vTaskDelete(NULL);
+}
+
+esp_err_t eth_rx_pipeline_new(const eth_rx_pipeline_config_t *config, esp_eth_mediator_t *eth, eth_rx_pipeline_handle_t *ret_pipeline)
+{
+    esp_err_t ret = ESP_OK;
+    struct eth_rx_pipeline_s *pipeline = NULL;
+    ESP_GOTO_ON_FALSE(config && eth && ret_pipeline, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+
+    pipeline = calloc(1, sizeof(struct eth_rx_pipeline_s));
+    ESP_GOTO_ON_FALSE(pipeline, ESP_ERR_NO_MEM, err, TAG, "no mem for pipeline");
+    pipeline->eth = eth;
+    portMUX_INITIALIZE(&pipeline->stats_lock);
+    pipeline->stats_start = esp_timer_get_time();
+    // frames are delivered right away by the driver task
+    if (config->depth == 0) {
+        *ret_pipeline = pipeline;
+        return ESP_OK;
+    }
+    pipeline->queue = xQueueCreate(config->depth, sizeof(eth_rx_pipeline_item_t));
+    ESP_GOTO_ON_FALSE(pipeline->queue, ESP_ERR_NO_MEM, err, TAG, "create queue failed");
+    pipeline->exit_sem = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(pipeline->exit_sem, ESP_ERR_NO_MEM, err, TAG, "create semaphore failed");
+    BaseType_t xReturned = xTaskCreatePinnedToCore(eth_rx_pipeline_task, "eth_rx_pipe", config->task_stack_size, pipeline,
+                                                   config->task_prio, &pipeline->task_hdl, config->task_core);
+    ESP_GOTO_ON_FALSE(xReturned == pdPASS, ESP_ERR_NO_MEM, err, TAG, "create delivery task failed");
+
+    *ret_pipeline = pipeline;
+    return ESP_OK;
+err:
+    if (pipeline) {
+        if (pipeline->exit_sem) {
+            vSemaphoreDelete(pipeline->exit_sem);
+        }
+        if (pipeline->queue) {
+            vQueueDelete(pipeline->queue);
+        }
+        free(pipeline);
+    }
+    return ret;
+}
+
+esp_err_t eth_rx_pipeline_del(eth_rx_pipeline_handle_t pipeline)
+{
+    ESP_RETURN_ON_FALSE(pipeline, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    if (pipeline->queue) {
+        // the exit request is queued behind pending frames, so they are still delivered
+        eth_rx_pipeline_item_t item = {
+            .buffer = NULL,
+        };
+        xQueueSend(pipeline->queue, &item, portMAX_DELAY);
+        xSemaphoreTake(pipeline->exit_sem, portMAX_DELAY);
+
+        vSemaphoreDelete(pipeline->exit_sem);
+        vQueueDelete(pipeline->queue);
+    }
+    free(pipeline);
+    return ESP_OK;
+}
+
+esp_err_t eth_rx_pipeline_push(eth_rx_pipeline_handle_t pipeline, uint8_t *buffer, uint32_t length)
+{
+    ESP_RETURN_ON_FALSE(pipeline && buffer, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    eth_rx_pipeline_item_t item = {
+        .buffer = buffer,
+        .length = length,
+#if CONFIG_ETH_RX_PIPELINE_LATENCY_STATS
+        .push_time = esp_timer_get_time(),
+#endif
+    };
+    if (pipeline->queue == NULL) {
+        eth_rx_pipeline_deliver(pipeline, &item);
+    } else if (xQueueSend(pipeline->queue, &item, 0) != pdTRUE) {
+        portENTER_CRITICAL(&pipeline->stats_lock);
+        pipeline->stall_cnt++;
+        portEXIT_CRITICAL(&pipeline->stats_lock);
+        xQueueSend(pipeline->queue, &item, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
+
+esp_err_t eth_rx_pipeline_get_stats(eth_rx_pipeline_handle_t pipeline, eth_rx_pipeline_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(pipeline && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&pipeline->stats_lock);
+    int64_t elapsed_us = now - pipeline->stats_start;
+    stats->frames = pipeline->frames;
+    stats->bytes = pipeline->bytes;
+    stats->latency_avg_us = pipeline->frames ? (uint32_t)(pipeline->latency_sum_us / pipeline->frames) : 0;
+    stats->latency_max_us = pipeline->latency_max_us;
+    stats->stall_cnt = pipeline->stall_cnt;
+    portEXIT_CRITICAL(&pipeline->stats_lock);
+    stats->frames_per_sec = elapsed_us > 0 ? (uint32_t)((uint64_t)stats->frames * 1000000 / elapsed_us) : 0;
+    return ESP_OK;
+}
+
+esp_err_t eth_rx_pipeline_clear_stats(eth_rx_pipeline_handle_t pipeline)
+{
+    ESP_RETURN_ON_FALSE(pipeline, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    int64_t now = esp_timer_get_time();
+    portENTER_CRITICAL(&pipeline->stats_lock);
+    pipeline->stats_start = now;
+    pipeline->frames = 0;
+    pipeline->bytes = 0;
+    pipeline->latency_sum_us = 0;
+    pipeline->latency_max_us = 0;
+    pipeline->stall_cnt = 0;
+    portEXIT_CRITICAL(&pipeline->stats_lock);
+    return ESP_OK;
+}
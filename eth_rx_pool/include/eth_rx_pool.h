@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+#include "esp_heap_caps.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Handle of a receive buffer pool
+ */
+typedef struct eth_rx_pool_s *eth_rx_pool_handle_t;
+
+/**
+ * @brief Receive buffer pool configuration
+ */
+typedef struct {
+    uint32_t block_size;        /*!< Size of one block, the largest frame the pool can hold */
+    uint32_t block_count;       /*!< Number of blocks, i.e. frames which can be in flight at the same time */
+    uint32_t caps;              /*!< Heap capabilities of the pool memory (MALLOC_CAP_*) */
+} eth_rx_pool_config_t;
+
+/**
+ * @brief Default receive buffer pool configuration
+ */
+#define ETH_RX_POOL_DEFAULT_CONFIG()        \
+    {                                       \
+        .block_size = 1536,                 \
+        .block_count = 16,                  \
+        .caps = MALLOC_CAP_DMA,             \
+    }
+
+/**
+ * @brief Receive buffer pool statistics
+ */
+typedef struct {
+    uint32_t block_size;        /*!< Usable size of one block */
+    uint32_t block_count;       /*!< Number of blocks in the pool */
+    uint32_t in_use;            /*!< Blocks currently allocated */
+    uint32_t peak_in_use;       /*!< Most blocks allocated at the same time */
+    uint32_t alloc_cnt;         /*!< Successful allocations */
+    uint32_t alloc_fail_cnt;    /*!< Allocations failed because the pool was empty or the frame did not fit */
+} eth_rx_pool_stats_t;
+
+/**
+ * @brief Create a receive buffer pool
+ *
+ * All blocks are allocated at once, so receiving frames does not touch the heap afterwards.
+ *
+ * @note At most CONFIG_ETH_RX_POOL_MAX_POOLS pools can exist at the same time.
+ *
+ * @param config pool configuration
+ * @param[out] ret_pool created pool
+ * @return
+ *      - ESP_OK: pool created
+ *      - ESP_ERR_INVALID_ARG: invalid configuration
+ *      - ESP_ERR_NO_MEM: not enough memory, or CONFIG_ETH_RX_POOL_MAX_POOLS pools already exist
+ */
+esp_err_t eth_rx_pool_new(const eth_rx_pool_config_t *config, eth_rx_pool_handle_t *ret_pool);
+
+/**
+ * @brief Delete a receive buffer pool
+ *
+ * @note All blocks must have been returned and no driver may use the pool anymore.
+ *
+ * @param pool pool to delete
+ * @return
+ *      - ESP_OK: pool deleted
+ *      - ESP_ERR_INVALID_ARG: pool is NULL
+ *      - ESP_ERR_INVALID_STATE: some blocks are still in use
+ */
+esp_err_t eth_rx_pool_del(eth_rx_pool_handle_t pool);
+
+/**
+ * @brief Allocate a receive buffer
+ *
+ * Lock-free, safe to be called from any task. If `pool` is NULL, the buffer is allocated by malloc(), as drivers do
+ * without a pool, so they can call this function regardless of the pool being configured.
+ *
+ * @param pool pool to allocate from, or NULL to allocate from heap
+ * @param size required size
+ * @return buffer, or NULL if the pool is empty, `size` is bigger than the block size or heap is exhausted
+ */
+void *eth_rx_pool_alloc(eth_rx_pool_handle_t pool, size_t size);
+
+/**
+ * @brief Free a buffer allocated by eth_rx_pool_alloc()
+ *
+ * Lock-free, safe to be called from any task. The owner pool is found by checking the buffer address against each
+ * registered pool, at most CONFIG_ETH_RX_POOL_MAX_POOLS of them. Buffers which do not belong to any pool are returned
+ * to heap, so this function can be used to free any buffer passed to the stack by the Ethernet drivers.
+ *
+ * @param buffer buffer to free, NULL is ignored
+ */
+void eth_rx_pool_free(void *buffer);
+
+/**
+ * @brief Free callback in the format of `esp_netif_driver_ifconfig_t::driver_free_rx_buffer`
+ *
+ * Set it as the free function of the network interface, so the stack returns received buffers to the pool.
+ *
+ * @param h driver handle (unused)
+ * @param buffer buffer to free
+ */
+void eth_rx_pool_netif_free(void *h, void *buffer);
+
+/**
+ * @brief Get pool statistics
+ *
+ * @param pool pool
+ * @param[out] stats statistics
+ * @return
+ *      - ESP_OK: statistics read
+ *      - ESP_ERR_INVALID_ARG: invalid argument
+ */
+esp_err_t eth_rx_pool_get_stats(eth_rx_pool_handle_t pool, eth_rx_pool_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
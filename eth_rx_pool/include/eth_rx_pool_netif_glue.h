@@ -0,0 +1,46 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include "esp_err.h"
+#include "esp_netif.h"
+#include "esp_eth_driver.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Handle of a netif glue of an Ethernet driver receiving frames into a buffer pool
+ */
+typedef void *eth_rx_pool_netif_glue_handle_t;
+
+/**
+ * @brief Create a netif glue for an Ethernet driver which receives frames into a buffer pool
+ *
+ * The glue attaches the driver to the netif exactly as the glue created by esp_eth_new_netif_glue() does, except
+ * that received frames are freed by eth_rx_pool_netif_free() instead of free(). Use it for every driver configured
+ * with `rx_pool`, the default glue would return pool blocks to heap.
+ *
+ * @param eth_hdl Ethernet driver handle
+ * @return glue object, which inherits esp_netif_driver_base_t, or NULL if there is not enough memory
+ */
+eth_rx_pool_netif_glue_handle_t eth_rx_pool_new_netif_glue(esp_eth_handle_t eth_hdl);
+
+/**
+ * @brief Delete a netif glue created by eth_rx_pool_new_netif_glue()
+ *
+ * @param glue netif glue
+ * @return
+ *      - ESP_OK: glue deleted
+ *      - ESP_ERR_INVALID_ARG: glue is NULL
+ */
+esp_err_t eth_rx_pool_del_netif_glue(eth_rx_pool_netif_glue_handle_t glue);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,221 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include <stdatomic.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "sdkconfig.h"
+#include "eth_rx_pool.h"
+
+static const char *TAG = "eth_rx_pool";
+
+/* Blocks are cache line aligned, so they can be written by DMA on targets with cache */
+#define ETH_RX_POOL_ALIGN       (64)
+/* The free list head packs the block index with an ABA tag, hence the limit on block count */
+#define ETH_RX_POOL_IDX_NONE    (0xFFFF)
+#define ETH_RX_POOL_MAX_BLOCKS  (ETH_RX_POOL_IDX_NONE)
+
+#define ETH_RX_POOL_HEAD(tag, idx)  (((uint32_t)(tag) << 16) | (idx))
+#define ETH_RX_POOL_HEAD_IDX(head)  ((head) & 0xFFFF)
+#define ETH_RX_POOL_HEAD_TAG(head)  ((head) >> 16)
+
+struct eth_rx_pool_s {
+    uint8_t *mem;                       /*!< Blocks memory */
+    uint8_t *mem_end;                   /*!< End of blocks memory */
+    uint32_t block_size;                /*!< Usable block size */
+    uint32_t block_stride;              /*!< Distance of two blocks, block size rounded up to alignment */
+    uint32_t block_count;               /*!< Number of blocks */
+    uint16_t *next;                     /*!< Free list links, index of the next free block */
+    _Atomic uint32_t free_head;         /*!< Free list head, ABA tag and block index */
+    _Atomic uint32_t in_use;            /*!< Blocks currently allocated */
+    _Atomic uint32_t peak_in_use;       /*!< Allocated blocks watermark */
+    _Atomic uint32_t alloc_cnt;         /*!< Successful allocations */
+    _Atomic uint32_t alloc_fail_cnt;    /*!< Failed allocations */
+    uint32_t slot;                      /*!< Index of the pool in s_slots */
+};
+
+/**
+ * @brief Memory range of a registered pool
+ *
+ * The range is kept in static memory rather than read from the pool, so it can be checked while the pool is deleted.
+ * `seq` is odd while the slot is rewritten.
+ */
+typedef struct {
+    _Atomic uint32_t seq;
+    _Atomic uintptr_t mem;
+    _Atomic uintptr_t mem_end;
+    _Atomic(struct eth_rx_pool_s *) pool;
+} eth_rx_pool_slot_t;
+
+/* Registered pools, so eth_rx_pool_free() can find the owner of a buffer without a handle */
+static eth_rx_pool_slot_t s_slots[CONFIG_ETH_RX_POOL_MAX_POOLS];
+/* Serializes creating and deleting pools, eth_rx_pool_free() never takes it */
+static portMUX_TYPE s_slots_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static void eth_rx_pool_slot_set(eth_rx_pool_slot_t *slot, struct eth_rx_pool_s *pool)
+{
+    atomic_fetch_add(&slot->seq, 1);
+    atomic_store(&slot->mem, pool ? (uintptr_t)pool->mem : 0);
+    atomic_store(&slot->mem_end, pool ? (uintptr_t)pool->mem_end : 0);
+    atomic_store(&slot->pool, pool);
+    atomic_fetch_add(&slot->seq, 1);
+}
+
+/* A buffer being freed keeps its pool alive, since eth_rx_pool_del() fails while blocks are in use. Other slots may be
+ * rewritten meanwhile, reading one is retried until it was not rewritten under the reader, which only happens while
+ * a pool is being created or deleted. */
+static struct eth_rx_pool_s *eth_rx_pool_find(const void *buffer)
+{
+    uintptr_t addr = (uintptr_t)buffer;
+    for (int i = 0; i < CONFIG_ETH_RX_POOL_MAX_POOLS; i++) {
+        eth_rx_pool_slot_t *slot = &s_slots[i];
+        uint32_t seq;
+        uintptr_t mem;
+        uintptr_t mem_end;
+        struct eth_rx_pool_s *pool;
+        do {
+            seq = atomic_load(&slot->seq);
+            mem = atomic_load(&slot->mem);
+            mem_end = atomic_load(&slot->mem_end);
+            pool = atomic_load(&slot->pool);
+        } while ((seq & 1) || seq != atomic_load(&slot->seq));
+        if (addr >= mem && addr < mem_end) {
+            return pool;
+        }
+    }
+    return NULL;
+}
+
+esp_err_t eth_rx_pool_new(const eth_rx_pool_config_t *config, eth_rx_pool_handle_t *ret_pool)
+{
+    esp_err_t ret = ESP_OK;
+    struct eth_rx_pool_s *pool = NULL;
+    ESP_GOTO_ON_FALSE(config && ret_pool, ESP_ERR_INVALID_ARG, err, TAG, "invalid argument");
+    ESP_GOTO_ON_FALSE(config->block_size > 0 && config->block_count > 0 && config->block_count < ETH_RX_POOL_MAX_BLOCKS,
+                      ESP_ERR_INVALID_ARG, err, TAG, "invalid pool dimensions");
+
+    pool = calloc(1, sizeof(struct eth_rx_pool_s));
+    ESP_GOTO_ON_FALSE(pool, ESP_ERR_NO_MEM, err, TAG, "no mem for pool");
+    pool->block_size = config->block_size;
+    pool->block_stride = (config->block_size + ETH_RX_POOL_ALIGN - 1) & ~(ETH_RX_POOL_ALIGN - 1);
+    pool->block_count = config->block_count;
+    pool->mem = heap_caps_aligned_alloc(ETH_RX_POOL_ALIGN, pool->block_stride * pool->block_count, config->caps);
+    ESP_GOTO_ON_FALSE(pool->mem, ESP_ERR_NO_MEM, err, TAG, "no mem for pool blocks");
+    pool->mem_end = pool->mem + pool->block_stride * pool->block_count;
+    pool->next = calloc(pool->block_count, sizeof(uint16_t));
+    ESP_GOTO_ON_FALSE(pool->next, ESP_ERR_NO_MEM, err, TAG, "no mem for pool free list");
+    // chain all blocks into the free list
+    for (uint32_t i = 0; i < pool->block_count; i++) {
+        pool->next[i] = (i + 1 < pool->block_count) ? i + 1 : ETH_RX_POOL_IDX_NONE;
+    }
+    atomic_init(&pool->free_head, ETH_RX_POOL_HEAD(0, 0));
+
+    portENTER_CRITICAL(&s_slots_lock);
+    pool->slot = CONFIG_ETH_RX_POOL_MAX_POOLS;
+    for (uint32_t i = 0; i < CONFIG_ETH_RX_POOL_MAX_POOLS; i++) {
+        if (atomic_load(&s_slots[i].pool) == NULL) {
+            pool->slot = i;
+            eth_rx_pool_slot_set(&s_slots[i], pool);
+            break;
+        }
+    }
+    portEXIT_CRITICAL(&s_slots_lock);
+    ESP_GOTO_ON_FALSE(pool->slot < CONFIG_ETH_RX_POOL_MAX_POOLS, ESP_ERR_NO_MEM, err, TAG,
+                      "no free pool slot, see CONFIG_ETH_RX_POOL_MAX_POOLS");
+
+    *ret_pool = pool;
+    return ESP_OK;
+err:
+    if (pool) {
+        heap_caps_free(pool->mem);
+        free(pool->next);
+        free(pool);
+    }
+    return ret;
+}
+
+esp_err_t eth_rx_pool_del(eth_rx_pool_handle_t pool)
+{
+    ESP_RETURN_ON_FALSE(pool, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ESP_RETURN_ON_FALSE(atomic_load(&pool->in_use) == 0, ESP_ERR_INVALID_STATE, TAG, "pool blocks still in use");
+
+    portENTER_CRITICAL(&s_slots_lock);
+    eth_rx_pool_slot_set(&s_slots[pool->slot], NULL);
+    portEXIT_CRITICAL(&s_slots_lock);
+
+    heap_caps_free(pool->mem);
+    free(pool->next);
+    free(pool);
+    return ESP_OK;
+}
+
+void *eth_rx_pool_alloc(eth_rx_pool_handle_t pool, size_t size)
+{
+    if (pool == NULL) {
+        return malloc(size);
+    }
+    if (size > pool->block_size) {
+        atomic_fetch_add(&pool->alloc_fail_cnt, 1);
+        return NULL;
+    }
+    uint32_t head = atomic_load(&pool->free_head);
+    uint32_t new_head;
+    uint32_t idx;
+    do {
+        idx = ETH_RX_POOL_HEAD_IDX(head);
+        if (idx == ETH_RX_POOL_IDX_NONE) {
+            atomic_fetch_add(&pool->alloc_fail_cnt, 1);
+            return NULL;
+        }
+        // the tag changes on every update, so a block freed and allocated again in between fails the exchange
+        new_head = ETH_RX_POOL_HEAD(ETH_RX_POOL_HEAD_TAG(head) + 1, pool->next[idx]);
+    } while (!atomic_compare_exchange_weak(&pool->free_head, &head, new_head));
+
+    atomic_fetch_add(&pool->alloc_cnt, 1);
+    uint32_t in_use = atomic_fetch_add(&pool->in_use, 1) + 1;
+    uint32_t peak = atomic_load(&pool->peak_in_use);
+    while (in_use > peak && !atomic_compare_exchange_weak(&pool->peak_in_use, &peak, in_use)) {
+    }
+    return pool->mem + idx * pool->block_stride;
+}
+
+void eth_rx_pool_free(void *buffer)
+{
+    if (buffer == NULL) {
+        return;
+    }
+    struct eth_rx_pool_s *pool = eth_rx_pool_find(buffer);
+    if (pool == NULL) {
+        heap_caps_free(buffer);
+        return;
+    }
+    uint32_t idx = ((uint8_t *)buffer - pool->mem) / pool->block_stride;
+    uint32_t head = atomic_load(&pool->free_head);
+    do {
+        pool->next[idx] = ETH_RX_POOL_HEAD_IDX(head);
+    } while (!atomic_compare_exchange_weak(&pool->free_head, &head, ETH_RX_POOL_HEAD(ETH_RX_POOL_HEAD_TAG(head) + 1, idx)));
+    atomic_fetch_sub(&pool->in_use, 1);
+}
+
+void eth_rx_pool_netif_free(void *h, void *buffer)
+{
+    eth_rx_pool_free(buffer);
+}
+
+esp_err_t eth_rx_pool_get_stats(eth_rx_pool_handle_t pool, eth_rx_pool_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(pool && stats, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    stats->block_size = pool->block_size;
+    stats->block_count = pool->block_count;
+    stats->in_use = atomic_load(&pool->in_use);
+    stats->peak_in_use = atomic_load(&pool->peak_in_use);
+    stats->alloc_cnt = atomic_load(&pool->alloc_cnt);
+    stats->alloc_fail_cnt = atomic_load(&pool->alloc_fail_cnt);
+    return ESP_OK;
+}
@@ -0,0 +1,60 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <stdlib.h>
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_eth_netif_glue.h"
+#include "eth_rx_pool.h"
+#include "eth_rx_pool_netif_glue.h"
+
+static const char *TAG = "eth_rx_pool_glue";
+
+typedef struct {
+    esp_netif_driver_base_t base;
+    esp_eth_netif_glue_handle_t eth_glue;   /*!< Default Ethernet glue, it does all the work except freeing frames */
+} eth_rx_pool_netif_glue_t;
+
+static esp_err_t eth_rx_pool_netif_post_attach(esp_netif_t *esp_netif, void *args)
+{
+    eth_rx_pool_netif_glue_t *glue = (eth_rx_pool_netif_glue_t *)args;
+    esp_netif_driver_base_t *eth_glue = (esp_netif_driver_base_t *)glue->eth_glue;
+    glue->base.netif = esp_netif;
+
+    // the Ethernet glue registers the input path and the event handlers and sets up the driver config
+    ESP_RETURN_ON_ERROR(eth_glue->post_attach(esp_netif, eth_glue), TAG, "Ethernet glue attach failed");
+    // only the free function differs, the interface is attached before the driver is started, so no frame is received in between
+    esp_netif_driver_ifconfig_t driver_ifconfig = {
+        .handle = esp_netif_get_io_driver(esp_netif),
+        .transmit = esp_eth_transmit,
+        .driver_free_rx_buffer = eth_rx_pool_netif_free,
+    };
+    ESP_RETURN_ON_ERROR(esp_netif_set_driver_config(esp_netif, &driver_ifconfig), TAG, "set driver config failed");
+    return ESP_OK;
+}
+
+eth_rx_pool_netif_glue_handle_t eth_rx_pool_new_netif_glue(esp_eth_handle_t eth_hdl)
+{
+    eth_rx_pool_netif_glue_t *glue = calloc(1, sizeof(eth_rx_pool_netif_glue_t));
+    ESP_RETURN_ON_FALSE(glue, NULL, TAG, "no mem for glue");
+    glue->eth_glue = esp_eth_new_netif_glue(eth_hdl);
+    if (glue->eth_glue == NULL) {
+        ESP_LOGE(TAG, "create Ethernet glue failed");
+        free(glue);
+        return NULL;
+    }
+    glue->base.post_attach = eth_rx_pool_netif_post_attach;
+    return glue;
+}
+
+esp_err_t eth_rx_pool_del_netif_glue(eth_rx_pool_netif_glue_handle_t glue)
+{
+    ESP_RETURN_ON_FALSE(glue, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    eth_rx_pool_netif_glue_t *pool_glue = (eth_rx_pool_netif_glue_t *)glue;
+    esp_eth_del_netif_glue(pool_glue->eth_glue);
+    free(pool_glue);
+    return ESP_OK;
+}
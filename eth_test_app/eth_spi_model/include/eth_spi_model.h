@@ -0,0 +1,112 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "esp_eth_com.h"
+#include "esp_eth_mac_spi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ETH_SPI_MODEL_MAX_FRAMES    (64) /*!< Number of frames passed to the stack which are recorded */
+#define ETH_SPI_MODEL_FRAME_HEAD    (16) /*!< Bytes recorded from the start of each frame */
+
+/**
+ * @brief Register model of an SPI Ethernet chip, which the driver accesses instead of the SPI bus
+ *
+ * The functions take the arguments of the custom SPI driver read/write functions, i.e. `cmd` and `addr` are the command
+ * and address phases as the driver issues them. They are called with the harness lock held.
+ */
+typedef struct {
+    esp_err_t (*read)(void *ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len);        /*!< Read transaction */
+    esp_err_t (*write)(void *ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len); /*!< Write transaction */
+    void *ctx;                                                                                  /*!< Model context */
+} eth_spi_model_t;
+
+/**
+ * @brief Frame passed to the stack by the driver
+ */
+typedef struct {
+    uint32_t len;                           /*!< Frame length */
+    uint8_t head[ETH_SPI_MODEL_FRAME_HEAD]; /*!< First bytes of the frame */
+    uint32_t crc;                           /*!< esp_rom_crc32_le() of the whole frame */
+} eth_spi_model_frame_t;
+
+/**
+ * @brief Reset the harness: clear the counters and the received frames, detach the interrupt line
+ *
+ * Call it before the model and the driver are set up.
+ */
+void eth_spi_model_reset(void);
+
+/**
+ * @brief Custom SPI driver which passes every transaction to the model
+ *
+ * @param model model, it must stay valid while the driver uses it
+ */
+eth_spi_custom_driver_config_t eth_spi_model_driver(const eth_spi_model_t *model);
+
+/**
+ * @brief Take the harness lock, so the model state can be changed outside of the driver transactions
+ */
+void eth_spi_model_lock(void);
+
+/**
+ * @brief Release the harness lock
+ */
+void eth_spi_model_unlock(void);
+
+/**
+ * @brief Count transactions issued by the given task only, NULL stops counting; the count is cleared
+ */
+void eth_spi_model_count_task(void *task_hdl);
+
+/**
+ * @brief Count transactions issued by any task, until eth_spi_model_count_task() is called; the count is cleared
+ */
+void eth_spi_model_count_all(void);
+
+/**
+ * @brief Transactions counted since the counting was (re)started
+ */
+uint32_t eth_spi_model_trans(void);
+
+/**
+ * @brief Drive the given GPIO as the active low interrupt line of the model
+ *
+ * Call it after the MAC init() which configured the pin as input with the driver's interrupt handler.
+ */
+void eth_spi_model_int_attach(int gpio_num);
+
+/**
+ * @brief Assert or deassert the interrupt line, the model calls it with the harness lock held
+ *
+ * The level is kept while the line is not attached, it is applied once it is.
+ */
+void eth_spi_model_int_set(bool asserted);
+
+/**
+ * @brief Mediator to set to the MAC: state changes are accepted, frames passed to the stack are recorded and freed
+ */
+esp_eth_mediator_t *eth_spi_model_mediator(void);
+
+/**
+ * @brief Number of frames passed to the stack since the reset
+ */
+uint32_t eth_spi_model_rx_count(void);
+
+/**
+ * @brief Frame passed to the stack, in the order they were passed, the first ETH_SPI_MODEL_MAX_FRAMES are recorded
+ */
+const eth_spi_model_frame_t *eth_spi_model_rx_frame(uint32_t index);
+
+#ifdef __cplusplus
+}
+#endif
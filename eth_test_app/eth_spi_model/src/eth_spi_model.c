@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "driver/gpio.h"
+#include "esp_rom_crc.h"
+#include "eth_spi_model.h"
+
+typedef struct {
+    SemaphoreHandle_t lock;
+    TaskHandle_t count_task;
+    bool count_all;
+    uint32_t trans;
+    int int_gpio_num;
+    bool int_attached;
+    bool int_asserted;
+    uint32_t rx_count;
+    eth_spi_model_frame_t rx_frames[ETH_SPI_MODEL_MAX_FRAMES];
+} eth_spi_model_harness_t;
+
+static eth_spi_model_harness_t s_harness;
+
+static esp_err_t harness_on_state_changed(esp_eth_mediator_t *eth, esp_eth_state_t state, void *args)
+{
+    return ESP_OK;
+}
+
+static esp_err_t harness_stack_input(esp_eth_mediator_t *eth, uint8_t *buffer, uint32_t length)
+{
+    eth_spi_model_lock();
+    if (s_harness.rx_count < ETH_SPI_MODEL_MAX_FRAMES) {
+        eth_spi_model_frame_t *frame = &s_harness.rx_frames[s_harness.rx_count];
+        frame->len = length;
+        memcpy(frame->head, buffer, length < sizeof(frame->head) ? length : sizeof(frame->head));
+        frame->crc = esp_rom_crc32_le(0, buffer, length);
+    }
+    s_harness.rx_count++;
+    eth_spi_model_unlock();
+    free(buffer);
+    return ESP_OK;
+}
+
+static esp_eth_mediator_t s_mediator = {
+    .on_state_changed = harness_on_state_changed,
+    .stack_input = harness_stack_input,
+};
+
+static void harness_count(void)
+{
+    if (s_harness.count_all || (s_harness.count_task && xTaskGetCurrentTaskHandle() == s_harness.count_task)) {
+        s_harness.trans++;
+    }
+}
+
+static void *harness_spi_init(const void *config)
+{
+    return (void *)config;
+}
+
+static esp_err_t harness_spi_deinit(void *ctx)
+{
+    return ESP_OK;
+}
+
+static esp_err_t harness_spi_read(void *ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len)
+{
+    const eth_spi_model_t *model = ctx;
+    eth_spi_model_lock();
+    harness_count();
+    esp_err_t ret = model->read(model->ctx, cmd, addr, data, len);
+    eth_spi_model_unlock();
+    return ret;
+}
+
+static esp_err_t harness_spi_write(void *ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len)
+{
+    const eth_spi_model_t *model = ctx;
+    eth_spi_model_lock();
+    harness_count();
+    esp_err_t ret = model->write(model->ctx, cmd, addr, data, len);
+    eth_spi_model_unlock();
+    return ret;
+}
+
+void eth_spi_model_reset(void)
+{
+    if (!s_harness.lock) {
+        s_harness.lock = xSemaphoreCreateMutex();
+    }
+    SemaphoreHandle_t lock = s_harness.lock;
+    memset(&s_harness, 0, sizeof(s_harness));
+    s_harness.lock = lock;
+    s_harness.int_gpio_num = -1;
+}
+
+eth_spi_custom_driver_config_t eth_spi_model_driver(const eth_spi_model_t *model)
+{
+    eth_spi_custom_driver_config_t driver = {
+        .config = (void *)model,
+        .init = harness_spi_init,
+        .deinit = harness_spi_deinit,
+        .read = harness_spi_read,
+        .write = harness_spi_write,
+    };
+    return driver;
+}
+
+void eth_spi_model_lock(void)
+{
+    xSemaphoreTake(s_harness.lock, portMAX_DELAY);
+}
+
+void eth_spi_model_unlock(void)
+{
+    xSemaphoreGive(s_harness.lock);
+}
+
+void eth_spi_model_count_task(void *task_hdl)
+{
+    eth_spi_model_lock();
+    s_harness.count_task = task_hdl;
+    s_harness.count_all = false;
+    s_harness.trans = 0;
+    eth_spi_model_unlock();
+}
+
+void eth_spi_model_count_all(void)
+{
+    eth_spi_model_lock();
+    s_harness.count_task = NULL;
+    s_harness.count_all = true;
+    s_harness.trans = 0;
+    eth_spi_model_unlock();
+}
+
+uint32_t eth_spi_model_trans(void)
+{
+    return s_harness.trans;
+}
+
+void eth_spi_model_int_attach(int gpio_num)
+{
+    eth_spi_model_lock();
+    gpio_set_level(gpio_num, 1);
+    gpio_set_direction(gpio_num, GPIO_MODE_INPUT_OUTPUT);
+    s_harness.int_gpio_num = gpio_num;
+    s_harness.int_attached = true;
+    eth_spi_model_int_set(s_harness.int_asserted);
+    eth_spi_model_unlock();
+}
+
+void eth_spi_model_int_set(bool asserted)
+{
+    s_harness.int_asserted = asserted;
+    if (s_harness.int_attached) {
+        gpio_set_level(s_harness.int_gpio_num, asserted ? 0 : 1); // active low
+    }
+}
+
+esp_eth_mediator_t *eth_spi_model_mediator(void)
+{
+    return &s_mediator;
+}
+
+uint32_t eth_spi_model_rx_count(void)
+{
+    return s_harness.rx_count;
+}
+
+const eth_spi_model_frame_t *eth_spi_model_rx_frame(uint32_t index)
+{
+    return index < ETH_SPI_MODEL_MAX_FRAMES ? &s_harness.rx_frames[index] : NULL;
+}
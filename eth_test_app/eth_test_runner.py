@@ -240,3 +240,40 @@ class EthTestRunner:
                 loopback_proc.terminate()
 
         dut.expect_unity_test_output()
+
+    def run_ethernet_latency_test(self, dut, test_if: str = '') -> None:
+        """Run round trip latency test, frames are looped back by the host. Compare results of different driver configurations,
+        e.g. store-and-forward and cut-through mode."""
+        target_if = EthTestIntf(self.eth_type, test_if)
+        dut.expect_exact('Press ENTER to see the list of tests')
+        dut.write('\n')
+        dut.expect_exact('Enter test for running.')
+        dut.write('"ethernet round trip latency"')
+        res = dut.expect(
+            r'DUT MAC: ([0-9A-Fa-f]{2}:[0-9A-Fa-f]{2}:[0-9A-Fa-f]{2}:[0-9A-Fa-f]{2}:[0-9A-Fa-f]{2}:[0-9A-Fa-f]{2})'
+        )
+        dut_mac = res.group(1).decode('utf-8')
+        pipe_rcv, pipe_send = Pipe(False)
+        loopback_proc = Process(
+            target=target_if.eth_loopback,
+            args=(dut_mac, pipe_rcv),
+        )
+        loopback_proc.start()
+        try:
+            target_if.recv_resp_poke(mac=dut_mac)
+            for _ in range(3):
+                res = dut.expect(r'Round trip latency of (\d+) B frames: avg (\d+) us, max (\d+) us')
+                logging.info(
+                    'Round trip latency of %s B frames: avg %s us, max %s us',
+                    res.group(1).decode('utf-8'),
+                    res.group(2).decode('utf-8'),
+                    res.group(3).decode('utf-8'),
+                )
+            dut.expect_exact('Ethernet Stopped')
+        finally:
+            pipe_send.send(0)
+            loopback_proc.join(5)
+            if loopback_proc.exitcode is None:
+                loopback_proc.terminate()
+
+        dut.expect_unity_test_output()
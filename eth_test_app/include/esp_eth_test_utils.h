@@ -24,6 +24,14 @@
 
 #define MAX_HEAP_ALLOCATION_POINTERS 20
 
+/**
+ * @brief Snapshot of CPU run time, used to compute CPU time left to the application
+ */
+typedef struct {
+    uint64_t idle;      /*!< Run time of idle tasks of all cores */
+    uint64_t total;     /*!< Total run time */
+} eth_test_cpu_time_t;
+
 typedef struct {
     uint8_t dest[ETH_ADDR_LEN];
     uint8_t src[ETH_ADDR_LEN];
@@ -131,3 +139,21 @@ void eth_test_free(void *ptr);
  * @return void
  */
 void eth_test_free_all(void);
+
+/** @brief Take a snapshot of CPU run time
+ *
+ *  @note Requires `CONFIG_FREERTOS_USE_TRACE_FACILITY` and `CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS`.
+ *
+ * @param[out] cpu_time The run time snapshot
+ * @return esp_err_t ESP_OK on success, ESP_ERR_NOT_SUPPORTED if run time statistics are disabled, ESP_ERR_NO_MEM
+ */
+esp_err_t eth_test_get_cpu_time(eth_test_cpu_time_t *cpu_time);
+
+/** @brief Compute the share of CPU time spent in idle tasks between two snapshots, i.e. the CPU headroom
+ *         left to the application
+ *
+ * @param start The snapshot taken at the start of the measurement
+ * @param end The snapshot taken at the end of the measurement
+ * @return uint32_t The idle CPU time in percent of the time of all cores
+ */
+uint32_t eth_test_get_cpu_idle_percent(const eth_test_cpu_time_t *start, const eth_test_cpu_time_t *end);
@@ -13,6 +13,7 @@
 #include "esp_http_client.h"
 #include "esp_rom_md5.h"
 #include "esp_eth_test_utils.h"
+#include "ethernet_init.h"
 #include "unity.h"
 
 #define LOOPBACK_TEST_PACKET_SIZE 256
@@ -307,7 +308,7 @@ static esp_err_t loopback_test_case_incoming_handler(esp_eth_handle_t eth_handle
 {
     TEST_ASSERT(memcmp(priv, buffer, LOOPBACK_TEST_PACKET_SIZE) == 0);
     xSemaphoreGive(loopback_test_case_data_received);
-    free(buffer);
+    eth_rx_pool_free(buffer);
     return ESP_OK;
 }
 
@@ -11,6 +11,8 @@
 #include "esp_eth_test_utils.h"
 #include "arpa/inet.h" // for ntohs, etc.
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "ethernet_init.h"
 
 #define TEST_ETH_TYPE           0x3300
 #define TEST_CTRL_ETH_TYPE      (TEST_ETH_TYPE + 1)
@@ -56,7 +58,7 @@ static esp_err_t l2_packet_txrx_test_cb(esp_eth_handle_t hdl, uint8_t *buffer, u
                 for (int i = 0; i < (length - ETH_HEADER_LEN); ++i) {
                     if (pkt->data[i] != (i & 0xff)) {
                         printf("payload mismatch\n");
-                        free(buffer);
+                        eth_rx_pool_free(buffer);
                         return ESP_OK;
                     }
                 }
@@ -80,7 +82,7 @@ static esp_err_t l2_packet_txrx_test_cb(esp_eth_handle_t hdl, uint8_t *buffer, u
             xEventGroupSetBits(eth_event_group, ETH_POKE_RESP_RECV_BIT);
         }
     }
-    free(buffer);
+    eth_rx_pool_free(buffer);
     return ESP_OK;
 }
 
@@ -476,7 +478,14 @@ TEST_CASE("ethernet start/stop stress test under heavy traffic", "[ethernet_l2]"
         bits = xEventGroupWaitBits(eth_event_rx_group, ETH_UNICAST_RECV_BIT, true, true, pdMS_TO_TICKS(3000));
         TEST_ASSERT((bits & ETH_UNICAST_RECV_BIT) == ETH_UNICAST_RECV_BIT);
 
+        // report CPU time left to the application while the driver is busy receiving
+        eth_test_cpu_time_t cpu_time_start = {};
+        eth_test_cpu_time_t cpu_time_end = {};
+        bool cpu_time_valid = eth_test_get_cpu_time(&cpu_time_start) == ESP_OK;
         vTaskDelay(pdMS_TO_TICKS(500));
+        if (cpu_time_valid && eth_test_get_cpu_time(&cpu_time_end) == ESP_OK) {
+            printf("CPU idle under Rx traffic: %" PRIu32 " %%\n", eth_test_get_cpu_idle_percent(&cpu_time_start, &cpu_time_end));
+        }
 
         TEST_ESP_OK(esp_eth_stop(eth_handle));
         bits = xEventGroupWaitBits(eth_event_group, ETH_STOP_BIT, true, true, pdMS_TO_TICKS(3000));
@@ -564,6 +573,26 @@ TEST_CASE("heap utilization", "[ethernet_l2]")
     memcpy(test_pkt->dest, dest_mac_addr, ETH_ADDR_LEN); // overwrite destination address with test PC addr
 #endif
 
+    // frames are allocated from the pool when CONFIG_ETHERNET_SPI_RX_POOL is enabled, otherwise from heap
+    eth_rx_pool_handle_t rx_pool = ethernet_init_get_rx_pool();
+    // compare latency of receive buffer allocation from heap and from the pool, 1000 iterations so us read as ns per buffer
+    int64_t start_time = esp_timer_get_time();
+    for (int i = 0; i < 1000; i++) {
+        eth_rx_pool_free(eth_rx_pool_alloc(NULL, ETH_MAX_PACKET_SIZE));
+    }
+    ESP_LOGI(TAG, "heap RX buffer alloc/free: %" PRIi64 " ns", esp_timer_get_time() - start_time);
+    if (rx_pool != NULL) {
+        start_time = esp_timer_get_time();
+        for (int i = 0; i < 1000; i++) {
+            eth_rx_pool_free(eth_rx_pool_alloc(rx_pool, ETH_MAX_PACKET_SIZE));
+        }
+        ESP_LOGI(TAG, "pool RX buffer alloc/free: %" PRIi64 " ns", esp_timer_get_time() - start_time);
+    }
+    eth_rx_pool_stats_t pool_stats_start = {};
+    if (rx_pool != NULL) {
+        TEST_ESP_OK(eth_rx_pool_get_stats(rx_pool, &pool_stats_start));
+    }
+
     uint16_t transmit_size;
     size_t free_heap = 0;
     uint8_t *p;
@@ -588,7 +617,11 @@ TEST_CASE("heap utilization", "[ethernet_l2]")
         TEST_ESP_OK(esp_eth_transmit(eth_handle, test_pkt, transmit_size));
         // wait for dummy traffic
         bits = xEventGroupWaitBits(eth_event_rx_group, ETH_UNICAST_RECV_BIT, true, true, pdMS_TO_TICKS(200));
-        TEST_ASSERT(bits == 0); // we don't received the frame due to "no mem"
+        if (rx_pool != NULL) {
+            TEST_ASSERT((bits & ETH_UNICAST_RECV_BIT) == ETH_UNICAST_RECV_BIT); // the pool does not depend on heap
+        } else {
+            TEST_ASSERT(bits == 0); // we don't received the frame due to "no mem"
+        }
     }
     ESP_LOGI(TAG, "Free previously allocated heap");
     eth_test_free_all();
@@ -603,6 +636,83 @@ TEST_CASE("heap utilization", "[ethernet_l2]")
         bits = xEventGroupWaitBits(eth_event_rx_group, ETH_UNICAST_RECV_BIT, true, true, pdMS_TO_TICKS(200));
         TEST_ASSERT((bits & ETH_UNICAST_RECV_BIT) == ETH_UNICAST_RECV_BIT); // now, we should be able to receive frames again
     }
+    if (rx_pool != NULL) {
+        eth_rx_pool_stats_t pool_stats;
+        TEST_ESP_OK(eth_rx_pool_get_stats(rx_pool, &pool_stats));
+        ESP_LOGI(TAG, "RX pool: %" PRIu32 " allocations, %" PRIu32 " failed, peak %" PRIu32 "/%" PRIu32 " blocks",
+                 pool_stats.alloc_cnt - pool_stats_start.alloc_cnt, pool_stats.alloc_fail_cnt - pool_stats_start.alloc_fail_cnt,
+                 pool_stats.peak_in_use, pool_stats.block_count);
+        TEST_ASSERT_EQUAL_UINT32(pool_stats_start.alloc_fail_cnt, pool_stats.alloc_fail_cnt);
+        TEST_ASSERT_EQUAL_UINT32(0, pool_stats.in_use);
+    }
+    TEST_ESP_OK(esp_eth_stop(eth_handle));
+    bits = xEventGroupWaitBits(eth_event_group, ETH_STOP_BIT, true, true, pdMS_TO_TICKS(3000));
+    TEST_ASSERT((bits & ETH_STOP_BIT) == ETH_STOP_BIT);
+}
+
+TEST_CASE("ethernet round trip latency", "[ethernet_l2]")
+{
+    // get handles from common module initialized by setUp()
+    esp_eth_handle_t eth_handle = eth_test_get_eth_handle();
+    EventGroupHandle_t eth_event_group = eth_test_get_default_event_group();
+
+    // use static event group to avoid dynamic memory allocation
+    StaticEventGroup_t eth_event_rx_group_buffer;
+    EventGroupHandle_t eth_event_rx_group = xEventGroupCreateStatic(&eth_event_rx_group_buffer);
+    TEST_ASSERT(eth_event_rx_group != NULL);
+
+    s_recv_info.eth_event_group = eth_event_rx_group;
+    s_recv_info.check_rx_data = false;
+    s_recv_info.unicast_rx_cnt = 0;
+    s_recv_info.multicast_rx_cnt = 0;
+    s_recv_info.brdcast_rx_cnt = 0;
+
+    uint8_t local_mac_addr[ETH_ADDR_LEN] = {};
+    TEST_ESP_OK(esp_eth_ioctl(eth_handle, ETH_CMD_G_MAC_ADDR, local_mac_addr));
+    // test app will parse the DUT MAC from this line of log output
+    printf("DUT MAC: %.2x:%.2x:%.2x:%.2x:%.2x:%.2x\n", local_mac_addr[0], local_mac_addr[1], local_mac_addr[2],
+           local_mac_addr[3], local_mac_addr[4], local_mac_addr[5]);
+
+    TEST_ESP_OK(esp_eth_update_input_path(eth_handle, l2_packet_txrx_test_cb, &s_recv_info));
+
+    TEST_ESP_OK(esp_eth_start(eth_handle));
+    EventBits_t bits = xEventGroupWaitBits(eth_event_group, ETH_CONNECT_BIT, true, true, pdMS_TO_TICKS(ETH_CONNECT_TIMEOUT_MS));
+    TEST_ASSERT((bits & ETH_CONNECT_BIT) == ETH_CONNECT_BIT);
+
+    // frames are looped back by the test script
+    uint8_t dest_mac_addr[ETH_ADDR_LEN] = {};
+    poke_and_wait(eth_handle, NULL, 0, dest_mac_addr, eth_event_rx_group);
+
+    emac_frame_t *test_pkt = (emac_frame_t *)eth_test_alloc(ETH_MAX_PACKET_SIZE);
+    TEST_ASSERT_NOT_NULL(test_pkt);
+    test_pkt->proto = htons(TEST_ETH_TYPE);
+    memcpy(test_pkt->dest, dest_mac_addr, ETH_ADDR_LEN);
+    memcpy(test_pkt->src, local_mac_addr, ETH_ADDR_LEN);
+    memset(test_pkt->data, 0, ETH_MAX_PAYLOAD_LEN);
+
+    // latency of store-and-forward devices grows with the frame length, the one of cut-through devices much less
+    const uint16_t frame_sizes[] = {ETH_MIN_PACKET_SIZE - ETH_CRC_LEN, 512, ETH_MAX_PACKET_SIZE - ETH_CRC_LEN};
+    for (size_t s = 0; s < sizeof(frame_sizes) / sizeof(frame_sizes[0]); s++) {
+        int64_t sum_us = 0;
+        int64_t max_us = 0;
+        int received = 0;
+        for (int i = 0; i < 100; i++) {
+            xEventGroupClearBits(eth_event_rx_group, ETH_UNICAST_RECV_BIT);
+            int64_t start_us = esp_timer_get_time();
+            TEST_ESP_OK(esp_eth_transmit(eth_handle, test_pkt, frame_sizes[s]));
+            bits = xEventGroupWaitBits(eth_event_rx_group, ETH_UNICAST_RECV_BIT, true, true, pdMS_TO_TICKS(100));
+            int64_t rtt_us = esp_timer_get_time() - start_us;
+            if ((bits & ETH_UNICAST_RECV_BIT) == ETH_UNICAST_RECV_BIT) {
+                sum_us += rtt_us;
+                max_us = rtt_us > max_us ? rtt_us : max_us;
+                received++;
+            }
+        }
+        TEST_ASSERT_GREATER_THAN_INT(0, received);
+        printf("Round trip latency of %" PRIu16 " B frames: avg %" PRIi64 " us, max %" PRIi64 " us (%d/100 frames)\n",
+               frame_sizes[s], sum_us / received, max_us, received);
+    }
+
     TEST_ESP_OK(esp_eth_stop(eth_handle));
     bits = xEventGroupWaitBits(eth_event_group, ETH_STOP_BIT, true, true, pdMS_TO_TICKS(3000));
     TEST_ASSERT((bits & ETH_STOP_BIT) == ETH_STOP_BIT);
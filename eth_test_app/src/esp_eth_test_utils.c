@@ -7,6 +7,7 @@
 #include <inttypes.h>
 #include "esp_eth_driver.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "freertos/event_groups.h"
 #include "esp_event.h"
 #include "esp_log.h"
@@ -15,6 +16,7 @@
 #include "esp_check.h"
 #include "ethernet_init.h"
 #include "esp_netif.h"
+#include "eth_rx_pool_netif_glue.h"
 
 // Local override of TEST_ASSERT and TEST_ESP_OK to fix Unity file name reporting
 // when assertions are in a different file than the test. This temporarily sets Unity.
@@ -40,7 +42,8 @@ static esp_eth_handle_t *s_eth_handles; // only because we use Ethernet Init com
 static EventGroupHandle_t s_eth_event_group;
 static esp_eth_handle_t s_eth_handle;
 static esp_netif_t *s_eth_netif;
-static esp_eth_netif_glue_handle_t s_eth_glue;
+static void *s_eth_glue;
+static bool s_eth_pool_glue;
 static void *s_memory_p[MAX_HEAP_ALLOCATION_POINTERS];
 
 esp_err_t eth_test_set_phy_reg_bits(esp_eth_handle_t eth_handle, uint32_t reg_addr, uint32_t bitmask, uint32_t max_attempts)
@@ -158,7 +161,9 @@ void setUp(void)
         esp_netif_config_t netif_cfg = ESP_NETIF_DEFAULT_ETH();
         s_eth_netif = esp_netif_new(&netif_cfg);
         // combine driver with netif
-        s_eth_glue = esp_eth_new_netif_glue(s_eth_handle);
+        // frames received into a pool must be returned to it, the default glue would free them to heap
+        s_eth_pool_glue = ethernet_init_get_rx_pool() != NULL;
+        s_eth_glue = s_eth_pool_glue ? eth_rx_pool_new_netif_glue(s_eth_handle) : esp_eth_new_netif_glue(s_eth_handle);
         ETH_TEST_ESP_OK(esp_netif_attach(s_eth_netif, s_eth_glue));
         // register user defined event handlers
         ETH_TEST_ESP_OK(esp_event_handler_register(IP_EVENT, IP_EVENT_ETH_GOT_IP, &eth_test_got_ip_event_handler, s_eth_event_group));
@@ -179,9 +184,9 @@ void tearDown(void)
     esp_err_t ret;
 
     if (s_eth_glue != NULL) {
-        ret = esp_eth_del_netif_glue(s_eth_glue);
+        ret = s_eth_pool_glue ? eth_rx_pool_del_netif_glue(s_eth_glue) : esp_eth_del_netif_glue(s_eth_glue);
         if (ret != ESP_OK) {
-            ESP_LOGW(TAG, "esp_eth_del_netif_glue failed: %s", esp_err_to_name(ret));
+            ESP_LOGW(TAG, "netif glue delete failed: %s", esp_err_to_name(ret));
         }
         s_eth_glue = NULL;
     }
@@ -280,6 +285,41 @@ void eth_test_free_all(void)
     }
 }
 
+esp_err_t eth_test_get_cpu_time(eth_test_cpu_time_t *cpu_time)
+{
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY && CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    // some headroom for tasks created in between
+    UBaseType_t task_cnt = uxTaskGetNumberOfTasks() + 4;
+    TaskStatus_t *tasks = malloc(task_cnt * sizeof(TaskStatus_t));
+    ESP_RETURN_ON_FALSE(tasks, ESP_ERR_NO_MEM, TAG, "no memory for task status");
+    configRUN_TIME_COUNTER_TYPE total = 0;
+    task_cnt = uxTaskGetSystemState(tasks, task_cnt, &total);
+    cpu_time->idle = 0;
+    cpu_time->total = total;
+    for (UBaseType_t i = 0; i < task_cnt; i++) {
+        for (int core = 0; core < portNUM_PROCESSORS; core++) {
+            if (tasks[i].xHandle == xTaskGetIdleTaskHandleForCore(core)) {
+                cpu_time->idle += tasks[i].ulRunTimeCounter;
+            }
+        }
+    }
+    free(tasks);
+    return ESP_OK;
+#else
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+uint32_t eth_test_get_cpu_idle_percent(const eth_test_cpu_time_t *start, const eth_test_cpu_time_t *end)
+{
+    // total run time is the wall clock time, idle time is accumulated over all cores
+    uint64_t total = (end->total - start->total) * portNUM_PROCESSORS;
+    if (total == 0) {
+        return 0;
+    }
+    return (uint32_t)((end->idle - start->idle) * 100 / total);
+}
+
 /** Event handler for Ethernet events */
 void eth_test_default_event_handler(void *arg, esp_event_base_t event_base,
                                     int32_t event_id, void *event_data)
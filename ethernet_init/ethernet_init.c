@@ -17,6 +17,9 @@
 #include "sdkconfig.h"
 #if CONFIG_ETHERNET_SPI_SUPPORT
 #include "driver/spi_master.h"
+#if CONFIG_ETHERNET_SPI_RX_POOL
+#include "esp_netif.h"
+#endif
 #endif // CONFIG_ETHERNET_SPI_SUPPORT
 
 #if CONFIG_ETHERNET_PHY_LAN867X
@@ -153,6 +156,7 @@ static uint8_t eth_cnt_g = 0;
 static eth_device eth_instance_g[CONFIG_ETHERNET_INTERNAL_SUPPORT + ETHERNET_SPI_NUMBER + CONFIG_ETHERNET_OPENETH_SUPPORT];
 #if CONFIG_ETHERNET_SPI_SUPPORT
 static bool spi_bus_deinit_g = false;
+static eth_rx_pool_handle_t rx_pool_g = NULL;
 #endif // CONFIG_ETHERNET_SPI_SUPPORT
 #if CONFIG_ETHERNET_DEFAULT_EVENT_HANDLER
 static esp_event_handler_instance_t eth_event_ctx_g;
@@ -519,6 +523,10 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
 #if CONFIG_ETHERNET_SPI_USE_KSZ8851SNL
         eth_ksz8851snl_config_t ksz8851snl_config = ETH_KSZ8851SNL_DEFAULT_CONFIG(CONFIG_ETHERNET_SPI_HOST, &spi_devcfg);
         ksz8851snl_config.int_gpio_num = spi_eth_module_config->int_gpio;
+        ksz8851snl_config.rx_pool = rx_pool_g;
+        ksz8851snl_config.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
+        ksz8851snl_config.rx_pipeline_depth = CONFIG_ETHERNET_KSZ8851SNL_RX_PIPELINE_DEPTH;
+        ksz8851snl_config.tx_queue_size = CONFIG_ETHERNET_KSZ8851SNL_TX_QUEUE_SIZE;
         ksz8851snl_config.poll_period_ms = spi_eth_module_config->poll_period_ms;
         mac = esp_eth_mac_new_ksz8851snl(&ksz8851snl_config, &mac_config);
         phy = esp_eth_phy_new_ksz8851snl(&phy_config);
@@ -528,6 +536,8 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
 #if CONFIG_ETHERNET_SPI_USE_DM9051
         eth_dm9051_config_t dm9051_config = ETH_DM9051_DEFAULT_CONFIG(CONFIG_ETHERNET_SPI_HOST, &spi_devcfg);
         dm9051_config.int_gpio_num = spi_eth_module_config->int_gpio;
+        dm9051_config.rx_pool = rx_pool_g;
+        dm9051_config.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
         dm9051_config.poll_period_ms = spi_eth_module_config->poll_period_ms;
         mac = esp_eth_mac_new_dm9051(&dm9051_config, &mac_config);
         phy = esp_eth_phy_new_dm9051(&phy_config);
@@ -539,6 +549,11 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(6, 0, 0)
         w5500_config.base.int_gpio_num = spi_eth_module_config->int_gpio;
         w5500_config.base.poll_period_ms = spi_eth_module_config->poll_period_ms;
+        w5500_config.base.rx_pool = rx_pool_g;
+        w5500_config.base.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
+#if CONFIG_ETHERNET_WIZNET_ASYNC_TX
+        w5500_config.base.flags |= ETH_WIZNET_FLAG_ASYNC_TX;
+#endif // CONFIG_ETHERNET_WIZNET_ASYNC_TX
 #else
         w5500_config.int_gpio_num = spi_eth_module_config->int_gpio;
         w5500_config.poll_period_ms = spi_eth_module_config->poll_period_ms;
@@ -552,6 +567,11 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
         eth_w6100_config_t w6100_config = ETH_W6100_DEFAULT_CONFIG(CONFIG_ETHERNET_SPI_HOST, &spi_devcfg);
         w6100_config.base.int_gpio_num = spi_eth_module_config->int_gpio;
         w6100_config.base.poll_period_ms = spi_eth_module_config->poll_period_ms;
+        w6100_config.base.rx_pool = rx_pool_g;
+        w6100_config.base.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
+#if CONFIG_ETHERNET_WIZNET_ASYNC_TX
+        w6100_config.base.flags |= ETH_WIZNET_FLAG_ASYNC_TX;
+#endif // CONFIG_ETHERNET_WIZNET_ASYNC_TX
         mac = esp_eth_mac_new_w6100(&w6100_config, &mac_config);
         phy = esp_eth_phy_new_w6100(&phy_config);
         (void)snprintf(dev_name, ETH_DEV_NAME_MAX_LEN, "W6100");
@@ -560,6 +580,8 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
 #if CONFIG_ETHERNET_SPI_USE_CH390
         eth_ch390_config_t ch390_config = ETH_CH390_DEFAULT_CONFIG(CONFIG_ETHERNET_SPI_HOST, &spi_devcfg);
         ch390_config.int_gpio_num = spi_eth_module_config->int_gpio;
+        ch390_config.rx_pool = rx_pool_g;
+        ch390_config.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
         ch390_config.poll_period_ms = spi_eth_module_config->poll_period_ms;
         mac = esp_eth_mac_new_ch390(&ch390_config, &mac_config);
         phy = esp_eth_phy_new_ch390(&phy_config);
@@ -570,6 +592,8 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
         spi_devcfg.cs_ena_posttrans = enc28j60_cal_spi_cs_hold_time(CONFIG_ETHERNET_SPI_CLOCK_MHZ);
         eth_enc28j60_config_t enc28j60_config = ETH_ENC28J60_DEFAULT_CONFIG(CONFIG_ETHERNET_SPI_HOST, &spi_devcfg);
         enc28j60_config.int_gpio_num = spi_eth_module_config->int_gpio;
+        enc28j60_config.rx_pool = rx_pool_g;
+        enc28j60_config.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
         mac = esp_eth_mac_new_enc28j60(&enc28j60_config, &mac_config);
 
         // ENC28J60 Errata #1 check
@@ -586,6 +610,12 @@ static esp_eth_handle_t eth_init_spi(spi_eth_module_config_t *spi_eth_module_con
 #if CONFIG_ETHERNET_SPI_USE_LAN865X
         eth_lan865x_config_t lan865x_config = ETH_LAN865X_DEFAULT_CONFIG(CONFIG_ETHERNET_SPI_HOST, &spi_devcfg);
         lan865x_config.int_gpio_num = spi_eth_module_config->int_gpio;
+        lan865x_config.rx_pool = rx_pool_g;
+        lan865x_config.spi_queued_min_len = CONFIG_ETHERNET_SPI_QUEUED_MIN_LEN;
+#if CONFIG_ETHERNET_LAN865X_CUT_THROUGH
+        lan865x_config.rx_cut_through = true;
+        lan865x_config.tx_cut_through = true;
+#endif // CONFIG_ETHERNET_LAN865X_CUT_THROUGH
         lan865x_config.poll_period_ms = spi_eth_module_config->poll_period_ms;
 
         mac = esp_eth_mac_new_lan865x(&lan865x_config, &mac_config);
@@ -756,6 +786,14 @@ esp_err_t ethernet_init_all(esp_eth_handle_t *eth_handles_out[], uint8_t *eth_cn
 #error Maximum number of supported SPI Ethernet devices is currently limited to 2 by this example.
 #endif
 
+#if CONFIG_ETHERNET_SPI_RX_POOL
+    if (rx_pool_g == NULL) {
+        eth_rx_pool_config_t rx_pool_config = ETH_RX_POOL_DEFAULT_CONFIG();
+        rx_pool_config.block_count = CONFIG_ETHERNET_SPI_RX_POOL_FRAMES * ETHERNET_SPI_NUMBER;
+        ESP_GOTO_ON_ERROR(eth_rx_pool_new(&rx_pool_config, &rx_pool_g), err, TAG, "RX buffer pool init failed");
+    }
+#endif // CONFIG_ETHERNET_SPI_RX_POOL
+
     for (int i = 0; i < ETHERNET_SPI_NUMBER; i++) {
         eth_handles[eth_cnt_g] = eth_init_spi(&spi_eth_module_config[i], eth_instance_g[eth_cnt_g].dev_info.name);
         ESP_GOTO_ON_FALSE(eth_handles[eth_cnt_g], ESP_FAIL, err, TAG, "SPI Ethernet init failed");
@@ -913,6 +951,9 @@ esp_err_t ethernet_deinit_all(esp_eth_handle_t *eth_handles)
         spi_bus_deinit_g = false;
     }
     gpio_uninstall_isr_service();
+    if (rx_pool_g != NULL && eth_rx_pool_del(rx_pool_g) == ESP_OK) {
+        rx_pool_g = NULL;
+    }
 #endif // CONFIG_ETHERNET_SPI_SUPPORT
     free(eth_handles);
     eth_cnt_g = 0;
@@ -936,3 +977,12 @@ eth_dev_info_t ethernet_init_get_dev_info(esp_eth_handle_t eth_handle)
 #endif // CONFIG_ETHERNET_INTERNAL_SUPPORT || CONFIG_ETHERNET_SPI_SUPPORT || CONFIG_ETHERNET_OPENETH_SUPPORT
     return ret;
 }
+
+eth_rx_pool_handle_t ethernet_init_get_rx_pool(void)
+{
+#if CONFIG_ETHERNET_SPI_SUPPORT
+    return rx_pool_g;
+#else
+    return NULL;
+#endif // CONFIG_ETHERNET_SPI_SUPPORT
+}
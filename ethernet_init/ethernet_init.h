@@ -6,6 +6,7 @@
 #pragma once
 
 #include "esp_eth_driver.h"
+#include "eth_rx_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -68,6 +69,15 @@ esp_err_t ethernet_deinit_all(esp_eth_handle_t *eth_handles);
  */
 eth_dev_info_t ethernet_init_get_dev_info(esp_eth_handle_t eth_handle);
 
+/**
+ * @brief Returns the receive buffer pool shared by SPI Ethernet modules
+ *
+ * @return
+ *          - eth_rx_pool_handle_t pool handle
+ *          - NULL when the pool is disabled in configuration or Ethernet is not initialized
+ */
+eth_rx_pool_handle_t ethernet_init_get_rx_pool(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,9 @@
 
 #include "esp_eth_com.h"
 #include "esp_eth_mac_spi.h"
+#include "eth_rx_pool.h"
+#include "eth_rx_pipeline.h"
+#include "eth_offload.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +27,12 @@ typedef struct {
     spi_host_device_t spi_host_id;                      /*!< SPI peripheral (this field is invalid when custom SPI driver is defined) */
     spi_device_interface_config_t *spi_devcfg;          /*!< SPI device configuration (this field is invalid when custom SPI driver is defined) */
     eth_spi_custom_driver_config_t custom_spi_driver;   /*!< Custom SPI driver definitions */
+    eth_rx_pool_handle_t rx_pool;                       /*!< Pool to allocate received frames from, NULL to allocate them from heap. With a pool, attach the driver to its netif by eth_rx_pool_new_netif_glue() */
+    uint32_t spi_queued_min_len;                        /*!< Queue SPI transfers of at least this many bytes, so the calling task sleeps while they run, 0 to poll all transfers */
+    uint32_t rx_pipeline_depth;                         /*!< Received frames delivered to the stack by a separate task while the next ones are read,
+                                                             0 to deliver them from the driver task */
+    uint32_t tx_queue_size;                             /*!< Bytes of frames queued for the driver task to write to TXQ in batches,
+                                                             0 to write every frame from the transmitting task */
 } eth_ksz8851snl_config_t;
 
 /**
@@ -37,8 +46,35 @@ typedef struct {
         .spi_host_id = spi_host,                \
         .spi_devcfg = spi_devcfg_p,             \
         .custom_spi_driver = ETH_DEFAULT_SPI,   \
+        .rx_pool = NULL,                        \
+        .spi_queued_min_len = 0,                \
+        .rx_pipeline_depth = 0,                 \
+        .tx_queue_size = 0,                     \
     }
 
+/**
+ * @brief KSZ8851SNL transmit statistics
+ *
+ */
+typedef struct {
+    uint32_t frames;            /*!< Frames written to TXQ */
+    uint32_t batches;           /*!< TXQ writes, each of one or more frames */
+    uint32_t frames_per_sec;    /*!< Frames written per second since the statistics were reset */
+    uint32_t txq_full_cnt;      /*!< Times queued frames waited for TXQ space */
+    uint32_t queue_full_cnt;    /*!< Times a frame waited for space in the transmit queue */
+} eth_ksz8851_tx_stats_t;
+
+/**
+ * @brief KSZ8851SNL specific commands for ioctl API
+ *
+ */
+typedef enum {
+    ETH_MAC_KSZ8851_CMD_G_RX_STATS = ETH_CMD_CUSTOM_MAC_CMDS_OFFSET,   /*!< Get receive statistics, frames per second and pipeline latency (eth_rx_pipeline_stats_t) */
+    ETH_MAC_KSZ8851_CMD_CLR_RX_STATS,                                   /*!< Reset receive statistics (data unused) */
+    ETH_MAC_KSZ8851_CMD_G_TX_STATS,                                     /*!< Get transmit statistics (eth_ksz8851_tx_stats_t) */
+    ETH_MAC_KSZ8851_CMD_CLR_TX_STATS,                                   /*!< Reset transmit statistics (data unused) */
+} eth_mac_ksz8851_io_cmd_t;
+
 /**
 * @brief Create KSZ8851SNL Ethernet MAC instance
 *
@@ -17,18 +17,31 @@
 #include "esp_private/gpio.h"
 #include "soc/io_mux_reg.h"
 #include "driver/spi_master.h"
+#include "eth_spi_transmit.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
+#include "freertos/event_groups.h"
 #include "ksz8851.h"
 #include "esp_timer.h"
 #include "esp_rom_crc.h"
 
-#define KSZ8851_ETH_MAC_RX_BUF_SIZE_AUTO (0)
+#define KSZ8851_RX_BATCH_MAX (8)
 #define KSZ8851_HASH_FILTER_TABLE_SIZE (64)
+// NOTE(v.chistyakov): 4 bytes header + length aligned to 4 bytes
+#define KSZ8851_TX_FRAME_SIZE(len) (4U + (((len) + 3U) & ~0x3U))
+// NOTE(v.chistyakov): 4 dummy + 4 header bytes precede a frame read from RXQ
+#define KSZ8851_RX_HEADER_SIZE (8U)
+// frame including CRC, aligned to 4 bytes, as read from RXQ after the header
+#define KSZ8851_RX_FRAME_SIZE(byte_count) (((byte_count) + 3U) & ~0x3U)
+// KSZ8851SNL can't generate UDP checksums
+#define KSZ8851_CHECKSUM_OFFLOAD (ETH_CHECKSUM_OFFLOAD_TX_IP | ETH_CHECKSUM_OFFLOAD_TX_TCP | ETH_CHECKSUM_OFFLOAD_TX_ICMP | \
+                                  ETH_CHECKSUM_OFFLOAD_RX_IP | ETH_CHECKSUM_OFFLOAD_RX_TCP | ETH_CHECKSUM_OFFLOAD_RX_UDP | \
+                                  ETH_CHECKSUM_OFFLOAD_RX_ICMP)
 
 typedef struct {
     spi_device_handle_t hdl;
+    uint32_t queued_min_len;
 } eth_spi_info_t;
 
 typedef struct {
@@ -51,14 +64,27 @@ typedef struct {
     uint32_t poll_period_ms;
     uint8_t *rx_buffer;
     uint8_t *tx_buffer;
+    eth_rx_pool_handle_t rx_pool;
+    eth_rx_pipeline_config_t rx_pipeline_config;
+    eth_rx_pipeline_handle_t rx_pipeline;
+    SemaphoreHandle_t rx_lock;
+    uint16_t rxqcr;
+    uint16_t tx_free;
+    uint8_t tx_frame_id;
+    bool tx_wait_space;
+    uint32_t tx_queue_size;
+    SemaphoreHandle_t tx_lock;
+    EventGroupHandle_t tx_space_evt;
+    uint8_t *tx_stage[2];
+    uint32_t tx_stage_len[2];
+    uint8_t tx_fill;
+    uint32_t tx_flush_pos;
+    portMUX_TYPE tx_stats_lock;
+    eth_ksz8851_tx_stats_t tx_stats;
+    int64_t tx_stats_start;
     uint8_t hash_filter_cnt[KSZ8851_HASH_FILTER_TABLE_SIZE];
 } emac_ksz8851snl_t;
 
-typedef struct {
-    uint32_t copy_len;
-    uint32_t byte_cnt;
-} __attribute__((packed)) ksz8851_auto_buf_info_t;
-
 typedef enum {
     KSZ8851_SPI_COMMAND_READ_REG   = 0x0U,
     KSZ8851_SPI_COMMAND_WRITE_REG  = 0x1U,
@@ -77,6 +103,7 @@ static const unsigned KSZ8851_SPI_COMMAND_BITS    = 2U;
 static const unsigned KSZ8851_SPI_ADDR_SHIFT      = 2U;
 static const unsigned KSZ8851_SPI_BYTE_MASK_SHIFT = 8U + KSZ8851_SPI_ADDR_SHIFT;
 static const unsigned KSZ8851_SPI_LOCK_TIMEOUT_MS = 500U;
+static const EventBits_t KSZ8851_TX_SPACE_BIT      = BIT0; // set when the driver task takes over the queued frames
 
 static const uint16_t RXDTTR_INIT_VALUE  = 0x03E8U;
 static const uint16_t RXDBCTR_INIT_VALUE = 0x1000U;
@@ -108,6 +135,7 @@ static void *ksz8851_spi_init(const void *spi_config)
     // SPI device init
     ESP_GOTO_ON_FALSE(spi_bus_add_device(ksz8851snl_config->spi_host_id, ksz8851snl_config->spi_devcfg, &spi->hdl) == ESP_OK, NULL,
                       err, TAG, "adding device to SPI host #%i failed", ksz8851snl_config->spi_host_id + 1);
+    spi->queued_min_len = ksz8851snl_config->spi_queued_min_len;
     ret = spi;
     return ret;
 err:
@@ -147,7 +175,7 @@ static esp_err_t ksz8851_spi_read(void *spi_ctx, uint32_t cmd, uint32_t addr, vo
     }
 
     // No need for mutex here since SPI access is protected at higher layer of this driver
-    ESP_RETURN_ON_ERROR(spi_device_polling_transmit(spi->hdl, &trans.base), TAG, "spi transmit failed");
+    ESP_RETURN_ON_ERROR(eth_spi_transmit(spi->hdl, &trans.base, len, spi->queued_min_len), TAG, "spi transmit failed");
 
     if ((trans.base.flags & SPI_TRANS_USE_RXDATA) && len <= 4) {
         memcpy(value, trans.base.rx_data, len);  // copy register values to output
@@ -174,11 +202,83 @@ static esp_err_t ksz8851_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, c
     }
 
     // No need for mutex here since SPI access is protected at higher layer of this driver
-    ESP_RETURN_ON_ERROR(spi_device_polling_transmit(spi->hdl, &trans.base), TAG, "spi transmit failed");
+    ESP_RETURN_ON_ERROR(eth_spi_transmit(spi->hdl, &trans.base, len, spi->queued_min_len), TAG, "spi transmit failed");
 
     return ESP_OK;
 }
 
+/**
+ * @brief Read a frame from RXQ, the dummy bytes and frame header to `header`, the frame itself straight to `frame`
+ *
+ * Both parts are read in one SPI burst, CS is kept active in between.
+ */
+static esp_err_t ksz8851_spi_read_fifo(eth_spi_info_t *spi, void *header, uint32_t header_len, void *frame, uint32_t frame_len)
+{
+    esp_err_t ret = ESP_OK;
+    spi_transaction_ext_t header_trans = {
+        .base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY | SPI_TRANS_CS_KEEP_ACTIVE,
+        .base.cmd = KSZ8851_SPI_COMMAND_READ_FIFO,
+        .base.length = 8 * header_len,
+        .base.rx_buffer = header,
+        .command_bits = KSZ8851_SPI_COMMAND_BITS,
+        .address_bits = 8 - KSZ8851_SPI_COMMAND_BITS
+    };
+    spi_transaction_ext_t frame_trans = {
+        .base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY,
+        .base.length = 8 * frame_len,
+        .base.rx_buffer = frame
+    };
+
+    // CS can be kept active only while the bus is acquired
+    ESP_RETURN_ON_ERROR(spi_device_acquire_bus(spi->hdl, portMAX_DELAY), TAG, "acquire SPI bus failed");
+    ESP_GOTO_ON_ERROR(eth_spi_transmit(spi->hdl, &header_trans.base, header_len, spi->queued_min_len), err, TAG, "spi transmit failed");
+    ESP_GOTO_ON_ERROR(eth_spi_transmit(spi->hdl, &frame_trans.base, frame_len, spi->queued_min_len), err, TAG, "spi transmit failed");
+err:
+    spi_device_release_bus(spi->hdl);
+    return ret;
+}
+
+/**
+ * @brief Write a frame to TXQ, its control word from `header`, the frame itself straight from `frame`
+ *
+ * The control word, the frame and its padding to a multiple of 4 bytes are written in one SPI burst, CS is kept active
+ * in between.
+ */
+static esp_err_t ksz8851_spi_write_fifo(eth_spi_info_t *spi, const uint8_t *header, const void *frame, uint32_t frame_len)
+{
+    esp_err_t ret = ESP_OK;
+    uint32_t pad_len = KSZ8851_TX_FRAME_SIZE(frame_len) - 4U - frame_len;
+    spi_transaction_ext_t header_trans = {
+        .base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY | SPI_TRANS_USE_TXDATA | SPI_TRANS_CS_KEEP_ACTIVE,
+        .base.cmd = KSZ8851_SPI_COMMAND_WRITE_FIFO,
+        .base.length = 8 * 4U,
+        .command_bits = KSZ8851_SPI_COMMAND_BITS,
+        .address_bits = 8 - KSZ8851_SPI_COMMAND_BITS
+    };
+    memcpy(header_trans.base.tx_data, header, 4U);
+    spi_transaction_ext_t frame_trans = {
+        .base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY | (pad_len ? SPI_TRANS_CS_KEEP_ACTIVE : 0),
+        .base.length = 8 * frame_len,
+        .base.tx_buffer = frame
+    };
+    // padding is sent from the zeroed tx_data
+    spi_transaction_ext_t pad_trans = {
+        .base.flags = SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY | SPI_TRANS_USE_TXDATA,
+        .base.length = 8 * pad_len
+    };
+
+    // CS can be kept active only while the bus is acquired
+    ESP_RETURN_ON_ERROR(spi_device_acquire_bus(spi->hdl, portMAX_DELAY), TAG, "acquire SPI bus failed");
+    ESP_GOTO_ON_ERROR(eth_spi_transmit(spi->hdl, &header_trans.base, 4U, spi->queued_min_len), err, TAG, "spi transmit failed");
+    ESP_GOTO_ON_ERROR(eth_spi_transmit(spi->hdl, &frame_trans.base, frame_len, spi->queued_min_len), err, TAG, "spi transmit failed");
+    if (pad_len) {
+        ESP_GOTO_ON_ERROR(eth_spi_transmit(spi->hdl, &pad_trans.base, pad_len, spi->queued_min_len), err, TAG, "spi transmit failed");
+    }
+err:
+    spi_device_release_bus(spi->hdl);
+    return ret;
+}
+
 static inline bool ksz8851_mutex_lock(emac_ksz8851snl_t *emac)
 {
     return xSemaphoreTakeRecursive(emac->spi_lock, pdMS_TO_TICKS(KSZ8851_SPI_LOCK_TIMEOUT_MS)) == pdTRUE;
@@ -213,6 +313,29 @@ err:
     return ret;
 }
 
+static esp_err_t ksz8851_read_reg32(emac_ksz8851snl_t *emac, uint32_t reg_addr, uint32_t *value)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(value != NULL, ESP_ERR_INVALID_ARG, err, TAG, "out pointer must not be null");
+    ESP_GOTO_ON_FALSE((reg_addr & ~KSZ8851_VALID_ADDRESS_MASK) == 0U && (reg_addr & 0x3U) == 0U, ESP_ERR_INVALID_ARG, err, TAG,
+                      "address is out of bounds or not dword aligned");
+
+    // NOTE(v.chistyakov): select both words of the dword, the lower register ends up in the lower half
+    const unsigned byte_mask = 0xFU << KSZ8851_SPI_BYTE_MASK_SHIFT;
+    reg_addr <<= KSZ8851_SPI_ADDR_SHIFT;
+
+    if (ksz8851_mutex_lock(emac)) {
+        ret = emac->spi.read(emac->spi.ctx, KSZ8851_SPI_COMMAND_READ_REG, reg_addr | byte_mask, value, 4);
+    } else {
+        ret = ESP_ERR_TIMEOUT;
+    }
+    ksz8851_mutex_unlock(emac);
+    ESP_LOGV(TAG, "reading reg 0x%02" PRIx32 " = 0x%04" PRIx32, reg_addr, *value);
+
+err:
+    return ret;
+}
+
 static esp_err_t ksz8851_write_reg(emac_ksz8851snl_t *emac, uint32_t reg_addr, uint16_t value)
 {
     esp_err_t ret = ESP_OK;
@@ -269,6 +392,18 @@ err:
     return ret;
 }
 
+static void emac_ksz8851_del_rx_pipeline(emac_ksz8851snl_t *emac)
+{
+    // wait for the driver task to finish pushing frames, it does not receive once the pipeline is gone
+    xSemaphoreTake(emac->rx_lock, portMAX_DELAY);
+    eth_rx_pipeline_handle_t rx_pipeline = emac->rx_pipeline;
+    emac->rx_pipeline = NULL;
+    xSemaphoreGive(emac->rx_lock);
+    if (rx_pipeline) {
+        eth_rx_pipeline_del(rx_pipeline);
+    }
+}
+
 static esp_err_t init_soft_reset(emac_ksz8851snl_t *emac)
 {
     esp_err_t ret           = ESP_OK;
@@ -304,6 +439,7 @@ static esp_err_t init_set_defaults(emac_ksz8851snl_t *emac)
 {
     esp_err_t ret           = ESP_OK;
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_TXFDPR, TXFDPR_TXFPAI), err, TAG, "TXFDPR write failed");
+    // checksums are generated and checked as reported by ETH_OFFLOAD_CMD_G_CHECKSUM (KSZ8851_CHECKSUM_OFFLOAD)
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_TXCR,
                                        TXCR_TXFCE | TXCR_TXPE | TXCR_TXCE | TXCR_TCGICMP | TXCR_TCGIP | TXCR_TCGTCP), err, TAG, "TXCR write failed");
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_RXFDPR, RXFDPR_RXFPAI), err, TAG, "RXFDPR write failed");
@@ -315,11 +451,18 @@ static esp_err_t init_set_defaults(emac_ksz8851snl_t *emac)
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_RXCR2,
                                        (4 << RXCR2_SRDBL_SHIFT) | RXCR2_IUFFP | RXCR2_RXIUFCEZ | RXCR2_UDPLFE | RXCR2_RXICMPFCC), err, TAG, "RXCR2 write failed");
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_RXQCR, RXQCR_RXFCTE | RXQCR_ADRFE), err, TAG, "RXQCR write failed");
+    // RXQCR is written on every received frame, keep its value so it does not need to be read back
+    ESP_GOTO_ON_ERROR(ksz8851_read_reg(emac, KSZ8851_RXQCR, &emac->rxqcr), err, TAG, "RXQCR read failed");
+    emac->rxqcr &= ~(RXQCR_RXDTTS | RXQCR_RXDBCTS | RXQCR_RXFCTS | RXQCR_SDA | RXQCR_RRXEF);
     ESP_GOTO_ON_ERROR(ksz8851_clear_bits(emac, KSZ8851_P1CR, P1CR_FORCE_DUPLEX), err, TAG, "P1CR write failed");
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_P1CR, P1CR_RESTART_AN), err, TAG, "P1CR write failed");
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_ISR, ISR_ALL), err, TAG, "ISR write failed");
-    ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_IER, IER_TXIE | IER_RXIE | IER_LDIE | IER_SPIBEIE | IER_RXOIE), err, TAG, "IER write failed");
+    // queued frames wait for TXQ space to be signalled, frames written from transmit() fail when there is none
+    uint16_t ier = IER_RXIE | IER_LDIE | IER_SPIBEIE | IER_RXOIE | (emac->tx_queue_size ? IER_TXSAIE : 0);
+    ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_IER, ier), err, TAG, "IER write failed");
     ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_TXQCR, TXQCR_AETFE), err, TAG, "TXQCR write failed");
+    emac->tx_free = 0;
+    emac->tx_wait_space = false;
     memset(emac->hash_filter_cnt, 0, sizeof(emac->hash_filter_cnt));
     return ESP_OK;
 err:
@@ -331,6 +474,8 @@ static esp_err_t emac_ksz8851_init(esp_eth_mac_t *mac)
     esp_err_t ret           = ESP_OK;
     emac_ksz8851snl_t *emac = __containerof(mac, emac_ksz8851snl_t, parent);
     esp_eth_mediator_t *eth = emac->eth;
+    // received frames are delivered to the mediator through the pipeline
+    ESP_RETURN_ON_ERROR(eth_rx_pipeline_new(&emac->rx_pipeline_config, eth, &emac->rx_pipeline), TAG, "create RX pipeline failed");
     if (emac->int_gpio_num >= 0) {
         gpio_func_sel(emac->int_gpio_num, PIN_FUNC_GPIO);
         gpio_input_enable(emac->int_gpio_num);
@@ -357,6 +502,7 @@ err:
     if (emac->int_gpio_num >= 0) {
         gpio_isr_handler_remove(emac->int_gpio_num);
     }
+    emac_ksz8851_del_rx_pipeline(emac);
     eth->on_state_changed(eth, ETH_STATE_DEINIT, NULL);
     return ret;
 }
@@ -372,6 +518,7 @@ static esp_err_t emac_ksz8851_deinit(esp_eth_mac_t *mac)
     if (emac->poll_timer && esp_timer_is_active(emac->poll_timer)) {
         esp_timer_stop(emac->poll_timer);
     }
+    emac_ksz8851_del_rx_pipeline(emac);
     eth->on_state_changed(eth, ETH_STATE_DEINIT, NULL);
     ESP_LOGD(TAG, "MAC deinitialized");
     return ESP_OK;
@@ -399,96 +546,286 @@ err:
     return ret;
 }
 
-static esp_err_t emac_ksz8851snl_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_t length)
+/**
+ * @brief Fill in the control word which precedes a frame in TXQ
+ *
+ * TXIC is not requested, nothing waits for frames to be transmitted and an interrupt per frame would just wake the driver task.
+ */
+static void ksz8851_tx_frame_header(emac_ksz8851snl_t *emac, uint8_t *header, uint32_t length)
+{
+    header[0] = ++emac->tx_frame_id & TXSR_TXFID_MASK;
+    header[1] = 0x00U;
+    header[2] = length & 0xFFU;
+    header[3] = (length >> 8U) & 0xFFU;
+}
+
+/**
+ * @brief Check whether `size` bytes fit into TXQ, the caller holds the SPI lock
+ *
+ * The free space only grows while frames are transmitted, so TXMIR is read only when the space known to be free is not enough.
+ */
+static esp_err_t ksz8851_txq_space_check(emac_ksz8851snl_t *emac, uint32_t size, bool *fits)
+{
+    if (emac->tx_free < size) {
+        uint16_t txmir;
+        ESP_RETURN_ON_ERROR(ksz8851_read_reg(emac, KSZ8851_TXMIR, &txmir), TAG, "TXMIR read failed");
+        emac->tx_free = txmir & TXMIR_TXMA_MASK;
+    }
+    *fits = emac->tx_free >= size;
+    return ESP_OK;
+}
+
+/**
+ * @brief Write to TXQ in one DMA access window, the caller holds the SPI lock
+ *
+ * Without `header`, `data` holds `frames` frames preceded by their control words, `size` bytes in total. With `header`,
+ * `data` is a single frame of `size` bytes and `header` its control word, they are written without being copied together.
+ */
+static esp_err_t ksz8851_txq_write(emac_ksz8851snl_t *emac, const uint8_t *header, const uint8_t *data, uint32_t size, uint32_t frames)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_RXQCR, emac->rxqcr | RXQCR_SDA), TAG, "RXQCR write failed");
+    if (header) {
+        ret = ksz8851_spi_write_fifo(emac->spi.ctx, header, data, size);
+        size = KSZ8851_TX_FRAME_SIZE(size);
+    } else {
+        ret = emac->spi.write(emac->spi.ctx, KSZ8851_SPI_COMMAND_WRITE_FIFO, 0, data, size);
+    }
+    // registers are not accessible until SDA is cleared, so clear it even if the write failed
+    ESP_RETURN_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_RXQCR, emac->rxqcr), TAG, "RXQCR write failed");
+    ESP_RETURN_ON_ERROR(ret, TAG, "TXQ write failed");
+    emac->tx_free -= size;
+    portENTER_CRITICAL(&emac->tx_stats_lock);
+    emac->tx_stats.frames += frames;
+    emac->tx_stats.batches++;
+    portEXIT_CRITICAL(&emac->tx_stats_lock);
+    return ESP_OK;
+}
+
+/**
+ * @brief Append a frame to the transmit queue, the driver task writes it to TXQ
+ *
+ * Waits for the driver task to take over the queued frames when there is no space left. The space is signalled by an
+ * event bit rather than a semaphore, so that it wakes all the waiting transmitters and not just one of them.
+ */
+static esp_err_t ksz8851_tx_enqueue(emac_ksz8851snl_t *emac, const uint8_t *buf, uint32_t length)
+{
+    uint32_t size = KSZ8851_TX_FRAME_SIZE(length);
+    bool waited = false;
+    while (true) {
+        ESP_RETURN_ON_FALSE(xSemaphoreTake(emac->tx_lock, pdMS_TO_TICKS(KSZ8851_SPI_LOCK_TIMEOUT_MS)) == pdTRUE,
+                            ESP_ERR_TIMEOUT, TAG, "transmit queue lock timeout");
+        uint8_t fill = emac->tx_fill;
+        bool queued = emac->tx_stage_len[fill] + size <= emac->tx_queue_size;
+        if (queued) {
+            uint8_t *frame = emac->tx_stage[fill] + emac->tx_stage_len[fill];
+            ksz8851_tx_frame_header(emac, frame, length);
+            memcpy(frame + 4U, buf, length);
+            emac->tx_stage_len[fill] += size;
+        } else {
+            // cleared under the lock, the bit set by a take over which happens after this can't be missed
+            xEventGroupClearBits(emac->tx_space_evt, KSZ8851_TX_SPACE_BIT);
+        }
+        xSemaphoreGive(emac->tx_lock);
+        xTaskNotifyGive(emac->rx_task_hdl);
+        if (queued) {
+            return ESP_OK;
+        }
+        if (!waited) {
+            waited = true;
+            portENTER_CRITICAL(&emac->tx_stats_lock);
+            emac->tx_stats.queue_full_cnt++;
+            portEXIT_CRITICAL(&emac->tx_stats_lock);
+        }
+        EventBits_t bits = xEventGroupWaitBits(emac->tx_space_evt, KSZ8851_TX_SPACE_BIT, pdFALSE, pdTRUE,
+                                               pdMS_TO_TICKS(KSZ8851_SPI_LOCK_TIMEOUT_MS));
+        ESP_RETURN_ON_FALSE(bits & KSZ8851_TX_SPACE_BIT, ESP_FAIL, TAG, "transmit queue full");
+    }
+}
+
+/**
+ * @brief Length of the leading frames of `data` which fit into `space` bytes
+ */
+static uint32_t ksz8851_tx_frames_fit(const uint8_t *data, uint32_t len, uint32_t space, uint32_t *frames)
 {
-    static unsigned s_frame_id = 0U;
+    uint32_t size = 0;
+    *frames = 0;
+    while (size < len) {
+        uint32_t frame_size = KSZ8851_TX_FRAME_SIZE(data[size + 2] | (data[size + 3] << 8U));
+        if (size + frame_size > space) {
+            break;
+        }
+        size += frame_size;
+        (*frames)++;
+    }
+    return size;
+}
 
+/**
+ * @brief Write frames queued by transmit() to TXQ, called from the driver task
+ *
+ * One buffer is filled by transmit() while the other one is written to TXQ, as many frames at once as TXQ has space for.
+ * When not even the next frame fits, KSZ8851 is asked to signal TXSAIS once it does.
+ */
+static void ksz8851_tx_flush(emac_ksz8851snl_t *emac)
+{
+    if (emac->tx_queue_size == 0 || emac->tx_wait_space) {
+        return;
+    }
+    if (!ksz8851_mutex_lock(emac)) {
+        ESP_LOGE(TAG, "SPI lock timeout");
+        return;
+    }
+    while (true) {
+        uint8_t flush = emac->tx_fill ^ 1U;
+        if (emac->tx_flush_pos == emac->tx_stage_len[flush]) {
+            // everything is written, take over the frames queued meanwhile
+            bool swapped = false;
+            xSemaphoreTake(emac->tx_lock, portMAX_DELAY);
+            if (emac->tx_stage_len[emac->tx_fill]) {
+                emac->tx_stage_len[flush] = 0;
+                emac->tx_fill = flush;
+                emac->tx_flush_pos = 0;
+                swapped = true;
+            }
+            xSemaphoreGive(emac->tx_lock);
+            if (!swapped) {
+                break;
+            }
+            xEventGroupSetBits(emac->tx_space_evt, KSZ8851_TX_SPACE_BIT);
+            continue;
+        }
+        const uint8_t *data = emac->tx_stage[flush] + emac->tx_flush_pos;
+        uint32_t remaining = emac->tx_stage_len[flush] - emac->tx_flush_pos;
+        uint32_t frames;
+        uint32_t size = ksz8851_tx_frames_fit(data, remaining, emac->tx_free, &frames);
+        if (size < remaining) {
+            uint16_t txmir;
+            if (ksz8851_read_reg(emac, KSZ8851_TXMIR, &txmir) != ESP_OK) {
+                ESP_LOGE(TAG, "TXMIR read failed");
+                break;
+            }
+            emac->tx_free = txmir & TXMIR_TXMA_MASK;
+            size = ksz8851_tx_frames_fit(data, remaining, emac->tx_free, &frames);
+        }
+        if (size == 0) {
+            uint32_t next_size = KSZ8851_TX_FRAME_SIZE(data[2] | (data[3] << 8U));
+            if (ksz8851_write_reg(emac, KSZ8851_TXNTFSR, next_size) != ESP_OK ||
+                    ksz8851_write_reg(emac, KSZ8851_TXQCR, TXQCR_AETFE | TXQCR_TXQMAM) != ESP_OK) {
+                ESP_LOGE(TAG, "TXQ space monitor setup failed");
+                break;
+            }
+            emac->tx_wait_space = true;
+            portENTER_CRITICAL(&emac->tx_stats_lock);
+            emac->tx_stats.txq_full_cnt++;
+            portEXIT_CRITICAL(&emac->tx_stats_lock);
+            break;
+        }
+        if (ksz8851_txq_write(emac, NULL, data, size, frames) != ESP_OK) {
+            // state of TXQ is unknown, drop the rest of the buffer rather than risk sending frames twice
+            ESP_LOGE(TAG, "dropped %" PRIu32 " bytes of queued frames", remaining);
+            emac->tx_free = 0;
+            emac->tx_flush_pos = emac->tx_stage_len[flush];
+            continue;
+        }
+        emac->tx_flush_pos += size;
+    }
+    ksz8851_mutex_unlock(emac);
+}
+
+static esp_err_t emac_ksz8851snl_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_t length)
+{
     ESP_LOGV(TAG, "transmitting frame of size %" PRIu32, length);
     esp_err_t ret           = ESP_OK;
     emac_ksz8851snl_t *emac = __containerof(mac, emac_ksz8851snl_t, parent);
+    ESP_RETURN_ON_FALSE(length <= KSZ8851_QMU_PACKET_LENGTH, ESP_ERR_INVALID_ARG,
+                        TAG, "frame size is too big (actual %" PRIu32 ", maximum %d)", length, KSZ8851_QMU_PACKET_LENGTH);
+    if (emac->tx_queue_size) {
+        return ksz8851_tx_enqueue(emac, buf, length);
+    }
+
     // Lock SPI since once `SDA Start DMA Access` bit is set, all registers access are disabled.
     if (!ksz8851_mutex_lock(emac)) {
         return ESP_ERR_TIMEOUT;
     }
-
-    ESP_GOTO_ON_FALSE(length <= KSZ8851_QMU_PACKET_LENGTH, ESP_ERR_INVALID_ARG, err,
-                      TAG, "frame size is too big (actual %" PRIu32 ", maximum %d)", length, ETH_MAX_PACKET_SIZE);
-    // NOTE(v.chistyakov): 4 bytes header + length aligned to 4 bytes
-    unsigned transmit_length = 4U + ((length + 3U) & ~0x3U);
-
-    uint16_t free_space;
-    ESP_GOTO_ON_ERROR(ksz8851_read_reg(emac, KSZ8851_TXMIR, &free_space), err, TAG, "TXMIR read failed");
-    ESP_GOTO_ON_FALSE(transmit_length <= free_space, ESP_FAIL, err, TAG, "TXQ free space (%" PRIu16 ") < send length (%" PRIu16 ")", free_space,
+    uint32_t transmit_length = KSZ8851_TX_FRAME_SIZE(length);
+    bool fits;
+    ESP_GOTO_ON_ERROR(ksz8851_txq_space_check(emac, transmit_length, &fits), err, TAG, "TXQ space check failed");
+    if (!fits) {
+        portENTER_CRITICAL(&emac->tx_stats_lock);
+        emac->tx_stats.txq_full_cnt++;
+        portEXIT_CRITICAL(&emac->tx_stats_lock);
+    }
+    ESP_GOTO_ON_FALSE(fits, ESP_FAIL, err, TAG, "TXQ free space (%" PRIu16 ") < send length (%" PRIu32 ")", emac->tx_free,
                       transmit_length);
 
-    emac->tx_buffer[0] = ++s_frame_id & TXSR_TXFID_MASK;
-    emac->tx_buffer[1] = 0x80U;
-    emac->tx_buffer[2] = length & 0xFFU;
-    emac->tx_buffer[3] = (length >> 8U) & 0xFFU;
-    memcpy(emac->tx_buffer + 4U, buf, length);
-
-    uint16_t ier;
-    ESP_GOTO_ON_ERROR(ksz8851_read_reg(emac, KSZ8851_IER, &ier), err, TAG, "IER read failed");
-    ESP_GOTO_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_IER, 0), err, TAG, "IER write failed");
-
-    ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_RXQCR, RXQCR_SDA), err, TAG, "RXQCR write failed");
-    ret = emac->spi.write(emac->spi.ctx, KSZ8851_SPI_COMMAND_WRITE_FIFO, 0, emac->tx_buffer, transmit_length);
-    ESP_GOTO_ON_ERROR(ksz8851_clear_bits(emac, KSZ8851_RXQCR, RXQCR_SDA), err, TAG, "RXQCR write failed");
-
-    ESP_GOTO_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_IER, ier), err, TAG, "IER write failed");
+    if (emac->spi.write == ksz8851_spi_write) {
+        // the frame is written straight from the caller's buffer
+        uint8_t header[4];
+        ksz8851_tx_frame_header(emac, header, length);
+        ESP_GOTO_ON_ERROR(ksz8851_txq_write(emac, header, buf, length, 1), err, TAG, "frame write failed");
+    } else {
+        // custom SPI drivers take the control word and the frame in one buffer
+        ksz8851_tx_frame_header(emac, emac->tx_buffer, length);
+        memcpy(emac->tx_buffer + 4U, buf, length);
+        ESP_GOTO_ON_ERROR(ksz8851_txq_write(emac, NULL, emac->tx_buffer, transmit_length, 1), err, TAG, "frame write failed");
+    }
 err:
     ksz8851_mutex_unlock(emac);
     return ret;
 }
 
+static esp_err_t emac_ksz8851_release_frame(emac_ksz8851snl_t *emac)
+{
+    // NOTE(v.chistyakov): RRXEF is a self-clearing bit
+    return ksz8851_write_reg(emac, KSZ8851_RXQCR, emac->rxqcr | RXQCR_RRXEF);
+}
+
 static esp_err_t emac_ksz8851_get_recv_byte_count(emac_ksz8851snl_t *emac, uint16_t *size)
 {
     esp_err_t ret = ESP_OK;
     *size = 0;
-    uint16_t header_status;
-    ESP_GOTO_ON_ERROR(ksz8851_read_reg(emac, KSZ8851_RXFHSR, &header_status), err, TAG, "RXFHSR read failed");
-    uint16_t byte_count;
-    ESP_GOTO_ON_ERROR(ksz8851_read_reg(emac, KSZ8851_RXFHBCR, &byte_count), err, TAG, "RXFHBCR read failed");
-    if (header_status & RXFHSR_RXFV) {
+    // RXFHSR and RXFHBCR share a dword, so the frame header is fetched by a single register access
+    uint32_t header;
+    ESP_GOTO_ON_ERROR(ksz8851_read_reg32(emac, KSZ8851_RXFHSR, &header), err, TAG, "RXFHSR/RXFHBCR read failed");
+    uint16_t header_status = header & 0xFFFFU;
+    uint16_t byte_count = header >> 16U;
+    // frames failing checksum checks are dropped even if marked valid, the stack relies on the checks being done
+    if (header_status & (RXFHSR_RXCE | RXFHSR_RXRF | RXFHSR_RXFTL | RXFHSR_RXMR | RXFHSR_RXUDPFCS | RXFHSR_RXTCPFCS |
+                         RXFHSR_RXIPFCS | RXFHSR_RXICMPFCS)) {
+        ESP_LOGD(TAG, "dropped received frame, status 0x%04" PRIx16, header_status);
+        ESP_GOTO_ON_ERROR(emac_ksz8851_release_frame(emac), err, TAG, "RXQCR write failed");
+    } else if (header_status & RXFHSR_RXFV) {
         *size = byte_count & RXFHBCR_RXBC_MASK;
-    } else if (header_status & (RXFHSR_RXCE | RXFHSR_RXRF | RXFHSR_RXFTL | RXFHSR_RXMR | RXFHSR_RXUDPFCS | RXFHSR_RXTCPFCS |
-                                RXFHSR_RXIPFCS | RXFHSR_RXICMPFCS)) {
-        // NOTE(v.chistyakov): RRXEF is a self-clearing bit
-        ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_RXQCR, RXQCR_RRXEF), err, TAG, "RXQCR write failed");
     }
 err:
     return ret;
 }
 
-static esp_err_t emac_ksz8851_alloc_recv_buf(emac_ksz8851snl_t *emac, uint8_t **buf, uint32_t *length)
+/**
+ * @brief Read the frame at the head of RXQ, the caller holds the SPI lock
+ *
+ * With the default SPI driver and `buf_size` of at least KSZ8851_RX_FRAME_SIZE(byte_count), the frame is read straight
+ * to `buf`, the CRC and alignment padding included. Otherwise, it is read to the driver buffer and `copy_len` bytes of it
+ * are copied to `buf`.
+ */
+static esp_err_t emac_ksz8851_read_frame(emac_ksz8851snl_t *emac, uint8_t *buf, uint32_t buf_size, uint16_t byte_count, uint16_t copy_len)
 {
     esp_err_t ret = ESP_OK;
-    uint16_t rx_len = 0;
-    uint16_t byte_count;
-    *buf = NULL;
-
-    ESP_GOTO_ON_ERROR(emac_ksz8851_get_recv_byte_count(emac, &byte_count), err, TAG, "get receive frame byte count failed");
-    // silently return when no frame is waiting
-    if (!byte_count) {
-        goto err;
-    }
-    // do not include 4 bytes CRC at the end
-    rx_len = byte_count - ETH_CRC_LEN;
-    // frames larger than expected will be truncated
-    uint16_t copy_len = rx_len > *length ? *length : rx_len;
-    // runt frames are not forwarded, but check the length anyway since it could be corrupted at SPI bus
-    ESP_GOTO_ON_FALSE(copy_len >= ETH_MIN_PACKET_SIZE - ETH_CRC_LEN, ESP_ERR_INVALID_SIZE, err, TAG, "invalid frame length %" PRIu16, copy_len);
-    *buf = malloc(copy_len);
-    if (*buf != NULL) {
-        ksz8851_auto_buf_info_t *buff_info = (ksz8851_auto_buf_info_t *)*buf;
-        buff_info->copy_len = copy_len;
-        buff_info->byte_cnt = byte_count;
+    const uint32_t frame_size = KSZ8851_RX_FRAME_SIZE(byte_count);
+    const bool direct = emac->spi.read == ksz8851_spi_read && buf_size >= frame_size;
+    // registers are written directly, reading them back first would double the register traffic of every frame
+    ESP_RETURN_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_RXFDPR, RXFDPR_RXFPAI), TAG, "RXFDPR write failed");
+    ESP_RETURN_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_RXQCR, emac->rxqcr | RXQCR_SDA), TAG, "RXQCR write failed");
+    if (direct) {
+        ret = ksz8851_spi_read_fifo(emac->spi.ctx, emac->rx_buffer, KSZ8851_RX_HEADER_SIZE, buf, frame_size);
     } else {
-        ret = ESP_ERR_NO_MEM;
-        goto err;
+        ret = emac->spi.read(emac->spi.ctx, KSZ8851_SPI_COMMAND_READ_FIFO, 0, emac->rx_buffer, KSZ8851_RX_HEADER_SIZE + frame_size);
+    }
+    ESP_RETURN_ON_ERROR(ksz8851_write_reg(emac, KSZ8851_RXQCR, emac->rxqcr), TAG, "RXQCR write failed");
+    if (!direct) {
+        memcpy(buf, emac->rx_buffer + KSZ8851_RX_HEADER_SIZE, copy_len);
     }
-err:
-    *length = rx_len;
     return ret;
 }
 
@@ -497,45 +834,32 @@ static esp_err_t emac_ksz8851_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t
     esp_err_t ret           = ESP_OK;
     emac_ksz8851snl_t *emac = __containerof(mac, emac_ksz8851snl_t, parent);
     uint16_t copy_len       = 0;
-    uint16_t rx_len;
     uint16_t byte_count;
 
-    ESP_GOTO_ON_FALSE(buf, ESP_ERR_INVALID_ARG, err, TAG, "receive buffer can not be null");
-    ESP_GOTO_ON_FALSE(length, ESP_ERR_INVALID_ARG, err, TAG, "receive buffer length can not be null");
-    if (*length != KSZ8851_ETH_MAC_RX_BUF_SIZE_AUTO) {
-        ESP_GOTO_ON_ERROR(emac_ksz8851_get_recv_byte_count(emac, &byte_count), err, TAG, "get receive frame byte count failed");
-        // silently return when no frame is waiting
-        if (!byte_count) {
-            goto err;
-        }
-        // do not include 4 bytes CRC at the end
-        rx_len = byte_count - ETH_CRC_LEN;
-        // frames larger than expected will be truncated
-        copy_len = rx_len > *length ? *length : rx_len;
-    } else {
-        ksz8851_auto_buf_info_t *buff_info = (ksz8851_auto_buf_info_t *)buf;
-        copy_len = buff_info->copy_len;
-        byte_count = buff_info->byte_cnt;
-    }
-
-    // NOTE(v.chistyakov): 4 dummy + 4 header + alignment
-    const unsigned receive_size = 8U + ((byte_count + 3U) & ~0x3U);
+    ESP_RETURN_ON_FALSE(buf, ESP_ERR_INVALID_ARG, TAG, "receive buffer can not be null");
+    ESP_RETURN_ON_FALSE(length, ESP_ERR_INVALID_ARG, TAG, "receive buffer length can not be null");
     // Lock SPI since once `SDA Start DMA Access` bit is set, all registers access are disabled.
     if (!ksz8851_mutex_lock(emac)) {
+        *length = 0U;
         return ESP_ERR_TIMEOUT;
     }
-    ESP_GOTO_ON_ERROR(ksz8851_clear_bits(emac, KSZ8851_RXFDPR, RXFDPR_RXFP_MASK), err, TAG, "RXFDPR write failed");
-    ESP_GOTO_ON_ERROR(ksz8851_set_bits(emac, KSZ8851_RXQCR, RXQCR_SDA), err, TAG, "RXQCR write failed");
-    ret = emac->spi.read(emac->spi.ctx, KSZ8851_SPI_COMMAND_READ_FIFO, 0, emac->rx_buffer, receive_size);
-    ESP_GOTO_ON_ERROR(ksz8851_clear_bits(emac, KSZ8851_RXQCR, RXQCR_SDA), err, TAG, "RXQCR write failed");
+    ESP_GOTO_ON_ERROR(emac_ksz8851_get_recv_byte_count(emac, &byte_count), err, TAG, "get receive frame byte count failed");
+    if (byte_count <= ETH_CRC_LEN || byte_count > ETH_MAX_PACKET_SIZE) {
+        // silently return when no frame is waiting, drop the frame when the length is invalid
+        if (byte_count) {
+            ESP_LOGE(TAG, "invalid frame length %" PRIu16, byte_count);
+            emac_ksz8851_release_frame(emac);
+        }
+    } else {
+        // do not include 4 bytes CRC at the end, frames larger than expected will be truncated
+        uint16_t rx_len = byte_count - ETH_CRC_LEN;
+        copy_len = rx_len > *length ? *length : rx_len;
+        ESP_GOTO_ON_ERROR(emac_ksz8851_read_frame(emac, buf, *length, byte_count, copy_len), err, TAG, "frame read failed");
+    }
+err:
     ksz8851_mutex_unlock(emac);
-    // NOTE(v.chistyakov): skip 4 dummy, 4 header
-    memcpy(buf, emac->rx_buffer + 8U, copy_len);
     *length = copy_len;
     return ret;
-err:
-    *length = 0U;
-    return ret;
 }
 
 static esp_err_t emac_ksz8851_flush_recv_queue(emac_ksz8851snl_t *emac)
@@ -549,6 +873,73 @@ err:
     return ret;
 }
 
+/**
+ * @brief Read up to KSZ8851_RX_BATCH_MAX frames from RXQ and pass them to the stack
+ *
+ * The SPI lock is taken once for the whole batch, frames are handed over only after it is released,
+ * so the stack may transmit from the delivery path without waiting for the lock.
+ *
+ * @return number of frames which are still waiting in RXQ
+ */
+static uint16_t emac_ksz8851_receive_batch(emac_ksz8851snl_t *emac, uint16_t frame_count)
+{
+    uint8_t *frames[KSZ8851_RX_BATCH_MAX];
+    uint32_t frame_lens[KSZ8851_RX_BATCH_MAX];
+    unsigned read_cnt = 0;
+
+    if (!ksz8851_mutex_lock(emac)) {
+        ESP_LOGE(TAG, "SPI lock timeout");
+        return 0;
+    }
+    while (frame_count && read_cnt < KSZ8851_RX_BATCH_MAX) {
+        frame_count--;
+        uint16_t byte_count;
+        if (emac_ksz8851_get_recv_byte_count(emac, &byte_count) != ESP_OK) {
+            ESP_LOGE(TAG, "get receive frame byte count failed");
+            emac_ksz8851_flush_recv_queue(emac);
+            frame_count = 0;
+            break;
+        }
+        // frame with errors was already released
+        if (byte_count == 0) {
+            continue;
+        }
+        if (byte_count <= ETH_CRC_LEN || byte_count > ETH_MAX_PACKET_SIZE) {
+            ESP_LOGE(TAG, "invalid frame length %" PRIu16, byte_count);
+            emac_ksz8851_release_frame(emac);
+            continue;
+        }
+        // do not include 4 bytes CRC at the end, the buffer has room for it so the frame can be read straight to it
+        uint32_t rx_len = byte_count - ETH_CRC_LEN;
+        uint32_t buffer_size = KSZ8851_RX_FRAME_SIZE(byte_count);
+        uint8_t *buffer = eth_rx_pool_alloc(emac->rx_pool, buffer_size);
+        if (buffer == NULL) {
+            // drop just this frame, the following ones may still fit
+            ESP_LOGE(TAG, "no mem for receive buffer");
+            emac_ksz8851_release_frame(emac);
+            continue;
+        }
+        if (emac_ksz8851_read_frame(emac, buffer, buffer_size, byte_count, rx_len) != ESP_OK) {
+            ESP_LOGE(TAG, "frame read from module failed");
+            emac_ksz8851_flush_recv_queue(emac);
+            eth_rx_pool_free(buffer);
+            frame_count = 0;
+            break;
+        }
+        frames[read_cnt] = buffer;
+        frame_lens[read_cnt] = rx_len;
+        read_cnt++;
+    }
+    ksz8851_mutex_unlock(emac);
+
+    for (unsigned i = 0; i < read_cnt; i++) {
+        ESP_LOGD(TAG, "receive len=%" PRIu32, frame_lens[i]);
+        /* pass the buffer to stack (e.g. TCP/IP layer), possibly while the next frame is read */
+        eth_rx_pipeline_push(emac->rx_pipeline, frames[i], frame_lens[i]);
+    }
+    return frame_count;
+}
+
 static esp_err_t emac_ksz8851_read_phy_reg(esp_eth_mac_t *mac, uint32_t phy_addr, uint32_t phy_reg, uint32_t *reg_value)
 {
     esp_err_t ret           = ESP_OK;
@@ -788,13 +1179,18 @@ static esp_err_t emac_ksz8851_set_peer_pause_ability(esp_eth_mac_t *mac, uint32_
 static void emac_ksz8851snl_task(void *arg)
 {
     emac_ksz8851snl_t *emac = (emac_ksz8851snl_t *)arg;
-    esp_err_t ret;
     while (1) {
         if (emac->int_gpio_num >= 0) {                                   // if in interrupt mode
             if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(1000)) == 0 &&   // if no notification ...
                     gpio_get_level(emac->int_gpio_num) != 0) {               // ...and no interrupt asserted
+                emac->tx_wait_space = false;                             // -> look at TXQ space again in case TXSAIS was missed
+                ksz8851_tx_flush(emac);
                 continue;                                                // -> just continue to check again
             }
+            if (gpio_get_level(emac->int_gpio_num) != 0) {               // woken up by transmit() only
+                ksz8851_tx_flush(emac);
+                continue;
+            }
         } else {
             ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         }
@@ -803,9 +1199,6 @@ static void emac_ksz8851snl_task(void *arg)
         ksz8851_read_reg(emac, KSZ8851_ISR, &interrupt_status);
         ksz8851_write_reg(emac, KSZ8851_ISR, interrupt_status);
 
-        if (interrupt_status & ISR_TXIS) {
-            ESP_LOGD(TAG, "TX Interrupt");
-        }
         if (interrupt_status & ISR_RXOIS) {
             ESP_LOGD(TAG, "RX Overrun Interrupt");
         }
@@ -817,6 +1210,7 @@ static void emac_ksz8851snl_task(void *arg)
         }
         if (interrupt_status & ISR_TXSAIS) {
             ESP_LOGD(TAG, "TX Space Available Interrupt");
+            emac->tx_wait_space = false;
         }
         if (interrupt_status & ISR_RXWFDIS) {
             ESP_LOGD(TAG, "RX Wakeup Frame Detect Interrupt");
@@ -841,51 +1235,68 @@ static void emac_ksz8851snl_task(void *arg)
             ksz8851_read_reg(emac, KSZ8851_IER, &ier);
             ksz8851_write_reg(emac, KSZ8851_IER, 0);
 
-            uint16_t frame_count = 0;
-            ksz8851_read_reg(emac, KSZ8851_RXFCTR, &frame_count);
-            frame_count = (frame_count & RXFCTR_RXFC_MASK) >> RXFCTR_RXFC_SHIFT;
-
-            while (frame_count--) {
-                /* define max expected frame len */
-                uint32_t frame_len = ETH_MAX_PACKET_SIZE;
-                uint8_t *buffer;
-                if ((ret = emac_ksz8851_alloc_recv_buf(emac, &buffer, &frame_len)) == ESP_OK) {
-                    if (buffer != NULL) {
-                        /* we have memory to receive the frame of maximal size previously defined */
-                        uint32_t buf_len = KSZ8851_ETH_MAC_RX_BUF_SIZE_AUTO;
-                        if (emac->parent.receive(&emac->parent, buffer, &buf_len) == ESP_OK) {
-                            if (buf_len == 0) {
-                                emac_ksz8851_flush_recv_queue(emac);
-                                free(buffer);
-                            } else if (frame_len > buf_len) {
-                                ESP_LOGE(TAG, "received frame was truncated");
-                                free(buffer);
-                            } else {
-                                ESP_LOGD(TAG, "receive len=%" PRIu32, buf_len);
-                                /* pass the buffer to stack (e.g. TCP/IP layer) */
-                                emac->eth->stack_input(emac->eth, buffer, buf_len);
-                            }
-                        } else {
-                            ESP_LOGE(TAG, "frame read from module failed");
-                            emac_ksz8851_flush_recv_queue(emac);
-                            free(buffer);
-                        }
-                    } else if (frame_len) {
-                        ESP_LOGE(TAG, "invalid combination of frame_len(%" PRIu32 ") and buffer pointer(%p)", frame_len, buffer);
-                    }
-                } else if (ret == ESP_ERR_NO_MEM) {
-                    ESP_LOGE(TAG, "no mem for receive buffer");
-                    emac_ksz8851_flush_recv_queue(emac);
-                } else {
-                    ESP_LOGE(TAG, "unexpected error 0x%x", ret);
+            // frames are received between init() and deinit() only, while the pipeline exists
+            xSemaphoreTake(emac->rx_lock, portMAX_DELAY);
+            if (emac->rx_pipeline) {
+                uint16_t frame_count = 0;
+                ksz8851_read_reg(emac, KSZ8851_RXFCTR, &frame_count);
+                frame_count = (frame_count & RXFCTR_RXFC_MASK) >> RXFCTR_RXFC_SHIFT;
+
+                while (frame_count) {
+                    frame_count = emac_ksz8851_receive_batch(emac, frame_count);
                 }
             }
+            xSemaphoreGive(emac->rx_lock);
             ksz8851_write_reg(emac, KSZ8851_IER, ier);
         }
+        ksz8851_tx_flush(emac);
     }
     vTaskDelete(NULL);
 }
 
+static esp_err_t emac_ksz8851_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *data)
+{
+    emac_ksz8851snl_t *emac = __containerof(mac, emac_ksz8851snl_t, parent);
+
+    switch (cmd) {
+    case ETH_MAC_KSZ8851_CMD_G_RX_STATS:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "receive statistics get invalid argument, can't be NULL");
+        ESP_RETURN_ON_FALSE(emac->rx_pipeline, ESP_ERR_INVALID_STATE, TAG, "MAC is not initialized");
+        ESP_RETURN_ON_ERROR(eth_rx_pipeline_get_stats(emac->rx_pipeline, (eth_rx_pipeline_stats_t *)data), TAG, "get receive statistics failed");
+        break;
+    case ETH_MAC_KSZ8851_CMD_CLR_RX_STATS:
+        ESP_RETURN_ON_FALSE(emac->rx_pipeline, ESP_ERR_INVALID_STATE, TAG, "MAC is not initialized");
+        ESP_RETURN_ON_ERROR(eth_rx_pipeline_clear_stats(emac->rx_pipeline), TAG, "reset receive statistics failed");
+        break;
+    case ETH_MAC_KSZ8851_CMD_G_TX_STATS: {
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "transmit statistics get invalid argument, can't be NULL");
+        eth_ksz8851_tx_stats_t *stats = (eth_ksz8851_tx_stats_t *)data;
+        int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL(&emac->tx_stats_lock);
+        int64_t elapsed_us = now - emac->tx_stats_start;
+        *stats = emac->tx_stats;
+        portEXIT_CRITICAL(&emac->tx_stats_lock);
+        stats->frames_per_sec = elapsed_us > 0 ? (uint32_t)((uint64_t)stats->frames * 1000000 / elapsed_us) : 0;
+        break;
+    }
+    case ETH_MAC_KSZ8851_CMD_CLR_TX_STATS: {
+        int64_t now = esp_timer_get_time();
+        portENTER_CRITICAL(&emac->tx_stats_lock);
+        memset(&emac->tx_stats, 0, sizeof(emac->tx_stats));
+        emac->tx_stats_start = now;
+        portEXIT_CRITICAL(&emac->tx_stats_lock);
+        break;
+    }
+    case ETH_OFFLOAD_CMD_G_CHECKSUM:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "checksum offload get invalid argument, can't be NULL");
+        *(uint32_t *)data = KSZ8851_CHECKSUM_OFFLOAD;
+        break;
+    default:
+        ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_ARG, TAG, "unknown io command: %i", cmd);
+    }
+    return ESP_OK;
+}
+
 static esp_err_t emac_ksz8851_del(esp_eth_mac_t *mac)
 {
     emac_ksz8851snl_t *emac = __containerof(mac, emac_ksz8851snl_t, parent);
@@ -893,10 +1304,20 @@ static esp_err_t emac_ksz8851_del(esp_eth_mac_t *mac)
         esp_timer_delete(emac->poll_timer);
     }
     vTaskDelete(emac->rx_task_hdl);
+    if (emac->rx_pipeline) {
+        eth_rx_pipeline_del(emac->rx_pipeline);
+    }
     emac->spi.deinit(emac->spi.ctx);
     vSemaphoreDelete(emac->spi_lock);
+    vSemaphoreDelete(emac->rx_lock);
+    if (emac->tx_lock) {
+        vSemaphoreDelete(emac->tx_lock);
+        vEventGroupDelete(emac->tx_space_evt);
+    }
     heap_caps_free(emac->rx_buffer);
     heap_caps_free(emac->tx_buffer);
+    heap_caps_free(emac->tx_stage[0]);
+    heap_caps_free(emac->tx_stage[1]);
     free(emac);
     return ESP_OK;
 }
@@ -909,6 +1330,9 @@ esp_eth_mac_t *esp_eth_mac_new_ksz8851snl(const eth_ksz8851snl_config_t *ksz8851
 
     ESP_GOTO_ON_FALSE(ksz8851snl_config && mac_config, NULL, err, TAG, "arguments can not be null");
     ESP_GOTO_ON_FALSE((ksz8851snl_config->int_gpio_num >= 0) != (ksz8851snl_config->poll_period_ms > 0), NULL, err, TAG, "invalid configuration argument combination");
+    ESP_GOTO_ON_FALSE(ksz8851snl_config->tx_queue_size == 0 ||
+                      ksz8851snl_config->tx_queue_size >= KSZ8851_TX_FRAME_SIZE(KSZ8851_QMU_PACKET_LENGTH), NULL, err, TAG,
+                      "transmit queue must fit the longest frame");
 
     emac = calloc(1, sizeof(emac_ksz8851snl_t));
     ESP_GOTO_ON_FALSE(emac, NULL, err, TAG, "no mem for MAC instance");
@@ -916,6 +1340,8 @@ esp_eth_mac_t *esp_eth_mac_new_ksz8851snl(const eth_ksz8851snl_config_t *ksz8851
     emac->sw_reset_timeout_ms           = mac_config->sw_reset_timeout_ms;
     emac->int_gpio_num                  = ksz8851snl_config->int_gpio_num;
     emac->poll_period_ms                = ksz8851snl_config->poll_period_ms;
+    emac->rx_pool                       = ksz8851snl_config->rx_pool;
+    emac->tx_queue_size                 = ksz8851snl_config->tx_queue_size;
     emac->parent.set_mediator           = emac_ksz8851_set_mediator;
     emac->parent.init                   = emac_ksz8851_init;
     emac->parent.deinit                 = emac_ksz8851_deinit;
@@ -936,17 +1362,28 @@ esp_eth_mac_t *esp_eth_mac_new_ksz8851snl(const eth_ksz8851snl_config_t *ksz8851
     emac->parent.set_all_multicast      = emac_ksz8851_set_all_multicast;
     emac->parent.enable_flow_ctrl       = emac_ksz8851_enable_flow_ctrl;
     emac->parent.set_peer_pause_ability = emac_ksz8851_set_peer_pause_ability;
+    emac->parent.custom_ioctl           = emac_ksz8851_custom_ioctl;
     emac->parent.del                    = emac_ksz8851_del;
     emac->rx_buffer = NULL;
     emac->tx_buffer = NULL;
     emac->rx_buffer = heap_caps_malloc(KSZ8851_QMU_PACKET_LENGTH + KSZ8851_QMU_PACKET_PADDING, MALLOC_CAP_DMA);
-    emac->tx_buffer = heap_caps_malloc(KSZ8851_QMU_PACKET_LENGTH + KSZ8851_QMU_PACKET_PADDING, MALLOC_CAP_DMA);
     ESP_GOTO_ON_FALSE(emac->rx_buffer, NULL, err, TAG, "RX buffer allocation failed");
-    ESP_GOTO_ON_FALSE(emac->tx_buffer, NULL, err, TAG, "TX buffer allocation failed");
+    portMUX_INITIALIZE(&emac->tx_stats_lock);
+    emac->tx_stats_start = esp_timer_get_time();
+    if (emac->tx_queue_size) {
+        emac->tx_stage[0] = heap_caps_malloc(emac->tx_queue_size, MALLOC_CAP_DMA);
+        emac->tx_stage[1] = heap_caps_malloc(emac->tx_queue_size, MALLOC_CAP_DMA);
+        ESP_GOTO_ON_FALSE(emac->tx_stage[0] && emac->tx_stage[1], NULL, err, TAG, "transmit queue allocation failed");
+        emac->tx_lock = xSemaphoreCreateMutex();
+        emac->tx_space_evt = xEventGroupCreate();
+        ESP_GOTO_ON_FALSE(emac->tx_lock && emac->tx_space_evt, NULL, err, TAG, "create transmit queue lock failed");
+    }
 
     /* create mutex */
     emac->spi_lock = xSemaphoreCreateRecursiveMutex();
     ESP_GOTO_ON_FALSE(emac->spi_lock, NULL, err, TAG, "create lock failed");
+    emac->rx_lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(emac->rx_lock, NULL, err, TAG, "create RX lock failed");
 
     if (ksz8851snl_config->custom_spi_driver.init != NULL && ksz8851snl_config->custom_spi_driver.deinit != NULL
             && ksz8851snl_config->custom_spi_driver.read != NULL && ksz8851snl_config->custom_spi_driver.write != NULL) {
@@ -955,6 +1392,10 @@ esp_eth_mac_t *esp_eth_mac_new_ksz8851snl(const eth_ksz8851snl_config_t *ksz8851
         emac->spi.deinit = ksz8851snl_config->custom_spi_driver.deinit;
         emac->spi.read = ksz8851snl_config->custom_spi_driver.read;
         emac->spi.write = ksz8851snl_config->custom_spi_driver.write;
+        // the default driver writes frames straight from the caller's buffer, custom ones get the control word and
+        // the frame copied together
+        emac->tx_buffer = heap_caps_malloc(KSZ8851_QMU_PACKET_LENGTH + KSZ8851_QMU_PACKET_PADDING, MALLOC_CAP_DMA);
+        ESP_GOTO_ON_FALSE(emac->tx_buffer, NULL, err, TAG, "TX buffer allocation failed");
         /* Custom SPI driver device init */
         ESP_GOTO_ON_FALSE((emac->spi.ctx = emac->spi.init(ksz8851snl_config->custom_spi_driver.config)) != NULL, NULL, err, TAG, "SPI initialization failed");
     } else {
@@ -971,6 +1412,11 @@ esp_eth_mac_t *esp_eth_mac_new_ksz8851snl(const eth_ksz8851snl_config_t *ksz8851
     if (mac_config->flags & ETH_MAC_FLAG_PIN_TO_CORE) {
         core_num = esp_cpu_get_core_id();
     }
+    // frames are delivered by a task of the same priority as the driver task, so neither starves the other
+    emac->rx_pipeline_config.depth = ksz8851snl_config->rx_pipeline_depth;
+    emac->rx_pipeline_config.task_stack_size = mac_config->rx_task_stack_size;
+    emac->rx_pipeline_config.task_prio = mac_config->rx_task_prio;
+    emac->rx_pipeline_config.task_core = core_num;
     BaseType_t xReturned = xTaskCreatePinnedToCore(emac_ksz8851snl_task, "ksz8851snl_tsk", mac_config->rx_task_stack_size,
                                                    emac, mac_config->rx_task_prio, &emac->rx_task_hdl, core_num);
     ESP_GOTO_ON_FALSE(xReturned == pdPASS, NULL, err, TAG, "create ksz8851 task failed");
@@ -998,12 +1444,23 @@ err:
         if (emac->spi_lock) {
             vSemaphoreDelete(emac->spi_lock);
         }
+        if (emac->rx_lock) {
+            vSemaphoreDelete(emac->rx_lock);
+        }
+        if (emac->tx_lock) {
+            vSemaphoreDelete(emac->tx_lock);
+        }
+        if (emac->tx_space_evt) {
+            vEventGroupDelete(emac->tx_space_evt);
+        }
         if (emac->spi.ctx) {
             emac->spi.deinit(emac->spi.ctx);
         }
         // NOTE(v.chistyakov): safe to call with NULL
         heap_caps_free(emac->rx_buffer);
         heap_caps_free(emac->tx_buffer);
+        heap_caps_free(emac->tx_stage[0]);
+        heap_caps_free(emac->tx_stage[1]);
         free(emac);
     }
     return ret;
@@ -0,0 +1,71 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+#include "arpa/inet.h" // for htons
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_eth_test_utils.h"
+#include "esp_eth_mac_ksz8851snl.h"
+
+#define TEST_ETH_TYPE           (0x3300)
+#define TEST_BURST_FRAMES       (2000)
+#define TEST_BURST_TIMEOUT_US   (10 * 1000 * 1000)
+
+TEST_CASE("ksz8851snl transmit burst", "[ksz8851snl]")
+{
+    // get handles from common module initialized by setUp()
+    esp_eth_handle_t eth_handle = eth_test_get_eth_handle();
+    EventGroupHandle_t eth_event_group = eth_test_get_default_event_group();
+
+    TEST_ESP_OK(esp_eth_start(eth_handle));
+    EventBits_t bits = xEventGroupWaitBits(eth_event_group, ETH_CONNECT_BIT, true, true, pdMS_TO_TICKS(ETH_CONNECT_TIMEOUT_MS));
+    TEST_ASSERT((bits & ETH_CONNECT_BIT) == ETH_CONNECT_BIT);
+
+    emac_frame_t *pkt = (emac_frame_t *)eth_test_alloc(ETH_MAX_PACKET_SIZE);
+    TEST_ASSERT_NOT_NULL(pkt);
+    memset(pkt->dest, 0xff, ETH_ADDR_LEN);
+    TEST_ESP_OK(esp_eth_ioctl(eth_handle, ETH_CMD_G_MAC_ADDR, pkt->src));
+    pkt->proto = htons(TEST_ETH_TYPE);
+    memset(pkt->data, 0, ETH_MAX_PAYLOAD_LEN);
+
+    // without the transmit queue, transmit fails while TXQ is full and is retried, don't log every failure
+    esp_log_level_t log_level = esp_log_level_get("ksz8851snl-mac");
+    esp_log_level_set("ksz8851snl-mac", ESP_LOG_NONE);
+    const uint16_t frame_sizes[] = {ETH_MIN_PACKET_SIZE - ETH_CRC_LEN, 512, ETH_MAX_PACKET_SIZE - ETH_CRC_LEN};
+    for (size_t s = 0; s < sizeof(frame_sizes) / sizeof(frame_sizes[0]); s++) {
+        eth_ksz8851_tx_stats_t tx_stats;
+        uint32_t retries = 0;
+        TEST_ESP_OK(esp_eth_ioctl(eth_handle, ETH_MAC_KSZ8851_CMD_CLR_TX_STATS, NULL));
+        int64_t start_us = esp_timer_get_time();
+        for (int i = 0; i < TEST_BURST_FRAMES; i++) {
+            while (esp_eth_transmit(eth_handle, pkt, frame_sizes[s]) != ESP_OK) {
+                retries++;
+                TEST_ASSERT_LESS_THAN_INT64(TEST_BURST_TIMEOUT_US, esp_timer_get_time() - start_us);
+                taskYIELD();
+            }
+        }
+        // queued frames are still being written to TXQ by the driver task
+        do {
+            TEST_ESP_OK(esp_eth_ioctl(eth_handle, ETH_MAC_KSZ8851_CMD_G_TX_STATS, &tx_stats));
+            TEST_ASSERT_LESS_THAN_INT64(TEST_BURST_TIMEOUT_US, esp_timer_get_time() - start_us);
+            taskYIELD();
+        } while (tx_stats.frames < TEST_BURST_FRAMES);
+        int64_t elapsed_us = esp_timer_get_time() - start_us;
+        printf("Transmit burst of %" PRIu16 " B frames: %" PRIi64 " frames/s, %" PRIu32 " writes, TXQ full %" PRIu32 " times, %" PRIu32 " retries\n",
+               frame_sizes[s], (int64_t)TEST_BURST_FRAMES * 1000000 / elapsed_us, tx_stats.batches, tx_stats.txq_full_cnt, retries);
+        // let the chip send out the burst before the next one
+        vTaskDelay(pdMS_TO_TICKS(500));
+    }
+    esp_log_level_set("ksz8851snl-mac", log_level);
+
+    TEST_ESP_OK(esp_eth_stop(eth_handle));
+    bits = xEventGroupWaitBits(eth_event_group, ETH_STOP_BIT, true, true, pdMS_TO_TICKS(3000));
+    TEST_ASSERT((bits & ETH_STOP_BIT) == ETH_STOP_BIT);
+}
@@ -1,8 +1,9 @@
 # SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
 # SPDX-License-Identifier: Apache-2.0
 """
-Target test using EthTestRunner from eth_test_app component.
+Target test using EthTestRunner from eth_test_app component and KSZ8851SNL transmit burst measurement.
 """
+import logging
 
 import pytest
 
@@ -16,6 +17,8 @@ TEST_IF = ''
     [
         pytest.param('default_ksz8851snl', 'esp32', marks=[pytest.mark.eth_ksz8851snl]),
         pytest.param('poll_ksz8851snl', 'esp32', marks=[pytest.mark.eth_ksz8851snl]),
+        pytest.param('rx_pipeline_ksz8851snl', 'esp32', marks=[pytest.mark.eth_ksz8851snl]),
+        pytest.param('tx_queue_ksz8851snl', 'esp32', marks=[pytest.mark.eth_ksz8851snl]),
     ],
     indirect=['target'],
 )
@@ -25,3 +28,23 @@ def test_eth_ksz8851snl(dut: Dut, eth_test_runner) -> None:
     eth_test_runner.run_ethernet_l2_test(dut, TEST_IF)
     dut.serial.hard_reset()
     eth_test_runner.run_ethernet_heap_alloc_test(dut, TEST_IF)
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default_ksz8851snl', 'esp32', marks=[pytest.mark.eth_ksz8851snl]),
+        pytest.param('tx_queue_ksz8851snl', 'esp32', marks=[pytest.mark.eth_ksz8851snl]),
+    ],
+    indirect=['target'],
+)
+def test_ksz8851snl_tx_burst(dut: Dut) -> None:
+    # compare the logged burst rates of writing every frame from transmit (default) and of the transmit queue
+    dut.expect_exact('Press ENTER to see the list of tests')
+    dut.write('\n')
+    dut.expect_exact('Enter test for running.')
+    dut.write('"ksz8851snl transmit burst"')
+    for _ in range(3):
+        res = dut.expect(r'Transmit burst of \d+ B frames: .+ retries')
+        logging.info(res.group(0).decode('utf-8'))
+    dut.expect_unity_test_output()
@@ -348,8 +348,8 @@ void app_main(void)
     ESP_ERROR_CHECK(esp_eth_ioctl(host_eth_handle, ETH_CMD_S_PROMISCUOUS, &enable));
 
     // Register Ports to which forward traffic received by "host eth"
-    ksz8863_register_tail_tag_port(p1_eth_handle, 0);
-    ksz8863_register_tail_tag_port(p2_eth_handle, 1);
+    ESP_ERROR_CHECK(ksz8863_register_tail_tag_port(p1_eth_handle, 0));
+    ESP_ERROR_CHECK(ksz8863_register_tail_tag_port(p2_eth_handle, 1));
     // Make "host eth" decide where to forward traffic (i.e. to registered ports)
     ESP_ERROR_CHECK(esp_eth_update_input_path(host_eth_handle, ksz8863_eth_tail_tag_port_forward, NULL));
     // Register "host eth" so it could be used by Ports for transmit
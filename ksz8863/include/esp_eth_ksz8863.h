@@ -19,6 +19,59 @@ extern "C" {
 #define KSZ8863_PORT_1 (0)
 #define KSZ8863_PORT_2 (1)
 
+/**
+ * @brief Number of ports identified by Tail Tag of frames received at Host port, the tag equals the port number
+ *
+ */
+#define KSZ8863_TAIL_TAG_PORTS_NUM (2)
+
+/**
+ * @brief Maximum number of segments of a frame transmitted by `ksz8863_eth_transmit_segs`
+ *
+ */
+#define KSZ8863_TX_SEGS_MAX (3)
+
+/**
+ * @brief Number of ports with MIB counters, P1, P2 and P3 (Host) port
+ *
+ */
+#define KSZ8863_MIB_PORTS_NUM (3)
+
+/**
+ * @brief Maximum MIB counters collection period, 30-bit byte counters may overflow just once in that time at 100 Mbps
+ *
+ */
+#define KSZ8863_MIB_PERIOD_MAX_MS (60000)
+
+/**
+ * @brief Default configuration of MIB counters collector
+ *
+ */
+#define KSZ8863_MIB_COLLECTOR_DEFAULT_CONFIG() \
+    {                                         \
+        .period_ms = 10000,                   \
+        .task_stack_size = 3072,              \
+        .task_prio = 1,                       \
+    }
+
+/**
+ * @brief Number of priority queues of a port
+ *
+ */
+#define KSZ8863_QUEUES_NUM (4)
+
+/**
+ * @brief Number of IEEE 802.1p priorities mapped to queues by KSZ8863_ETH_CMD_S_802_1P_MAP
+ *
+ */
+#define KSZ8863_802_1P_PRIOS_NUM (8)
+
+/**
+ * @brief Maximum Broadcast Storm Protection rate, number of 64-byte blocks per 67 ms interval (at 100BT)
+ *
+ */
+#define KSZ8863_BCAST_STORM_RATE_MAX (0x7FF)
+
 /**
  * @brief Default configuration for KSZ8863 Ethernet driver
  *
@@ -51,6 +104,20 @@ typedef enum {
     KSZ8863_ETH_CMD_S_TAIL_TAG,
     KSZ8863_ETH_CMD_G_TAIL_TAG,
     KSZ8863_ETH_CMD_G_PORT_NUM,
+    KSZ8863_ETH_CMD_S_VLAN_EN,
+    KSZ8863_ETH_CMD_G_VLAN_EN,
+    KSZ8863_ETH_CMD_S_VLAN_TBL,
+    KSZ8863_ETH_CMD_G_VLAN_TBL,
+    KSZ8863_ETH_CMD_S_PORT_VLAN,
+    KSZ8863_ETH_CMD_G_PORT_VLAN,
+    KSZ8863_ETH_CMD_S_PORT_QOS,
+    KSZ8863_ETH_CMD_G_PORT_QOS,
+    KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT,
+    KSZ8863_ETH_CMD_G_PORT_RATE_LIMIT,
+    KSZ8863_ETH_CMD_S_802_1P_MAP,
+    KSZ8863_ETH_CMD_G_802_1P_MAP,
+    KSZ8863_ETH_CMD_S_BCAST_STORM_RATE,
+    KSZ8863_ETH_CMD_G_BCAST_STORM_RATE,
 } ksz8863_eth_io_cmd_t;
 
 typedef struct {
@@ -62,6 +129,158 @@ typedef struct {
     };
 } ksz8863_mac_tbl_info_t;
 
+/**
+ * @brief VLAN table entries to be accessed by KSZ8863_ETH_CMD_S_VLAN_TBL/KSZ8863_ETH_CMD_G_VLAN_TBL
+ *
+ */
+typedef struct {
+    uint16_t start_entry;               /*!< Index of the first entry */
+    uint16_t entries_num;               /*!< Number of consecutive entries, accessed in one batch */
+    ksz8863_vlan_table_t *vlan_tbls;    /*!< Entries */
+} ksz8863_vlan_tbl_info_t;
+
+/**
+ * @brief 802.1Q VLAN configuration of a port, accessed by KSZ8863_ETH_CMD_S_PORT_VLAN/KSZ8863_ETH_CMD_G_PORT_VLAN
+ *
+ */
+typedef struct {
+    uint16_t default_tag;       /*!< Default tag, priority [15:13], CFI [12] and VID [11:0], untagged ingress frames are assigned its VID */
+    uint8_t membership;         /*!< Ports the port is allowed to forward frames to (KSZ8863_TO_PORTx), applies in port-based VLAN */
+    bool insert_tag;            /*!< Insert the tag to untagged egress frames */
+    bool remove_tag;            /*!< Remove the tag from tagged egress frames */
+    bool ingress_filter;        /*!< Discard ingress frames whose VID port is not member of */
+    bool discard_non_pvid;      /*!< Discard ingress frames whose VID doesn't match the port default VID */
+} ksz8863_port_vlan_config_t;
+
+/**
+ * @brief Priority classification and queuing of a port, accessed by KSZ8863_ETH_CMD_S_PORT_QOS/KSZ8863_ETH_CMD_G_PORT_QOS
+ *
+ */
+typedef struct {
+    uint8_t queues_num;             /*!< Number of egress priority queues, 1, 2 or 4 */
+    uint8_t port_priority;          /*!< Priority (queue) of ingress frames not classified otherwise, 0 to 3 */
+    bool priority_802_1p_en;        /*!< Classify tagged frames by 802.1p priority, see KSZ8863_ETH_CMD_S_802_1P_MAP */
+    bool priority_diffserv_en;      /*!< Classify IP frames by DiffServ */
+    bool user_priority_ceiling;     /*!< Limit 802.1p priority of tagged frames to the priority of the port default tag */
+    bool bcast_storm_en;            /*!< Limit ingress broadcast frames, see KSZ8863_ETH_CMD_S_BCAST_STORM_RATE */
+} ksz8863_port_qos_config_t;
+
+/**
+ * @brief Frames counted by ingress rate limit
+ *
+ */
+typedef enum {
+    KSZ8863_INGRESS_LIMIT_ALL,                  /*!< All frames */
+    KSZ8863_INGRESS_LIMIT_BCAST_MCAST_FLOOD,    /*!< Broadcast, multicast and flooded unicast frames */
+    KSZ8863_INGRESS_LIMIT_BCAST_MCAST,          /*!< Broadcast and multicast frames */
+    KSZ8863_INGRESS_LIMIT_BCAST,                /*!< Broadcast frames only */
+} ksz8863_ingress_limit_mode_t;
+
+/**
+ * @brief Rate limits of a port, accessed by KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT/KSZ8863_ETH_CMD_G_PORT_RATE_LIMIT
+ *
+ * @note Rates are in kbps, 0 means not limited. Rates below 1 Mbps must be multiples of 64 kbps, higher rates whole Mbps up to
+ *       99 Mbps. KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT fails with ESP_ERR_INVALID_ARG for any other rate and changes nothing.
+ *
+ */
+typedef struct {
+    uint32_t ingress_kbps[KSZ8863_QUEUES_NUM];  /*!< Ingress rate limit of each priority queue */
+    uint32_t egress_kbps[KSZ8863_QUEUES_NUM];   /*!< Egress rate limit of each priority queue */
+    ksz8863_ingress_limit_mode_t ingress_mode;  /*!< Frames counted by ingress rate limit */
+    bool count_ifg;                             /*!< Count inter frame gap bytes to the rate */
+    bool count_preamble;                        /*!< Count preamble bytes to the rate */
+} ksz8863_port_rate_limit_t;
+
+/**
+ * @brief Tail Tag forwarding statistics of a port
+ *
+ */
+typedef struct {
+    uint32_t rx_frames;     /*!< Frames forwarded to the port Ethernet interface */
+    uint32_t rx_bytes;      /*!< Bytes forwarded to the port Ethernet interface, Tail Tag excluded (wraps around) */
+} ksz8863_tail_tag_port_stats_t;
+
+/**
+ * @brief Tail Tag forwarding statistics
+ *
+ */
+typedef struct {
+    ksz8863_tail_tag_port_stats_t port[KSZ8863_TAIL_TAG_PORTS_NUM]; /*!< Per port statistics, indexed by port number */
+    uint32_t unknown_tag_cnt;                                       /*!< Frames dropped since no port was registered for their Tail Tag */
+} ksz8863_tail_tag_stats_t;
+
+/**
+ * @brief MIB counters of a port
+ *
+ */
+typedef enum {
+    KSZ8863_MIB_RX_LO_PRIO_BYTE,        /*!< RX lo-priority (default) octet count including bad packets */
+    KSZ8863_MIB_RX_HI_PRIO_BYTE,        /*!< RX hi-priority octet count including bad packets */
+    KSZ8863_MIB_RX_UNDERSIZE,           /*!< RX undersize packets with good CRC */
+    KSZ8863_MIB_RX_FRAGMENTS,           /*!< RX fragment packets with bad CRC, symbol errors or alignment errors */
+    KSZ8863_MIB_RX_OVERSIZE,            /*!< RX oversize packets with good CRC */
+    KSZ8863_MIB_RX_JABBERS,             /*!< RX packets longer than 1522 bytes with either CRC errors, alignment errors or symbol errors */
+    KSZ8863_MIB_RX_SYMBOL_ERR,          /*!< RX packets with invalid data symbol and legal packet size */
+    KSZ8863_MIB_RX_CRC_ERR,             /*!< RX packets within 64 to 1522 bytes with an integral number of bytes and a bad CRC */
+    KSZ8863_MIB_RX_ALIGN_ERR,           /*!< RX packets within 64 to 1522 bytes with a non-integral number of bytes and a bad CRC */
+    KSZ8863_MIB_RX_CTRL_8808,           /*!< MAC control frames received with 0x8808 in EtherType field */
+    KSZ8863_MIB_RX_PAUSE,               /*!< PAUSE frames received */
+    KSZ8863_MIB_RX_BROADCAST,           /*!< RX good broadcast packets */
+    KSZ8863_MIB_RX_MULTICAST,           /*!< RX good multicast packets */
+    KSZ8863_MIB_RX_UNICAST,             /*!< RX good unicast packets */
+    KSZ8863_MIB_RX_64,                  /*!< RX packets with 64 bytes */
+    KSZ8863_MIB_RX_65_127,              /*!< RX packets with 65 to 127 bytes */
+    KSZ8863_MIB_RX_128_255,             /*!< RX packets with 128 to 255 bytes */
+    KSZ8863_MIB_RX_256_511,             /*!< RX packets with 256 to 511 bytes */
+    KSZ8863_MIB_RX_512_1023,            /*!< RX packets with 512 to 1023 bytes */
+    KSZ8863_MIB_RX_1024_1522,           /*!< RX packets with 1024 to 1522 bytes */
+    KSZ8863_MIB_TX_LO_PRIO_BYTE,        /*!< TX lo-priority good octet count */
+    KSZ8863_MIB_TX_HI_PRIO_BYTE,        /*!< TX hi-priority good octet count */
+    KSZ8863_MIB_TX_LATE_COLLISION,      /*!< Times a collision is detected later than 512 bit-times */
+    KSZ8863_MIB_TX_PAUSE,               /*!< PAUSE frames transmitted */
+    KSZ8863_MIB_TX_BROADCAST,           /*!< TX good broadcast packets */
+    KSZ8863_MIB_TX_MULTICAST,           /*!< TX good multicast packets */
+    KSZ8863_MIB_TX_UNICAST,             /*!< TX good unicast packets */
+    KSZ8863_MIB_TX_DEFERRED,            /*!< TX packets delayed due to busy medium */
+    KSZ8863_MIB_TX_TOTAL_COLLISION,     /*!< TX total collisions, half duplex only */
+    KSZ8863_MIB_TX_EXCESS_COLLISION,    /*!< TX packets dropped due to excessive collisions */
+    KSZ8863_MIB_TX_SINGLE_COLLISION,    /*!< TX packets transmitted after exactly one collision */
+    KSZ8863_MIB_TX_MULTI_COLLISION,     /*!< TX packets transmitted after more than one collision */
+    KSZ8863_MIB_TX_DROP,                /*!< TX packets dropped due to lack of resources, lost when the 16-bit counter wraps between collections */
+    KSZ8863_MIB_RX_DROP,                /*!< RX packets dropped due to lack of resources, lost when the 16-bit counter wraps between collections */
+    KSZ8863_MIB_CNTRS_NUM
+} ksz8863_mib_cntr_t;
+
+/**
+ * @brief MIB counters of all ports, counted since the collector was started
+ *
+ */
+typedef struct {
+    int64_t timestamp_us;                                   /*!< Time of the collection, in microseconds since boot (elapsed time in delta) */
+    struct {
+        uint64_t cntr[KSZ8863_MIB_CNTRS_NUM];               /*!< Counters indexed by ksz8863_mib_cntr_t */
+    } port[KSZ8863_MIB_PORTS_NUM];                          /*!< Counters indexed by port number, P3 (Host) port is the last */
+} ksz8863_mib_snapshot_t;
+
+/**
+ * @brief MIB counters collector configuration
+ *
+ */
+typedef struct {
+    uint32_t period_ms;         /*!< Collection period, at most KSZ8863_MIB_PERIOD_MAX_MS */
+    uint32_t task_stack_size;   /*!< Stack size of the collector task */
+    uint32_t task_prio;         /*!< Priority of the collector task, keep it low not to delay the data path */
+} ksz8863_mib_collector_config_t;
+
+/**
+ * @brief Segment of a frame to be transmitted
+ *
+ */
+typedef struct {
+    void *buf;      /*!< Segment data */
+    size_t len;     /*!< Segment length */
+} ksz8863_tx_seg_t;
+
 /**
  * @brief Software reset of KSZ8863
  *
@@ -112,16 +331,48 @@ esp_err_t ksz8863_p3_rmii_clk_invert(esp_eth_handle_t port_eth_handle, bool rmii
  * @brief Registers KSZ8863 port Ethernet driver handle and associates it with port number. This information is
  * later used by `ksz8863_eth_tail_tag_port_forward` to decide where to forward frame received at Host (P3) port.
  *
+ * @note Ports can be registered and unregistered while frames are being forwarded.
+ *
  * @param port_eth_handle handle of KSZ8863 non-Host (P1/P2) port Ethernet driver
  * @param port_num port number
  * @return esp_err_t
  *          ESP_OK - when port info successfully registered
- *          ESP_ERR_NO_MEM - when not enough memory to store port information
+ *          ESP_ERR_INVALID_ARG - when invalid input parameter
+ *          ESP_ERR_INVALID_STATE - when other Ethernet driver handle has been already registered for the port
  */
 esp_err_t ksz8863_register_tail_tag_port(esp_eth_handle_t port_eth_handle, int32_t port_num);
 
+/**
+ * @brief Unregisters all KSZ8863 port Ethernet driver handles, frames received at Host port are dropped afterwards.
+ *
+ * @note The handle is not used, all ports are unregistered. Use `ksz8863_unregister_tail_tag_port_handle` to
+ * unregister a single port.
+ *
+ * @note Returns once no frame is being forwarded to any of the port Ethernet drivers, so they can be deleted afterwards.
+ * Must not be called from `stack_input` of a port Ethernet interface.
+ *
+ * @param port_eth_handle not used
+ * @return esp_err_t
+ *          ESP_OK - always
+ */
+esp_err_t ksz8863_unregister_tail_tag_port(esp_eth_handle_t port_eth_handle);
+
+/**
+ * @brief Unregisters KSZ8863 port Ethernet driver handle, frames with its Tail Tag are dropped afterwards.
+ *
+ * @note Returns once no frame is being forwarded to the Ethernet driver, so it can be deleted afterwards, even while
+ * the Host Ethernet interface keeps receiving. Must not be called from `stack_input` of a port Ethernet interface.
+ *
+ * @param port_eth_handle handle of KSZ8863 non-Host (P1/P2) port Ethernet driver
+ * @return esp_err_t
+ *          ESP_OK - when port info successfully unregistered
+ *          ESP_ERR_NOT_FOUND - when the handle has not been registered
+ */
+esp_err_t ksz8863_unregister_tail_tag_port_handle(esp_eth_handle_t port_eth_handle);
+
 /**
  * @brief Forwards received frames on Host Ethernet interface to Port Ethernet interfaces based on Tail Tagging.
+ * Frames with Tail Tag of no registered port are counted and dropped.
  *
  * @note: this functions is callback to be registered as `stack_input` of Host Ethernet interface by `esp_eth_update_input_path`.
  *
@@ -134,6 +385,24 @@ esp_err_t ksz8863_register_tail_tag_port(esp_eth_handle_t port_eth_handle, int32
  */
 esp_err_t ksz8863_eth_tail_tag_port_forward(esp_eth_handle_t eth_handle, uint8_t *buffer, uint32_t length, void *priv);
 
+/**
+ * @brief Get statistics of frames forwarded by `ksz8863_eth_tail_tag_port_forward`
+ *
+ * @param[out] stats statistics
+ * @return esp_err_t
+ *          ESP_OK - when success
+ *          ESP_ERR_INVALID_ARG - when invalid input parameter
+ */
+esp_err_t ksz8863_get_tail_tag_stats(ksz8863_tail_tag_stats_t *stats);
+
+/**
+ * @brief Clear statistics of frames forwarded by `ksz8863_eth_tail_tag_port_forward`
+ *
+ * @return esp_err_t
+ *          ESP_OK - always
+ */
+esp_err_t ksz8863_clear_tail_tag_stats(void);
+
 /**
  * @brief Registers Host Ethernet interface handle so Port Ethernet interfaces could transmit via it.
  *
@@ -171,6 +440,83 @@ esp_err_t ksz8863_eth_transmit_via_host(void *buf, size_t length, uint8_t tail_t
  */
 esp_err_t ksz8863_eth_transmit_normal_lookup(esp_eth_handle_t host_eth_handle, void *buf, size_t length);
 
+/**
+ * @brief Transmit frame gathered from segments via Host Ethernet interface with Tail Tag appended.
+ *
+ * Frames shorter than 60 bytes are padded by zeros. Neither padding nor Tail Tag need any memory allocation, they are
+ * passed to the Host Ethernet interface as an additional constant segment.
+ *
+ * @param host_eth_handle handle of KSZ8863 Host port Ethernet driver
+ * @param segs segments of the frame, in order
+ * @param segs_num number of segments, at most KSZ8863_TX_SEGS_MAX
+ * @param tail_tag Tail Tag, egress ports (KSZ8863_TO_PORT1/KSZ8863_TO_PORT2) or 0 for normal address lookup
+ * @return esp_err_t
+ *          ESP_OK - when success
+ *          ESP_ERR_INVALID_ARG - when invalid input parameter
+ */
+esp_err_t ksz8863_eth_transmit_segs(esp_eth_handle_t host_eth_handle, const ksz8863_tx_seg_t *segs, uint32_t segs_num, uint8_t tail_tag);
+
+/**
+ * @brief Start background collection of MIB counters of all ports
+ *
+ * MIB counters are cleared by read in KSZ8863, so they must not be read by other means when the collector runs.
+ *
+ * @note The counters are read by indirect access via I2C or SPI control interface.
+ *
+ * @param config collector configuration
+ * @return esp_err_t
+ *          ESP_OK - when collector started
+ *          ESP_ERR_INVALID_ARG - when invalid configuration
+ *          ESP_ERR_INVALID_STATE - when collector has been already started or indirect access is not available
+ *          ESP_ERR_NO_MEM - when not enough memory
+ */
+esp_err_t ksz8863_mib_collector_start(const ksz8863_mib_collector_config_t *config);
+
+/**
+ * @brief Stop background collection of MIB counters, collected counters are discarded
+ *
+ * @note Waits for the collection in progress. MIB API calls running concurrently complete on the stopped collector,
+ * calls made afterwards fail with ESP_ERR_INVALID_STATE.
+ *
+ * @return esp_err_t
+ *          ESP_OK - when collector stopped
+ *          ESP_ERR_INVALID_STATE - when collector has not been started
+ */
+esp_err_t ksz8863_mib_collector_stop(void);
+
+/**
+ * @brief Collect MIB counters right away, in context of the caller
+ *
+ * @return esp_err_t
+ *          ESP_OK - when success
+ *          ESP_ERR_INVALID_STATE - when collector has not been started
+ *          other - when control interface access failed
+ */
+esp_err_t ksz8863_mib_collect_now(void);
+
+/**
+ * @brief Get MIB counters as of the last collection, the control interface is not accessed
+ *
+ * @param[out] snapshot MIB counters
+ * @return esp_err_t
+ *          ESP_OK - when success
+ *          ESP_ERR_INVALID_ARG - when invalid input parameter
+ *          ESP_ERR_INVALID_STATE - when collector has not been started
+ */
+esp_err_t ksz8863_mib_get_snapshot(ksz8863_mib_snapshot_t *snapshot);
+
+/**
+ * @brief Get change of MIB counters since the last call, e.g. to compute rates
+ *
+ * @param[in,out] last snapshot of the last call, updated to the current one; zero it before the first call
+ * @param[out] delta change of counters, its timestamp is time elapsed between the snapshots
+ * @return esp_err_t
+ *          ESP_OK - when success
+ *          ESP_ERR_INVALID_ARG - when invalid input parameter
+ *          ESP_ERR_INVALID_STATE - when collector has not been started
+ */
+esp_err_t ksz8863_mib_get_delta(ksz8863_mib_snapshot_t *last, ksz8863_mib_snapshot_t *delta);
+
 #ifdef __cplusplus
 }
 #endif
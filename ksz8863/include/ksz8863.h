@@ -649,6 +649,22 @@ typedef enum {
 #define KSZ8863_MACA2_MSB_ADDR (0x99)
 #define KSZ8863_MACA2_LSB_ADDR (0x94)
 
+/**
+ * @brief Register 154-165 (0x9A-0xA5) [6:0]: Port x Q0-Q3 Egress Data Rate Limit
+ *
+ */
+typedef union {
+    struct {
+        uint32_t out_rate_limit : 7;      /*!< Egress Data Rate Limit */
+        uint32_t reserved_7 : 1;          /*!< Reserved */
+    };
+    uint32_t val;
+} ksz8863_edrl_reg_t;
+#define KSZ8863_P1EDRLQ0_ADDR (0x9A)
+#define KSZ8863_P2EDRLQ0_ADDR (0x9E)
+#define KSZ8863_P3EDRLQ0_ADDR (0xA2)
+#define KSZ8863_EDRL_PORT_REGS_NUM (4)
+
 /**
  * @brief Register 198 (0xC6): Forward Invalid VID Frame and Host Mode
  *
@@ -702,6 +718,22 @@ typedef union {
 } ksz8863_dyn_mac_table_t;
 #define KSZ8863_DYN_MAC_TBL_MAX_ENTR (0x3ff)
 
+/**
+ * @brief VLAN Table (16 entries)
+ *
+ */
+typedef union {
+    struct __attribute__((packed)) {
+        uint32_t vid : 12;          /*!< IEEE 802.1Q 12 bits VLAN ID */
+        uint32_t fid : 4;           /*!< Filter VLAN ID, identifies one of the 16 active VLANs */
+        uint32_t membership : 3;    /*!< Port membership, bit 0 for P1, bit 1 for P2 and bit 2 for P3 */
+        uint32_t entry_val : 1;     /*!< Valid */
+        uint32_t reserved : 4;      /*!< Reserved */
+    };
+    uint8_t data[3];
+} ksz8863_vlan_table_t;
+#define KSZ8863_VLAN_TBL_MAX_ENTR (16)
+
 #ifdef __cplusplus
 }
 #endif
@@ -9,6 +9,7 @@
 #include "driver/i2c_master.h"
 #include "driver/spi_master.h"
 #include "esp_eth_driver.h" // for esp_eth_handle_t
+#include "esp_eth_mac_spi.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -33,6 +34,7 @@ typedef struct {
     spi_host_device_t host_id;
     int32_t clock_speed_hz;
     int32_t spics_io_num;
+    eth_spi_custom_driver_config_t custom_spi_driver; /*!< Custom SPI driver definitions, left zeroed for the default driver which uses the fields above */
 } ksz8863_ctrl_spi_config_t;
 
 typedef struct {
@@ -53,6 +55,14 @@ typedef struct {
  */
 esp_err_t ksz8863_ctrl_intf_init(ksz8863_ctrl_intf_config_t *config);
 
+/**
+ * @brief Deinitialize control interface
+ *
+ * @return esp_err_t
+ *          ESP_OK - on success, also when the interface is not initialized
+ */
+esp_err_t ksz8863_ctrl_intf_deinit(void);
+
 /**
  * @brief Read KSZ8863 register value
  *
@@ -6,8 +6,11 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <inttypes.h>
 #include <sys/cdefs.h>
-#include <sys/queue.h>
+#include <stdatomic.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
 #include "esp_log.h"
 #include "esp_check.h"
 #include "driver/gpio.h"
@@ -18,13 +21,31 @@
 
 static const char *TAG = "ksz8863_eth";
 
+// Tail Tag is placed at the end of frame, so short frames need to be padded before it
+#define KSZ8863_TX_MIN_FRAME_LEN (ETH_HEADER_LEN + ETH_MIN_PAYLOAD_LEN)
+// Tail Tag of transmitted frames selects egress ports, 0 means normal address lookup
+#define KSZ8863_TX_TAIL_TAG_MAX (KSZ8863_TO_PORT1 | KSZ8863_TO_PORT2)
+
+// Zero padding followed by Tail Tag for each Tail Tag value, frame of length `len` is completed by row[len:]
+static const uint8_t s_tx_pad_tag[KSZ8863_TX_TAIL_TAG_MAX + 1][KSZ8863_TX_MIN_FRAME_LEN + 1] = {
+    [KSZ8863_TO_PORT1] = { [KSZ8863_TX_MIN_FRAME_LEN] = KSZ8863_TO_PORT1 },
+    [KSZ8863_TO_PORT2] = { [KSZ8863_TX_MIN_FRAME_LEN] = KSZ8863_TO_PORT2 },
+    [KSZ8863_TO_PORT1 | KSZ8863_TO_PORT2] = { [KSZ8863_TX_MIN_FRAME_LEN] = KSZ8863_TO_PORT1 | KSZ8863_TO_PORT2 },
+};
+
+// Number of yields unregistering waits for forwarders before it sleeps, in case a forwarder of lower priority was preempted
+#define KSZ8863_UNREG_WAIT_YIELDS (100)
+
+// Port Ethernet interfaces indexed by Tail Tag of frames received at Host port
 struct ksz8863_port_tbl_s {
-    esp_eth_handle_t eth_handle;
-    int32_t port_num;
-    SLIST_ENTRY(ksz8863_port_tbl_s) next;
+    _Atomic(esp_eth_mediator_t *) eth;
+    _Atomic uint32_t in_flight; // forwarders which may hold `eth`, counted before they load it
+    _Atomic uint32_t rx_frames;
+    _Atomic uint32_t rx_bytes;
 };
 
-static SLIST_HEAD(slisthead, ksz8863_port_tbl_s) s_port_tbls_head;
+static struct ksz8863_port_tbl_s s_port_tbl[KSZ8863_TAIL_TAG_PORTS_NUM];
+static _Atomic uint32_t s_unknown_tag_cnt;
 static esp_eth_handle_t s_host_eth_hndl = NULL;
 
 /* ----------------- Functions to control receive/transmit flow ------------------ */
@@ -32,42 +53,101 @@ static esp_eth_handle_t s_host_eth_hndl = NULL;
 esp_err_t ksz8863_register_tail_tag_port(esp_eth_handle_t port_eth_handle, int32_t port_num)
 {
     esp_err_t ret = ESP_OK;
-    struct ksz8863_port_tbl_s *item = malloc(sizeof(struct ksz8863_port_tbl_s));
-    ESP_GOTO_ON_FALSE(item, ESP_ERR_NO_MEM, err, TAG, "no memory for Tail Tag port info");
-    item->eth_handle = port_eth_handle;
-    item->port_num = port_num;
-    SLIST_INSERT_HEAD(&s_port_tbls_head, item, next);
-
+    ESP_GOTO_ON_FALSE(port_eth_handle, ESP_ERR_INVALID_ARG, err, TAG, "ethernet driver handle can't be null");
+    ESP_GOTO_ON_FALSE(port_num >= 0 && port_num < KSZ8863_TAIL_TAG_PORTS_NUM, ESP_ERR_INVALID_ARG, err, TAG,
+                      "invalid port number %" PRIi32, port_num);
+    esp_eth_mediator_t *expected = NULL;
+    ESP_GOTO_ON_FALSE(atomic_compare_exchange_strong(&s_port_tbl[port_num].eth, &expected, port_eth_handle) ||
+                      expected == port_eth_handle, ESP_ERR_INVALID_STATE, err, TAG,
+                      "port %" PRIi32 " has been already registered", port_num);
 err:
     return ret;
 }
 
+/**
+ * @brief Wait until no forwarder which loaded the port handle before it was cleared is using it
+ */
+static void ksz8863_port_wait_forwarders(struct ksz8863_port_tbl_s *port)
+{
+    // the handle was cleared before the counter is read (both sequentially consistent), so a forwarder not counted
+    // yet loads NULL, and counted ones don't wait for anything while they hold the handle
+    for (uint32_t i = 0; atomic_load(&port->in_flight) != 0; i++) {
+        if (i < KSZ8863_UNREG_WAIT_YIELDS) {
+            taskYIELD();
+        } else {
+            vTaskDelay(1);
+        }
+    }
+}
+
 esp_err_t ksz8863_unregister_tail_tag_port(esp_eth_handle_t port_eth_handle)
 {
-    struct ksz8863_port_tbl_s *item;
-    while (!SLIST_EMPTY(&s_port_tbls_head)) {
-        item = SLIST_FIRST(&s_port_tbls_head);
-        SLIST_REMOVE_HEAD(&s_port_tbls_head, next);
-        free(item);
+    // all ports are unregistered, as it always used to be
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        atomic_store(&s_port_tbl[i].eth, NULL);
+    }
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        ksz8863_port_wait_forwarders(&s_port_tbl[i]);
     }
     return ESP_OK;
 }
 
+esp_err_t ksz8863_unregister_tail_tag_port_handle(esp_eth_handle_t port_eth_handle)
+{
+    esp_err_t ret = ESP_ERR_NOT_FOUND;
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        esp_eth_mediator_t *expected = port_eth_handle;
+        if (atomic_compare_exchange_strong(&s_port_tbl[i].eth, &expected, NULL)) {
+            ksz8863_port_wait_forwarders(&s_port_tbl[i]);
+            ret = ESP_OK;
+        }
+    }
+    return ret;
+}
+
 esp_err_t ksz8863_eth_tail_tag_port_forward(esp_eth_handle_t eth_handle, uint8_t *buffer, uint32_t length, void *priv)
 {
-    struct ksz8863_port_tbl_s *item;
-    SLIST_FOREACH(item, &s_port_tbls_head, next) {
-        if (item->port_num == buffer[length - 1]) {
-            esp_eth_mediator_t *eth = item->eth_handle;
+    if (length > 1 && buffer[length - 1] < KSZ8863_TAIL_TAG_PORTS_NUM) {
+        struct ksz8863_port_tbl_s *port = &s_port_tbl[buffer[length - 1]];
+        // counted before the handle is loaded, so unregistering knows the handle may be in use
+        atomic_fetch_add(&port->in_flight, 1);
+        esp_eth_mediator_t *eth = atomic_load(&port->eth);
+        if (eth) {
+            atomic_fetch_add_explicit(&port->rx_frames, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&port->rx_bytes, length - 1, memory_order_relaxed);
             eth->stack_input(eth, buffer, length - 1);
+            atomic_fetch_sub_explicit(&port->in_flight, 1, memory_order_release);
             return ESP_OK;
         }
+        atomic_fetch_sub_explicit(&port->in_flight, 1, memory_order_release);
     }
 
+    atomic_fetch_add_explicit(&s_unknown_tag_cnt, 1, memory_order_relaxed);
     free(buffer);
     return ESP_OK;
 }
 
+esp_err_t ksz8863_get_tail_tag_stats(ksz8863_tail_tag_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "no mem to store Tail Tag statistics");
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        stats->port[i].rx_frames = atomic_load(&s_port_tbl[i].rx_frames);
+        stats->port[i].rx_bytes = atomic_load(&s_port_tbl[i].rx_bytes);
+    }
+    stats->unknown_tag_cnt = atomic_load(&s_unknown_tag_cnt);
+    return ESP_OK;
+}
+
+esp_err_t ksz8863_clear_tail_tag_stats(void)
+{
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        atomic_store(&s_port_tbl[i].rx_frames, 0);
+        atomic_store(&s_port_tbl[i].rx_bytes, 0);
+    }
+    atomic_store(&s_unknown_tag_cnt, 0);
+    return ESP_OK;
+}
+
 esp_err_t ksz8863_register_host_eth_hndl(esp_eth_handle_t host_eth_handle)
 {
     esp_err_t ret = ESP_OK;
@@ -86,24 +166,48 @@ esp_err_t ksz8863_unregister_host_eth_hndl(void)
     return ret;
 }
 
-static esp_err_t ksz8863_eth_transmit_tag(esp_eth_handle_t host_eth_handle, void *buf, size_t length, uint8_t tail_tag)
+esp_err_t ksz8863_eth_transmit_segs(esp_eth_handle_t host_eth_handle, const ksz8863_tx_seg_t *segs, uint32_t segs_num, uint8_t tail_tag)
 {
     esp_err_t ret = ESP_OK;
-    // Add padding bytes for frames shorter than 60 bytes since Tail tag needs to be placed at the end of the frame
-    if (length < ETH_HEADER_LEN + ETH_MIN_PAYLOAD_LEN) {
-        uint32_t tail_len = ETH_HEADER_LEN + ETH_MIN_PAYLOAD_LEN - length + 1;
-        uint8_t *buff_tail = calloc(1, tail_len);
-        ESP_GOTO_ON_FALSE(buff_tail, ESP_ERR_NO_MEM, err, TAG, "no memory");
-        buff_tail[tail_len - 1] = tail_tag;
-        ret = esp_eth_transmit_vargs(host_eth_handle, 2, buf, length, buff_tail, tail_len);
-        free(buff_tail);
-    } else {
-        ret = esp_eth_transmit_vargs(host_eth_handle, 2, buf, length, &tail_tag, 1);
+    ESP_GOTO_ON_FALSE(host_eth_handle, ESP_ERR_INVALID_ARG, err, TAG, "ethernet driver handle can't be null");
+    ESP_GOTO_ON_FALSE(segs && segs_num > 0 && segs_num <= KSZ8863_TX_SEGS_MAX, ESP_ERR_INVALID_ARG, err, TAG,
+                      "invalid number of segments");
+    ESP_GOTO_ON_FALSE(tail_tag <= KSZ8863_TX_TAIL_TAG_MAX, ESP_ERR_INVALID_ARG, err, TAG, "invalid tail tag 0x%x", tail_tag);
+
+    size_t length = 0;
+    for (uint32_t i = 0; i < segs_num; i++) {
+        length += segs[i].len;
+    }
+    // Frames shorter than 60 bytes are completed by zero padding since Tail tag needs to be placed at the end of the frame
+    size_t tail_offset = length < KSZ8863_TX_MIN_FRAME_LEN ? length : KSZ8863_TX_MIN_FRAME_LEN;
+    const uint8_t *tail = &s_tx_pad_tag[tail_tag][tail_offset];
+    size_t tail_len = KSZ8863_TX_MIN_FRAME_LEN + 1 - tail_offset;
+
+    switch (segs_num) {
+    case 1:
+        ret = esp_eth_transmit_vargs(host_eth_handle, 2, segs[0].buf, segs[0].len, tail, tail_len);
+        break;
+    case 2:
+        ret = esp_eth_transmit_vargs(host_eth_handle, 3, segs[0].buf, segs[0].len, segs[1].buf, segs[1].len, tail, tail_len);
+        break;
+    default:
+        ret = esp_eth_transmit_vargs(host_eth_handle, 4, segs[0].buf, segs[0].len, segs[1].buf, segs[1].len,
+                                     segs[2].buf, segs[2].len, tail, tail_len);
+        break;
     }
 err:
     return ret;
 }
 
+static esp_err_t ksz8863_eth_transmit_tag(esp_eth_handle_t host_eth_handle, void *buf, size_t length, uint8_t tail_tag)
+{
+    ksz8863_tx_seg_t seg = {
+        .buf = buf,
+        .len = length,
+    };
+    return ksz8863_eth_transmit_segs(host_eth_handle, &seg, 1, tail_tag);
+}
+
 // Transmits with tail tag 0 (normal address lookup)
 esp_err_t ksz8863_eth_transmit_normal_lookup(esp_eth_handle_t host_eth_handle, void *buf, size_t length)
 {
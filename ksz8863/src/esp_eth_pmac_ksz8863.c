@@ -7,6 +7,7 @@
 // KSZ8863 functions related to Port MAC functionality => hence the name "pmac"
 
 #include <string.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <sys/cdefs.h>
 #include <sys/queue.h>
@@ -19,6 +20,12 @@
 
 #define KSZ8863_GLOBAL_INIT_DONE     (1 << 0)
 
+#define KSZ8863_RATE_LIMIT_NONE         (0)
+#define KSZ8863_RATE_LIMIT_MBPS_MAX     (99)
+#define KSZ8863_RATE_LIMIT_KBPS_STEP    (64)
+#define KSZ8863_RATE_LIMIT_KBPS_BASE    (100) // 64 kbps is encoded as 101, 960 kbps as 115
+#define KSZ8863_RATE_LIMIT_KBPS_MAX     (115)
+
 static const char *TAG = "ksz8863_pmac";
 
 typedef struct {
@@ -328,6 +335,279 @@ err:
     return ret;
 }
 
+static esp_err_t pmac_ksz8863_access_vlan_tbl(ksz8863_vlan_tbl_info_t *tbls_info, bool write)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(tbls_info->vlan_tbls, ESP_ERR_INVALID_ARG, err, TAG, "VLAN table entries can't be NULL");
+    ESP_GOTO_ON_FALSE(tbls_info->start_entry + tbls_info->entries_num <= KSZ8863_VLAN_TBL_MAX_ENTR, ESP_ERR_INVALID_ARG, err, TAG,
+                      "VLAN table has only %d entries", KSZ8863_VLAN_TBL_MAX_ENTR);
+    if (write) {
+        ESP_GOTO_ON_ERROR(ksz8863_indirect_write_multi(KSZ8863_VLAN_TABLE, tbls_info->start_entry, tbls_info->vlan_tbls,
+                                                       sizeof(ksz8863_vlan_table_t), tbls_info->entries_num),
+                          err, TAG, "failed to write VLAN table");
+    } else {
+        ESP_GOTO_ON_ERROR(ksz8863_indirect_read_multi(KSZ8863_VLAN_TABLE, tbls_info->start_entry, tbls_info->vlan_tbls,
+                                                      sizeof(ksz8863_vlan_table_t), tbls_info->entries_num),
+                          err, TAG, "failed to read VLAN table");
+    }
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_set_port_vlan(pmac_ksz8863_t *pmac, ksz8863_port_vlan_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    esp_eth_mediator_t *eth = pmac->eth;
+    ksz8863_pcr0_reg_t pcr0;
+    ksz8863_pcr1_reg_t pcr1;
+    ksz8863_pcr2_reg_t pcr2;
+    ksz8863_pcr3_reg_t pcr3 = {0};
+    ksz8863_pcr4_reg_t pcr4 = {0};
+
+    ESP_GOTO_ON_FALSE(!(config->insert_tag && config->remove_tag), ESP_ERR_INVALID_ARG, err, TAG,
+                      "tag can't be both inserted and removed");
+    ESP_GOTO_ON_FALSE(!(config->membership & ~(KSZ8863_TO_PORT1 | KSZ8863_TO_PORT2 | KSZ8863_TO_PORT3)), ESP_ERR_INVALID_ARG, err, TAG,
+                      "invalid VLAN membership");
+    // Default tag is set first, so the port doesn't filter on VID of the previous configuration
+    pcr3.default_tag_15_8 = config->default_tag >> 8;
+    pcr4.default_tag_7_0 = config->default_tag & 0xFF;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR3_BASE_ADDR + pmac->port_reg_offset, pcr3.val), err, TAG, "write PC3 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR4_BASE_ADDR + pmac->port_reg_offset, pcr4.val), err, TAG, "write PC4 failed");
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR1_BASE_ADDR + pmac->port_reg_offset, &(pcr1.val)), err, TAG, "read PC1 failed");
+    pcr1.port_vlan_membership = config->membership;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR1_BASE_ADDR + pmac->port_reg_offset, pcr1.val), err, TAG, "write PC1 failed");
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR2_BASE_ADDR + pmac->port_reg_offset, &(pcr2.val)), err, TAG, "read PC2 failed");
+    pcr2.ingres_VLAN_filter = config->ingress_filter;
+    pcr2.discard_non_pvid = config->discard_non_pvid;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR2_BASE_ADDR + pmac->port_reg_offset, pcr2.val), err, TAG, "write PC2 failed");
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, &(pcr0.val)), err, TAG, "read PC0 failed");
+    pcr0.insert_tag = config->insert_tag;
+    pcr0.remove_tag = config->remove_tag;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, pcr0.val), err, TAG, "write PC0 failed");
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_get_port_vlan(pmac_ksz8863_t *pmac, ksz8863_port_vlan_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    esp_eth_mediator_t *eth = pmac->eth;
+    ksz8863_pcr0_reg_t pcr0;
+    ksz8863_pcr1_reg_t pcr1;
+    ksz8863_pcr2_reg_t pcr2;
+    ksz8863_pcr3_reg_t pcr3;
+    ksz8863_pcr4_reg_t pcr4;
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, &(pcr0.val)), err, TAG, "read PC0 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR1_BASE_ADDR + pmac->port_reg_offset, &(pcr1.val)), err, TAG, "read PC1 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR2_BASE_ADDR + pmac->port_reg_offset, &(pcr2.val)), err, TAG, "read PC2 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR3_BASE_ADDR + pmac->port_reg_offset, &(pcr3.val)), err, TAG, "read PC3 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR4_BASE_ADDR + pmac->port_reg_offset, &(pcr4.val)), err, TAG, "read PC4 failed");
+    config->default_tag = pcr3.default_tag_15_8 << 8 | pcr4.default_tag_7_0;
+    config->membership = pcr1.port_vlan_membership;
+    config->insert_tag = pcr0.insert_tag;
+    config->remove_tag = pcr0.remove_tag;
+    config->ingress_filter = pcr2.ingres_VLAN_filter;
+    config->discard_non_pvid = pcr2.discard_non_pvid;
+err:
+    return ret;
+}
+
+static esp_err_t ksz8863_rate_limit_encode(uint32_t kbps, uint8_t *rate)
+{
+    if (kbps == 0) {
+        *rate = KSZ8863_RATE_LIMIT_NONE;
+        return ESP_OK;
+    }
+    // only rates the getter reports back the same are accepted
+    if (kbps < 1000) {
+        ESP_RETURN_ON_FALSE(kbps % KSZ8863_RATE_LIMIT_KBPS_STEP == 0, ESP_ERR_INVALID_ARG, TAG,
+                            "rate %" PRIu32 " kbps is not a multiple of %d kbps", kbps, KSZ8863_RATE_LIMIT_KBPS_STEP);
+        *rate = KSZ8863_RATE_LIMIT_KBPS_BASE + kbps / KSZ8863_RATE_LIMIT_KBPS_STEP;
+        return ESP_OK;
+    }
+    ESP_RETURN_ON_FALSE(kbps % 1000 == 0 && kbps / 1000 <= KSZ8863_RATE_LIMIT_MBPS_MAX, ESP_ERR_INVALID_ARG, TAG,
+                        "rate %" PRIu32 " kbps is not a whole number of Mbps up to %d Mbps", kbps, KSZ8863_RATE_LIMIT_MBPS_MAX);
+    *rate = kbps / 1000;
+    return ESP_OK;
+}
+
+static uint32_t ksz8863_rate_limit_decode(uint8_t rate)
+{
+    if (rate > KSZ8863_RATE_LIMIT_KBPS_BASE && rate <= KSZ8863_RATE_LIMIT_KBPS_MAX) {
+        return (rate - KSZ8863_RATE_LIMIT_KBPS_BASE) * KSZ8863_RATE_LIMIT_KBPS_STEP;
+    }
+    if (rate <= KSZ8863_RATE_LIMIT_MBPS_MAX) {
+        return rate * 1000;
+    }
+    return 0;
+}
+
+static esp_err_t pmac_ksz8863_set_port_qos(pmac_ksz8863_t *pmac, ksz8863_port_qos_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    esp_eth_mediator_t *eth = pmac->eth;
+    ksz8863_pcr0_reg_t pcr0;
+    ksz8863_pcr1_reg_t pcr1;
+    ksz8863_pcr2_reg_t pcr2;
+
+    ESP_GOTO_ON_FALSE(config->queues_num == 1 || config->queues_num == 2 || config->queues_num == KSZ8863_QUEUES_NUM,
+                      ESP_ERR_INVALID_ARG, err, TAG, "port can have 1, 2 or %d queues", KSZ8863_QUEUES_NUM);
+    ESP_GOTO_ON_FALSE(config->port_priority < KSZ8863_QUEUES_NUM, ESP_ERR_INVALID_ARG, err, TAG, "invalid port priority");
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, &(pcr0.val)), err, TAG, "read PC0 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR2_BASE_ADDR + pmac->port_reg_offset, &(pcr2.val)), err, TAG, "read PC2 failed");
+    // 4 and 2 queues split can't be enabled at the same time, so disable the one in use first
+    if (pcr0.txq_split_en && config->queues_num != KSZ8863_QUEUES_NUM) {
+        pcr0.txq_split_en = 0;
+        ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, pcr0.val), err, TAG, "write PC0 failed");
+    }
+    pcr2.tx_2_queues_split_en = config->queues_num == 2;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR2_BASE_ADDR + pmac->port_reg_offset, pcr2.val), err, TAG, "write PC2 failed");
+
+    pcr0.txq_split_en = config->queues_num == KSZ8863_QUEUES_NUM;
+    pcr0.port_based_priority = config->port_priority;
+    pcr0.priority_802_1p_en = config->priority_802_1p_en;
+    pcr0.priority_diffserv_en = config->priority_diffserv_en;
+    pcr0.broadcast_storm_en = config->bcast_storm_en;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, pcr0.val), err, TAG, "write PC0 failed");
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR1_BASE_ADDR + pmac->port_reg_offset, &(pcr1.val)), err, TAG, "read PC1 failed");
+    pcr1.user_priority_ceiling = config->user_priority_ceiling;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR1_BASE_ADDR + pmac->port_reg_offset, pcr1.val), err, TAG, "write PC1 failed");
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_get_port_qos(pmac_ksz8863_t *pmac, ksz8863_port_qos_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    esp_eth_mediator_t *eth = pmac->eth;
+    ksz8863_pcr0_reg_t pcr0;
+    ksz8863_pcr1_reg_t pcr1;
+    ksz8863_pcr2_reg_t pcr2;
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR0_BASE_ADDR + pmac->port_reg_offset, &(pcr0.val)), err, TAG, "read PC0 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR1_BASE_ADDR + pmac->port_reg_offset, &(pcr1.val)), err, TAG, "read PC1 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR2_BASE_ADDR + pmac->port_reg_offset, &(pcr2.val)), err, TAG, "read PC2 failed");
+    config->queues_num = pcr0.txq_split_en ? KSZ8863_QUEUES_NUM : pcr2.tx_2_queues_split_en ? 2 : 1;
+    config->port_priority = pcr0.port_based_priority;
+    config->priority_802_1p_en = pcr0.priority_802_1p_en;
+    config->priority_diffserv_en = pcr0.priority_diffserv_en;
+    config->user_priority_ceiling = pcr1.user_priority_ceiling;
+    config->bcast_storm_en = pcr0.broadcast_storm_en;
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_set_port_rate_limit(pmac_ksz8863_t *pmac, ksz8863_port_rate_limit_t *limit)
+{
+    esp_err_t ret = ESP_OK;
+    esp_eth_mediator_t *eth = pmac->eth;
+    ksz8863_pcr5_reg_t pcr5;
+    ksz8863_idrlq0_reg_t idrl; // Q0 register layout, the other queues have just reserved bit 7 instead of REFCLK invert
+    ksz8863_edrl_reg_t edrl;
+    uint32_t edrl_addr = KSZ8863_P1EDRLQ0_ADDR + pmac->port * KSZ8863_EDRL_PORT_REGS_NUM;
+    uint8_t ingress_rate[KSZ8863_QUEUES_NUM];
+    uint8_t egress_rate[KSZ8863_QUEUES_NUM];
+
+    ESP_GOTO_ON_FALSE(limit->ingress_mode <= KSZ8863_INGRESS_LIMIT_BCAST, ESP_ERR_INVALID_ARG, err, TAG, "invalid ingress limit mode");
+    // all rates are checked first, so that an invalid one doesn't leave the port half configured
+    for (int i = 0; i < KSZ8863_QUEUES_NUM; i++) {
+        ESP_GOTO_ON_ERROR(ksz8863_rate_limit_encode(limit->ingress_kbps[i], &ingress_rate[i]), err, TAG, "invalid Q%d ingress rate", i);
+        ESP_GOTO_ON_ERROR(ksz8863_rate_limit_encode(limit->egress_kbps[i], &egress_rate[i]), err, TAG, "invalid Q%d egress rate", i);
+    }
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR5_BASE_ADDR + pmac->port_reg_offset, &(pcr5.val)), err, TAG, "read PC5 failed");
+    pcr5.limit_mode = limit->ingress_mode;
+    pcr5.count_ifg = limit->count_ifg;
+    pcr5.count_pre = limit->count_preamble;
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_PCR5_BASE_ADDR + pmac->port_reg_offset, pcr5.val), err, TAG, "write PC5 failed");
+
+    for (int i = 0; i < KSZ8863_QUEUES_NUM; i++) {
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_IDRLQ0_BASE_ADDR + i + pmac->port_reg_offset, &(idrl.val)),
+                          err, TAG, "read IDRLQ%d failed", i);
+        idrl.q0_in_rate_limit = ingress_rate[i];
+        ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_IDRLQ0_BASE_ADDR + i + pmac->port_reg_offset, idrl.val),
+                          err, TAG, "write IDRLQ%d failed", i);
+
+        edrl.val = 0;
+        edrl.out_rate_limit = egress_rate[i];
+        ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, edrl_addr + i, edrl.val), err, TAG, "write EDRLQ%d failed", i);
+    }
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_get_port_rate_limit(pmac_ksz8863_t *pmac, ksz8863_port_rate_limit_t *limit)
+{
+    esp_err_t ret = ESP_OK;
+    esp_eth_mediator_t *eth = pmac->eth;
+    ksz8863_pcr5_reg_t pcr5;
+    ksz8863_idrlq0_reg_t idrl;
+    ksz8863_edrl_reg_t edrl;
+    uint32_t edrl_addr = KSZ8863_P1EDRLQ0_ADDR + pmac->port * KSZ8863_EDRL_PORT_REGS_NUM;
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_PCR5_BASE_ADDR + pmac->port_reg_offset, &(pcr5.val)), err, TAG, "read PC5 failed");
+    limit->ingress_mode = pcr5.limit_mode;
+    limit->count_ifg = pcr5.count_ifg;
+    limit->count_preamble = pcr5.count_pre;
+    for (int i = 0; i < KSZ8863_QUEUES_NUM; i++) {
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_IDRLQ0_BASE_ADDR + i + pmac->port_reg_offset, &(idrl.val)),
+                          err, TAG, "read IDRLQ%d failed", i);
+        limit->ingress_kbps[i] = ksz8863_rate_limit_decode(idrl.q0_in_rate_limit);
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, edrl_addr + i, &(edrl.val)), err, TAG, "read EDRLQ%d failed", i);
+        limit->egress_kbps[i] = ksz8863_rate_limit_decode(edrl.out_rate_limit);
+    }
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_set_802_1p_map(esp_eth_mediator_t *eth, uint8_t *map)
+{
+    esp_err_t ret = ESP_OK;
+    ksz8863_gcr10_reg_t gcr10 = {0};
+    ksz8863_gcr11_reg_t gcr11 = {0};
+
+    for (int i = 0; i < KSZ8863_802_1P_PRIOS_NUM; i++) {
+        ESP_GOTO_ON_FALSE(map[i] < KSZ8863_QUEUES_NUM, ESP_ERR_INVALID_ARG, err, TAG, "invalid queue of 802.1p priority %d", i);
+    }
+    gcr10.tag_0x0 = map[0];
+    gcr10.tag_0x1 = map[1];
+    gcr10.tag_0x2 = map[2];
+    gcr10.tag_0x3 = map[3];
+    gcr11.tag_0x4 = map[4];
+    gcr11.tag_0x5 = map[5];
+    gcr11.tag_0x6 = map[6];
+    gcr11.tag_0x7 = map[7];
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_GCR10_ADDR, gcr10.val), err, TAG, "write GC10 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_GCR11_ADDR, gcr11.val), err, TAG, "write GC11 failed");
+err:
+    return ret;
+}
+
+static esp_err_t pmac_ksz8863_get_802_1p_map(esp_eth_mediator_t *eth, uint8_t *map)
+{
+    esp_err_t ret = ESP_OK;
+    ksz8863_gcr10_reg_t gcr10;
+    ksz8863_gcr11_reg_t gcr11;
+
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR10_ADDR, &(gcr10.val)), err, TAG, "read GC10 failed");
+    ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR11_ADDR, &(gcr11.val)), err, TAG, "read GC11 failed");
+    map[0] = gcr10.tag_0x0;
+    map[1] = gcr10.tag_0x1;
+    map[2] = gcr10.tag_0x2;
+    map[3] = gcr10.tag_0x3;
+    map[4] = gcr11.tag_0x4;
+    map[5] = gcr11.tag_0x5;
+    map[6] = gcr11.tag_0x6;
+    map[7] = gcr11.tag_0x7;
+err:
+    return ret;
+}
+
 static esp_err_t pmac_ksz8863_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *data)
 {
     esp_err_t ret = ESP_OK;
@@ -337,6 +617,9 @@ static esp_err_t pmac_ksz8863_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *da
     ksz8863_chipid1_reg_t start_sw;
     ksz8863_gcr0_reg_t gcr0;
     ksz8863_gcr1_reg_t gcr1;
+    ksz8863_gcr3_reg_t gcr3;
+    ksz8863_gcr4_reg_t gcr4;
+    ksz8863_gcr5_reg_t gcr5;
     ksz8863_pcr2_reg_t pcr2;
 
     switch (cmd) {
@@ -433,6 +716,73 @@ static esp_err_t pmac_ksz8863_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *da
         ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store port number");
         *(int32_t *)data = pmac->port;
         break;
+    case KSZ8863_ETH_CMD_S_VLAN_EN:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "VLAN enable can't be NULL");
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR3_ADDR, &(gcr3.val)), err, TAG, "read GC3 failed");
+        gcr3.vlan_en = *(bool *)data;
+        ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_GCR3_ADDR, gcr3.val), err, TAG, "write GC3 failed");
+        break;
+    case KSZ8863_ETH_CMD_G_VLAN_EN:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store VLAN enable");
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR3_ADDR, &(gcr3.val)), err, TAG, "read GC3 failed");
+        *(bool *)data = gcr3.vlan_en;
+        break;
+    case KSZ8863_ETH_CMD_S_VLAN_TBL:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "VLAN tbl info can't be NULL");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_access_vlan_tbl((ksz8863_vlan_tbl_info_t *)data, true), err, TAG, "VLAN table write failed");
+        break;
+    case KSZ8863_ETH_CMD_G_VLAN_TBL:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store VLAN table");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_access_vlan_tbl((ksz8863_vlan_tbl_info_t *)data, false), err, TAG, "VLAN table read failed");
+        break;
+    case KSZ8863_ETH_CMD_S_PORT_VLAN:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "port VLAN config can't be NULL");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_set_port_vlan(pmac, (ksz8863_port_vlan_config_t *)data), err, TAG, "port VLAN config failed");
+        break;
+    case KSZ8863_ETH_CMD_G_PORT_VLAN:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store port VLAN config");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_get_port_vlan(pmac, (ksz8863_port_vlan_config_t *)data), err, TAG, "port VLAN config read failed");
+        break;
+    case KSZ8863_ETH_CMD_S_PORT_QOS:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "port QoS config can't be NULL");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_set_port_qos(pmac, (ksz8863_port_qos_config_t *)data), err, TAG, "port QoS config failed");
+        break;
+    case KSZ8863_ETH_CMD_G_PORT_QOS:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store port QoS config");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_get_port_qos(pmac, (ksz8863_port_qos_config_t *)data), err, TAG, "port QoS config read failed");
+        break;
+    case KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "port rate limit can't be NULL");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_set_port_rate_limit(pmac, (ksz8863_port_rate_limit_t *)data), err, TAG, "port rate limit config failed");
+        break;
+    case KSZ8863_ETH_CMD_G_PORT_RATE_LIMIT:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store port rate limit");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_get_port_rate_limit(pmac, (ksz8863_port_rate_limit_t *)data), err, TAG, "port rate limit read failed");
+        break;
+    case KSZ8863_ETH_CMD_S_802_1P_MAP:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "802.1p priority map can't be NULL");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_set_802_1p_map(eth, (uint8_t *)data), err, TAG, "802.1p priority map config failed");
+        break;
+    case KSZ8863_ETH_CMD_G_802_1P_MAP:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store 802.1p priority map");
+        ESP_GOTO_ON_ERROR(pmac_ksz8863_get_802_1p_map(eth, (uint8_t *)data), err, TAG, "802.1p priority map read failed");
+        break;
+    case KSZ8863_ETH_CMD_S_BCAST_STORM_RATE:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "broadcast storm rate can't be NULL");
+        ESP_GOTO_ON_FALSE(*(uint16_t *)data <= KSZ8863_BCAST_STORM_RATE_MAX, ESP_ERR_INVALID_ARG, err, TAG, "invalid broadcast storm rate");
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR4_ADDR, &(gcr4.val)), err, TAG, "read GC4 failed");
+        gcr4.brdcast_storm_rate_8_10 = *(uint16_t *)data >> 8;
+        gcr5.val = 0;
+        gcr5.brdcast_storm_rate_0_7 = *(uint16_t *)data & 0xFF;
+        ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_GCR4_ADDR, gcr4.val), err, TAG, "write GC4 failed");
+        ESP_GOTO_ON_ERROR(eth->phy_reg_write(eth, 0, KSZ8863_GCR5_ADDR, gcr5.val), err, TAG, "write GC5 failed");
+        break;
+    case KSZ8863_ETH_CMD_G_BCAST_STORM_RATE:
+        ESP_GOTO_ON_FALSE(data, ESP_ERR_INVALID_ARG, err, TAG, "no mem to store broadcast storm rate");
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR4_ADDR, &(gcr4.val)), err, TAG, "read GC4 failed");
+        ESP_GOTO_ON_ERROR(eth->phy_reg_read(eth, 0, KSZ8863_GCR5_ADDR, &(gcr5.val)), err, TAG, "read GC5 failed");
+        *(uint16_t *)data = gcr4.brdcast_storm_rate_8_10 << 8 | gcr5.brdcast_storm_rate_0_7;
+        break;
     default:
         ret = ESP_ERR_INVALID_ARG;
         break;
@@ -18,14 +18,23 @@
 #define KSZ8863_I2C_TIMEOUT_MS 500
 #define KSZ8863_I2C_LOCK_TIMEOUT_MS (KSZ8863_I2C_TIMEOUT_MS + 50)
 #define KSZ8863_SPI_LOCK_TIMEOUT_MS 500
+#define KSZ8863_INDIR_LOCK_TIMEOUT_MS 1000
+
+typedef struct {
+    void *ctx;
+    esp_err_t (*deinit)(void *spi_ctx);
+    esp_err_t (*read)(void *spi_ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t data_len);
+    esp_err_t (*write)(void *spi_ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t data_len);
+} ksz8863_spi_driver_t;
 
 typedef struct {
     ksz8863_intf_mode_t mode;
     SemaphoreHandle_t bus_lock;
+    SemaphoreHandle_t indir_lock; // Indirect Access Control and Data registers are shared by all tables
     esp_err_t (*ksz8863_reg_read)(uint8_t reg_addr, uint8_t *data, size_t len);
     esp_err_t (*ksz8863_reg_write)(uint8_t reg_addr, uint8_t *data, size_t len);
     union {
-        spi_device_handle_t spi_handle;
+        ksz8863_spi_driver_t spi;
         i2c_master_dev_handle_t i2c_handle;
     };
 } ksz8863_ctrl_intf_t;
@@ -75,46 +84,80 @@ err:
     return ret;
 }
 
-static esp_err_t ksz8863_spi_write(uint8_t reg_addr, uint8_t *data, size_t len)
+static void *ksz8863_spi_dev_init(const void *spi_config)
 {
-    esp_err_t ret = ESP_OK;
+    const ksz8863_ctrl_spi_config_t *spi_dev_config = (const ksz8863_ctrl_spi_config_t *)spi_config;
+    spi_device_handle_t spi_handle = NULL;
+
+    spi_device_interface_config_t devcfg = {
+        .command_bits = 8,
+        .address_bits = 8,
+        .mode = 0,
+        .clock_speed_hz = spi_dev_config->clock_speed_hz,
+        .spics_io_num = spi_dev_config->spics_io_num,
+        .queue_size = 20
+    };
+    ESP_RETURN_ON_FALSE(spi_bus_add_device(spi_dev_config->host_id, &devcfg, &spi_handle) == ESP_OK, NULL, TAG,
+                        "Error when trying to add the SPI device");
+    return spi_handle;
+}
 
+static esp_err_t ksz8863_spi_dev_deinit(void *spi_ctx)
+{
+    return spi_bus_remove_device((spi_device_handle_t)spi_ctx);
+}
+
+static esp_err_t ksz8863_spi_dev_write(void *spi_ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len)
+{
     spi_transaction_t trans = {
-        .cmd = KSZ8863_SPI_WRITE_CMD,
-        .addr = reg_addr,
+        .cmd = cmd,
+        .addr = addr,
         .length = 8 * len,
         .tx_buffer = data
     };
-    ESP_GOTO_ON_FALSE(bus_lock(KSZ8863_SPI_LOCK_TIMEOUT_MS), ESP_ERR_TIMEOUT, err, TAG, "SPI bus lock timeout");
-    ESP_GOTO_ON_ERROR(spi_device_polling_transmit(s_ksz8863_ctrl_intf->spi_handle, &trans), err_release, TAG, "SPI transmit fail");
-err_release:
-    bus_unlock();
-err:
-    return ret;
+    return spi_device_polling_transmit((spi_device_handle_t)spi_ctx, &trans);
 }
 
-static esp_err_t ksz8863_spi_read(uint8_t reg_addr, uint8_t *data, size_t len)
+static esp_err_t ksz8863_spi_dev_read(void *spi_ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len)
 {
-    esp_err_t ret = ESP_OK;
-
     spi_transaction_t trans = {
         .flags = len <= 4 ? SPI_TRANS_USE_RXDATA : 0, // use direct reads for registers to prevent overwrites by 4-byte boundary writes
-        .cmd = KSZ8863_SPI_READ_CMD,
-        .addr = reg_addr,
+        .cmd = cmd,
+        .addr = addr,
         .length = 8 * len,
         .rx_buffer = data
     };
-    ESP_GOTO_ON_FALSE(bus_lock(KSZ8863_SPI_LOCK_TIMEOUT_MS), ESP_ERR_TIMEOUT, err, TAG, "SPI bus lock timeout");
-    ESP_GOTO_ON_ERROR(spi_device_polling_transmit(s_ksz8863_ctrl_intf->spi_handle, &trans), err_release, TAG, "SPI transmit fail");
-    bus_unlock();
+    esp_err_t ret = spi_device_polling_transmit((spi_device_handle_t)spi_ctx, &trans);
 
-    if ((trans.flags & SPI_TRANS_USE_RXDATA) && len <= 4) {
+    if (ret == ESP_OK && (trans.flags & SPI_TRANS_USE_RXDATA) && len <= 4) {
         memcpy(data, trans.rx_data, len);  // copy register values to output
     }
+    return ret;
+}
+
+static esp_err_t ksz8863_spi_write(uint8_t reg_addr, uint8_t *data, size_t len)
+{
+    esp_err_t ret = ESP_OK;
+
+    ESP_GOTO_ON_FALSE(bus_lock(KSZ8863_SPI_LOCK_TIMEOUT_MS), ESP_ERR_TIMEOUT, err, TAG, "SPI bus lock timeout");
+    ESP_GOTO_ON_ERROR(s_ksz8863_ctrl_intf->spi.write(s_ksz8863_ctrl_intf->spi.ctx, KSZ8863_SPI_WRITE_CMD, reg_addr, data, len),
+                      err_release, TAG, "SPI transmit fail");
+err_release:
+    bus_unlock();
 err:
     return ret;
+}
+
+static esp_err_t ksz8863_spi_read(uint8_t reg_addr, uint8_t *data, size_t len)
+{
+    esp_err_t ret = ESP_OK;
+
+    ESP_GOTO_ON_FALSE(bus_lock(KSZ8863_SPI_LOCK_TIMEOUT_MS), ESP_ERR_TIMEOUT, err, TAG, "SPI bus lock timeout");
+    ESP_GOTO_ON_ERROR(s_ksz8863_ctrl_intf->spi.read(s_ksz8863_ctrl_intf->spi.ctx, KSZ8863_SPI_READ_CMD, reg_addr, data, len),
+                      err_release, TAG, "SPI transmit fail");
 err_release:
     bus_unlock();
+err:
     return ret;
 }
 
@@ -176,10 +219,10 @@ static void ksz8863_swap_from_mac_tbl(void *mac_table_in, uint8_t *swap_data, bo
     }
 }
 
-esp_err_t ksz8863_indirect_read(ksz8863_indir_access_tbls_t tbl, uint8_t ind_addr, void *data, size_t len)
+static esp_err_t ksz8863_indirect_check(size_t len)
 {
     if (!(s_ksz8863_ctrl_intf->mode == KSZ8863_I2C_MODE || s_ksz8863_ctrl_intf->mode == KSZ8863_SPI_MODE)) {
-        ESP_LOGD(TAG, "Indirect read is accessible only in I2C or SPI mode");
+        ESP_LOGD(TAG, "Indirect access is available only in I2C or SPI mode");
         return ESP_ERR_INVALID_STATE;
     }
 
@@ -187,41 +230,67 @@ esp_err_t ksz8863_indirect_read(ksz8863_indir_access_tbls_t tbl, uint8_t ind_add
         ESP_LOGD(TAG, "maximally %d bytes can be indirectly accessed at a time", KSZ8863_INDIR_DATA_MAX_SIZE);
         return ESP_ERR_INVALID_SIZE;
     }
+    return ESP_OK;
+}
 
+static esp_err_t ksz8863_indirect_read_entry(ksz8863_indir_access_tbls_t tbl, uint16_t ind_addr, void *data, size_t len)
+{
+    esp_err_t ret = ESP_OK;
     ksz8863_iacr0_1_reg_t req_hdr;
+    req_hdr.val = 0;
     req_hdr.read_write = KSZ8863_INDIR_ACCESS_READ;
     req_hdr.table_sel = tbl;
     req_hdr.addr = ind_addr;
 
     // Indirect Access header is stored in opposite order in KSZ
     uint16_t swap_hdr = __builtin_bswap16(req_hdr.val); // TODO: this maybe too GCC specific
-    s_ksz8863_ctrl_intf->ksz8863_reg_write(KSZ8863_IACR0_ADDR, (uint8_t *)&swap_hdr, sizeof(req_hdr));
+    ESP_GOTO_ON_ERROR(s_ksz8863_ctrl_intf->ksz8863_reg_write(KSZ8863_IACR0_ADDR, (uint8_t *)&swap_hdr, sizeof(req_hdr)),
+                      err, TAG, "write IACR failed");
 
     // Indirect Access data is stored in opposite order in KSZ
     uint8_t read_data[KSZ8863_INDIR_DATA_MAX_SIZE];
-    s_ksz8863_ctrl_intf->ksz8863_reg_read(KSZ8863_IDR0_ADDR - len + 1, read_data, len);
+    ESP_GOTO_ON_ERROR(s_ksz8863_ctrl_intf->ksz8863_reg_read(KSZ8863_IDR0_ADDR - len + 1, read_data, len),
+                      err, TAG, "read IDR failed");
     if (tbl == KSZ8863_STA_MAC_TABLE) {
         ksz8863_swap_to_mac_tbl(read_data, data, true);
     } else if (tbl == KSZ8863_DYN_MAC_TABLE) {
         ksz8863_swap_to_mac_tbl(read_data, data, false);
+    } else {
+        for (int i = 0; i < len; i++) {
+            ((uint8_t *)data)[i] = read_data[len - 1 - i];
+        }
     }
-
-    return ESP_OK;
+err:
+    return ret;
 }
 
-esp_err_t ksz8863_indirect_write(ksz8863_indir_access_tbls_t tbl, uint8_t ind_addr, void *data, size_t len)
+esp_err_t ksz8863_indirect_read(ksz8863_indir_access_tbls_t tbl, uint16_t ind_addr, void *data, size_t len)
 {
-    if (!(s_ksz8863_ctrl_intf->mode == KSZ8863_I2C_MODE || s_ksz8863_ctrl_intf->mode == KSZ8863_SPI_MODE)) {
-        ESP_LOGD(TAG, "Indirect write is accessible only in I2C or SPI mode");
-        return ESP_ERR_INVALID_STATE;
-    }
+    return ksz8863_indirect_read_multi(tbl, ind_addr, data, len, 1);
+}
 
-    if (len > KSZ8863_INDIR_DATA_MAX_SIZE) {
-        ESP_LOGD(TAG, "maximal %d bytes can be indirectly accessed at a time", KSZ8863_INDIR_DATA_MAX_SIZE);
-        return ESP_ERR_INVALID_SIZE;
+esp_err_t ksz8863_indirect_read_multi(ksz8863_indir_access_tbls_t tbl, uint16_t start_addr, void *data, size_t len, uint32_t entries_num)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(ksz8863_indirect_check(len), TAG, "indirect read not possible");
+
+    // The entries are read in one go, so other indirect access can't sneak in between them
+    ESP_RETURN_ON_FALSE(xSemaphoreTake(s_ksz8863_ctrl_intf->indir_lock, pdMS_TO_TICKS(KSZ8863_INDIR_LOCK_TIMEOUT_MS)) == pdTRUE,
+                        ESP_ERR_TIMEOUT, TAG, "indirect access lock timeout");
+    for (uint32_t i = 0; i < entries_num; i++) {
+        ESP_GOTO_ON_ERROR(ksz8863_indirect_read_entry(tbl, start_addr + i, (uint8_t *)data + i * len, len), err, TAG,
+                          "indirect read of entry 0x%x failed", (unsigned)(start_addr + i));
     }
+err:
+    xSemaphoreGive(s_ksz8863_ctrl_intf->indir_lock);
+    return ret;
+}
 
+static esp_err_t ksz8863_indirect_write_entry(ksz8863_indir_access_tbls_t tbl, uint16_t ind_addr, void *data, size_t len)
+{
+    esp_err_t ret = ESP_OK;
     ksz8863_iacr0_1_reg_t req_hdr;
+    req_hdr.val = 0;
     req_hdr.read_write = KSZ8863_INDIR_ACCESS_WRITE;
     req_hdr.table_sel = tbl;
     req_hdr.addr = ind_addr;
@@ -233,12 +302,40 @@ esp_err_t ksz8863_indirect_write(ksz8863_indir_access_tbls_t tbl, uint8_t ind_ad
         ksz8863_swap_from_mac_tbl(data, swap_data, true);
     } else if (tbl == KSZ8863_DYN_MAC_TABLE) {
         ksz8863_swap_from_mac_tbl(data, swap_data, false);
+    } else {
+        for (int i = 0; i < len; i++) {
+            swap_data[len - 1 - i] = ((uint8_t *)data)[i];
+        }
     }
 
-    s_ksz8863_ctrl_intf->ksz8863_reg_write(KSZ8863_IDR0_ADDR - len + 1, swap_data, len);
-    s_ksz8863_ctrl_intf->ksz8863_reg_write(KSZ8863_IACR0_ADDR, (uint8_t *)&swap_hdr, sizeof(req_hdr));
+    ESP_GOTO_ON_ERROR(s_ksz8863_ctrl_intf->ksz8863_reg_write(KSZ8863_IDR0_ADDR - len + 1, swap_data, len),
+                      err, TAG, "write IDR failed");
+    ESP_GOTO_ON_ERROR(s_ksz8863_ctrl_intf->ksz8863_reg_write(KSZ8863_IACR0_ADDR, (uint8_t *)&swap_hdr, sizeof(req_hdr)),
+                      err, TAG, "write IACR failed");
+err:
+    return ret;
+}
 
-    return ESP_OK;
+esp_err_t ksz8863_indirect_write(ksz8863_indir_access_tbls_t tbl, uint16_t ind_addr, void *data, size_t len)
+{
+    return ksz8863_indirect_write_multi(tbl, ind_addr, data, len, 1);
+}
+
+esp_err_t ksz8863_indirect_write_multi(ksz8863_indir_access_tbls_t tbl, uint16_t start_addr, void *data, size_t len, uint32_t entries_num)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_ERROR(ksz8863_indirect_check(len), TAG, "indirect write not possible");
+
+    // The entries are written in one go, so a table is not observed half reconfigured by other indirect access
+    ESP_RETURN_ON_FALSE(xSemaphoreTake(s_ksz8863_ctrl_intf->indir_lock, pdMS_TO_TICKS(KSZ8863_INDIR_LOCK_TIMEOUT_MS)) == pdTRUE,
+                        ESP_ERR_TIMEOUT, TAG, "indirect access lock timeout");
+    for (uint32_t i = 0; i < entries_num; i++) {
+        ESP_GOTO_ON_ERROR(ksz8863_indirect_write_entry(tbl, start_addr + i, (uint8_t *)data + i * len, len), err, TAG,
+                          "indirect write of entry 0x%x failed", (unsigned)(start_addr + i));
+    }
+err:
+    xSemaphoreGive(s_ksz8863_ctrl_intf->indir_lock);
+    return ret;
 }
 
 esp_err_t ksz8863_ctrl_intf_init(ksz8863_ctrl_intf_config_t *config)
@@ -253,6 +350,7 @@ esp_err_t ksz8863_ctrl_intf_init(ksz8863_ctrl_intf_config_t *config)
     ESP_RETURN_ON_FALSE(s_ksz8863_ctrl_intf, ESP_ERR_NO_MEM, TAG, "no memory");
 
     s_ksz8863_ctrl_intf->mode = config->host_mode;
+    ESP_GOTO_ON_FALSE(s_ksz8863_ctrl_intf->indir_lock = xSemaphoreCreateMutex(), ESP_ERR_NO_MEM, err, TAG, "mutex creation failed");
 
     switch (config->host_mode) {
     case KSZ8863_I2C_MODE:
@@ -269,15 +367,21 @@ esp_err_t ksz8863_ctrl_intf_init(ksz8863_ctrl_intf_config_t *config)
     case KSZ8863_SPI_MODE:;
         ESP_GOTO_ON_FALSE(s_ksz8863_ctrl_intf->bus_lock = xSemaphoreCreateMutex(), ESP_ERR_NO_MEM, err, TAG, "mutex creation failed");
 
-        spi_device_interface_config_t devcfg = {
-            .command_bits = 8,
-            .address_bits = 8,
-            .mode = 0,
-            .clock_speed_hz = config->spi_dev_config->clock_speed_hz,
-            .spics_io_num = config->spi_dev_config->spics_io_num,
-            .queue_size = 20
-        };
-        ESP_ERROR_CHECK(spi_bus_add_device(config->spi_dev_config->host_id, &devcfg, &s_ksz8863_ctrl_intf->spi_handle));
+        const eth_spi_custom_driver_config_t *custom_spi = &config->spi_dev_config->custom_spi_driver;
+        if (custom_spi->init != NULL && custom_spi->deinit != NULL && custom_spi->read != NULL && custom_spi->write != NULL) {
+            ESP_LOGD(TAG, "Using user's custom SPI Driver");
+            s_ksz8863_ctrl_intf->spi.deinit = custom_spi->deinit;
+            s_ksz8863_ctrl_intf->spi.read = custom_spi->read;
+            s_ksz8863_ctrl_intf->spi.write = custom_spi->write;
+            s_ksz8863_ctrl_intf->spi.ctx = custom_spi->init(custom_spi->config);
+        } else {
+            ESP_LOGD(TAG, "Using default SPI Driver");
+            s_ksz8863_ctrl_intf->spi.deinit = ksz8863_spi_dev_deinit;
+            s_ksz8863_ctrl_intf->spi.read = ksz8863_spi_dev_read;
+            s_ksz8863_ctrl_intf->spi.write = ksz8863_spi_dev_write;
+            s_ksz8863_ctrl_intf->spi.ctx = ksz8863_spi_dev_init(config->spi_dev_config);
+        }
+        ESP_GOTO_ON_FALSE(s_ksz8863_ctrl_intf->spi.ctx, ESP_FAIL, err, TAG, "SPI initialization failed");
 
         s_ksz8863_ctrl_intf->ksz8863_reg_read = ksz8863_spi_read;
         s_ksz8863_ctrl_intf->ksz8863_reg_write = ksz8863_spi_write;
@@ -286,7 +390,14 @@ esp_err_t ksz8863_ctrl_intf_init(ksz8863_ctrl_intf_config_t *config)
     }
     return ESP_OK;
 err:
+    if (s_ksz8863_ctrl_intf->bus_lock) {
+        vSemaphoreDelete(s_ksz8863_ctrl_intf->bus_lock);
+    }
+    if (s_ksz8863_ctrl_intf->indir_lock) {
+        vSemaphoreDelete(s_ksz8863_ctrl_intf->indir_lock);
+    }
     free(s_ksz8863_ctrl_intf);
+    s_ksz8863_ctrl_intf = NULL;
     return ret;
 }
 
@@ -299,11 +410,12 @@ esp_err_t ksz8863_ctrl_intf_deinit(void)
             break;
         case KSZ8863_SPI_MODE:
             vSemaphoreDelete(s_ksz8863_ctrl_intf->bus_lock);
-            spi_bus_remove_device(s_ksz8863_ctrl_intf->spi_handle);
+            s_ksz8863_ctrl_intf->spi.deinit(s_ksz8863_ctrl_intf->spi.ctx);
         default:
             break;
         }
 
+        vSemaphoreDelete(s_ksz8863_ctrl_intf->indir_lock);
         free(s_ksz8863_ctrl_intf);
         s_ksz8863_ctrl_intf = NULL;
     }
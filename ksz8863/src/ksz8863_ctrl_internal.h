@@ -15,8 +15,12 @@ extern "C" {
 #define KSZ8863_SPI_WRITE_CMD (0x02)
 #define KSZ8863_SPI_READ_CMD  (0x03)
 
-esp_err_t ksz8863_indirect_read(ksz8863_indir_access_tbls_t tbl, uint8_t ind_addr, void *data, size_t len);
-esp_err_t ksz8863_indirect_write(ksz8863_indir_access_tbls_t tbl, uint8_t ind_addr, void *data, size_t len);
+esp_err_t ksz8863_indirect_read(ksz8863_indir_access_tbls_t tbl, uint16_t ind_addr, void *data, size_t len);
+// Reads `entries_num` consecutive entries of `len` bytes each, no other indirect access is interleaved
+esp_err_t ksz8863_indirect_read_multi(ksz8863_indir_access_tbls_t tbl, uint16_t start_addr, void *data, size_t len, uint32_t entries_num);
+esp_err_t ksz8863_indirect_write(ksz8863_indir_access_tbls_t tbl, uint16_t ind_addr, void *data, size_t len);
+// Writes `entries_num` consecutive entries of `len` bytes each, no other indirect access is interleaved
+esp_err_t ksz8863_indirect_write_multi(ksz8863_indir_access_tbls_t tbl, uint16_t start_addr, void *data, size_t len, uint32_t entries_num);
 
 #ifdef __cplusplus
 }
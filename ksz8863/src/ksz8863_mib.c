@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+// Collects KSZ8863 MIB counters in background and extends them to 64 bits
+
+#include <string.h>
+#include <stdlib.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_log.h"
+#include "esp_check.h"
+#include "esp_timer.h"
+
+#include "esp_eth_ksz8863.h"
+#include "ksz8863_ctrl_internal.h" // indirect read
+#include "ksz8863.h" // registers
+
+static const char *TAG = "ksz8863_mib";
+
+#define KSZ8863_MIB_PORT_CNTRS_NUM      (KSZ8863_MIB_TX_MULTI_COLLISION + 1) // counters at per port addresses
+#define KSZ8863_MIB_PORT_ADDR(port)     ((port) * 0x20)
+#define KSZ8863_MIB_TX_DROP_ADDR(port)  (0x100 + (port))
+#define KSZ8863_MIB_RX_DROP_ADDR(port)  (0x103 + (port))
+#define KSZ8863_MIB_DROP_ADDR_NUM       (2 * KSZ8863_MIB_PORTS_NUM)
+
+#define KSZ8863_MIB_OVERFLOW            (1UL << 31)
+#define KSZ8863_MIB_VALID               (1UL << 30)
+#define KSZ8863_MIB_VALUE_MASK          (KSZ8863_MIB_VALID - 1)
+#define KSZ8863_MIB_DROP_VALUE_MASK     (0xFFFF)
+
+#define KSZ8863_MIB_LOCK_TIMEOUT_MS     (100)
+
+typedef struct {
+    TaskHandle_t task_hdl;
+    SemaphoreHandle_t task_done;        // given by the task when it no longer uses the collector
+    SemaphoreHandle_t lock;             // guards totals, held only to update them, so readers don't wait for the bus
+    SemaphoreHandle_t collect_lock;     // serializes collections, dropped packet counters are processed in order
+    uint32_t period_ms;
+    volatile bool stop;
+    uint32_t refs;                      // the running collector holds one, each API call in progress another one
+    ksz8863_mib_snapshot_t totals;
+    uint16_t drop_last[KSZ8863_MIB_DROP_ADDR_NUM]; // dropped packet counters are not cleared by read
+    bool drop_last_valid;
+} ksz8863_mib_collector_t;
+
+static ksz8863_mib_collector_t *s_mib = NULL;
+static portMUX_TYPE s_mib_ref_lock = portMUX_INITIALIZER_UNLOCKED; // guards s_mib and the reference counts
+
+static void ksz8863_mib_free(ksz8863_mib_collector_t *mib)
+{
+    if (mib->lock) {
+        vSemaphoreDelete(mib->lock);
+    }
+    if (mib->collect_lock) {
+        vSemaphoreDelete(mib->collect_lock);
+    }
+    if (mib->task_done) {
+        vSemaphoreDelete(mib->task_done);
+    }
+    free(mib);
+}
+
+/**
+ * @brief Get the running collector, it is not freed until released even if the collector is stopped meanwhile
+ */
+static ksz8863_mib_collector_t *ksz8863_mib_acquire(void)
+{
+    portENTER_CRITICAL(&s_mib_ref_lock);
+    ksz8863_mib_collector_t *mib = s_mib;
+    if (mib) {
+        mib->refs++;
+    }
+    portEXIT_CRITICAL(&s_mib_ref_lock);
+    return mib;
+}
+
+static void ksz8863_mib_release(ksz8863_mib_collector_t *mib)
+{
+    portENTER_CRITICAL(&s_mib_ref_lock);
+    bool last = --mib->refs == 0;
+    portEXIT_CRITICAL(&s_mib_ref_lock);
+    if (last) {
+        ksz8863_mib_free(mib);
+    }
+}
+
+static esp_err_t ksz8863_mib_collect(ksz8863_mib_collector_t *mib)
+{
+    esp_err_t ret = ESP_OK;
+    uint32_t cntrs[KSZ8863_MIB_PORTS_NUM][KSZ8863_MIB_PORT_CNTRS_NUM];
+    uint32_t drops[KSZ8863_MIB_DROP_ADDR_NUM];
+
+    xSemaphoreTake(mib->collect_lock, portMAX_DELAY);
+    // Read the whole counter block of a port in one batch, counters are cleared by the read
+    for (int port = 0; port < KSZ8863_MIB_PORTS_NUM; port++) {
+        ESP_GOTO_ON_ERROR(ksz8863_indirect_read_multi(KSZ8863_MIB_CNTRS, KSZ8863_MIB_PORT_ADDR(port), cntrs[port],
+                                                      sizeof(uint32_t), KSZ8863_MIB_PORT_CNTRS_NUM),
+                          err, TAG, "read MIB counters of port %d failed", port + 1);
+    }
+    // TX drop counters of all ports are followed by RX drop counters
+    ESP_GOTO_ON_ERROR(ksz8863_indirect_read_multi(KSZ8863_MIB_CNTRS, KSZ8863_MIB_TX_DROP_ADDR(0), drops,
+                                                  sizeof(uint32_t), KSZ8863_MIB_DROP_ADDR_NUM),
+                      err, TAG, "read dropped packet counters failed");
+
+    // The counters were cleared by the read, so wait for the lock as long as it takes, giving up would lose them. The lock
+    // is held only to copy totals, never while accessing the bus.
+    xSemaphoreTake(mib->lock, portMAX_DELAY);
+    for (int port = 0; port < KSZ8863_MIB_PORTS_NUM; port++) {
+        uint64_t *totals = mib->totals.port[port].cntr;
+        for (int i = 0; i < KSZ8863_MIB_PORT_CNTRS_NUM; i++) {
+            // not valid counter keeps its value until the next read
+            if (cntrs[port][i] & KSZ8863_MIB_VALID) {
+                if (cntrs[port][i] & KSZ8863_MIB_OVERFLOW) {
+                    totals[i] += KSZ8863_MIB_VALUE_MASK + 1ULL;
+                }
+                totals[i] += cntrs[port][i] & KSZ8863_MIB_VALUE_MASK;
+            }
+        }
+    }
+    for (int i = 0; i < KSZ8863_MIB_DROP_ADDR_NUM; i++) {
+        uint16_t drop = drops[i] & KSZ8863_MIB_DROP_VALUE_MASK;
+        // drops counted before the collector was started are not included
+        if (mib->drop_last_valid) {
+            int port = i % KSZ8863_MIB_PORTS_NUM;
+            ksz8863_mib_cntr_t cntr = i < KSZ8863_MIB_PORTS_NUM ? KSZ8863_MIB_TX_DROP : KSZ8863_MIB_RX_DROP;
+            mib->totals.port[port].cntr[cntr] += (uint16_t)(drop - mib->drop_last[i]);
+        }
+        mib->drop_last[i] = drop;
+    }
+    mib->drop_last_valid = true;
+    mib->totals.timestamp_us = esp_timer_get_time();
+    xSemaphoreGive(mib->lock);
+err:
+    xSemaphoreGive(mib->collect_lock);
+    return ret;
+}
+
+static void ksz8863_mib_task(void *arg)
+{
+    ksz8863_mib_collector_t *mib = (ksz8863_mib_collector_t *)arg;
+    while (!mib->stop) {
+        if (ksz8863_mib_collect(mib) != ESP_OK) {
+            ESP_LOGW(TAG, "MIB counters collection failed");
+        }
+        // woken up early to collect on demand or to stop
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(mib->period_ms));
+    }
+    xSemaphoreGive(mib->task_done);
+    vTaskDelete(NULL);
+}
+
+esp_err_t ksz8863_mib_collector_start(const ksz8863_mib_collector_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config, ESP_ERR_INVALID_ARG, TAG, "can't set MIB collector config to null");
+    ESP_RETURN_ON_FALSE(config->period_ms > 0 && config->period_ms <= KSZ8863_MIB_PERIOD_MAX_MS, ESP_ERR_INVALID_ARG, TAG,
+                        "collection period must be 1 to %d ms so the counters don't overflow twice", KSZ8863_MIB_PERIOD_MAX_MS);
+    ESP_RETURN_ON_FALSE(s_mib == NULL, ESP_ERR_INVALID_STATE, TAG, "MIB collector has been already started");
+
+    ksz8863_mib_collector_t *mib = calloc(1, sizeof(ksz8863_mib_collector_t));
+    ESP_RETURN_ON_FALSE(mib, ESP_ERR_NO_MEM, TAG, "no memory for MIB collector");
+    mib->period_ms = config->period_ms;
+    mib->refs = 1;
+    mib->lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(mib->lock, ESP_ERR_NO_MEM, err, TAG, "create MIB lock failed");
+    mib->collect_lock = xSemaphoreCreateMutex();
+    ESP_GOTO_ON_FALSE(mib->collect_lock, ESP_ERR_NO_MEM, err, TAG, "create MIB collection lock failed");
+    mib->task_done = xSemaphoreCreateBinary();
+    ESP_GOTO_ON_FALSE(mib->task_done, ESP_ERR_NO_MEM, err, TAG, "create MIB task done semaphore failed");
+
+    // Clear the counters, so totals start from zero
+    ESP_GOTO_ON_ERROR(ksz8863_mib_collect(mib), err, TAG, "initial MIB counters read failed");
+    memset(&mib->totals.port, 0, sizeof(mib->totals.port));
+
+    portENTER_CRITICAL(&s_mib_ref_lock);
+    bool published = s_mib == NULL;
+    if (published) {
+        s_mib = mib;
+    }
+    portEXIT_CRITICAL(&s_mib_ref_lock);
+    ESP_GOTO_ON_FALSE(published, ESP_ERR_INVALID_STATE, err, TAG, "MIB collector has been already started");
+    ESP_GOTO_ON_FALSE(xTaskCreate(ksz8863_mib_task, "ksz8863_mib", config->task_stack_size, mib,
+                                  config->task_prio, &mib->task_hdl) == pdPASS,
+                      ESP_FAIL, err_task, TAG, "create MIB collector task failed");
+    return ESP_OK;
+err_task:
+    portENTER_CRITICAL(&s_mib_ref_lock);
+    s_mib = NULL;
+    portEXIT_CRITICAL(&s_mib_ref_lock);
+    // API calls which got the collector meanwhile may still use it
+    ksz8863_mib_release(mib);
+    return ret;
+err:
+    ksz8863_mib_free(mib);
+    return ret;
+}
+
+esp_err_t ksz8863_mib_collector_stop(void)
+{
+    portENTER_CRITICAL(&s_mib_ref_lock);
+    ksz8863_mib_collector_t *mib = s_mib;
+    s_mib = NULL;
+    portEXIT_CRITICAL(&s_mib_ref_lock);
+    ESP_RETURN_ON_FALSE(mib, ESP_ERR_INVALID_STATE, TAG, "MIB collector has not been started");
+    mib->stop = true;
+    xTaskNotifyGive(mib->task_hdl);
+    // wait for the task to finish the collection in progress
+    xSemaphoreTake(mib->task_done, portMAX_DELAY);
+    // freed here, or by the last API call still using it
+    ksz8863_mib_release(mib);
+    return ESP_OK;
+}
+
+esp_err_t ksz8863_mib_collect_now(void)
+{
+    ksz8863_mib_collector_t *mib = ksz8863_mib_acquire();
+    ESP_RETURN_ON_FALSE(mib, ESP_ERR_INVALID_STATE, TAG, "MIB collector has not been started");
+    esp_err_t ret = ksz8863_mib_collect(mib);
+    ksz8863_mib_release(mib);
+    return ret;
+}
+
+esp_err_t ksz8863_mib_get_snapshot(ksz8863_mib_snapshot_t *snapshot)
+{
+    ESP_RETURN_ON_FALSE(snapshot, ESP_ERR_INVALID_ARG, TAG, "no mem to store MIB snapshot");
+    ksz8863_mib_collector_t *mib = ksz8863_mib_acquire();
+    ESP_RETURN_ON_FALSE(mib, ESP_ERR_INVALID_STATE, TAG, "MIB collector has not been started");
+    esp_err_t ret = ESP_OK;
+    ESP_GOTO_ON_FALSE(xSemaphoreTake(mib->lock, pdMS_TO_TICKS(KSZ8863_MIB_LOCK_TIMEOUT_MS)) == pdTRUE,
+                      ESP_ERR_TIMEOUT, err, TAG, "MIB lock timeout");
+    *snapshot = mib->totals;
+    xSemaphoreGive(mib->lock);
+err:
+    ksz8863_mib_release(mib);
+    return ret;
+}
+
+esp_err_t ksz8863_mib_get_delta(ksz8863_mib_snapshot_t *last, ksz8863_mib_snapshot_t *delta)
+{
+    ESP_RETURN_ON_FALSE(last && delta && last != delta, ESP_ERR_INVALID_ARG, TAG, "invalid argument");
+    ksz8863_mib_snapshot_t now;
+    ESP_RETURN_ON_ERROR(ksz8863_mib_get_snapshot(&now), TAG, "get MIB snapshot failed");
+    for (int port = 0; port < KSZ8863_MIB_PORTS_NUM; port++) {
+        for (int i = 0; i < KSZ8863_MIB_CNTRS_NUM; i++) {
+            delta->port[port].cntr[i] = now.port[port].cntr[i] - last->port[port].cntr[i];
+        }
+    }
+    delta->timestamp_us = now.timestamp_us - last->timestamp_us;
+    *last = now;
+    return ESP_OK;
+}
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <stdbool.h>
+#include "ksz8863_model.h"
+
+/* The model is written against the datasheet, it intentionally doesn't share register definitions with the driver. */
+#define SPI_CMD_WRITE       (0x02)
+#define SPI_CMD_READ        (0x03)
+
+#define REG_P1CR1           (0x11) // Port Control 1, ports 2 and 3 follow at 0x10 offsets
+#define REG_P1CR2           (0x12)
+#define REG_P1CR4           (0x14)
+#define REG_IACR0           (0x79) // [4] read high/write low, [3:2] table select, [1:0] indirect address [9:8]
+#define REG_IACR1           (0x7A) // indirect address [7:0], writing it starts the access
+#define REG_IDR0            (0x83) // indirect data [7:0], IDR1 to IDR8 hold the higher bytes at the lower addresses
+
+#define IACR0_READ          (0x10)
+#define IACR0_TABLE_SHIFT   (2)
+#define IACR0_TABLE_MASK    (0x03)
+#define IACR0_ADDR_HI_MASK  (0x03)
+#define TABLE_VLAN          (0x01)
+
+#define VLAN_ENTRY_BYTES    (3) // IDR2..IDR0
+#define VLAN_ENTRY_MASK     (0x000FFFFF)
+
+typedef struct {
+    uint8_t regs[256];
+    uint32_t vlan[KSZ8863_MODEL_VLAN_ENTRIES];
+    ksz8863_model_stats_t stats;
+} ksz8863_model_t;
+
+static ksz8863_model_t s_model;
+
+static void regs_reset(void)
+{
+    memset(s_model.regs, 0, sizeof(s_model.regs));
+    for (int port = 0; port < 3; port++) {
+        s_model.regs[REG_P1CR1 + port * 0x10] = 0x07; // member of all ports
+        s_model.regs[REG_P1CR2 + port * 0x10] = 0x06; // transmit and receive enabled
+        s_model.regs[REG_P1CR4 + port * 0x10] = 0x01; // default VID 1
+    }
+}
+
+void ksz8863_model_reset(void)
+{
+    memset(&s_model, 0, sizeof(s_model));
+    regs_reset();
+}
+
+const ksz8863_model_stats_t *ksz8863_model_stats(void)
+{
+    return &s_model.stats;
+}
+
+uint8_t ksz8863_model_reg_get(uint8_t addr)
+{
+    return s_model.regs[addr];
+}
+
+void ksz8863_model_reg_set(uint8_t addr, uint8_t value)
+{
+    s_model.regs[addr] = value;
+}
+
+uint32_t ksz8863_model_vlan_entry_get(uint8_t index)
+{
+    return s_model.vlan[index % KSZ8863_MODEL_VLAN_ENTRIES];
+}
+
+void ksz8863_model_vlan_entry_set(uint8_t index, uint32_t entry)
+{
+    s_model.vlan[index % KSZ8863_MODEL_VLAN_ENTRIES] = entry & VLAN_ENTRY_MASK;
+}
+
+/* the access is started by the write of IACR1, the data of a write is taken from IDRx as they are at that moment */
+static void indirect_access(void)
+{
+    uint8_t iacr0 = s_model.regs[REG_IACR0];
+    uint16_t addr = ((iacr0 & IACR0_ADDR_HI_MASK) << 8) | s_model.regs[REG_IACR1];
+    bool read = iacr0 & IACR0_READ;
+
+    if (((iacr0 >> IACR0_TABLE_SHIFT) & IACR0_TABLE_MASK) != TABLE_VLAN || addr >= KSZ8863_MODEL_VLAN_ENTRIES) {
+        s_model.stats.indir_other++;
+        return;
+    }
+    if (read) {
+        s_model.stats.indir_reads++;
+        for (int i = 0; i < VLAN_ENTRY_BYTES; i++) {
+            s_model.regs[REG_IDR0 - i] = s_model.vlan[addr] >> (8 * i);
+        }
+    } else {
+        s_model.stats.indir_writes++;
+        uint32_t entry = 0;
+        for (int i = 0; i < VLAN_ENTRY_BYTES; i++) {
+            entry |= s_model.regs[REG_IDR0 - i] << (8 * i);
+        }
+        s_model.vlan[addr] = entry & VLAN_ENTRY_MASK;
+    }
+}
+
+/* the command and address phases are one byte each, the data follows with auto-incremented address */
+static esp_err_t model_spi_read(void *ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len)
+{
+    uint8_t *rx = data;
+    if (cmd != SPI_CMD_READ || !rx || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        rx[i] = s_model.regs[(uint8_t)(addr + i)];
+    }
+    return ESP_OK;
+}
+
+static esp_err_t model_spi_write(void *ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len)
+{
+    const uint8_t *tx = data;
+    if (cmd != SPI_CMD_WRITE || !tx || len == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        uint8_t reg = addr + i;
+        s_model.regs[reg] = tx[i];
+        if (reg == REG_IACR1) {
+            indirect_access();
+        }
+    }
+    return ESP_OK;
+}
+
+static const eth_spi_model_t s_spi_model = {
+    .read = model_spi_read,
+    .write = model_spi_write,
+};
+
+eth_spi_custom_driver_config_t ksz8863_model_spi_driver(void)
+{
+    return eth_spi_model_driver(&s_spi_model);
+}
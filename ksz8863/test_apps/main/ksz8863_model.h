@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "eth_spi_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define KSZ8863_MODEL_VLAN_ENTRIES  (16)
+
+/**
+ * @brief Statistics collected by the KSZ8863 model
+ */
+typedef struct {
+    uint32_t indir_reads;   /*!< Indirect read commands of the VLAN table */
+    uint32_t indir_writes;  /*!< Indirect write commands of the VLAN table */
+    uint32_t indir_other;   /*!< Indirect commands of the other tables, not modelled */
+} ksz8863_model_stats_t;
+
+/**
+ * @brief Reset the model to the power on state and clear the statistics
+ */
+void ksz8863_model_reset(void);
+
+/**
+ * @brief Get the statistics collected since the last reset
+ */
+const ksz8863_model_stats_t *ksz8863_model_stats(void);
+
+/**
+ * @brief Get a register value as held by the chip, without any SPI transaction
+ */
+uint8_t ksz8863_model_reg_get(uint8_t addr);
+
+/**
+ * @brief Set a register value as if the chip changed it, without any SPI transaction
+ */
+void ksz8863_model_reg_set(uint8_t addr, uint8_t value);
+
+/**
+ * @brief Get a VLAN table entry as held by the chip: valid [19], membership [18:16], FID [15:12] and VID [11:0]
+ */
+uint32_t ksz8863_model_vlan_entry_get(uint8_t index);
+
+/**
+ * @brief Set a VLAN table entry as held by the chip, see ksz8863_model_vlan_entry_get()
+ */
+void ksz8863_model_vlan_entry_set(uint8_t index, uint32_t entry);
+
+/**
+ * @brief Custom SPI driver of the control interface which executes its transactions against the model
+ */
+eth_spi_custom_driver_config_t ksz8863_model_spi_driver(void);
+
+#ifdef __cplusplus
+}
+#endif
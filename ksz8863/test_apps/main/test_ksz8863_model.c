@@ -0,0 +1,333 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "esp_eth_driver.h"
+#include "esp_eth_ksz8863.h"
+#include "ksz8863_model.h"
+#include "eth_spi_model.h"
+#include "unity.h"
+
+// Register addresses and bit positions as given by the datasheet, independently of the driver register definitions
+#define TEST_PCR0(port)             (0x10 + (port) * 0x10)
+#define TEST_PCR1(port)             (0x11 + (port) * 0x10)
+#define TEST_PCR2(port)             (0x12 + (port) * 0x10)
+#define TEST_PCR3(port)             (0x13 + (port) * 0x10)
+#define TEST_PCR4(port)             (0x14 + (port) * 0x10)
+#define TEST_PCR5(port)             (0x15 + (port) * 0x10)
+#define TEST_IDRL(port, queue)      (0x16 + (queue) + (port) * 0x10)
+#define TEST_EDRL(port, queue)      (0x9A + (queue) + (port) * 4)
+#define TEST_PCR0_TAG_INSERT        (1 << 2)
+#define TEST_PCR0_TAG_REMOVE        (1 << 1)
+#define TEST_PCR1_MEMBERSHIP_MASK   (0x07)
+#define TEST_PCR2_INGRESS_FILTER    (1 << 6)
+#define TEST_PCR2_DISCARD_NON_PVID  (1 << 5)
+#define TEST_PCR5_LIMIT_MODE_SHIFT  (2)
+#define TEST_PCR5_LIMIT_MODE_MASK   (0x0C)
+#define TEST_PCR5_COUNT_IFG         (1 << 1)
+#define TEST_PCR5_COUNT_PRE         (1 << 0)
+#define TEST_RATE_MASK              (0x7F)
+#define TEST_REG_IDR2               (0x81)
+#define TEST_REG_IDR1               (0x82)
+#define TEST_REG_IDR0               (0x83)
+
+#define TEST_PORTS_NUM              (2) // ports with a Port MAC
+
+static esp_eth_mac_t *s_macs[TEST_PORTS_NUM];
+
+static esp_err_t test_phy_reg_read(esp_eth_mediator_t *eth, uint32_t phy_addr, uint32_t phy_reg, uint32_t *reg_value)
+{
+    return ksz8863_phy_reg_read(NULL, phy_addr, phy_reg, reg_value);
+}
+
+static esp_err_t test_phy_reg_write(esp_eth_mediator_t *eth, uint32_t phy_addr, uint32_t phy_reg, uint32_t reg_value)
+{
+    return ksz8863_phy_reg_write(NULL, phy_addr, phy_reg, reg_value);
+}
+
+// registers are accessed the way ETH_KSZ8863_DEFAULT_CONFIG() sets up the Ethernet driver, through the control interface
+static esp_eth_mediator_t s_eth = {
+    .phy_reg_read = test_phy_reg_read,
+    .phy_reg_write = test_phy_reg_write,
+};
+
+/**
+ * @brief Reset the model and set up the control interface and the Port MACs the way the driver is used over SPI
+ */
+static void test_setup(void)
+{
+    eth_spi_model_reset();
+    ksz8863_model_reset();
+    TEST_ESP_OK(ksz8863_ctrl_intf_deinit());
+    ksz8863_ctrl_spi_config_t spi_dev_config = {
+        .host_id = SPI2_HOST,
+        .clock_speed_hz = 20 * 1000 * 1000,
+        .spics_io_num = -1,
+        .custom_spi_driver = ksz8863_model_spi_driver(),
+    };
+    ksz8863_ctrl_intf_config_t ctrl_intf_cfg = {
+        .host_mode = KSZ8863_SPI_MODE,
+        .spi_dev_config = &spi_dev_config,
+    };
+    TEST_ESP_OK(ksz8863_ctrl_intf_init(&ctrl_intf_cfg));
+
+    // Port MACs are created once, they are not bound to the control interface instance
+    eth_mac_config_t mac_config = ETH_MAC_DEFAULT_CONFIG();
+    for (int i = 0; i < TEST_PORTS_NUM; i++) {
+        if (!s_macs[i]) {
+            ksz8863_eth_mac_config_t ksz8863_config = {
+                .port_num = KSZ8863_PORT_1 + i,
+                .pmac_mode = KSZ8863_PORT_MODE,
+            };
+            s_macs[i] = esp_eth_mac_new_ksz8863(&ksz8863_config, &mac_config);
+            TEST_ASSERT_NOT_NULL(s_macs[i]);
+            TEST_ESP_OK(s_macs[i]->set_mediator(s_macs[i], &s_eth));
+        }
+    }
+}
+
+// VLAN table entry composed from the bit positions given by the datasheet, independently of the bit-fields
+static uint32_t test_ref_vlan_entry(bool valid, uint8_t membership, uint8_t fid, uint16_t vid)
+{
+    return (uint32_t)valid << 19 | (uint32_t)membership << 16 | (uint32_t)fid << 12 | vid;
+}
+
+static void test_regs_save(uint8_t *regs)
+{
+    for (int addr = 0; addr < 256; addr++) {
+        regs[addr] = ksz8863_model_reg_get(addr);
+    }
+}
+
+static void test_port_vlan_check(int port, const ksz8863_port_vlan_config_t *config, const uint8_t *regs_before)
+{
+    uint8_t pcr0 = regs_before[TEST_PCR0(port)] & ~(TEST_PCR0_TAG_INSERT | TEST_PCR0_TAG_REMOVE);
+    pcr0 |= (config->insert_tag ? TEST_PCR0_TAG_INSERT : 0) | (config->remove_tag ? TEST_PCR0_TAG_REMOVE : 0);
+    uint8_t pcr1 = (regs_before[TEST_PCR1(port)] & ~TEST_PCR1_MEMBERSHIP_MASK) | config->membership;
+    uint8_t pcr2 = regs_before[TEST_PCR2(port)] & ~(TEST_PCR2_INGRESS_FILTER | TEST_PCR2_DISCARD_NON_PVID);
+    pcr2 |= (config->ingress_filter ? TEST_PCR2_INGRESS_FILTER : 0) | (config->discard_non_pvid ? TEST_PCR2_DISCARD_NON_PVID : 0);
+
+    TEST_ASSERT_EQUAL_HEX8(pcr0, ksz8863_model_reg_get(TEST_PCR0(port)));
+    TEST_ASSERT_EQUAL_HEX8(pcr1, ksz8863_model_reg_get(TEST_PCR1(port)));
+    TEST_ASSERT_EQUAL_HEX8(pcr2, ksz8863_model_reg_get(TEST_PCR2(port)));
+    TEST_ASSERT_EQUAL_HEX8(config->default_tag >> 8, ksz8863_model_reg_get(TEST_PCR3(port)));
+    TEST_ASSERT_EQUAL_HEX8(config->default_tag & 0xFF, ksz8863_model_reg_get(TEST_PCR4(port)));
+    // nothing else is touched, the registers of the other ports included
+    for (int addr = 0; addr < 256; addr++) {
+        if (addr < TEST_PCR0(port) || addr > TEST_PCR4(port)) {
+            TEST_ASSERT_EQUAL_HEX8_MESSAGE(regs_before[addr], ksz8863_model_reg_get(addr), "unrelated register changed");
+        }
+    }
+
+    ksz8863_port_vlan_config_t config_get;
+    TEST_ESP_OK(s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_G_PORT_VLAN, &config_get));
+    TEST_ASSERT_EQUAL_HEX16(config->default_tag, config_get.default_tag);
+    TEST_ASSERT_EQUAL_HEX8(config->membership, config_get.membership);
+    TEST_ASSERT_EQUAL(config->insert_tag, config_get.insert_tag);
+    TEST_ASSERT_EQUAL(config->remove_tag, config_get.remove_tag);
+    TEST_ASSERT_EQUAL(config->ingress_filter, config_get.ingress_filter);
+    TEST_ASSERT_EQUAL(config->discard_non_pvid, config_get.discard_non_pvid);
+}
+
+TEST_CASE("VLAN table entries are placed in IDR2..IDR0", "[ksz8863_model]")
+{
+    ksz8863_vlan_table_t entries[KSZ8863_VLAN_TBL_MAX_ENTR];
+    uint32_t expected[KSZ8863_VLAN_TBL_MAX_ENTR];
+    test_setup();
+
+    memset(entries, 0, sizeof(entries));
+    for (int i = 0; i < KSZ8863_VLAN_TBL_MAX_ENTR; i++) {
+        entries[i].vid = (i * 0x111 + 0x5A) & 0xFFF;
+        entries[i].fid = KSZ8863_VLAN_TBL_MAX_ENTR - 1 - i;
+        entries[i].membership = i & 0x07;
+        entries[i].entry_val = i & 0x01;
+        expected[i] = test_ref_vlan_entry(entries[i].entry_val, entries[i].membership, entries[i].fid, entries[i].vid);
+    }
+    ksz8863_vlan_tbl_info_t tbl_info = {
+        .start_entry = 0,
+        .entries_num = KSZ8863_VLAN_TBL_MAX_ENTR,
+        .vlan_tbls = entries,
+    };
+    TEST_ESP_OK(s_macs[0]->custom_ioctl(s_macs[0], KSZ8863_ETH_CMD_S_VLAN_TBL, &tbl_info));
+    TEST_ASSERT_EQUAL_UINT32(KSZ8863_VLAN_TBL_MAX_ENTR, ksz8863_model_stats()->indir_writes);
+    TEST_ASSERT_EQUAL_UINT32(0, ksz8863_model_stats()->indir_other);
+    for (int i = 0; i < KSZ8863_VLAN_TBL_MAX_ENTR; i++) {
+        TEST_ASSERT_EQUAL_HEX32(expected[i], ksz8863_model_vlan_entry_get(i));
+    }
+    // the most significant byte of the entry goes to IDR2, the least significant to IDR0
+    uint32_t last = expected[KSZ8863_VLAN_TBL_MAX_ENTR - 1];
+    TEST_ASSERT_EQUAL_HEX8(last >> 16, ksz8863_model_reg_get(TEST_REG_IDR2));
+    TEST_ASSERT_EQUAL_HEX8((last >> 8) & 0xFF, ksz8863_model_reg_get(TEST_REG_IDR1));
+    TEST_ASSERT_EQUAL_HEX8(last & 0xFF, ksz8863_model_reg_get(TEST_REG_IDR0));
+
+    // a part of the table is read back entry by entry
+    for (int i = 0; i < KSZ8863_VLAN_TBL_MAX_ENTR; i++) {
+        expected[i] = test_ref_vlan_entry(!(i & 0x01), 0x07 - (i & 0x07), i, 0xFFF - i);
+        ksz8863_model_vlan_entry_set(i, expected[i]);
+    }
+    memset(entries, 0, sizeof(entries));
+    tbl_info.start_entry = 3;
+    tbl_info.entries_num = 5;
+    TEST_ESP_OK(s_macs[1]->custom_ioctl(s_macs[1], KSZ8863_ETH_CMD_G_VLAN_TBL, &tbl_info));
+    TEST_ASSERT_EQUAL_UINT32(5, ksz8863_model_stats()->indir_reads);
+    for (int i = 0; i < tbl_info.entries_num; i++) {
+        uint32_t entry = expected[tbl_info.start_entry + i];
+        TEST_ASSERT_EQUAL_HEX16(entry & 0xFFF, entries[i].vid);
+        TEST_ASSERT_EQUAL_HEX8((entry >> 12) & 0x0F, entries[i].fid);
+        TEST_ASSERT_EQUAL_HEX8((entry >> 16) & 0x07, entries[i].membership);
+        TEST_ASSERT_EQUAL((entry >> 19) & 0x01, entries[i].entry_val);
+    }
+    TEST_ASSERT_EQUAL_HEX16(0, entries[tbl_info.entries_num].vid);
+
+    // entries past the end of the table are refused before any of them is accessed
+    tbl_info.start_entry = KSZ8863_VLAN_TBL_MAX_ENTR - 2;
+    tbl_info.entries_num = 3;
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, s_macs[0]->custom_ioctl(s_macs[0], KSZ8863_ETH_CMD_S_VLAN_TBL, &tbl_info));
+    TEST_ASSERT_EQUAL_UINT32(KSZ8863_VLAN_TBL_MAX_ENTR, ksz8863_model_stats()->indir_writes);
+    TEST_ASSERT_EQUAL_UINT32(5, ksz8863_model_stats()->indir_reads);
+}
+
+TEST_CASE("port VLAN settings are placed in PCR0..PCR4", "[ksz8863_model]")
+{
+    static uint8_t s_regs_before[256];
+    test_setup();
+
+    for (int port = 0; port < TEST_PORTS_NUM; port++) {
+        // bits not related to VLAN are set, so that their loss shows
+        ksz8863_model_reg_set(TEST_PCR0(port), ~(TEST_PCR0_TAG_INSERT | TEST_PCR0_TAG_REMOVE));
+        ksz8863_model_reg_set(TEST_PCR1(port), ~TEST_PCR1_MEMBERSHIP_MASK);
+        ksz8863_model_reg_set(TEST_PCR2(port), ~(TEST_PCR2_INGRESS_FILTER | TEST_PCR2_DISCARD_NON_PVID));
+    }
+    for (int port = 0; port < TEST_PORTS_NUM; port++) {
+        ksz8863_port_vlan_config_t configs[] = {
+            {
+                .default_tag = 0xA123,
+                .membership = KSZ8863_TO_PORT1 | KSZ8863_TO_PORT3,
+                .insert_tag = true,
+                .ingress_filter = true,
+            },
+            {
+                .default_tag = 0x0001 + port,
+                .membership = KSZ8863_TO_PORT2,
+                .remove_tag = true,
+                .discard_non_pvid = true,
+            },
+            {
+                .default_tag = 0xFFFF,
+                .membership = KSZ8863_TO_PORT1 | KSZ8863_TO_PORT2 | KSZ8863_TO_PORT3,
+                .ingress_filter = true,
+                .discard_non_pvid = true,
+            },
+        };
+        for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+            test_regs_save(s_regs_before);
+            TEST_ESP_OK(s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_S_PORT_VLAN, &configs[i]));
+            test_port_vlan_check(port, &configs[i], s_regs_before);
+        }
+
+        // invalid configurations don't change anything
+        test_regs_save(s_regs_before);
+        ksz8863_port_vlan_config_t invalid = {
+            .default_tag = 0x0002,
+            .insert_tag = true,
+            .remove_tag = true,
+        };
+        TEST_ESP_ERR(ESP_ERR_INVALID_ARG, s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_S_PORT_VLAN, &invalid));
+        invalid.remove_tag = false;
+        invalid.membership = 0x08;
+        TEST_ESP_ERR(ESP_ERR_INVALID_ARG, s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_S_PORT_VLAN, &invalid));
+        for (int addr = 0; addr < 256; addr++) {
+            TEST_ASSERT_EQUAL_HEX8(s_regs_before[addr], ksz8863_model_reg_get(addr));
+        }
+    }
+}
+
+// Rate limit code as given by the datasheet: 1-99 for 1-99 Mbps, 101-115 for 64-960 kbps, 0 for no limit
+static uint8_t test_ref_rate(uint32_t kbps)
+{
+    if (kbps == 0) {
+        return 0;
+    }
+    return kbps < 1000 ? 100 + kbps / 64 : kbps / 1000;
+}
+
+TEST_CASE("port rate limits are placed in PCR5 and rate limit registers", "[ksz8863_model]")
+{
+    static uint8_t s_regs_before[256];
+    test_setup();
+
+    for (int port = 0; port < TEST_PORTS_NUM; port++) {
+        // bits not related to rate limiting are set, so that their loss shows
+        ksz8863_model_reg_set(TEST_PCR5(port), ~(TEST_PCR5_LIMIT_MODE_MASK | TEST_PCR5_COUNT_IFG | TEST_PCR5_COUNT_PRE));
+        for (int q = 0; q < KSZ8863_QUEUES_NUM; q++) {
+            ksz8863_model_reg_set(TEST_IDRL(port, q), ~TEST_RATE_MASK);
+        }
+    }
+    for (int port = 0; port < TEST_PORTS_NUM; port++) {
+        ksz8863_port_rate_limit_t limits[] = {
+            {
+                .ingress_kbps = { 64, 960, 1000, 99000 },
+                .egress_kbps = { 0, 128, 2000, 50000 },
+                .ingress_mode = KSZ8863_INGRESS_LIMIT_BCAST_MCAST_FLOOD,
+                .count_ifg = true,
+            },
+            {
+                .ingress_kbps = { 0, 0, 512, 10000 },
+                .egress_kbps = { 99000, 64, 0, 1000 },
+                .ingress_mode = KSZ8863_INGRESS_LIMIT_BCAST,
+                .count_preamble = true,
+            },
+        };
+        for (size_t i = 0; i < sizeof(limits) / sizeof(limits[0]); i++) {
+            test_regs_save(s_regs_before);
+            TEST_ESP_OK(s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT, &limits[i]));
+
+            uint8_t pcr5 = s_regs_before[TEST_PCR5(port)] & ~(TEST_PCR5_LIMIT_MODE_MASK | TEST_PCR5_COUNT_IFG | TEST_PCR5_COUNT_PRE);
+            pcr5 |= limits[i].ingress_mode << TEST_PCR5_LIMIT_MODE_SHIFT;
+            pcr5 |= (limits[i].count_ifg ? TEST_PCR5_COUNT_IFG : 0) | (limits[i].count_preamble ? TEST_PCR5_COUNT_PRE : 0);
+            TEST_ASSERT_EQUAL_HEX8(pcr5, ksz8863_model_reg_get(TEST_PCR5(port)));
+            for (int q = 0; q < KSZ8863_QUEUES_NUM; q++) {
+                uint8_t idrl = (s_regs_before[TEST_IDRL(port, q)] & ~TEST_RATE_MASK) | test_ref_rate(limits[i].ingress_kbps[q]);
+                TEST_ASSERT_EQUAL_HEX8(idrl, ksz8863_model_reg_get(TEST_IDRL(port, q)));
+                TEST_ASSERT_EQUAL_HEX8(test_ref_rate(limits[i].egress_kbps[q]), ksz8863_model_reg_get(TEST_EDRL(port, q)));
+            }
+            for (int addr = 0; addr < 256; addr++) {
+                bool port_reg = addr >= TEST_PCR5(port) && addr <= TEST_IDRL(port, KSZ8863_QUEUES_NUM - 1);
+                bool egress_reg = addr >= TEST_EDRL(port, 0) && addr <= TEST_EDRL(port, KSZ8863_QUEUES_NUM - 1);
+                if (!port_reg && !egress_reg) {
+                    TEST_ASSERT_EQUAL_HEX8_MESSAGE(s_regs_before[addr], ksz8863_model_reg_get(addr), "unrelated register changed");
+                }
+            }
+
+            // every rate reads back exactly as it was set
+            ksz8863_port_rate_limit_t limit_get;
+            TEST_ESP_OK(s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_G_PORT_RATE_LIMIT, &limit_get));
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(limits[i].ingress_kbps, limit_get.ingress_kbps, KSZ8863_QUEUES_NUM);
+            TEST_ASSERT_EQUAL_UINT32_ARRAY(limits[i].egress_kbps, limit_get.egress_kbps, KSZ8863_QUEUES_NUM);
+            TEST_ASSERT_EQUAL(limits[i].ingress_mode, limit_get.ingress_mode);
+            TEST_ASSERT_EQUAL(limits[i].count_ifg, limit_get.count_ifg);
+            TEST_ASSERT_EQUAL(limits[i].count_preamble, limit_get.count_preamble);
+        }
+
+        // rates which can't be represented are refused, in any queue, and nothing is changed
+        const uint32_t invalid_kbps[] = { 1, 32, 100, 999, 1500, 99999, 100000, 1000000 };
+        test_regs_save(s_regs_before);
+        for (size_t i = 0; i < sizeof(invalid_kbps) / sizeof(invalid_kbps[0]); i++) {
+            ksz8863_port_rate_limit_t limit = {
+                .ingress_kbps = { 1000, 1000, 1000, 1000 },
+                .egress_kbps = { 1000, 1000, 1000, 1000 },
+            };
+            limit.ingress_kbps[i % KSZ8863_QUEUES_NUM] = invalid_kbps[i];
+            TEST_ESP_ERR(ESP_ERR_INVALID_ARG, s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT, &limit));
+            limit.ingress_kbps[i % KSZ8863_QUEUES_NUM] = 1000;
+            limit.egress_kbps[KSZ8863_QUEUES_NUM - 1 - i % KSZ8863_QUEUES_NUM] = invalid_kbps[i];
+            TEST_ESP_ERR(ESP_ERR_INVALID_ARG, s_macs[port]->custom_ioctl(s_macs[port], KSZ8863_ETH_CMD_S_PORT_RATE_LIMIT, &limit));
+        }
+        for (int addr = 0; addr < 256; addr++) {
+            TEST_ASSERT_EQUAL_HEX8(s_regs_before[addr], ksz8863_model_reg_get(addr));
+        }
+    }
+}
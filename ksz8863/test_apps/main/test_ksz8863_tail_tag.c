@@ -0,0 +1,185 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <sys/cdefs.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_eth_ksz8863.h"
+#include "unity.h"
+
+#define TEST_CYCLES         (5000)
+#define TEST_CYCLE_FRAMES   (4) // frames forwarded while the ports are registered and again while they are not
+#define TEST_FRAME_LEN      (64)
+#define TEST_UNKNOWN_TAG    (KSZ8863_TAIL_TAG_PORTS_NUM) // Tail Tag of no port
+#define TEST_INPUT_SPINS    (200) // work done by stack_input, so that unregistering has a chance to overlap it
+
+/**
+ * @brief Port Ethernet interface as seen by the Tail Tag forwarding, only stack_input is used
+ */
+typedef struct {
+    esp_eth_mediator_t eth;
+    uint8_t tag;
+    _Atomic uint32_t frames;
+    _Atomic uint32_t bytes;
+    _Atomic uint32_t wrong_frames;
+    _Atomic bool deleted;               // set once unregistering returned, the handle may be deleted then
+    _Atomic uint32_t deleted_inputs;    // frames passed to the port while it was (or became) deleted
+} test_port_t;
+
+static test_port_t s_ports[KSZ8863_TAIL_TAG_PORTS_NUM];
+static volatile bool s_forward_stop;
+static _Atomic uint32_t s_forward_frames;
+
+static esp_err_t test_port_input(esp_eth_mediator_t *eth, uint8_t *buffer, uint32_t length)
+{
+    test_port_t *port = __containerof(eth, test_port_t, eth);
+    if (atomic_load(&port->deleted)) {
+        atomic_fetch_add(&port->deleted_inputs, 1);
+    }
+    for (volatile int i = 0; i < TEST_INPUT_SPINS; i++) {
+    }
+    // the handle must stay valid till stack_input returns
+    if (atomic_load(&port->deleted)) {
+        atomic_fetch_add(&port->deleted_inputs, 1);
+    }
+    // the first byte carries the Tail Tag the frame was sent with, the Tail Tag itself is stripped
+    if (length != TEST_FRAME_LEN - 1 || buffer[0] != port->tag) {
+        atomic_fetch_add(&port->wrong_frames, 1);
+    }
+    atomic_fetch_add(&port->frames, 1);
+    atomic_fetch_add(&port->bytes, length);
+    free(buffer);
+    return ESP_OK;
+}
+
+static void test_ports_init(void)
+{
+    memset(s_ports, 0, sizeof(s_ports));
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        s_ports[i].eth.stack_input = test_port_input;
+        s_ports[i].tag = i;
+    }
+    TEST_ESP_OK(ksz8863_unregister_tail_tag_port(NULL));
+    TEST_ESP_OK(ksz8863_clear_tail_tag_stats());
+}
+
+// let the forwarding task pass the given number of frames, it runs at the same priority on single core targets
+static void test_wait_frames(uint32_t frames)
+{
+    uint32_t start = atomic_load(&s_forward_frames);
+    while (atomic_load(&s_forward_frames) - start < frames) {
+        taskYIELD();
+    }
+}
+
+static void test_forward_task(void *arg)
+{
+    SemaphoreHandle_t done_sem = arg;
+    while (!s_forward_stop) {
+        uint8_t *frame = malloc(TEST_FRAME_LEN);
+        if (!frame) {
+            vTaskDelay(1);
+            continue;
+        }
+        uint8_t tag = atomic_load(&s_forward_frames) % (TEST_UNKNOWN_TAG + 1);
+        frame[0] = tag;
+        frame[TEST_FRAME_LEN - 1] = tag;
+        ksz8863_eth_tail_tag_port_forward(NULL, frame, TEST_FRAME_LEN, NULL);
+        atomic_fetch_add(&s_forward_frames, 1);
+    }
+    xSemaphoreGive(done_sem);
+    vTaskDelete(NULL);
+}
+
+TEST_CASE("tail tag ports register and unregister by handle", "[ksz8863_tail_tag]")
+{
+    test_ports_init();
+    esp_eth_handle_t p0 = &s_ports[0].eth;
+    esp_eth_handle_t p1 = &s_ports[1].eth;
+
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, ksz8863_register_tail_tag_port(NULL, 0));
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, ksz8863_register_tail_tag_port(p0, -1));
+    TEST_ESP_ERR(ESP_ERR_INVALID_ARG, ksz8863_register_tail_tag_port(p0, KSZ8863_TAIL_TAG_PORTS_NUM));
+    TEST_ESP_OK(ksz8863_register_tail_tag_port(p0, 0));
+    // the same handle again is fine, another one is refused
+    TEST_ESP_OK(ksz8863_register_tail_tag_port(p0, 0));
+    TEST_ESP_ERR(ESP_ERR_INVALID_STATE, ksz8863_register_tail_tag_port(p1, 0));
+    TEST_ESP_OK(ksz8863_register_tail_tag_port(p1, 1));
+
+    // only the given handle is removed
+    TEST_ESP_OK(ksz8863_unregister_tail_tag_port_handle(p0));
+    TEST_ESP_ERR(ESP_ERR_NOT_FOUND, ksz8863_unregister_tail_tag_port_handle(p0));
+    TEST_ESP_ERR(ESP_ERR_INVALID_STATE, ksz8863_register_tail_tag_port(p0, 1));
+    TEST_ESP_OK(ksz8863_register_tail_tag_port(p0, 0));
+
+    // the handle passed to the original entry point doesn't matter, all ports are removed
+    TEST_ESP_OK(ksz8863_unregister_tail_tag_port(p0));
+    TEST_ESP_ERR(ESP_ERR_NOT_FOUND, ksz8863_unregister_tail_tag_port_handle(p0));
+    TEST_ESP_ERR(ESP_ERR_NOT_FOUND, ksz8863_unregister_tail_tag_port_handle(p1));
+
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        uint8_t *frame = calloc(1, TEST_FRAME_LEN);
+        TEST_ASSERT_NOT_NULL(frame);
+        frame[TEST_FRAME_LEN - 1] = i;
+        ksz8863_eth_tail_tag_port_forward(NULL, frame, TEST_FRAME_LEN, NULL);
+    }
+    ksz8863_tail_tag_stats_t stats;
+    TEST_ESP_OK(ksz8863_get_tail_tag_stats(&stats));
+    TEST_ASSERT_EQUAL_UINT32(KSZ8863_TAIL_TAG_PORTS_NUM, stats.unknown_tag_cnt);
+}
+
+TEST_CASE("tail tag forwarding while ports register and unregister", "[ksz8863_tail_tag]")
+{
+    test_ports_init();
+    SemaphoreHandle_t done_sem = xSemaphoreCreateBinary();
+    TEST_ASSERT_NOT_NULL(done_sem);
+    s_forward_stop = false;
+    atomic_store(&s_forward_frames, 0);
+    // on the other core where there is one, so that the table changes in the middle of the lookup
+    TEST_ASSERT_EQUAL(pdPASS, xTaskCreatePinnedToCore(test_forward_task, "forward", 4096, done_sem, 5, NULL,
+                                                      portNUM_PROCESSORS - 1));
+
+    for (uint32_t cycle = 1; cycle <= TEST_CYCLES; cycle++) {
+        for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+            atomic_store(&s_ports[i].deleted, false);
+            TEST_ESP_OK(ksz8863_register_tail_tag_port(&s_ports[i].eth, i));
+        }
+        test_wait_frames(TEST_CYCLE_FRAMES);
+        for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+            TEST_ESP_OK(ksz8863_unregister_tail_tag_port_handle(&s_ports[i].eth));
+            // no frame is forwarded to the port any more, it could be deleted now
+            atomic_store(&s_ports[i].deleted, true);
+        }
+        test_wait_frames(TEST_CYCLE_FRAMES);
+    }
+    s_forward_stop = true;
+    TEST_ASSERT_EQUAL(pdTRUE, xSemaphoreTake(done_sem, pdMS_TO_TICKS(1000)));
+    vSemaphoreDelete(done_sem);
+    printf("%" PRIu32 " frames during %d register/unregister cycles\n", atomic_load(&s_forward_frames), TEST_CYCLES);
+
+    // every frame was either handed to the port of its Tail Tag or dropped, none was lost or misrouted
+    ksz8863_tail_tag_stats_t stats;
+    TEST_ESP_OK(ksz8863_get_tail_tag_stats(&stats));
+    uint32_t forwarded = 0;
+    for (int i = 0; i < KSZ8863_TAIL_TAG_PORTS_NUM; i++) {
+        TEST_ASSERT_EQUAL_UINT32(0, s_ports[i].wrong_frames);
+        TEST_ASSERT_EQUAL_UINT32(0, s_ports[i].deleted_inputs);
+        TEST_ASSERT_EQUAL_UINT32(s_ports[i].frames, stats.port[i].rx_frames);
+        TEST_ASSERT_EQUAL_UINT32(s_ports[i].bytes, stats.port[i].rx_bytes);
+        TEST_ASSERT_EQUAL_UINT32(s_ports[i].frames * (TEST_FRAME_LEN - 1), s_ports[i].bytes);
+        forwarded += s_ports[i].frames;
+    }
+    TEST_ASSERT_GREATER_THAN_UINT32(0, forwarded);
+    TEST_ASSERT_EQUAL_UINT32(atomic_load(&s_forward_frames), forwarded + stats.unknown_tag_cnt);
+    // frames with the Tail Tag of no port are never forwarded
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(atomic_load(&s_forward_frames) / (TEST_UNKNOWN_TAG + 1), stats.unknown_tag_cnt);
+}
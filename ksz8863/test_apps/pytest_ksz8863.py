@@ -0,0 +1,31 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""
+KSZ8863 driver tests which need no KSZ8863 hardware.
+"""
+
+import pytest
+
+from pytest_embedded import Dut
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default', 'esp32', marks=[pytest.mark.generic]),
+    ],
+    indirect=['target'],
+)
+def test_ksz8863_tail_tag(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='ksz8863_tail_tag')
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default', 'esp32', marks=[pytest.mark.generic]),
+    ],
+    indirect=['target'],
+)
+def test_ksz8863_model(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='ksz8863_model')
@@ -12,6 +12,8 @@
 #include "esp_eth_mac_spi.h"
 #endif
 #include "driver/spi_master.h"
+#include "eth_rx_pool.h"
+#include "eth_timestamp.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -26,6 +28,10 @@ typedef struct {
     int int_gpio_num;                                   /*!< Interrupt GPIO number, set to -1 if no interrupt */
     uint32_t poll_period_ms;                            /*!< Polling period in milliseconds if no interrupt */
     eth_spi_custom_driver_config_t custom_spi_driver;   /*!< Custom SPI driver configuration, optional */
+    eth_rx_pool_handle_t rx_pool;                       /*!< Pool to allocate received frames from, NULL to allocate them from heap. Its blocks must hold ETH_MAX_PACKET_SIZE bytes, frames are reassembled in them. With a pool, attach the driver to its netif by eth_rx_pool_new_netif_glue() */
+    uint32_t spi_queued_min_len;                        /*!< Queue SPI transfers of at least this many bytes, so the calling task sleeps while they run, 0 to poll all transfers */
+    bool rx_cut_through;                                /*!< Pass received frames to the host while they are still being received from the line */
+    bool tx_cut_through;                                /*!< Start transmitting to the line before the whole frame is transferred over SPI */
 } eth_lan865x_config_t;
 
 /**
@@ -39,8 +45,39 @@ typedef struct {
         .spi_host_id = spi_host,                \
         .spi_devcfg = spi_devcfg_p,             \
         .custom_spi_driver = ETH_DEFAULT_SPI,   \
+        .rx_pool = NULL,                        \
+        .spi_queued_min_len = 0,                \
+        .rx_cut_through = false,                \
+        .tx_cut_through = false,                \
     }
 
+/**
+ * @brief LAN865x specific commands for ioctl API
+ *
+ */
+typedef enum {
+    ETH_MAC_LAN865X_CMD_G_CHUNK_STATS = ETH_CMD_CUSTOM_MAC_CMDS_OFFSET,    /*!< Get data chunk statistics (eth_lan865x_chunk_stats_t) */
+    ETH_MAC_LAN865X_CMD_CLR_CHUNK_STATS,                                    /*!< Reset data chunk statistics (data unused) */
+} eth_mac_lan865x_io_cmd_t;
+
+/**
+ * @brief Statistics of OPEN Alliance data chunks exchanged with LAN865x
+ *
+ * Each SPI data transaction exchanges one chunk in both directions, hence (tx_chunks + rx_chunks - duplex_chunks) / total_chunks
+ * shows how well the full-duplex link is utilized.
+ *
+ */
+typedef struct {
+    uint32_t spi_transactions;  /*!< SPI transactions used to exchange the chunks */
+    uint32_t total_chunks;      /*!< Data chunks exchanged */
+    uint32_t tx_chunks;         /*!< Chunks carrying transmit data */
+    uint32_t rx_chunks;         /*!< Chunks carrying receive data */
+    uint32_t duplex_chunks;     /*!< Chunks carrying transmit and receive data at once */
+    uint32_t rx_dropped;        /*!< Received frames dropped by the driver (frame drop flag, oversize or no buffer) */
+    uint32_t rx_aborted;        /*!< Received frames which ended without end of frame, i.e. aborted on the line in cut-through mode */
+    uint32_t tx_aborted;        /*!< Transmitted frames aborted by LAN865x due to transmit buffer underflow or protocol error */
+} eth_lan865x_chunk_stats_t;
+
 /**
  * @brief Create a new LAN865x Ethernet MAC driver
  *
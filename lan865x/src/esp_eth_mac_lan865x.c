@@ -22,6 +22,7 @@
 // Driver headers
 #include "driver/gpio.h"
 #include "driver/spi_master.h"
+#include "eth_spi_transmit.h"
 #include "esp_private/gpio.h"
 #include "soc/io_mux_reg.h"
 
@@ -34,6 +35,7 @@
 #include "esp_eth_mac_spi.h"
 #include "esp_eth_mac_lan865x.h"
 #include "lan865x_reg.h"
+#include "oa_tc6.h"
 
 static const char *TAG = "lan865x.mac";
 
@@ -41,103 +43,51 @@ static const char *TAG = "lan865x.mac";
 #define LAN865X_WRITE_REG               (1)
 
 #define LAN865X_DUMMY_OFFSET            (4)
-#define LAN865X_HEADER_FOOTER_SIZE      (4)
-#define LAN865X_DATA_BLOCK_SIZE         (64)
 
 #define LAN865X_HASH_FILTER_TABLE_SIZE  (64)
 
-#define LAN865X_RX_BUFFER_SIZE (((ETH_MAX_PACKET_SIZE + LAN865X_DATA_BLOCK_SIZE - 1) / LAN865X_DATA_BLOCK_SIZE) * LAN865X_DATA_BLOCK_SIZE + LAN865X_HEADER_FOOTER_SIZE)
-#define LAN865X_SPI_BUFFER_SIZE (LAN865X_HEADER_FOOTER_SIZE + LAN865X_DATA_BLOCK_SIZE + LAN865X_DUMMY_OFFSET)
+// chunks exchanged in one SPI transaction at most, enough for a frame of maximal size
+#define LAN865X_FRAME_CHUNKS_MAX        ((ETH_MAX_PACKET_SIZE + OA_TC6_CHUNK_PAYLOAD_SIZE - 1) / OA_TC6_CHUNK_PAYLOAD_SIZE)
+
+#define LAN865X_RX_BUFFER_SIZE (ETH_MAX_PACKET_SIZE)
+#define LAN865X_SPI_BUFFER_SIZE (LAN865X_FRAME_CHUNKS_MAX * OA_TC6_CHUNK_SIZE)
 // use same size as for data block so we can use the same buffer for both data and control blocks
-#define LAN865X_SPI_MAX_CTRL_BLOCK_SIZE (LAN865X_DATA_BLOCK_SIZE)
+#define LAN865X_SPI_MAX_CTRL_BLOCK_SIZE (OA_TC6_CHUNK_PAYLOAD_SIZE)
 
 #define LAN865X_SPI_LOCK_TIMEOUT_MS     (500)
 #define LAN865X_SW_RESET_TIMEOUT_MS     (100)
 
-typedef struct {
-    union {
-        struct {
-            uint32_t parity: 1;        /* Parity bit over bits 31:1 */
-            uint32_t reserved: 5;       /* Reserved, set to 0 */
-            uint32_t tsc: 2;           /* Time Stamp Capture */
-            uint32_t ebo: 6;           /* End Byte Offset */
-            uint32_t ev: 1;            /* End Valid */
-            uint32_t reserved2: 1;     /* Reserved, set to 0 */
-            uint32_t swo: 4;           /* Start Word Offset */
-            uint32_t sv: 1;            /* Start Valid */
-            uint32_t dv: 1;            /* Data Valid */
-            uint32_t vs: 2;            /* Vendor Specific, set to 0 */
-            uint32_t reserved3: 5;     /* Reserved, set to 0 */
-            uint32_t norx: 1;          /* No Receive */
-            uint32_t seq: 1;           /* Data Block Sequence */
-            uint32_t dnc: 1;           /* Data Not Control, always 1 for data blocks */
-        };
-        uint32_t val;
-    };
-} lan865x_tx_header_t;
-
-typedef struct {
-    union {
-        struct {
-            uint32_t parity: 1;        /* Parity bit over bits 31:1 */
-            uint32_t txc: 5;           /* Transmit Credits */
-            uint32_t rtsp: 1;          /* Receive Timestamp Parity */
-            uint32_t rtsa: 1;          /* Receive Timestamp Added */
-            uint32_t ebo: 6;           /* End Byte Offset */
-            uint32_t ev: 1;            /* End Valid */
-            uint32_t fd: 1;            /* Frame Drop */
-            uint32_t swo: 4;           /* Start Word Offset */
-            uint32_t sv: 1;            /* Start Valid */
-            uint32_t dv: 1;            /* Data Valid */
-            uint32_t vs: 2;            /* Vendor Specific */
-            uint32_t rba: 5;           /* Receive Blocks Available */
-            uint32_t sync: 1;          /* Configuration Synchronized */
-            uint32_t hdrb: 1;          /* Header Bad */
-            uint32_t exst: 1;          /* Extended Status */
-        };
-        uint32_t val;
-    };
-} lan865x_rx_footer_t;
-
-typedef struct {
-    union {
-        struct {
-            uint32_t parity: 1;        /* Parity bit over bits 31:1 */
-            uint32_t len: 7;           /* Length - number of registers minus one */
-            uint32_t addr: 16;         /* Address of first register to access */
-            uint32_t mms: 4;           /* Memory Map Selector */
-            uint32_t aid: 1;            /* Address Increment disable */
-            uint32_t rw: 1;            /* Read/Write */
-            uint32_t hdrb: 1;          /* Header Bad */
-            uint32_t dnc: 1;           /* Data Not Control, always 0 for control */
-        };
-        uint32_t val;
-    };
-} lan865x_control_header_t;
-
-typedef struct {
-    lan865x_tx_header_t header;
-    uint8_t data[LAN865X_DATA_BLOCK_SIZE];
-} __attribute__((packed)) lan865x_tx_block_t;
-
-typedef struct {
-    uint8_t data[LAN865X_DATA_BLOCK_SIZE];
-    lan865x_rx_footer_t footer;
-} __attribute__((packed))lan865x_rx_block_t;
+// 64-bit timestamp prepended to received frames, seconds in the upper and nanoseconds in the lower word
+#define LAN865X_RX_TIMESTAMP_SIZE       (8)
+// transmit timestamp capture registers A, B and C
+#define LAN865X_TX_TIMESTAMP_CAPTURES   (3)
+// TSU timer is clocked by 25 MHz, the increment is in 1/2^24 ns
+#define LAN865X_TSU_INCREMENT_NS        (40)
+#define LAN865X_TSU_SUBNS_SHIFT         (24)
+// largest step MAC_TA applies at once
+#define LAN865X_TSU_ADJUST_MAX_NS       ((1 << 30) - 1)
 
 typedef struct {
-    lan865x_control_header_t header;
+    oa_tc6_ctrl_header_t header;
     uint32_t data[];
 } __attribute__((packed))lan865x_control_block_t;
 
 typedef struct {
     uint32_t dummy;
-    lan865x_control_header_t header;
+    oa_tc6_ctrl_header_t header;
     uint32_t data[];
 } __attribute__((packed))lan865x_control_resp_t;
 
+typedef struct {
+    uint8_t *buffer;
+    uint32_t length;
+    eth_timestamp_t ts;
+    bool ts_valid;
+} lan865x_rx_frame_t;
+
 typedef struct {
     spi_device_handle_t hdl;
+    uint32_t queued_min_len;
 } eth_spi_info_t;
 
 typedef struct {
@@ -158,8 +108,23 @@ typedef struct {
     int int_gpio_num;
     esp_timer_handle_t poll_timer;
     uint32_t poll_period_ms;
-    uint8_t *rx_buffer;
+    uint8_t *rx_buffer;                                     /* Frame being reassembled, passed to the stack as it is at its end */
     uint8_t *spi_buffer;
+    eth_rx_pool_handle_t rx_pool;
+    bool rx_started;                                        /* Frame is being reassembled in rx_buffer */
+    uint32_t rx_len;                                        /* Bytes of the frame reassembled so far */
+    lan865x_rx_frame_t rx_frames[LAN865X_FRAME_CHUNKS_MAX]; /* Received frames waiting for the task to pass them to the stack */
+    uint32_t rx_frames_cnt;
+    uint8_t txc;                                            /* Transmit credits reported by the last chunk footer */
+    bool rx_cut_through;
+    bool tx_cut_through;
+    bool status_pending;                                    /* Chunk footer indicated an event in OA_STATUS0 */
+    eth_timestamp_t rx_ts;                                  /* Timestamp of the frame being reassembled */
+    bool rx_ts_valid;
+    eth_timestamp_config_t ts_config;                       /* Timestamping callbacks, all NULL when disabled */
+    uint8_t tx_ts_busy;                                     /* Transmit timestamp captures waiting for the timestamp, bit per capture */
+    uint32_t tx_ts_ids[LAN865X_TX_TIMESTAMP_CAPTURES];      /* Frame identifiers of the busy captures */
+    eth_lan865x_chunk_stats_t chunk_stats;
     int8_t hash_filter_cnt[LAN865X_HASH_FILTER_TABLE_SIZE];
 } emac_lan865x_t;
 
@@ -190,6 +155,7 @@ static void *lan865x_spi_init(const void *spi_config)
     // Initialize SPI device
     ESP_GOTO_ON_FALSE(spi_bus_add_device(lan865x_config->spi_host_id, &devcfg, &spi_info->hdl) == ESP_OK,
                       NULL, err_spi, TAG, "failed to add SPI device");
+    spi_info->queued_min_len = lan865x_config->spi_queued_min_len;
 
     ret = spi_info;
     return ret;
@@ -220,7 +186,7 @@ static esp_err_t lan865x_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, c
         .tx_buffer = value,
     };
 
-    ESP_RETURN_ON_ERROR(spi_device_polling_transmit(spi->hdl, &trans), TAG, "spi write failed");
+    ESP_RETURN_ON_ERROR(eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len), TAG, "spi write failed");
 
     return ret;
 }
@@ -236,163 +202,138 @@ static esp_err_t lan865x_spi_read(void *spi_ctx, uint32_t cmd, uint32_t addr, vo
         .tx_buffer = value,
     };
 
-    ESP_RETURN_ON_ERROR(spi_device_polling_transmit(spi->hdl, &trans), TAG, "spi write-read failed");
+    ESP_RETURN_ON_ERROR(eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len), TAG, "spi write-read failed");
 
     return ret;
 }
 
-static bool lan865x_parity(uint32_t value)
+// Receive timestamp parity bit, the timestamp and the bit together have odd number of 1s
+static bool lan865x_timestamp_parity(uint64_t ts)
 {
-    value >>= 1; // Skip bit 0
-
-    for (int shift = 16; shift >= 1; shift /= 2) {
-        value ^= value >> shift;
-    }
-    return !(value & 0x1);
+    return !__builtin_parityll(ts);
 }
 
-static esp_err_t lan865x_frame_transmit(emac_lan865x_t *emac, uint8_t *frame, uint32_t length)
+// Processes receive data of a chunk, `data` points to the chunk payload returned by LAN865x
+static void lan865x_rx_chunk(emac_lan865x_t *emac, const uint8_t *data, oa_tc6_data_footer_t footer)
 {
-    esp_err_t ret = ESP_OK;
-    // the same memory is used for tx and rx blocks
-    lan865x_tx_block_t *tx_block = (lan865x_tx_block_t *)emac->spi_buffer;
-    lan865x_rx_block_t *rx_block = (lan865x_rx_block_t *)emac->spi_buffer;
-
-    if (!lan865x_spi_lock(emac)) {
-        ESP_LOGE(TAG, "%s: timeout", __func__);
-        return ESP_ERR_TIMEOUT;
+    if (footer.dv == 0) {
+        return;
     }
-    int chunks = (length + LAN865X_DATA_BLOCK_SIZE - 1) / LAN865X_DATA_BLOCK_SIZE;
-    for (int i = 0; i < chunks; i++) {
-        tx_block->header.val = 0; // clear to be reused
-
-        tx_block->header.dnc = 1; // Data, not control
-        tx_block->header.dv = 1; // Data valid
-        tx_block->header.norx = 1; // No data receive
-        if (i == 0) {
-            tx_block->header.sv = 1;
-            tx_block->header.swo = 0;
+    emac->chunk_stats.rx_chunks++;
+    uint32_t offset = 0;
+    if (footer.sv) {
+        if (emac->rx_started) {
+            ESP_LOGW(TAG, "end of received frame missing");
+            emac->chunk_stats.rx_aborted++;
         }
-        if (i == chunks - 1) {
-            tx_block->header.ev = 1;
-            tx_block->header.ebo = (length - 1) % LAN865X_DATA_BLOCK_SIZE;
-            uint32_t remaining = length - i * LAN865X_DATA_BLOCK_SIZE;
-            memcpy(tx_block->data, frame + i * LAN865X_DATA_BLOCK_SIZE, remaining);
-        } else {
-            memcpy(tx_block->data, frame + i * LAN865X_DATA_BLOCK_SIZE, LAN865X_DATA_BLOCK_SIZE);
+        // Data should be always aligned to zero due to LAN865X_OA_CONFIG0_RECV_FRAME_ALIGN_ZERO
+        emac->rx_started = footer.swo == 0;
+        emac->rx_len = 0;
+        emac->rx_ts_valid = false;
+        // length of the frame is known only at its end, so the buffer is allocated for the largest one; it is kept
+        // for the next frame if this one is dropped
+        if (emac->rx_started && emac->rx_buffer == NULL) {
+            emac->rx_buffer = eth_rx_pool_alloc(emac->rx_pool, LAN865X_RX_BUFFER_SIZE);
+            if (emac->rx_buffer == NULL) {
+                ESP_LOGE(TAG, "no mem for receive buffer");
+                emac->chunk_stats.rx_dropped++;
+                emac->rx_started = false;
+            }
+        }
+        // the timestamp precedes frame data in the chunk, it's stripped even if it's corrupted
+        if (footer.rtsa) {
+            uint64_t ts;
+            memcpy(&ts, data, sizeof(ts));
+            ts = be64toh(ts);
+            if (footer.rtsp == lan865x_timestamp_parity(ts)) {
+                emac->rx_ts.seconds = ts >> 32;
+                emac->rx_ts.nanoseconds = (uint32_t)ts;
+                emac->rx_ts_valid = true;
+            } else {
+                ESP_LOGW(TAG, "receive timestamp parity mismatch");
+            }
+            offset = LAN865X_RX_TIMESTAMP_SIZE;
         }
-        tx_block->header.parity = lan865x_parity(tx_block->header.val);
-        tx_block->header.val = htobe32(tx_block->header.val);
-
-        ESP_GOTO_ON_ERROR(emac->spi.read(emac->spi.ctx, 0, 0, tx_block, sizeof(lan865x_tx_block_t)), err_inv_data, TAG, "spi failed");
-
-        // compute footer parity - should have odd number of 1s
-        bool footer_parity = lan865x_parity(rx_block->footer.val);
-        // Invalid footer parity indicates potential data corruption at SPI from LAN865X
-        ESP_GOTO_ON_FALSE(footer_parity == rx_block->footer.parity, ESP_ERR_INVALID_CRC, err_inv_data, TAG, "footer parity mismatch");
-        // Header bad indicates potential data corruption at SPI to LAN865X
-        ESP_GOTO_ON_FALSE(rx_block->footer.hdrb == 0, ESP_ERR_INVALID_CRC, err, TAG, "header bad");
     }
+    // in case start of the frame was missed, wait for a new start
+    if (!emac->rx_started) {
+        return;
+    }
+    uint32_t copy_len = (footer.ev ? footer.ebo + 1 : OA_TC6_CHUNK_PAYLOAD_SIZE) - offset; // +1 because it's offset, not length
+    if (emac->rx_len + copy_len > ETH_MAX_PACKET_SIZE) {
+        ESP_LOGW(TAG, "received frame too long, dropped");
+        emac->chunk_stats.rx_dropped++;
+        emac->rx_started = false;
+        return;
+    }
+    memcpy(emac->rx_buffer + emac->rx_len, data + offset, copy_len);
+    emac->rx_len += copy_len;
+    if (footer.ev == 0) {
+        return;
+    }
+    emac->rx_started = false;
+    // in cut-through mode, this is the only indication the frame was received with FCS error
+    if (footer.fd) {
+        ESP_LOGD(TAG, "frame dropped by LAN865x");
+        emac->chunk_stats.rx_dropped++;
+        return;
+    }
+    if (emac->rx_frames_cnt >= LAN865X_FRAME_CHUNKS_MAX) {
+        ESP_LOGE(TAG, "receive queue full");
+        emac->chunk_stats.rx_dropped++;
+        return;
+    }
+    emac->rx_frames[emac->rx_frames_cnt].buffer = emac->rx_buffer;
+    emac->rx_frames[emac->rx_frames_cnt].length = emac->rx_len;
+    emac->rx_frames[emac->rx_frames_cnt].ts = emac->rx_ts;
+    emac->rx_frames[emac->rx_frames_cnt].ts_valid = emac->rx_ts_valid;
+    emac->rx_frames_cnt++;
+    emac->rx_buffer = NULL;
+}
 
-err:
-    // if there is data to receive, notify the rx_task
-    if (rx_block->footer.rba > 0) {
-        xTaskNotifyGive(emac->rx_task_hdl);
+// Claims a free transmit timestamp capture for a frame, returns the capture select of the chunk header, 0 if all are busy
+static uint8_t lan865x_tx_timestamp_claim(emac_lan865x_t *emac, uint32_t tx_id)
+{
+    for (uint8_t i = 0; i < LAN865X_TX_TIMESTAMP_CAPTURES; i++) {
+        if ((emac->tx_ts_busy & (1 << i)) == 0) {
+            emac->tx_ts_busy |= 1 << i;
+            emac->tx_ts_ids[i] = tx_id;
+            return i + 1;
+        }
     }
-err_inv_data:
-    lan865x_spi_unlock(emac);
-    return ret;
+    ESP_LOGW(TAG, "no free transmit timestamp capture");
+    return 0;
 }
 
-static esp_err_t lan865x_frame_receive(emac_lan865x_t *emac, uint8_t *frame, uint32_t *length, uint8_t *remain)
+// Takes up to `max` received frames out of the queue, in the order they were received, along with the timestamping
+// configuration to report their timestamps by (if `ts_config` is not NULL)
+static uint32_t lan865x_rx_frames_take(emac_lan865x_t *emac, lan865x_rx_frame_t *frames, uint32_t max, eth_timestamp_config_t *ts_config)
 {
-    esp_err_t ret = ESP_OK;
-    uint8_t *rx_buffer_p = frame;
-    lan865x_tx_block_t *tx_block;
-    lan865x_rx_block_t *rx_block;
-    uint8_t blocks_available = 0;
-    uint32_t actual_length = 0;
-    bool start_found = false;
     if (!lan865x_spi_lock(emac)) {
         ESP_LOGE(TAG, "%s: timeout", __func__);
-        return ESP_ERR_TIMEOUT;
+        return 0;
     }
-    do {
-        // check if input buffer is able to fit the next chunk
-        if (actual_length + LAN865X_DATA_BLOCK_SIZE + LAN865X_HEADER_FOOTER_SIZE > *length) {
-            ESP_LOGW(TAG, "frame truncated");
-            break;
-        }
-        // the same memory is used for tx and rx blocks (tx_block is just used to initiate receive)
-        tx_block = (lan865x_tx_block_t *)rx_buffer_p;
-        rx_block = (lan865x_rx_block_t *)rx_buffer_p;
-
-        // prepare empty tx block header to initiate receive data
-        memset(&tx_block->header.val, 0, sizeof(lan865x_tx_header_t));
-        tx_block->header.dnc = 1; // Data, not control
-        tx_block->header.parity = lan865x_parity(tx_block->header.val);
-        tx_block->header.val = be32toh(tx_block->header.val);
-
-        // initiate SPI transaction
-        ESP_GOTO_ON_ERROR(emac->spi.read(emac->spi.ctx, 0, 0, tx_block, sizeof(lan865x_tx_block_t)), err_inv_data, TAG, "spi failed");
-
-        rx_block->footer.val = be32toh(rx_block->footer.val);
-        // compute footer parity - should have odd number of 1s
-        bool footer_parity = lan865x_parity(rx_block->footer.val);
-        // Invalid footer parity indicates potential data corruption at SPI from LAN865X
-        ESP_GOTO_ON_FALSE(footer_parity == rx_block->footer.parity, ESP_ERR_INVALID_CRC, err_inv_data, TAG, "footer parity mismatch");
-        // Header bad indicates potential data corruption at SPI to LAN865X
-        ESP_GOTO_ON_FALSE(rx_block->footer.hdrb == 0, ESP_ERR_INVALID_CRC, err, TAG, "header bad");
-        blocks_available = rx_block->footer.rba;
-
-        // check if data is valid
-        if (rx_block->footer.dv == 1) {
-            // in case previous block was partially received, find a new start
-            if (!start_found) {
-                if (rx_block->footer.sv == 1) {
-                    // Data should be always aligned to zero due to LAN865X_OA_CONFIG0_RECV_FRAME_ALIGN_ZERO
-                    ESP_GOTO_ON_FALSE(rx_block->footer.swo == 0, ESP_ERR_INVALID_STATE, err, TAG, "partial block received");
-                    start_found = true;
-                } else {
-                    continue;
-                }
-            }
-
-            uint8_t copy_len;
-            if (rx_block->footer.ev) {
-                copy_len = rx_block->footer.ebo + 1; // +1 because it's offset, not length
-            } else {
-                copy_len = LAN865X_DATA_BLOCK_SIZE;
-            }
-            actual_length += copy_len;
-            // move pointer in rx_buffer to next block
-            rx_buffer_p += LAN865X_DATA_BLOCK_SIZE;
-        }
-    } while (rx_block->footer.dv == 1 && !rx_block->footer.ev);
-
-err:
-    if (remain != NULL) {
-        *remain = blocks_available;
+    uint32_t cnt = emac->rx_frames_cnt < max ? emac->rx_frames_cnt : max;
+    memcpy(frames, emac->rx_frames, cnt * sizeof(lan865x_rx_frame_t));
+    emac->rx_frames_cnt -= cnt;
+    memmove(emac->rx_frames, emac->rx_frames + cnt, emac->rx_frames_cnt * sizeof(lan865x_rx_frame_t));
+    if (ts_config) {
+        *ts_config = emac->ts_config;
     }
-err_inv_data:
     lan865x_spi_unlock(emac);
-    *length = actual_length;
-    return ret;
+    return cnt;
 }
 
-static esp_err_t lan865x_control_transaction(emac_lan865x_t *emac, bool write, uint8_t mms, uint16_t addr, uint8_t len, uint32_t *data)
+// The caller holds the SPI lock
+static esp_err_t lan865x_control_transaction_locked(emac_lan865x_t *emac, bool write, uint8_t mms, uint16_t addr, uint8_t len, uint32_t *data)
 {
     esp_err_t ret = ESP_OK;
     ESP_LOGD(TAG, "ctrl_translen: %" PRIu8 ", addr: 0x%04" PRIx16 ", mms: %" PRIu8 ", write: %d", len, addr, mms, write);
     ESP_RETURN_ON_FALSE(len * 4 <= LAN865X_SPI_MAX_CTRL_BLOCK_SIZE, ESP_ERR_INVALID_ARG, TAG, "invalid length");
-    if (!lan865x_spi_lock(emac)) {
-        ESP_LOGE(TAG, "%s: timeout", __func__);
-        return ESP_ERR_TIMEOUT;
-    }
-    uint32_t trans_len = LAN865X_DUMMY_OFFSET + LAN865X_HEADER_FOOTER_SIZE + len * 4;
+    uint32_t trans_len = LAN865X_DUMMY_OFFSET + OA_TC6_HEADER_FOOTER_SIZE + len * 4;
 
     // Prepare control header
-    lan865x_control_header_t ctrl_hdr = {
+    oa_tc6_ctrl_header_t ctrl_hdr = {
         .len = len - 1,  // Number of registers - 1
         .addr = addr,    // Register address
         .mms = mms,      // Memory map selector
@@ -402,7 +343,7 @@ static esp_err_t lan865x_control_transaction(emac_lan865x_t *emac, bool write, u
     };
 
     // Calculate header parity - odd number of 1s
-    ctrl_hdr.parity = lan865x_parity(ctrl_hdr.val);
+    ctrl_hdr.parity = oa_tc6_parity(ctrl_hdr.val);
 
     lan865x_control_block_t *control_block = (lan865x_control_block_t *)emac->spi_buffer;
     control_block->header.val = htobe32(ctrl_hdr.val);
@@ -415,7 +356,7 @@ static esp_err_t lan865x_control_transaction(emac_lan865x_t *emac, bool write, u
     ESP_GOTO_ON_ERROR(emac->spi.read(emac->spi.ctx, 0, 0, emac->spi_buffer, trans_len), err, TAG, "spi failed");
     lan865x_control_resp_t *control_resp = (lan865x_control_resp_t *)emac->spi_buffer;
     control_resp->header.val = be32toh(control_resp->header.val);
-    bool footer_parity = lan865x_parity(control_resp->header.val);
+    bool footer_parity = oa_tc6_parity(control_resp->header.val);
     // Invalid footer parity indicates potential data corruption at SPI from LAN865X
     ESP_GOTO_ON_FALSE(footer_parity == control_resp->header.parity, ESP_ERR_INVALID_CRC, err, TAG, "footer parity mismatch");
     // Header bad indicates potential data corruption at SPI to LAN865X
@@ -426,8 +367,103 @@ static esp_err_t lan865x_control_transaction(emac_lan865x_t *emac, bool write, u
             data++;
         }
     }
+err:
+    return ret;
+}
+
+static esp_err_t lan865x_control_transaction(emac_lan865x_t *emac, bool write, uint8_t mms, uint16_t addr, uint8_t len, uint32_t *data)
+{
+    if (!lan865x_spi_lock(emac)) {
+        ESP_LOGE(TAG, "%s: timeout", __func__);
+        return ESP_ERR_TIMEOUT;
+    }
+    esp_err_t ret = lan865x_control_transaction_locked(emac, write, mms, addr, len, data);
+    lan865x_spi_unlock(emac);
+    return ret;
+}
+
+/**
+ * @brief Exchange data chunks with LAN865x
+ *
+ * All chunks are exchanged in a single SPI transaction. Every chunk carries transmit data (if any) to LAN865x
+ * and receive data (if any) back, so frames received while transmitting don't need separate transactions.
+ * Completed receive frames are queued in `rx_frames`. The transmitted frame gets timestamped if the timestamping
+ * configuration has selected it. Transmit credits are checked under the same SPI lock, so concurrent transmits can't
+ * both spend the same credits.
+ *
+ * @param emac LAN865x driver
+ * @param frame frame to transmit, NULL to only receive
+ * @param length length of the frame to transmit
+ * @param tx_id identifier the timestamping configuration assigned to the frame, NULL if it is not to be timestamped
+ * @param rx_chunks minimal number of chunks to exchange, i.e. receive blocks to fetch
+ * @param[out] rba receive blocks available as reported by the last chunk footer
+ * @return ESP_ERR_NO_MEM if LAN865x does not have enough transmit credits for the frame
+ */
+static esp_err_t lan865x_chunk_exchange(emac_lan865x_t *emac, const uint8_t *frame, uint32_t length, const uint32_t *tx_id, uint32_t rx_chunks,
+                                        uint8_t *rba)
+{
+    esp_err_t ret = ESP_OK;
+    oa_tc6_data_footer_t footer = { .val = 0 };
+    uint32_t tx_chunks = frame ? (length + OA_TC6_CHUNK_PAYLOAD_SIZE - 1) / OA_TC6_CHUNK_PAYLOAD_SIZE : 0;
+    uint32_t chunks = tx_chunks > rx_chunks ? tx_chunks : rx_chunks;
+    if (chunks > LAN865X_FRAME_CHUNKS_MAX) {
+        chunks = LAN865X_FRAME_CHUNKS_MAX;
+    }
+
+    if (!lan865x_spi_lock(emac)) {
+        ESP_LOGE(TAG, "%s: timeout", __func__);
+        return ESP_ERR_TIMEOUT;
+    }
+    // credits from the last footer only decrease by transmitting, refresh them just when they seem insufficient
+    if (tx_chunks > emac->txc) {
+        lan865x_oa_bufsts_reg_t oa_bufsts;
+        ESP_GOTO_ON_ERROR(lan865x_control_transaction_locked(emac, LAN865X_READ_REG, LAN865X_MMS_OA, LAN865X_OA_BUFSTS_REG_ADDR, 1, &oa_bufsts.val),
+                          err_unlock, TAG, "OA_BUFSTS read failed");
+        emac->txc = oa_bufsts.txc;
+        if (tx_chunks > emac->txc) {
+            ESP_LOGD(TAG, "Not enough transmit credits available");
+            ret = ESP_ERR_NO_MEM;
+            goto err_unlock;
+        }
+    }
+    uint8_t tsc = 0;
+    // timestamping may have been disabled since the frame was matched
+    if (tx_id && emac->ts_config.tx_match_cb) {
+        tsc = lan865x_tx_timestamp_claim(emac, *tx_id);
+    }
+    // each chunk completes at most one frame, so stop receiving when no more frames can be queued
+    oa_tc6_tx_chunks_build(emac->spi_buffer, chunks, frame, length, tsc, LAN865X_FRAME_CHUNKS_MAX - emac->rx_frames_cnt);
+
+    ESP_GOTO_ON_ERROR(emac->spi.read(emac->spi.ctx, 0, 0, emac->spi_buffer, chunks * OA_TC6_CHUNK_SIZE), err, TAG, "spi failed");
+    emac->chunk_stats.spi_transactions++;
+
+    for (uint32_t i = 0; i < chunks; i++) {
+        const uint8_t *chunk = emac->spi_buffer + i * OA_TC6_CHUNK_SIZE;
+        // Invalid footer parity indicates potential data corruption at SPI from LAN865X
+        ESP_GOTO_ON_FALSE(oa_tc6_rx_footer_get(chunk, &footer), ESP_ERR_INVALID_CRC, err, TAG, "footer parity mismatch");
+        // Header bad indicates potential data corruption at SPI to LAN865X
+        ESP_GOTO_ON_FALSE(footer.hdrb == 0, ESP_ERR_INVALID_CRC, err, TAG, "header bad");
 
+        emac->chunk_stats.total_chunks++;
+        if (i < tx_chunks) {
+            emac->chunk_stats.tx_chunks++;
+            emac->chunk_stats.duplex_chunks += footer.dv;
+        }
+        lan865x_rx_chunk(emac, chunk, footer);
+        emac->status_pending |= footer.exst;
+    }
+    // credits reported by the last footer save reading OA_BUFSTS before the next transfer
+    emac->txc = footer.txc;
+    *rba = footer.rba;
+    lan865x_spi_unlock(emac);
+    return ESP_OK;
 err:
+    // the frame being received can't be completed anymore
+    emac->rx_started = false;
+    if (tsc) {
+        emac->tx_ts_busy &= ~(1 << (tsc - 1));
+    }
+err_unlock:
     lan865x_spi_unlock(emac);
     return ret;
 }
@@ -848,13 +884,29 @@ static esp_err_t emac_lan865x_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_
     emac_lan865x_t *emac = __containerof(mac, emac_lan865x_t, parent);
     ESP_LOGD(TAG, "Transmitting %" PRIu32 " bytes", length);
 
-    lan865x_oa_bufsts_reg_t oa_bufsts;
-    ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_OA, LAN865X_OA_BUFSTS_REG_ADDR, &oa_bufsts.val), err,  TAG, "OA_BUFSTS read failed");
-    if (oa_bufsts.txc < (length + LAN865X_DATA_BLOCK_SIZE - 1) / LAN865X_DATA_BLOCK_SIZE) {
-        ESP_LOGD(TAG, "Not enough transmit credits available");
-        return ESP_ERR_NO_MEM;
+    ESP_GOTO_ON_FALSE(length <= ETH_MAX_PACKET_SIZE, ESP_ERR_INVALID_ARG, err, TAG, "frame size is too big (actual %" PRIu32 ", maximum %d)",
+                      length, ETH_MAX_PACKET_SIZE);
+    // the frame is matched before the SPI lock is taken, so the callback does not hold off other SPI transactions
+    uint32_t tx_id;
+    bool ts_match = false;
+    if (emac->ts_config.tx_match_cb) {
+        eth_timestamp_config_t ts_config;
+        ESP_RETURN_ON_FALSE(lan865x_spi_lock(emac), ESP_ERR_TIMEOUT, TAG, "%s: timeout", __func__);
+        ts_config = emac->ts_config;
+        lan865x_spi_unlock(emac);
+        ts_match = ts_config.tx_match_cb && ts_config.tx_match_cb(buf, length, &tx_id, ts_config.user_ctx);
+    }
+    // the whole frame is transferred in one transaction
+    uint8_t rba = 0;
+    ret = lan865x_chunk_exchange(emac, buf, length, ts_match ? &tx_id : NULL, 0, &rba);
+    if (ret == ESP_ERR_NO_MEM) {
+        return ret;
+    }
+    ESP_GOTO_ON_FALSE(ret == ESP_OK, ESP_FAIL, err, TAG, "frame transmit failed at SPI");
+    // frames received while transmitting are passed to the stack by the task, it also fetches the rest
+    if (rba > 0 || emac->rx_frames_cnt > 0 || emac->status_pending) {
+        xTaskNotifyGive(emac->rx_task_hdl);
     }
-    ESP_GOTO_ON_FALSE(lan865x_frame_transmit(emac, buf, length) == ESP_OK, ESP_FAIL, err, TAG, "frame transmit failed at SPI");
 err:
     return ret;
 }
@@ -863,23 +915,30 @@ static esp_err_t emac_lan865x_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t
 {
     esp_err_t ret = ESP_OK;
     emac_lan865x_t *emac = __containerof(mac, emac_lan865x_t, parent);
-    lan865x_oa_bufsts_reg_t oa_bufsts;
-    ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_OA, LAN865X_OA_BUFSTS_REG_ADDR, &oa_bufsts.val), err,  TAG, "OA_BUFSTS read failed");
-    if (oa_bufsts.rba < 1) {
-        ESP_LOGD(TAG, "No receive blocks available");
-        return ESP_ERR_NO_MEM;
-    }
-    uint32_t frame_len = LAN865X_RX_BUFFER_SIZE;
-    ESP_GOTO_ON_ERROR(lan865x_frame_receive(emac, emac->rx_buffer, &frame_len, NULL), err, TAG, "frame receive failed at SPI");
-    if (frame_len > 0) {
-        uint32_t copy_len = frame_len;
-        if (frame_len > *length) {
-            ret = ESP_ERR_INVALID_SIZE;
-            copy_len = *length;
+    lan865x_rx_frame_t frame;
+    // frame may have been already received while transmitting
+    if (lan865x_rx_frames_take(emac, &frame, 1, NULL) == 0) {
+        lan865x_oa_bufsts_reg_t oa_bufsts;
+        ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_OA, LAN865X_OA_BUFSTS_REG_ADDR, &oa_bufsts.val), err,  TAG, "OA_BUFSTS read failed");
+        if (oa_bufsts.rba < 1) {
+            ESP_LOGD(TAG, "No receive blocks available");
+            return ESP_ERR_NO_MEM;
         }
-        memcpy(buf, emac->rx_buffer, copy_len);
-        *length = frame_len;
+        uint8_t rba;
+        ESP_GOTO_ON_ERROR(lan865x_chunk_exchange(emac, NULL, 0, NULL, oa_bufsts.rba, &rba), err, TAG, "frame receive failed at SPI");
+        if (lan865x_rx_frames_take(emac, &frame, 1, NULL) == 0) {
+            *length = 0;
+            return ESP_OK;
+        }
+    }
+    uint32_t copy_len = frame.length;
+    if (frame.length > *length) {
+        ret = ESP_ERR_INVALID_SIZE;
+        copy_len = *length;
     }
+    memcpy(buf, frame.buffer, copy_len);
+    eth_rx_pool_free(frame.buffer);
+    *length = frame.length;
 err:
     return ret;
 }
@@ -901,6 +960,108 @@ static void lan865x_poll_timer(void *arg)
     xTaskNotifyGive(emac->rx_task_hdl);
 }
 
+// Releases a transmit timestamp capture and reports the timestamp of its frame, `ts` is NULL if it was not captured
+static void lan865x_tx_timestamp_release(emac_lan865x_t *emac, uint8_t capture, const eth_timestamp_t *ts)
+{
+    if (!lan865x_spi_lock(emac)) {
+        ESP_LOGE(TAG, "%s: timeout", __func__);
+        return;
+    }
+    bool busy = emac->tx_ts_busy & (1 << capture);
+    emac->tx_ts_busy &= ~(1 << capture);
+    uint32_t tx_id = emac->tx_ts_ids[capture];
+    eth_timestamp_config_t ts_config = emac->ts_config;
+    lan865x_spi_unlock(emac);
+    if (busy && ts && ts_config.tx_cb) {
+        ts_config.tx_cb(tx_id, ts, ts_config.user_ctx);
+    }
+}
+
+static void lan865x_tx_timestamp_read(emac_lan865x_t *emac, uint8_t capture)
+{
+    // capture registers A, B and C follow each other, each as high (seconds) and low (nanoseconds) word
+    uint16_t addr = LAN865X_TTSCAH_REG_ADDR + capture * 2;
+    uint32_t high, low;
+    if (lan865x_read_reg(emac, LAN865X_MMS_OA, addr, &high) != ESP_OK ||
+            lan865x_read_reg(emac, LAN865X_MMS_OA, addr + 1, &low) != ESP_OK) {
+        ESP_LOGE(TAG, "transmit timestamp read failed");
+        lan865x_tx_timestamp_release(emac, capture, NULL);
+        return;
+    }
+    eth_timestamp_t ts = {
+        .seconds = high,
+        .nanoseconds = low,
+    };
+    lan865x_tx_timestamp_release(emac, capture, &ts);
+}
+
+// Releases captures of frames LAN865x could not timestamp, so they don't stay busy forever
+static void lan865x_tx_timestamp_check_missed(emac_lan865x_t *emac)
+{
+    lan865x_oa_status1_reg_t oa_status1;
+    if (lan865x_read_reg(emac, LAN865X_MMS_OA, LAN865X_OA_STATUS1_REG_ADDR, &oa_status1.val) != ESP_OK) {
+        ESP_LOGE(TAG, "OA_STATUS1 read failed");
+        return;
+    }
+    uint8_t missed = oa_status1.ttscma | oa_status1.ttscmb << 1 | oa_status1.ttscmc << 2;
+    if (missed == 0) {
+        return;
+    }
+    for (uint8_t i = 0; i < LAN865X_TX_TIMESTAMP_CAPTURES; i++) {
+        if (missed & (1 << i)) {
+            ESP_LOGW(TAG, "transmit timestamp capture %c missed", 'A' + i);
+            lan865x_tx_timestamp_release(emac, i, NULL);
+        }
+    }
+    // clear just the bits handled here
+    lan865x_oa_status1_reg_t oa_status1_clr = {
+        .ttscma = oa_status1.ttscma,
+        .ttscmb = oa_status1.ttscmb,
+        .ttscmc = oa_status1.ttscmc,
+    };
+    if (lan865x_write_reg(emac, LAN865X_MMS_OA, LAN865X_OA_STATUS1_REG_ADDR, oa_status1_clr.val) != ESP_OK) {
+        ESP_LOGE(TAG, "OA_STATUS1 write failed");
+    }
+}
+
+// Handles events signalled by the extended status flag of chunk footers
+static void lan865x_handle_status(emac_lan865x_t *emac)
+{
+    lan865x_oa_status0_reg_t oa_status0;
+    emac->status_pending = false;
+    if (lan865x_read_reg(emac, LAN865X_MMS_OA, LAN865X_OA_STATUS0_REG_ADDR, &oa_status0.val) != ESP_OK) {
+        ESP_LOGE(TAG, "OA_STATUS0 read failed");
+        return;
+    }
+    // LAN865x aborts the frame on the line if it runs out of data in transmit cut-through mode
+    if (oa_status0.txbue || oa_status0.txpe) {
+        ESP_LOGW(TAG, "transmit frame aborted (%s)", oa_status0.txbue ? "buffer underflow" : "protocol error");
+        emac->chunk_stats.tx_aborted++;
+    }
+    if (oa_status0.txboe) {
+        ESP_LOGW(TAG, "transmit buffer overflow");
+    }
+    if (oa_status0.rxboe) {
+        ESP_LOGW(TAG, "receive buffer overflow");
+    }
+    if (oa_status0.lofe || oa_status0.hdre) {
+        ESP_LOGE(TAG, "SPI %s error", oa_status0.lofe ? "loss of framing" : "header");
+    }
+    uint8_t captured = oa_status0.ttscaa | oa_status0.ttscab << 1 | oa_status0.ttscac << 2;
+    for (uint8_t i = 0; i < LAN865X_TX_TIMESTAMP_CAPTURES; i++) {
+        if (captured & (1 << i)) {
+            lan865x_tx_timestamp_read(emac, i);
+        }
+    }
+    // status bits are cleared by writing 1
+    if (lan865x_write_reg(emac, LAN865X_MMS_OA, LAN865X_OA_STATUS0_REG_ADDR, oa_status0.val) != ESP_OK) {
+        ESP_LOGE(TAG, "OA_STATUS0 write failed");
+    }
+    if (emac->tx_ts_busy) {
+        lan865x_tx_timestamp_check_missed(emac);
+    }
+}
+
 static void emac_lan865x_task(void *arg)
 {
     emac_lan865x_t *emac = (emac_lan865x_t *)arg;
@@ -916,25 +1077,29 @@ static void emac_lan865x_task(void *arg)
             ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
         }
 
-        uint8_t remain = 0;
+        // the first chunk reports how many receive blocks are available, all of them are fetched at once then
+        uint8_t remain = 1;
         do {
-            uint32_t frame_len = LAN865X_RX_BUFFER_SIZE;
-            if (lan865x_frame_receive(emac, emac->rx_buffer, &frame_len, &remain) == ESP_OK) {
-                if (frame_len > 0) {
-                    uint8_t *buffer = malloc(frame_len);
-                    if (buffer == NULL) {
-                        ESP_LOGE(TAG, "no mem for receive buffer");
-                    } else {
-                        memcpy(buffer, emac->rx_buffer, frame_len);
-                        ESP_LOGD(TAG, "receive len=%" PRIu32, frame_len);
-                        /* pass the buffer to stack (e.g. TCP/IP layer) */
-                        emac->eth->stack_input(emac->eth, buffer, frame_len);
-                    }
-                }
-            } else {
+            if (lan865x_chunk_exchange(emac, NULL, 0, NULL, remain, &remain) != ESP_OK) {
                 ESP_LOGE(TAG, "frame receive failed");
+                remain = 0;
+            }
+            // pass frames received by this exchange as well as those received while transmitting
+            lan865x_rx_frame_t frames[LAN865X_FRAME_CHUNKS_MAX];
+            eth_timestamp_config_t ts_config;
+            uint32_t frames_cnt = lan865x_rx_frames_take(emac, frames, LAN865X_FRAME_CHUNKS_MAX, &ts_config);
+            for (uint32_t i = 0; i < frames_cnt; i++) {
+                ESP_LOGD(TAG, "receive len=%" PRIu32, frames[i].length);
+                if (frames[i].ts_valid && ts_config.rx_cb) {
+                    ts_config.rx_cb(frames[i].buffer, frames[i].length, &frames[i].ts, ts_config.user_ctx);
+                }
+                /* pass the buffer to stack (e.g. TCP/IP layer) */
+                emac->eth->stack_input(emac->eth, frames[i].buffer, frames[i].length);
             }
         } while (remain > 0);
+        if (emac->status_pending) {
+            lan865x_handle_status(emac);
+        }
     }
 
     vTaskDelete(NULL);
@@ -977,10 +1142,10 @@ static esp_err_t emac_lan865x_init(esp_eth_mac_t *mac)
         .bps = LAN865X_OA_CONFIG0_BLOCK_PAYLOAD_SIZE_64,
         .rfa = LAN865X_OA_CONFIG0_RECV_FRAME_ALIGN_ZERO,
         .prote = 0,        // Disable control data protection
-        .ftse = 0,         // Disable frame timestamp
-        .rxcte = 0,        // Disable receive cut-through
-        .txcte = 0,        // Disable transmit cut-through
-        .txfcsve = 0,      // Disable transmit FCS validation
+        .ftse = 0,         // Frame timestamping is enabled by ETH_TIMESTAMP_CMD_ENABLE
+        .rxcte = emac->rx_cut_through,  // Receive cut-through
+        .txcte = emac->tx_cut_through,  // Transmit cut-through
+        .txfcsve = 0,      // Disable transmit FCS validation, it's not possible in transmit cut-through mode anyway
         .sync = 1,         // Confirm configuration synchronization
     };
     ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_OA, LAN865X_OA_CONFIG0_REG_ADDR, oa_config0.val), err, TAG, "OA_CONFIG0 configuration failed");
@@ -1021,6 +1186,205 @@ static esp_err_t emac_lan865x_deinit(esp_eth_mac_t *mac)
     return ESP_OK;
 }
 
+static esp_err_t lan865x_timestamp_enable(emac_lan865x_t *emac, const eth_timestamp_config_t *config)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(config->tx_match_cb == NULL || config->tx_cb, ESP_ERR_INVALID_ARG, TAG, "transmit timestamp callback is required");
+
+    // frames are received with 64-bit timestamps
+    lan865x_oa_config0_reg_t oa_config0_mask = {
+        .ftse = 1,
+        .ftss = 1,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_set_reg_bits(emac, LAN865X_MMS_OA, LAN865X_OA_CONFIG0_REG_ADDR, oa_config0_mask.val), err, TAG, "OA_CONFIG0 configuration failed");
+    // transmit timestamp captures are signalled by the extended status flag of chunk footers
+    lan865x_oa_imask0_reg_t oa_imask0_mask = {
+        .ttscaam = 1,
+        .ttscabm = 1,
+        .ttscacm = 1,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_clear_reg_bits(emac, LAN865X_MMS_OA, LAN865X_OA_IMASK0_REG_ADDR, oa_imask0_mask.val), err, TAG, "OA_IMASK0 configuration failed");
+    lan865x_oa_imask1_reg_t oa_imask1_mask = {
+        .ttscmam = 1,
+        .ttscmbm = 1,
+        .ttscmcm = 1,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_clear_reg_bits(emac, LAN865X_MMS_OA, LAN865X_OA_IMASK1_REG_ADDR, oa_imask1_mask.val), err, TAG, "OA_IMASK1 configuration failed");
+
+    ESP_RETURN_ON_FALSE(lan865x_spi_lock(emac), ESP_ERR_TIMEOUT, TAG, "%s: timeout", __func__);
+    emac->ts_config = *config;
+    lan865x_spi_unlock(emac);
+err:
+    return ret;
+}
+
+static esp_err_t lan865x_timestamp_disable(emac_lan865x_t *emac)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(lan865x_spi_lock(emac), ESP_ERR_TIMEOUT, TAG, "%s: timeout", __func__);
+    memset(&emac->ts_config, 0, sizeof(emac->ts_config));
+    emac->tx_ts_busy = 0;
+    lan865x_spi_unlock(emac);
+
+    lan865x_oa_config0_reg_t oa_config0_mask = {
+        .ftse = 1,
+        .ftss = 1,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_clear_reg_bits(emac, LAN865X_MMS_OA, LAN865X_OA_CONFIG0_REG_ADDR, oa_config0_mask.val), err, TAG, "OA_CONFIG0 configuration failed");
+    lan865x_oa_imask0_reg_t oa_imask0_mask = {
+        .ttscaam = 1,
+        .ttscabm = 1,
+        .ttscacm = 1,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_set_reg_bits(emac, LAN865X_MMS_OA, LAN865X_OA_IMASK0_REG_ADDR, oa_imask0_mask.val), err, TAG, "OA_IMASK0 configuration failed");
+    lan865x_oa_imask1_reg_t oa_imask1_mask = {
+        .ttscmam = 1,
+        .ttscmbm = 1,
+        .ttscmcm = 1,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_set_reg_bits(emac, LAN865X_MMS_OA, LAN865X_OA_IMASK1_REG_ADDR, oa_imask1_mask.val), err, TAG, "OA_IMASK1 configuration failed");
+err:
+    return ret;
+}
+
+static esp_err_t lan865x_get_time(emac_lan865x_t *emac, eth_timestamp_t *ts)
+{
+    esp_err_t ret = ESP_OK;
+    lan865x_mac_tsh_reg_t mac_tsh;
+    lan865x_mac_tsl_reg_t mac_tsl;
+    lan865x_mac_tsl_reg_t mac_tsl_next;
+    lan865x_mac_tn_reg_t mac_tn;
+    ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TSH_REG_ADDR, &mac_tsh.val), err, TAG, "MAC_TSH read failed");
+    ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TSL_REG_ADDR, &mac_tsl.val), err, TAG, "MAC_TSL read failed");
+    ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TN_REG_ADDR, &mac_tn.val), err, TAG, "MAC_TN read failed");
+    // nanoseconds may have wrapped around after reading the seconds
+    ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TSL_REG_ADDR, &mac_tsl_next.val), err, TAG, "MAC_TSL read failed");
+    if (mac_tsl_next.val != mac_tsl.val) {
+        mac_tsl = mac_tsl_next;
+        ESP_GOTO_ON_ERROR(lan865x_read_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TN_REG_ADDR, &mac_tn.val), err, TAG, "MAC_TN read failed");
+    }
+    ts->seconds = (uint64_t)(mac_tsh.tcs_47_40 << 8 | mac_tsh.tcs_39_32) << 32 | mac_tsl.tcs;
+    ts->nanoseconds = mac_tn.tns;
+err:
+    return ret;
+}
+
+static esp_err_t lan865x_set_time(emac_lan865x_t *emac, const eth_timestamp_t *ts)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(ts->nanoseconds < 1000000000 && ts->seconds < (1ULL << 48), ESP_ERR_INVALID_ARG, TAG, "invalid time");
+    lan865x_mac_tsh_reg_t mac_tsh = {
+        .tcs_39_32 = (ts->seconds >> 32) & 0xFF,
+        .tcs_47_40 = (ts->seconds >> 40) & 0xFF,
+    };
+    lan865x_mac_tsl_reg_t mac_tsl = {
+        .tcs = (uint32_t)ts->seconds,
+    };
+    lan865x_mac_tn_reg_t mac_tn = {
+        .tns = ts->nanoseconds,
+    };
+    // the timer is updated when nanoseconds are written
+    ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TSH_REG_ADDR, mac_tsh.val), err, TAG, "MAC_TSH write failed");
+    ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TSL_REG_ADDR, mac_tsl.val), err, TAG, "MAC_TSL write failed");
+    ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TN_REG_ADDR, mac_tn.val), err, TAG, "MAC_TN write failed");
+err:
+    return ret;
+}
+
+static esp_err_t lan865x_adjust_time(emac_lan865x_t *emac, int64_t delta_ns)
+{
+    esp_err_t ret = ESP_OK;
+    if (delta_ns > LAN865X_TSU_ADJUST_MAX_NS || delta_ns < -LAN865X_TSU_ADJUST_MAX_NS) {
+        // offset too large for MAC_TA, step the time instead
+        eth_timestamp_t ts;
+        ESP_RETURN_ON_ERROR(lan865x_get_time(emac, &ts), TAG, "get time failed");
+        int64_t seconds = (int64_t)ts.seconds + delta_ns / 1000000000;
+        int64_t nanoseconds = (int64_t)ts.nanoseconds + delta_ns % 1000000000;
+        if (nanoseconds < 0) {
+            nanoseconds += 1000000000;
+            seconds--;
+        } else if (nanoseconds >= 1000000000) {
+            nanoseconds -= 1000000000;
+            seconds++;
+        }
+        ESP_RETURN_ON_FALSE(seconds >= 0, ESP_ERR_INVALID_ARG, TAG, "time would be negative");
+        ts.seconds = seconds;
+        ts.nanoseconds = nanoseconds;
+        return lan865x_set_time(emac, &ts);
+    }
+    lan865x_mac_ta_reg_t mac_ta = {
+        .itdt = delta_ns < 0 ? -delta_ns : delta_ns,
+        .adj = delta_ns < 0,   // 1 to subtract
+    };
+    ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TA_REG_ADDR, mac_ta.val), err, TAG, "MAC_TA write failed");
+err:
+    return ret;
+}
+
+static esp_err_t lan865x_adjust_freq(emac_lan865x_t *emac, int32_t ppb)
+{
+    esp_err_t ret = ESP_OK;
+    ESP_RETURN_ON_FALSE(ppb > -1000000000 && ppb < 1000000000, ESP_ERR_INVALID_ARG, TAG, "invalid frequency adjustment");
+    int64_t incr = (int64_t)LAN865X_TSU_INCREMENT_NS << LAN865X_TSU_SUBNS_SHIFT;
+    incr += incr * ppb / 1000000000;
+    lan865x_mac_tisubn_reg_t mac_tisubn = {
+        .msbtir = (incr >> 8) & 0xFFFF,
+        .lsbtir = incr & 0xFF,
+    };
+    lan865x_mac_ti_reg_t mac_ti = {
+        .cns = incr >> LAN865X_TSU_SUBNS_SHIFT,
+    };
+    ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TISUBN_REG_ADDR, mac_tisubn.val), err, TAG, "MAC_TISUBN write failed");
+    ESP_GOTO_ON_ERROR(lan865x_write_reg(emac, LAN865X_MMS_MAC, LAN865X_MAC_TI_REG_ADDR, mac_ti.val), err, TAG, "MAC_TI write failed");
+err:
+    return ret;
+}
+
+static esp_err_t emac_lan865x_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *data)
+{
+    emac_lan865x_t *emac = __containerof(mac, emac_lan865x_t, parent);
+
+    switch (cmd) {
+    case ETH_MAC_LAN865X_CMD_G_CHUNK_STATS:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "chunk statistics get invalid argument, can't be NULL");
+        ESP_RETURN_ON_FALSE(lan865x_spi_lock(emac), ESP_ERR_TIMEOUT, TAG, "%s: timeout", __func__);
+        *(eth_lan865x_chunk_stats_t *)data = emac->chunk_stats;
+        lan865x_spi_unlock(emac);
+        break;
+    case ETH_MAC_LAN865X_CMD_CLR_CHUNK_STATS:
+        ESP_RETURN_ON_FALSE(lan865x_spi_lock(emac), ESP_ERR_TIMEOUT, TAG, "%s: timeout", __func__);
+        memset(&emac->chunk_stats, 0, sizeof(emac->chunk_stats));
+        lan865x_spi_unlock(emac);
+        break;
+    case ETH_TIMESTAMP_CMD_ENABLE:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "timestamping configuration can't be NULL");
+        ESP_RETURN_ON_ERROR(lan865x_timestamp_enable(emac, (eth_timestamp_config_t *)data), TAG, "enable timestamping failed");
+        break;
+    case ETH_TIMESTAMP_CMD_DISABLE:
+        ESP_RETURN_ON_ERROR(lan865x_timestamp_disable(emac), TAG, "disable timestamping failed");
+        break;
+    case ETH_TIMESTAMP_CMD_G_TIME:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "time get invalid argument, can't be NULL");
+        ESP_RETURN_ON_ERROR(lan865x_get_time(emac, (eth_timestamp_t *)data), TAG, "get time failed");
+        break;
+    case ETH_TIMESTAMP_CMD_S_TIME:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "time set invalid argument, can't be NULL");
+        ESP_RETURN_ON_ERROR(lan865x_set_time(emac, (eth_timestamp_t *)data), TAG, "set time failed");
+        break;
+    case ETH_TIMESTAMP_CMD_ADJ_TIME:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "time adjust invalid argument, can't be NULL");
+        ESP_RETURN_ON_ERROR(lan865x_adjust_time(emac, *(int64_t *)data), TAG, "adjust time failed");
+        break;
+    case ETH_TIMESTAMP_CMD_ADJ_FREQ:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, TAG, "frequency adjust invalid argument, can't be NULL");
+        ESP_RETURN_ON_ERROR(lan865x_adjust_freq(emac, *(int32_t *)data), TAG, "adjust frequency failed");
+        break;
+    default:
+        ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_ARG, TAG, "unknown io command: %i", cmd);
+    }
+    return ESP_OK;
+}
+
 static esp_err_t emac_lan865x_del(esp_eth_mac_t *mac)
 {
     emac_lan865x_t *emac = __containerof(mac, emac_lan865x_t, parent);
@@ -1028,9 +1392,13 @@ static esp_err_t emac_lan865x_del(esp_eth_mac_t *mac)
         esp_timer_delete(emac->poll_timer);
     }
     vTaskDelete(emac->rx_task_hdl);
+    // frames received while transmitting which were not passed to the stack yet
+    for (uint32_t i = 0; i < emac->rx_frames_cnt; i++) {
+        eth_rx_pool_free(emac->rx_frames[i].buffer);
+    }
     emac->spi.deinit(emac->spi.ctx);
     vSemaphoreDelete(emac->spi_lock);
-    heap_caps_free(emac->rx_buffer);
+    eth_rx_pool_free(emac->rx_buffer);
     heap_caps_free(emac->spi_buffer);
     free(emac);
     return ESP_OK;
@@ -1049,6 +1417,14 @@ esp_eth_mac_t *esp_eth_mac_new_lan865x(const eth_lan865x_config_t *lan865x_confi
     emac->sw_reset_timeout_ms = mac_config->sw_reset_timeout_ms;
     emac->int_gpio_num = lan865x_config->int_gpio_num;
     emac->poll_period_ms = lan865x_config->poll_period_ms;
+    if (lan865x_config->rx_pool) {
+        eth_rx_pool_stats_t pool_stats;
+        ESP_GOTO_ON_FALSE(eth_rx_pool_get_stats(lan865x_config->rx_pool, &pool_stats) == ESP_OK && pool_stats.block_size >= LAN865X_RX_BUFFER_SIZE,
+                          NULL, err, TAG, "rx pool blocks must hold a frame of maximal size");
+    }
+    emac->rx_pool = lan865x_config->rx_pool;
+    emac->rx_cut_through = lan865x_config->rx_cut_through;
+    emac->tx_cut_through = lan865x_config->tx_cut_through;
     emac->parent.set_mediator = emac_lan865x_set_mediator;
     emac->parent.init = emac_lan865x_init;
     emac->parent.deinit = emac_lan865x_deinit;
@@ -1072,6 +1448,7 @@ esp_eth_mac_t *esp_eth_mac_new_lan865x(const eth_lan865x_config_t *lan865x_confi
     emac->parent.enable_flow_ctrl = emac_lan865x_enable_flow_ctrl;
     emac->parent.transmit = emac_lan865x_transmit;
     emac->parent.receive = emac_lan865x_receive;
+    emac->parent.custom_ioctl = emac_lan865x_custom_ioctl;
 
     if (lan865x_config->custom_spi_driver.init != NULL && lan865x_config->custom_spi_driver.deinit != NULL
             && lan865x_config->custom_spi_driver.read != NULL && lan865x_config->custom_spi_driver.write != NULL) {
@@ -1105,9 +1482,6 @@ esp_eth_mac_t *esp_eth_mac_new_lan865x(const eth_lan865x_config_t *lan865x_confi
                                                    mac_config->rx_task_prio, &emac->rx_task_hdl, core_num);
     ESP_GOTO_ON_FALSE(xReturned == pdPASS, NULL, err, TAG, "create lan865x task failed");
 
-    emac->rx_buffer = heap_caps_malloc(LAN865X_RX_BUFFER_SIZE, MALLOC_CAP_DMA);
-    ESP_GOTO_ON_FALSE(emac->rx_buffer, NULL, err, TAG, "RX buffer allocation failed");
-
     emac->spi_buffer = heap_caps_malloc(LAN865X_SPI_BUFFER_SIZE, MALLOC_CAP_DMA);
     ESP_GOTO_ON_FALSE(emac->spi_buffer, NULL, err, TAG, "SPI buffer allocation failed");
 
@@ -1137,7 +1511,6 @@ err:
         if (emac->spi.ctx) {
             emac->spi.deinit(emac->spi.ctx);
         }
-        heap_caps_free(emac->rx_buffer);
         heap_caps_free(emac->spi_buffer);
         free(emac);
     }
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <endian.h>
+#include "oa_tc6.h"
+
+// Header in the byte order it's sent in, with parity
+static inline uint32_t oa_tc6_header_seal(oa_tc6_data_header_t header)
+{
+    header.parity = oa_tc6_parity(header.val);
+    return htobe32(header.val);
+}
+
+void oa_tc6_tx_chunks_build(uint8_t *chunks, uint32_t chunk_cnt, const uint8_t *frame, uint32_t length, uint8_t tsc, uint32_t norx_from)
+{
+    uint32_t tx_chunks = frame ? (length + OA_TC6_CHUNK_PAYLOAD_SIZE - 1) / OA_TC6_CHUNK_PAYLOAD_SIZE : 0;
+    // all chunks but the first and the last one of the frame share the same header
+    oa_tc6_data_header_t idle = {
+        .dnc = 1,
+    };
+    oa_tc6_data_header_t middle = {
+        .dnc = 1,
+        .dv = 1,
+    };
+    uint32_t idle_be = oa_tc6_header_seal(idle);
+    uint32_t middle_be = oa_tc6_header_seal(middle);
+    // setting No Receive flips the parity as well, as it's a single bit
+    oa_tc6_data_header_t norx_flip = {
+        .norx = 1,
+        .parity = 1,
+    };
+    uint32_t norx_flip_be = htobe32(norx_flip.val);
+
+    for (uint32_t i = 0; i < chunk_cnt; i++) {
+        uint8_t *chunk = chunks + i * OA_TC6_CHUNK_SIZE;
+        uint32_t header_be = idle_be;
+        if (i < tx_chunks) {
+            uint32_t payload_len = OA_TC6_CHUNK_PAYLOAD_SIZE;
+            header_be = middle_be;
+            if (i == 0 || i == tx_chunks - 1) {
+                oa_tc6_data_header_t header = middle;
+                if (i == 0) {
+                    header.sv = 1;
+                    header.swo = 0;
+                    header.tsc = tsc;
+                }
+                if (i == tx_chunks - 1) {
+                    header.ev = 1;
+                    header.ebo = (length - 1) % OA_TC6_CHUNK_PAYLOAD_SIZE;
+                    payload_len = length - i * OA_TC6_CHUNK_PAYLOAD_SIZE;
+                }
+                header_be = oa_tc6_header_seal(header);
+            }
+            memcpy(chunk + OA_TC6_HEADER_FOOTER_SIZE, frame + i * OA_TC6_CHUNK_PAYLOAD_SIZE, payload_len);
+        }
+        if (i >= norx_from) {
+            header_be ^= norx_flip_be;
+        }
+        memcpy(chunk, &header_be, sizeof(header_be));
+    }
+}
+
+bool oa_tc6_rx_footer_get(const uint8_t *chunk, oa_tc6_data_footer_t *footer)
+{
+    uint32_t footer_be;
+    memcpy(&footer_be, chunk + OA_TC6_CHUNK_PAYLOAD_SIZE, sizeof(footer_be));
+    footer->val = be32toh(footer_be);
+    return oa_tc6_parity(footer->val) == footer->parity;
+}
@@ -0,0 +1,119 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * OPEN Alliance 10BASE-T1x MAC-PHY Serial Interface (TC6) framing
+ *
+ * Chunk layout and helpers which don't depend on a particular MAC-PHY, so they can be shared by drivers of other
+ * TC6 compliant devices.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OA_TC6_HEADER_FOOTER_SIZE   (4)
+#define OA_TC6_CHUNK_PAYLOAD_SIZE   (64)
+#define OA_TC6_CHUNK_SIZE           (OA_TC6_HEADER_FOOTER_SIZE + OA_TC6_CHUNK_PAYLOAD_SIZE)
+
+/* Data chunk header, sent to the MAC-PHY */
+typedef union {
+    struct {
+        uint32_t parity: 1;        /* Parity bit over bits 31:1 */
+        uint32_t reserved: 5;      /* Reserved, set to 0 */
+        uint32_t tsc: 2;           /* Time Stamp Capture */
+        uint32_t ebo: 6;           /* End Byte Offset */
+        uint32_t ev: 1;            /* End Valid */
+        uint32_t reserved2: 1;     /* Reserved, set to 0 */
+        uint32_t swo: 4;           /* Start Word Offset */
+        uint32_t sv: 1;            /* Start Valid */
+        uint32_t dv: 1;            /* Data Valid */
+        uint32_t vs: 2;            /* Vendor Specific, set to 0 */
+        uint32_t reserved3: 5;     /* Reserved, set to 0 */
+        uint32_t norx: 1;          /* No Receive */
+        uint32_t seq: 1;           /* Data Block Sequence */
+        uint32_t dnc: 1;           /* Data Not Control, always 1 for data blocks */
+    };
+    uint32_t val;
+} oa_tc6_data_header_t;
+
+/* Data chunk footer, received from the MAC-PHY */
+typedef union {
+    struct {
+        uint32_t parity: 1;        /* Parity bit over bits 31:1 */
+        uint32_t txc: 5;           /* Transmit Credits */
+        uint32_t rtsp: 1;          /* Receive Timestamp Parity */
+        uint32_t rtsa: 1;          /* Receive Timestamp Added */
+        uint32_t ebo: 6;           /* End Byte Offset */
+        uint32_t ev: 1;            /* End Valid */
+        uint32_t fd: 1;            /* Frame Drop */
+        uint32_t swo: 4;           /* Start Word Offset */
+        uint32_t sv: 1;            /* Start Valid */
+        uint32_t dv: 1;            /* Data Valid */
+        uint32_t vs: 2;            /* Vendor Specific */
+        uint32_t rba: 5;           /* Receive Blocks Available */
+        uint32_t sync: 1;          /* Configuration Synchronized */
+        uint32_t hdrb: 1;          /* Header Bad */
+        uint32_t exst: 1;          /* Extended Status */
+    };
+    uint32_t val;
+} oa_tc6_data_footer_t;
+
+/* Control transaction header, echoed back by the MAC-PHY */
+typedef union {
+    struct {
+        uint32_t parity: 1;        /* Parity bit over bits 31:1 */
+        uint32_t len: 7;           /* Length - number of registers minus one */
+        uint32_t addr: 16;         /* Address of first register to access */
+        uint32_t mms: 4;           /* Memory Map Selector */
+        uint32_t aid: 1;           /* Address Increment disable */
+        uint32_t rw: 1;            /* Read/Write */
+        uint32_t hdrb: 1;          /* Header Bad */
+        uint32_t dnc: 1;           /* Data Not Control, always 0 for control */
+    };
+    uint32_t val;
+} oa_tc6_ctrl_header_t;
+
+/**
+ * @brief Parity bit of a header or footer, bits 31:1 and the parity bit together have odd number of 1s
+ */
+static inline bool oa_tc6_parity(uint32_t value)
+{
+    return !__builtin_parity(value >> 1);
+}
+
+/**
+ * @brief Lay out transmit data chunks
+ *
+ * Headers are built from templates whose parity is computed once per call, the frame is split into chunk payloads.
+ * Chunks past the frame carry no transmit data, they just fetch receive data.
+ *
+ * @param[out] chunks buffer of `chunk_cnt` chunks
+ * @param chunk_cnt number of chunks to lay out
+ * @param frame frame to transmit, NULL if none
+ * @param length frame length, it must fit into `chunk_cnt` chunks
+ * @param tsc Time Stamp Capture field of the first chunk of the frame
+ * @param norx_from index of the first chunk to set No Receive in
+ */
+void oa_tc6_tx_chunks_build(uint8_t *chunks, uint32_t chunk_cnt, const uint8_t *frame, uint32_t length, uint8_t tsc, uint32_t norx_from);
+
+/**
+ * @brief Read the footer of a received chunk
+ *
+ * @param chunk received chunk
+ * @param[out] footer footer in host byte order
+ * @return true if parity of the footer is correct
+ */
+bool oa_tc6_rx_footer_get(const uint8_t *chunk, oa_tc6_data_footer_t *footer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,364 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "lan865x_model.h"
+
+/* The model is written against the OPEN Alliance TC6 specification and the datasheet, it intentionally doesn't share
+ * chunk and register definitions with the driver. */
+#define CHUNK_PAYLOAD       (64)
+#define CHUNK_SIZE          (CHUNK_PAYLOAD + 4)
+#define CTRL_DUMMY          (4)     // control response is shifted by one word
+
+// bits of the data chunk header (from the host) and footer (from the MAC-PHY), as far as the model uses them
+#define DNC                 (1U << 31)
+#define HDR_NORX            (1U << 29)
+#define FTR_HDRB            (1U << 30)
+#define FTR_SYNC            (1U << 29)
+#define FTR_RBA_SHIFT       (24)
+#define DV                  (1U << 21)
+#define SV                  (1U << 20)
+#define FTR_FD              (1U << 15)
+#define EV                  (1U << 14)
+#define EBO_SHIFT           (8)
+#define EBO_MASK            (0x3F)
+#define FTR_TXC_SHIFT       (1)
+#define FTR_COUNT_MAX       (31)    // RBA and TXC are 5 bits wide
+// control header
+#define CTRL_HDRB           (1U << 30)
+#define CTRL_WNR            (1U << 29)
+#define CTRL_AID            (1U << 28)
+#define CTRL_MMS_SHIFT      (24)
+#define CTRL_ADDR_SHIFT     (8)
+#define CTRL_LEN_SHIFT      (1)
+
+#define MMS_OA              (0)
+#define MMS_MISC            (10)
+#define OA_RESET            (0x03)
+#define OA_RESET_SWRESET    (0x01)
+#define OA_CONFIG0          (0x04)
+#define OA_CONFIG0_SYNC     (0x8000)
+#define OA_STATUS0          (0x08)
+#define OA_STATUS0_RESETC   (0x40)
+#define OA_BUFSTS           (0x0B)
+#define MISC_DEVID          (0x94)
+#define DEVID_LAN8650       ((0x8650 << 4) | 0x1)
+
+#define MAX_REGS            (96)
+
+typedef struct {
+    uint8_t payload[CHUNK_PAYLOAD];
+    uint32_t flags;     // SV, EV with EBO and FD as they go to the footer
+} rx_chunk_t;
+
+typedef struct {
+    uint8_t mms;
+    uint16_t addr;
+    uint32_t val;
+} reg_t;
+
+typedef struct {
+    reg_t regs[MAX_REGS];
+    uint32_t regs_cnt;
+    bool sync;
+    uint8_t tx_credits;
+    bool tx_hold;
+    bool tx_started;
+    uint32_t tx_len;
+    uint32_t tx_chunks;
+    uint8_t tx_frame[LAN865X_MODEL_FRAME_MAX];
+    rx_chunk_t rx[LAN865X_MODEL_RX_CHUNKS];
+    uint32_t rx_rd;
+    uint32_t rx_cnt;
+    lan865x_model_stats_t stats;
+} lan865x_model_t;
+
+static lan865x_model_t s_model;
+
+// odd parity over the whole word, the parity bit included
+static uint32_t parity_set(uint32_t word)
+{
+    word &= ~1U;
+    return word | !__builtin_parity(word);
+}
+
+static uint32_t get_be32(const uint8_t *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static void put_be32(uint8_t *p, uint32_t word)
+{
+    p[0] = word >> 24;
+    p[1] = word >> 16;
+    p[2] = word >> 8;
+    p[3] = word;
+}
+
+static reg_t *reg_find(uint8_t mms, uint16_t addr, bool create)
+{
+    for (uint32_t i = 0; i < s_model.regs_cnt; i++) {
+        if (s_model.regs[i].mms == mms && s_model.regs[i].addr == addr) {
+            return &s_model.regs[i];
+        }
+    }
+    if (!create || s_model.regs_cnt >= MAX_REGS) {
+        return NULL;
+    }
+    reg_t *reg = &s_model.regs[s_model.regs_cnt++];
+    reg->mms = mms;
+    reg->addr = addr;
+    reg->val = 0;
+    return reg;
+}
+
+static void regs_reset(void)
+{
+    s_model.regs_cnt = 0;
+    s_model.sync = false;
+    reg_find(MMS_MISC, MISC_DEVID, true)->val = DEVID_LAN8650;
+    reg_find(MMS_OA, OA_STATUS0, true)->val = OA_STATUS0_RESETC;
+}
+
+static uint32_t rx_blocks(void)
+{
+    return s_model.rx_cnt < FTR_COUNT_MAX ? s_model.rx_cnt : FTR_COUNT_MAX;
+}
+
+static uint32_t reg_read(uint8_t mms, uint16_t addr)
+{
+    if (mms == MMS_OA && addr == OA_BUFSTS) {
+        s_model.stats.bufsts_reads++;
+        return s_model.tx_credits << 8 | rx_blocks();
+    }
+    reg_t *reg = reg_find(mms, addr, false);
+    return reg ? reg->val : 0;
+}
+
+static void reg_write(uint8_t mms, uint16_t addr, uint32_t val)
+{
+    if (mms == MMS_OA && addr == OA_RESET) {
+        if (val & OA_RESET_SWRESET) {
+            regs_reset();
+        }
+        return;
+    }
+    reg_t *reg = reg_find(mms, addr, true);
+    if (!reg) {
+        return;
+    }
+    if (mms == MMS_OA && addr == OA_STATUS0) {
+        reg->val &= ~val; // write 1 to clear
+        return;
+    }
+    reg->val = val;
+    if (mms == MMS_OA && addr == OA_CONFIG0 && (val & OA_CONFIG0_SYNC)) {
+        s_model.sync = true;
+    }
+}
+
+static void ctrl_transaction(uint8_t *buf, uint32_t len)
+{
+    uint32_t header = get_be32(buf);
+    uint32_t regs = ((header >> CTRL_LEN_SHIFT) & 0x7F) + 1;
+    uint8_t mms = (header >> CTRL_MMS_SHIFT) & 0x0F;
+    uint16_t addr = header >> CTRL_ADDR_SHIFT;
+    bool write = header & CTRL_WNR;
+    s_model.stats.ctrl_trans++;
+
+    uint32_t data[LAN865X_MODEL_RX_CHUNKS];
+    bool ok = __builtin_parity(header) && CTRL_DUMMY + 4 + regs * 4 <= len && regs <= LAN865X_MODEL_RX_CHUNKS;
+    if (ok) {
+        for (uint32_t i = 0; i < regs; i++) {
+            uint16_t reg_addr = addr + ((header & CTRL_AID) ? 0 : i);
+            if (write) {
+                data[i] = get_be32(buf + 4 + i * 4);
+                reg_write(mms, reg_addr, data[i]);
+            } else {
+                data[i] = reg_read(mms, reg_addr);
+                if (mms == MMS_OA && reg_addr == OA_RESET) {
+                    data[i] = 0; // reset is done right away
+                }
+            }
+        }
+    } else {
+        s_model.stats.bad_headers++;
+        header = parity_set(header | CTRL_HDRB);
+        regs = 0;
+    }
+    // the header and the data are echoed back one word later
+    memset(buf, 0, len);
+    put_be32(buf + CTRL_DUMMY, header);
+    for (uint32_t i = 0; i < regs; i++) {
+        put_be32(buf + CTRL_DUMMY + 4 + i * 4, data[i]);
+    }
+}
+
+static void tx_chunk(uint32_t header, const uint8_t *payload)
+{
+    if (s_model.tx_credits == 0) {
+        s_model.stats.tx_overflows++;
+        s_model.tx_started = false;
+        return;
+    }
+    s_model.tx_credits--;
+    if (header & SV) {
+        s_model.tx_started = true;
+        s_model.tx_len = 0;
+        s_model.tx_chunks = 0;
+    }
+    if (!s_model.tx_started) {
+        s_model.stats.tx_protocol_errors++;
+        return;
+    }
+    uint32_t len = (header & EV) ? ((header >> EBO_SHIFT) & EBO_MASK) + 1 : CHUNK_PAYLOAD;
+    s_model.tx_chunks++;
+    if (s_model.tx_len + len > LAN865X_MODEL_FRAME_MAX) {
+        s_model.stats.tx_protocol_errors++;
+        s_model.tx_started = false;
+        return;
+    }
+    memcpy(s_model.tx_frame + s_model.tx_len, payload, len);
+    s_model.tx_len += len;
+    if (!(header & EV)) {
+        return;
+    }
+    s_model.tx_started = false;
+    if (s_model.stats.tx_frames < LAN865X_MODEL_MAX_TX) {
+        lan865x_model_tx_frame_t *frame = &s_model.stats.tx[s_model.stats.tx_frames];
+        frame->len = s_model.tx_len;
+        memcpy(frame->data, s_model.tx_frame, s_model.tx_len);
+    }
+    s_model.stats.tx_frames++;
+    // the frame goes out to the line right away
+    if (!s_model.tx_hold) {
+        s_model.tx_credits += s_model.tx_chunks;
+    }
+}
+
+/* The chunk is answered in place: its payload and footer take the place of its header and payload */
+static void data_chunk(uint8_t *chunk)
+{
+    uint32_t header = get_be32(chunk);
+    uint8_t payload[CHUNK_PAYLOAD];
+    memcpy(payload, chunk + 4, CHUNK_PAYLOAD);
+    memset(chunk, 0, CHUNK_SIZE);
+
+    uint32_t footer = 0;
+    if (!__builtin_parity(header)) {
+        s_model.stats.bad_headers++;
+        footer |= FTR_HDRB;
+    } else {
+        if (header & DV) {
+            tx_chunk(header, payload);
+        }
+        if (!(header & HDR_NORX) && s_model.rx_cnt > 0) {
+            const rx_chunk_t *rx = &s_model.rx[s_model.rx_rd];
+            memcpy(chunk, rx->payload, CHUNK_PAYLOAD);
+            footer |= DV | rx->flags;
+            s_model.rx_rd = (s_model.rx_rd + 1) % LAN865X_MODEL_RX_CHUNKS;
+            s_model.rx_cnt--;
+        }
+    }
+    footer |= rx_blocks() << FTR_RBA_SHIFT;
+    footer |= (uint32_t)(s_model.tx_credits < FTR_COUNT_MAX ? s_model.tx_credits : FTR_COUNT_MAX) << FTR_TXC_SHIFT;
+    footer |= s_model.sync ? FTR_SYNC : 0;
+    put_be32(chunk + CHUNK_PAYLOAD, parity_set(footer));
+}
+
+static esp_err_t model_spi_read(void *ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len)
+{
+    uint8_t *buf = data;
+    if (!buf || len < 4) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!(get_be32(buf) & DNC)) {
+        ctrl_transaction(buf, len);
+        return ESP_OK;
+    }
+    if (len % CHUNK_SIZE) {
+        return ESP_ERR_INVALID_SIZE;
+    }
+    s_model.stats.data_trans++;
+    // IRQn is deasserted by the data transaction, the driver learns about the rest from RBA of the footers
+    eth_spi_model_int_set(false);
+    for (uint32_t i = 0; i < len / CHUNK_SIZE; i++) {
+        data_chunk(buf + i * CHUNK_SIZE);
+    }
+    return ESP_OK;
+}
+
+static esp_err_t model_spi_write(void *ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len)
+{
+    // every transaction of the TC6 interface is full duplex
+    return ESP_ERR_NOT_SUPPORTED;
+}
+
+void lan865x_model_reset(void)
+{
+    memset(&s_model, 0, sizeof(s_model));
+    s_model.tx_credits = LAN865X_MODEL_TX_CREDITS;
+    regs_reset();
+}
+
+void lan865x_model_stats_clear(void)
+{
+    eth_spi_model_lock();
+    memset(&s_model.stats, 0, sizeof(s_model.stats));
+    eth_spi_model_unlock();
+}
+
+const lan865x_model_stats_t *lan865x_model_stats(void)
+{
+    return &s_model.stats;
+}
+
+void lan865x_model_tx_credits_set(uint8_t credits, bool hold)
+{
+    eth_spi_model_lock();
+    s_model.tx_credits = credits;
+    s_model.tx_hold = hold;
+    eth_spi_model_unlock();
+}
+
+bool lan865x_model_rx_frame(const uint8_t *frame, uint32_t len, lan865x_model_rx_t how, bool signal)
+{
+    uint32_t chunks = (len + CHUNK_PAYLOAD - 1) / CHUNK_PAYLOAD;
+    bool ok = false;
+    eth_spi_model_lock();
+    if (len > 0 && s_model.rx_cnt + chunks <= LAN865X_MODEL_RX_CHUNKS) {
+        if (how == LAN865X_MODEL_RX_NO_END) {
+            chunks--;
+        }
+        for (uint32_t i = 0; i < chunks; i++) {
+            rx_chunk_t *rx = &s_model.rx[(s_model.rx_rd + s_model.rx_cnt) % LAN865X_MODEL_RX_CHUNKS];
+            uint32_t copy_len = len - i * CHUNK_PAYLOAD < CHUNK_PAYLOAD ? len - i * CHUNK_PAYLOAD : CHUNK_PAYLOAD;
+            memset(rx->payload, 0, CHUNK_PAYLOAD);
+            memcpy(rx->payload, frame + i * CHUNK_PAYLOAD, copy_len);
+            rx->flags = i == 0 ? SV : 0; // start word offset 0
+            if (i * CHUNK_PAYLOAD + copy_len == len) {
+                rx->flags |= EV | (copy_len - 1) << EBO_SHIFT;
+                rx->flags |= how == LAN865X_MODEL_RX_DROP ? FTR_FD : 0;
+            }
+            s_model.rx_cnt++;
+        }
+        if (signal) {
+            eth_spi_model_int_set(true);
+        }
+        ok = true;
+    }
+    eth_spi_model_unlock();
+    return ok;
+}
+
+static const eth_spi_model_t s_spi_model = {
+    .read = model_spi_read,
+    .write = model_spi_write,
+};
+
+eth_spi_custom_driver_config_t lan865x_model_spi_driver(void)
+{
+    return eth_spi_model_driver(&s_spi_model);
+}
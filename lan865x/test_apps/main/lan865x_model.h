@@ -0,0 +1,92 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "eth_spi_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define LAN865X_MODEL_MAX_TX        (8)     /*!< Number of transmitted frames recorded by the model */
+#define LAN865X_MODEL_TX_CREDITS    (31)    /*!< Transmit credits after reset, the most a chunk footer can report */
+#define LAN865X_MODEL_RX_CHUNKS     (64)    /*!< Receive buffer size in chunks */
+#define LAN865X_MODEL_FRAME_MAX     (1518)  /*!< Largest frame the model transmits and receives */
+
+/**
+ * @brief How a frame is received from the line
+ */
+typedef enum {
+    LAN865X_MODEL_RX_OK,        /*!< Frame is received intact */
+    LAN865X_MODEL_RX_DROP,      /*!< Last chunk of the frame has Frame Drop set, as on an FCS error in cut-through mode */
+    LAN865X_MODEL_RX_NO_END,    /*!< Chunk with End Valid never comes, as when the frame is aborted on the line in cut-through mode */
+} lan865x_model_rx_t;
+
+/**
+ * @brief Frame transmitted by the model
+ */
+typedef struct {
+    uint32_t len;                           /*!< Frame length */
+    uint8_t data[LAN865X_MODEL_FRAME_MAX];  /*!< Frame */
+} lan865x_model_tx_frame_t;
+
+/**
+ * @brief Statistics collected by the LAN865x model
+ */
+typedef struct {
+    uint32_t ctrl_trans;                            /*!< Control transactions */
+    uint32_t data_trans;                            /*!< Data transactions */
+    uint32_t bufsts_reads;                          /*!< Control reads of OA_BUFSTS */
+    uint32_t bad_headers;                           /*!< Headers with wrong parity, answered by Header Bad */
+    uint32_t tx_overflows;                          /*!< Chunks with transmit data which came while no transmit credit was available */
+    uint32_t tx_protocol_errors;                    /*!< Chunks with transmit data which didn't continue a started frame */
+    uint32_t tx_frames;                             /*!< Frames transmitted */
+    lan865x_model_tx_frame_t tx[LAN865X_MODEL_MAX_TX]; /*!< Frames transmitted, in the order they were */
+} lan865x_model_stats_t;
+
+/**
+ * @brief Reset the model to the power on state and clear the statistics
+ */
+void lan865x_model_reset(void);
+
+/**
+ * @brief Clear the statistics only
+ */
+void lan865x_model_stats_clear(void);
+
+/**
+ * @brief Get the statistics collected since the last reset or clear
+ */
+const lan865x_model_stats_t *lan865x_model_stats(void);
+
+/**
+ * @brief Set the transmit credits available
+ *
+ * @param credits free chunks of the transmit buffer, up to LAN865X_MODEL_TX_CREDITS
+ * @param hold keep the chunks of transmitted frames, as if the line was busy, otherwise they are freed as a frame ends
+ */
+void lan865x_model_tx_credits_set(uint8_t credits, bool hold);
+
+/**
+ * @brief Put a frame received from the line into the receive buffer, as chunks aligned to the start of the payload
+ *
+ * @param how how the frame is received
+ * @param signal Assert IRQn, so that the driver fetches this and all earlier frames; the next data transaction deasserts
+ *               it, the driver learns about the rest from the footers
+ * @return false when the frame doesn't fit into the receive buffer
+ */
+bool lan865x_model_rx_frame(const uint8_t *frame, uint32_t len, lan865x_model_rx_t how, bool signal);
+
+/**
+ * @brief Custom SPI driver which executes the driver's transactions against the model
+ */
+eth_spi_custom_driver_config_t lan865x_model_spi_driver(void);
+
+#ifdef __cplusplus
+}
+#endif
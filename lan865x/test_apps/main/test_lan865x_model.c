@@ -0,0 +1,201 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_rom_crc.h"
+#include "esp_eth_driver.h"
+#include "esp_eth_mac_lan865x.h"
+#include "lan865x_model.h"
+#include "eth_spi_model.h"
+#include "unity.h"
+
+#define TEST_INT_GPIO       (4)
+#define TEST_CHUNK_PAYLOAD  (64)
+#define TEST_RX_TIMEOUT_MS  (500)
+
+static uint8_t s_frames[5][LAN865X_MODEL_FRAME_MAX];
+
+static esp_eth_mac_t *test_mac_new(void)
+{
+    eth_spi_model_reset();
+    lan865x_model_reset();
+    eth_mac_config_t mac_config = ETH_MAC_DEFAULT_CONFIG();
+    eth_lan865x_config_t lan865x_config = ETH_LAN865X_DEFAULT_CONFIG(SPI2_HOST, NULL);
+    lan865x_config.int_gpio_num = TEST_INT_GPIO;
+    lan865x_config.custom_spi_driver = lan865x_model_spi_driver();
+    esp_eth_mac_t *mac = esp_eth_mac_new_lan865x(&lan865x_config, &mac_config);
+    TEST_ASSERT_NOT_NULL(mac);
+    TEST_ESP_OK(mac->set_mediator(mac, eth_spi_model_mediator()));
+    TEST_ESP_OK(mac->init(mac));
+    // init() configured IRQn as input, the model drives it from now on
+    eth_spi_model_int_attach(TEST_INT_GPIO);
+    TEST_ESP_OK(mac->start(mac));
+    lan865x_model_stats_clear();
+    TEST_ESP_OK(mac->custom_ioctl(mac, ETH_MAC_LAN865X_CMD_CLR_CHUNK_STATS, NULL));
+    return mac;
+}
+
+static void test_mac_del(esp_eth_mac_t *mac)
+{
+    TEST_ESP_OK(mac->deinit(mac));
+    TEST_ESP_OK(mac->del(mac));
+}
+
+static void test_frame_fill(uint8_t *frame, uint32_t len, uint8_t seq)
+{
+    memset(frame, 0xFF, ETH_ADDR_LEN);
+    for (uint32_t i = ETH_ADDR_LEN; i < len; i++) {
+        frame[i] = seq + i;
+    }
+}
+
+static void test_rx_wait(uint32_t count)
+{
+    for (int i = 0; i < TEST_RX_TIMEOUT_MS / 10 && eth_spi_model_rx_count() < count; i++) {
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+    // give the driver the chance to pass more frames than expected
+    vTaskDelay(pdMS_TO_TICKS(20));
+    TEST_ASSERT_EQUAL_UINT32(count, eth_spi_model_rx_count());
+}
+
+static void test_rx_frame_check(uint32_t index, const uint8_t *frame, uint32_t len)
+{
+    const eth_spi_model_frame_t *rx = eth_spi_model_rx_frame(index);
+    TEST_ASSERT_EQUAL_UINT32(len, rx->len);
+    TEST_ASSERT_EQUAL_HEX32(esp_rom_crc32_le(0, frame, len), rx->crc);
+}
+
+static uint32_t test_chunks(uint32_t len)
+{
+    return (len + TEST_CHUNK_PAYLOAD - 1) / TEST_CHUNK_PAYLOAD;
+}
+
+TEST_CASE("lan865x fetches all receive blocks reported by the footer RBA", "[lan865x_model]")
+{
+    // frames ending at the chunk boundary, one byte past it, and the largest one
+    const uint32_t lens[] = { 60, 64, 65, 1514, 129 };
+    const uint32_t frames_cnt = sizeof(lens) / sizeof(lens[0]);
+    const lan865x_model_stats_t *stats = lan865x_model_stats();
+    eth_lan865x_chunk_stats_t chunk_stats;
+    uint32_t chunks = 0;
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new();
+
+    // IRQn is asserted once all frames wait in the receive buffer
+    for (uint32_t i = 0; i < frames_cnt; i++) {
+        test_frame_fill(s_frames[i], lens[i], i);
+        TEST_ASSERT_TRUE(lan865x_model_rx_frame(s_frames[i], lens[i], LAN865X_MODEL_RX_OK, i == frames_cnt - 1));
+        chunks += test_chunks(lens[i]);
+    }
+    test_rx_wait(frames_cnt);
+    for (uint32_t i = 0; i < frames_cnt; i++) {
+        test_rx_frame_check(i, s_frames[i], lens[i]);
+    }
+    // the first chunk learns RBA, the rest is fetched by transactions of the largest frame size, OA_BUFSTS is not read
+    uint32_t frame_chunks_max = test_chunks(ETH_MAX_PACKET_SIZE);
+    TEST_ASSERT_EQUAL_UINT32(1 + (chunks - 1 + frame_chunks_max - 1) / frame_chunks_max, stats->data_trans);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->bufsts_reads);
+    TEST_ESP_OK(mac->custom_ioctl(mac, ETH_MAC_LAN865X_CMD_G_CHUNK_STATS, &chunk_stats));
+    TEST_ASSERT_EQUAL_UINT32(chunks, chunk_stats.rx_chunks);
+    TEST_ASSERT_EQUAL_UINT32(0, chunk_stats.rx_dropped);
+    TEST_ASSERT_EQUAL_UINT32(0, chunk_stats.rx_aborted);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->bad_headers);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
+
+TEST_CASE("lan865x transmits only within the credits", "[lan865x_model]")
+{
+    const uint32_t lens[] = { 1514, 300, 200, 150, 1514 };
+    const lan865x_model_stats_t *stats = lan865x_model_stats();
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new();
+    for (uint32_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        test_frame_fill(s_frames[i], lens[i], i);
+    }
+
+    // transmitted frames stay in the buffer, as if the line was busy
+    lan865x_model_tx_credits_set(8, true);
+    TEST_ESP_ERR(ESP_ERR_NO_MEM, mac->transmit(mac, s_frames[0], lens[0]));
+    TEST_ASSERT_EQUAL_UINT32(1, stats->bufsts_reads);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->data_trans);
+    // credits read from OA_BUFSTS are enough for this frame
+    TEST_ESP_OK(mac->transmit(mac, s_frames[1], lens[1]));
+    TEST_ASSERT_EQUAL_UINT32(1, stats->bufsts_reads);
+    // the footer reports 3 credits left, too few, OA_BUFSTS confirms that
+    TEST_ESP_ERR(ESP_ERR_NO_MEM, mac->transmit(mac, s_frames[2], lens[2]));
+    TEST_ASSERT_EQUAL_UINT32(2, stats->bufsts_reads);
+    TEST_ESP_OK(mac->transmit(mac, s_frames[3], lens[3]));
+    TEST_ASSERT_EQUAL_UINT32(2, stats->bufsts_reads);
+    // the line is free again, the footer of the last transfer reported no credit
+    lan865x_model_tx_credits_set(LAN865X_MODEL_TX_CREDITS, false);
+    TEST_ESP_OK(mac->transmit(mac, s_frames[4], lens[4]));
+    TEST_ASSERT_EQUAL_UINT32(3, stats->bufsts_reads);
+
+    TEST_ASSERT_EQUAL_UINT32(3, stats->data_trans);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->tx_overflows);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->tx_protocol_errors);
+    TEST_ASSERT_EQUAL_UINT32(3, stats->tx_frames);
+    const uint32_t sent[] = { 1, 3, 4 };
+    for (uint32_t i = 0; i < sizeof(sent) / sizeof(sent[0]); i++) {
+        TEST_ASSERT_EQUAL_UINT32(lens[sent[i]], stats->tx[i].len);
+        TEST_ASSERT_EQUAL_MEMORY(s_frames[sent[i]], stats->tx[i].data, lens[sent[i]]);
+    }
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
+
+TEST_CASE("lan865x drops frames with Frame Drop and frames without End Valid", "[lan865x_model]")
+{
+    const uint32_t lens[] = { 100, 200, 300, 1000 };
+    const lan865x_model_rx_t hows[] = { LAN865X_MODEL_RX_OK, LAN865X_MODEL_RX_DROP, LAN865X_MODEL_RX_NO_END, LAN865X_MODEL_RX_OK };
+    eth_lan865x_chunk_stats_t chunk_stats;
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new();
+
+    for (uint32_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        test_frame_fill(s_frames[i], lens[i], i);
+        TEST_ASSERT_TRUE(lan865x_model_rx_frame(s_frames[i], lens[i], hows[i], i == 3));
+    }
+    // Start Valid of the last frame comes while the previous one is still being received
+    test_rx_wait(2);
+    test_rx_frame_check(0, s_frames[0], lens[0]);
+    test_rx_frame_check(1, s_frames[3], lens[3]);
+    TEST_ESP_OK(mac->custom_ioctl(mac, ETH_MAC_LAN865X_CMD_G_CHUNK_STATS, &chunk_stats));
+    TEST_ASSERT_EQUAL_UINT32(1, chunk_stats.rx_dropped);
+    TEST_ASSERT_EQUAL_UINT32(1, chunk_stats.rx_aborted);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
+
+TEST_CASE("lan865x receives a frame on the chunks of a transmitted frame", "[lan865x_model]")
+{
+    const uint32_t rx_len = 150;
+    const uint32_t tx_len = 300;
+    const lan865x_model_stats_t *stats = lan865x_model_stats();
+    eth_lan865x_chunk_stats_t chunk_stats;
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new();
+
+    // IRQn is not asserted, the frame is found by the transmit transaction only
+    test_frame_fill(s_frames[0], rx_len, 0);
+    TEST_ASSERT_TRUE(lan865x_model_rx_frame(s_frames[0], rx_len, LAN865X_MODEL_RX_OK, false));
+    test_frame_fill(s_frames[1], tx_len, 1);
+    TEST_ESP_OK(mac->transmit(mac, s_frames[1], tx_len));
+    TEST_ESP_OK(mac->custom_ioctl(mac, ETH_MAC_LAN865X_CMD_G_CHUNK_STATS, &chunk_stats));
+    TEST_ASSERT_EQUAL_UINT32(test_chunks(tx_len), chunk_stats.tx_chunks);
+    TEST_ASSERT_EQUAL_UINT32(test_chunks(rx_len), chunk_stats.duplex_chunks);
+    // the task passes the frame received while transmitting
+    test_rx_wait(1);
+    test_rx_frame_check(0, s_frames[0], rx_len);
+    TEST_ASSERT_EQUAL_UINT32(1, stats->tx_frames);
+    TEST_ASSERT_EQUAL_MEMORY(s_frames[1], stats->tx[0].data, tx_len);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
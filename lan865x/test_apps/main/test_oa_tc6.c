@@ -0,0 +1,195 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <inttypes.h>
+#include <endian.h>
+#include "esp_random.h"
+#include "oa_tc6.h"
+#include "unity.h"
+
+// 1518 bytes frame spans 24 chunks, plus chunks which only fetch receive data
+#define TEST_CHUNKS_MAX     (32)
+#define TEST_FRAME_LEN_MAX  (1518)
+
+static uint8_t s_chunks[TEST_CHUNKS_MAX * OA_TC6_CHUNK_SIZE];
+static uint8_t s_frame[TEST_FRAME_LEN_MAX];
+
+static oa_tc6_data_header_t test_header_get(uint32_t chunk)
+{
+    uint32_t header_be;
+    memcpy(&header_be, s_chunks + chunk * OA_TC6_CHUNK_SIZE, sizeof(header_be));
+    oa_tc6_data_header_t header = {
+        .val = be32toh(header_be),
+    };
+    return header;
+}
+
+static uint32_t test_tx_chunks(uint32_t length)
+{
+    return (length + OA_TC6_CHUNK_PAYLOAD_SIZE - 1) / OA_TC6_CHUNK_PAYLOAD_SIZE;
+}
+
+TEST_CASE("transmit chunk headers have odd parity", "[oa_tc6]")
+{
+    for (uint32_t length = 1; length <= TEST_FRAME_LEN_MAX; length++) {
+        uint32_t tx_chunks = test_tx_chunks(length);
+        uint32_t norx_from[] = { 0, tx_chunks / 2, tx_chunks, TEST_CHUNKS_MAX };
+        for (uint8_t tsc = 0; tsc < 4; tsc++) {
+            for (size_t n = 0; n < sizeof(norx_from) / sizeof(norx_from[0]); n++) {
+                oa_tc6_tx_chunks_build(s_chunks, TEST_CHUNKS_MAX, s_frame, length, tsc, norx_from[n]);
+                for (uint32_t i = 0; i < TEST_CHUNKS_MAX; i++) {
+                    oa_tc6_data_header_t header = test_header_get(i);
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, header.dnc, "data chunk without DNC");
+                    // counted independently of oa_tc6_parity(), the whole header has odd number of 1s
+                    TEST_ASSERT_EQUAL_UINT32_MESSAGE(1, __builtin_parity(header.val), "header parity mismatch");
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("transmit chunks set NORX from the requested chunk only", "[oa_tc6]")
+{
+    const uint32_t length = 200;
+    const uint32_t chunk_cnt = test_tx_chunks(length) + 4;
+    oa_tc6_data_header_t receive_all[TEST_CHUNKS_MAX];
+    // transmit data chunks carry receive data as well, no chunk has NORX set
+    oa_tc6_tx_chunks_build(s_chunks, chunk_cnt, s_frame, length, 0, chunk_cnt);
+    for (uint32_t i = 0; i < chunk_cnt; i++) {
+        receive_all[i] = test_header_get(i);
+        TEST_ASSERT_EQUAL_UINT32(0, receive_all[i].norx);
+    }
+    for (uint32_t norx_from = 0; norx_from <= chunk_cnt; norx_from++) {
+        oa_tc6_tx_chunks_build(s_chunks, chunk_cnt, s_frame, length, 0, norx_from);
+        for (uint32_t i = 0; i < chunk_cnt; i++) {
+            oa_tc6_data_header_t header = test_header_get(i);
+            TEST_ASSERT_EQUAL_UINT32(i >= norx_from, header.norx);
+            TEST_ASSERT_EQUAL_UINT32(1, __builtin_parity(header.val));
+            // NORX changes nothing else but the parity
+            header.norx = 0;
+            header.parity = receive_all[i].parity;
+            TEST_ASSERT_EQUAL_HEX32(receive_all[i].val, header.val);
+        }
+    }
+}
+
+TEST_CASE("receive chunk footer parity is checked", "[oa_tc6]")
+{
+    uint8_t chunk[OA_TC6_CHUNK_SIZE];
+    for (int n = 0; n < 1000; n++) {
+        oa_tc6_data_footer_t footer = {
+            .val = esp_random(),
+        };
+        footer.parity = oa_tc6_parity(footer.val);
+        uint32_t footer_be = htobe32(footer.val);
+        memcpy(chunk + OA_TC6_CHUNK_PAYLOAD_SIZE, &footer_be, sizeof(footer_be));
+
+        oa_tc6_data_footer_t parsed;
+        TEST_ASSERT_TRUE(oa_tc6_rx_footer_get(chunk, &parsed));
+        TEST_ASSERT_EQUAL_HEX32(footer.val, parsed.val);
+        // any single bit error is detected, the parity bit itself included
+        for (int bit = 0; bit < 32; bit++) {
+            uint32_t corrupted_be = htobe32(footer.val ^ (1U << bit));
+            memcpy(chunk + OA_TC6_CHUNK_PAYLOAD_SIZE, &corrupted_be, sizeof(corrupted_be));
+            TEST_ASSERT_FALSE(oa_tc6_rx_footer_get(chunk, &parsed));
+        }
+    }
+}
+
+TEST_CASE("frame and receive only chunks are laid out for one transaction", "[oa_tc6]")
+{
+    const uint32_t length = 150;
+    const uint32_t tx_chunks = test_tx_chunks(length);
+    const uint32_t chunk_cnt = tx_chunks + 3;
+    for (uint32_t i = 0; i < length; i++) {
+        s_frame[i] = i;
+    }
+    memset(s_chunks, 0xA5, sizeof(s_chunks));
+    oa_tc6_tx_chunks_build(s_chunks, chunk_cnt, s_frame, length, 0, chunk_cnt);
+    for (uint32_t i = 0; i < chunk_cnt; i++) {
+        oa_tc6_data_header_t header = test_header_get(i);
+        const uint8_t *payload = s_chunks + i * OA_TC6_CHUNK_SIZE + OA_TC6_HEADER_FOOTER_SIZE;
+        if (i < tx_chunks) {
+            uint32_t payload_len = i == tx_chunks - 1 ? length - i * OA_TC6_CHUNK_PAYLOAD_SIZE : OA_TC6_CHUNK_PAYLOAD_SIZE;
+            TEST_ASSERT_EQUAL_UINT32(1, header.dv);
+            TEST_ASSERT_EQUAL_UINT32(i == 0, header.sv);
+            TEST_ASSERT_EQUAL_UINT32(i == tx_chunks - 1, header.ev);
+            if (header.ev) {
+                TEST_ASSERT_EQUAL_UINT32(payload_len - 1, header.ebo);
+            }
+            TEST_ASSERT_EQUAL_UINT8_ARRAY(s_frame + i * OA_TC6_CHUNK_PAYLOAD_SIZE, payload, payload_len);
+        } else {
+            // chunks past the frame just fetch receive data
+            TEST_ASSERT_EQUAL_UINT32(0, header.dv);
+            TEST_ASSERT_EQUAL_UINT32(0, header.sv);
+            TEST_ASSERT_EQUAL_UINT32(0, header.ev);
+        }
+    }
+}
+
+// Header composed bit by bit from the positions given by the TC6 specification, independently of the bit-fields
+static uint32_t test_ref_header(bool dv, bool sv, bool ev, uint32_t ebo, uint8_t tsc, bool norx)
+{
+    uint32_t header = 1U << 31; // DNC
+    header |= (uint32_t)norx << 29;
+    header |= (uint32_t)dv << 21;
+    header |= (uint32_t)sv << 20; // SWO (bits 19:16) stays 0, frames start at the chunk start
+    header |= (uint32_t)ev << 14;
+    header |= ebo << 8;
+    header |= (uint32_t)tsc << 6;
+    uint32_t ones = 0;
+    for (int bit = 1; bit < 32; bit++) {
+        ones += (header >> bit) & 1;
+    }
+    if (!(ones & 1)) {
+        header |= 1;
+    }
+    return header;
+}
+
+// Chunks built one at a time with every header computed from scratch
+static void test_ref_chunks_build(uint8_t *chunks, uint32_t chunk_cnt, const uint8_t *frame, uint32_t length, uint8_t tsc, uint32_t norx_from)
+{
+    uint32_t tx_chunks = test_tx_chunks(length);
+    for (uint32_t i = 0; i < chunk_cnt; i++) {
+        uint8_t *chunk = chunks + i * OA_TC6_CHUNK_SIZE;
+        bool dv = i < tx_chunks;
+        bool sv = i == 0 && dv;
+        bool ev = i == tx_chunks - 1;
+        uint32_t header = test_ref_header(dv, sv, ev, ev ? (length - 1) % OA_TC6_CHUNK_PAYLOAD_SIZE : 0,
+                                          sv ? tsc : 0, i >= norx_from);
+        chunk[0] = header >> 24;
+        chunk[1] = header >> 16;
+        chunk[2] = header >> 8;
+        chunk[3] = header;
+        if (dv) {
+            uint32_t payload_len = ev ? length - i * OA_TC6_CHUNK_PAYLOAD_SIZE : OA_TC6_CHUNK_PAYLOAD_SIZE;
+            memcpy(chunk + OA_TC6_HEADER_FOOTER_SIZE, frame + i * OA_TC6_CHUNK_PAYLOAD_SIZE, payload_len);
+        }
+    }
+}
+
+TEST_CASE("transmit chunks match the reference builder", "[oa_tc6]")
+{
+    static uint8_t s_ref_chunks[TEST_CHUNKS_MAX * OA_TC6_CHUNK_SIZE];
+    for (uint32_t i = 0; i < TEST_FRAME_LEN_MAX; i++) {
+        s_frame[i] = esp_random();
+    }
+    for (uint32_t length = 1; length <= TEST_FRAME_LEN_MAX; length++) {
+        uint32_t tx_chunks = test_tx_chunks(length);
+        uint32_t norx_from[] = { 0, tx_chunks - 1, tx_chunks, TEST_CHUNKS_MAX };
+        for (uint8_t tsc = 0; tsc < 4; tsc++) {
+            for (size_t n = 0; n < sizeof(norx_from) / sizeof(norx_from[0]); n++) {
+                // bytes not written by the builders (payload past the frame) compare equal as well
+                memset(s_chunks, 0, sizeof(s_chunks));
+                memset(s_ref_chunks, 0, sizeof(s_ref_chunks));
+                oa_tc6_tx_chunks_build(s_chunks, TEST_CHUNKS_MAX, s_frame, length, tsc, norx_from[n]);
+                test_ref_chunks_build(s_ref_chunks, TEST_CHUNKS_MAX, s_frame, length, tsc, norx_from[n]);
+                TEST_ASSERT_EQUAL_UINT8_ARRAY(s_ref_chunks, s_chunks, sizeof(s_chunks));
+            }
+        }
+    }
+}
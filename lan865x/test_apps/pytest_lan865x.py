@@ -0,0 +1,48 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""
+LAN865x OPEN Alliance TC6 framing and MAC-PHY model tests, which need no Ethernet hardware, and target test using
+EthTestRunner from eth_test_app component.
+"""
+
+import pytest
+
+from pytest_embedded import Dut
+
+TEST_IF = ''
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default_lan865x', 'esp32', marks=[pytest.mark.generic]),
+    ],
+    indirect=['target'],
+)
+def test_lan865x_oa_tc6(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='oa_tc6')
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default_lan865x', 'esp32', marks=[pytest.mark.generic]),
+    ],
+    indirect=['target'],
+)
+def test_lan865x_model(dut: Dut) -> None:
+    # the driver against a chunk-level model of the MAC-PHY, no LAN865x needed
+    dut.run_all_single_board_cases(group='lan865x_model')
+
+
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default_lan865x', 'esp32', marks=[pytest.mark.eth_lan865x]),
+        pytest.param('cut_through_lan865x', 'esp32', marks=[pytest.mark.eth_lan865x]),
+    ],
+    indirect=['target'],
+)
+def test_eth_lan865x_latency(dut: Dut, eth_test_runner) -> None:
+    # compare the logged round trip latency of store-and-forward (default) and cut-through mode
+    eth_test_runner.run_ethernet_latency_test(dut, TEST_IF)
@@ -24,6 +24,9 @@ _W5500_REQUIRES_IDF6 = pytest.mark.skipif(
     [
         pytest.param('default_w5500', 'esp32', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
         pytest.param('poll_w5500', 'esp32', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
+        pytest.param('async_tx_w5500', 'esp32', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
+        pytest.param('spi_queued_w5500', 'esp32', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
+        pytest.param('rx_pool_w5500', 'esp32', marks=[pytest.mark.eth_w5500, _W5500_REQUIRES_IDF6]),
     ],
     indirect=['target'],
 )
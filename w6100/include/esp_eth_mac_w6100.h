@@ -36,6 +36,9 @@ typedef struct {
             .spi_host_id = spi_host,                   \
             .spi_devcfg = spi_devcfg_p,                \
             .custom_spi_driver = ETH_DEFAULT_SPI,      \
+            .flags = 0,                                \
+            .rx_pool = NULL,                           \
+            .spi_queued_min_len = 0,                   \
         },                                             \
     }
 
@@ -21,6 +21,7 @@ TEST_IF = ''
     [
         pytest.param('default_w6100', 'esp32', marks=[pytest.mark.eth_w6100]),
         pytest.param('poll_w6100', 'esp32', marks=[pytest.mark.eth_w6100]),
+        pytest.param('async_tx_w6100', 'esp32', marks=[pytest.mark.eth_w6100]),
     ],
     indirect=['target'],
 )
@@ -9,6 +9,7 @@
 #include "esp_eth_mac.h"
 #include "esp_eth_mac_spi.h"
 #include "wiznet_spi.h"
+#include "eth_rx_pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -127,6 +128,54 @@ typedef struct {
 /** Upper-bound guard while polling Sn_CR / Sn_SR / Sn_IR (not a chip timing constant) */
 #define WIZNET_SOCK_CMD_GUARD_MS (1000)
 
+/** Sn_CR completion: busy-poll this long, then yield to other ready tasks until WIZNET_SOCK_CMD_YIELD_US,
+ *  only then sleep a tick between polls */
+#define WIZNET_SOCK_CMD_SPIN_US  (50)
+#define WIZNET_SOCK_CMD_YIELD_US (1000)
+
+/** SOCK0 gets the whole socket buffer memory in each direction, see wiznet_setup_default() */
+#define WIZNET_SOCK_BUF_SIZE_KB (16)
+#define WIZNET_SOCK_BUF_SIZE    (WIZNET_SOCK_BUF_SIZE_KB * 1024)
+
+/** How long transmit() waits for SEND_OK of the previous frame in asynchronous TX mode */
+#define WIZNET_TX_DONE_TMO_MS (10)
+
+/**
+ * @brief WIZnet driver flags (`eth_wiznet_config_t::flags`)
+ */
+#define ETH_WIZNET_FLAG_ASYNC_TX (1 << 0) /*!< Return from transmit() right after SEND is accepted; SEND_OK is handled
+                                               by the RX task and only waited for when the next frame is sent */
+
+/**
+ * @brief WIZnet specific commands for ioctl API
+ */
+typedef enum {
+    ETH_MAC_WIZNET_CMD_G_CMD_LATENCY = ETH_CMD_CUSTOM_MAC_CMDS_OFFSET,  /*!< Get socket command latency statistics (wiznet_cmd_latency_stats_t) */
+    ETH_MAC_WIZNET_CMD_CLR_CMD_LATENCY,                                 /*!< Reset socket command latency statistics (data unused) */
+} eth_mac_wiznet_io_cmd_t;
+
+/** Number of latency histogram buckets, bucket `i` counts commands completed in [2^(i-1), 2^i) us, bucket 0
+ *  those under 1 us and the last bucket everything above */
+#define WIZNET_CMD_LAT_BUCKETS (12)
+
+/**
+ * @brief Latency statistics of one socket command class
+ */
+typedef struct {
+    uint32_t count;                             /*!< Number of issued commands */
+    uint32_t max_us;                            /*!< Longest time from writing Sn_CR to completion */
+    uint32_t hist[WIZNET_CMD_LAT_BUCKETS];      /*!< Latency histogram, see WIZNET_CMD_LAT_BUCKETS */
+} wiznet_cmd_latency_t;
+
+/**
+ * @brief Socket command latency statistics
+ */
+typedef struct {
+    wiznet_cmd_latency_t send;                  /*!< SEND commands */
+    wiznet_cmd_latency_t recv;                  /*!< RECV commands */
+    wiznet_cmd_latency_t other;                 /*!< OPEN, CLOSE and other commands */
+} wiznet_cmd_latency_stats_t;
+
 /**
  * @brief Set mediator for Ethernet MAC
  *
@@ -262,6 +311,16 @@ esp_err_t emac_wiznet_write_phy_reg(esp_eth_mac_t *mac, uint32_t phy_addr, uint3
  */
 esp_err_t emac_wiznet_read_phy_reg(esp_eth_mac_t *mac, uint32_t phy_addr, uint32_t phy_reg, uint32_t *reg_value);
 
+/**
+ * @brief Process WIZnet specific ioctl commands
+ *
+ * @param mac Ethernet MAC instance
+ * @param cmd Command, see eth_mac_wiznet_io_cmd_t
+ * @param data Command specific data
+ * @return ESP_OK on success, ESP_ERR_INVALID_ARG for unknown command or missing data
+ */
+esp_err_t emac_wiznet_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *data);
+
 /**
  * @brief Initialize MAC
  *
@@ -325,7 +384,7 @@ esp_err_t wiznet_create_poll_timer(emac_wiznet_t *emac);
  * Operations performed:
  * - Allocate all 16KB RX and TX buffer to SOCK0
  * - Disable all socket interrupts (SIMR=0)
- * - Enable SOCK0 receive interrupt
+ * - Enable SOCK0 receive interrupt (and SEND_OK in asynchronous TX interrupt mode)
  * - Set interrupt level timer to maximum (~1.5ms)
  *
  * @param emac WIZnet EMAC instance
@@ -374,7 +433,10 @@ esp_err_t wiznet_write(emac_wiznet_t *emac, uint32_t address, const void *data,
  * @brief Send a socket command and wait for completion
  *
  * Writes the command to the socket command register and polls until
- * the command is acknowledged (register reads 0).
+ * the command is acknowledged (register reads 0). Polling busy-waits for
+ * WIZNET_SOCK_CMD_SPIN_US, then yields until WIZNET_SOCK_CMD_YIELD_US and
+ * only then sleeps a tick between polls. The latency is recorded in the
+ * statistics returned by ETH_MAC_WIZNET_CMD_G_CMD_LATENCY.
  *
  * @param emac WIZnet EMAC instance
  * @param command Command value to send
@@ -389,6 +451,14 @@ esp_err_t wiznet_send_command(emac_wiznet_t *emac, uint8_t command, uint32_t tim
  * Transmits an Ethernet frame using the chip-specific register addresses
  * from the ops structure.
  *
+ * The frame is uploaded to TX memory behind the previous, possibly still
+ * transmitting, frame; only committing TX_WR and issuing SEND wait for the
+ * previous SEND to complete. TX_WR and the free space are tracked locally and
+ * resynchronized from the chip after socket open or an error.
+ *
+ * With ETH_WIZNET_FLAG_ASYNC_TX, the function returns once the SEND command is
+ * accepted. Completion of that frame is only waited for by the next call.
+ *
  * @param mac Ethernet MAC instance
  * @param buf Frame buffer to transmit
  * @param length Frame length in bytes
@@ -436,6 +506,9 @@ typedef struct {
     spi_host_device_t spi_host_id;                      /*!< SPI peripheral */
     spi_device_interface_config_t *spi_devcfg;          /*!< SPI device configuration */
     eth_spi_custom_driver_config_t custom_spi_driver;   /*!< Custom SPI driver definitions */
+    uint32_t flags;                                     /*!< Driver flags, see ETH_WIZNET_FLAG_* */
+    eth_rx_pool_handle_t rx_pool;                       /*!< Pool to allocate received frames from, NULL to allocate them from heap. With a pool, attach the driver to its netif by eth_rx_pool_new_netif_glue() */
+    uint32_t spi_queued_min_len;                        /*!< Queue SPI transfers of at least this many bytes, so the calling task sleeps while they run, 0 to poll all transfers */
 } eth_wiznet_config_t;
 
 /**
@@ -18,13 +18,17 @@ extern "C" {
  *
  * This structure contains the SPI-related fields needed to initialize
  * the default SPI driver.
+ *
+ * @note The leading members keep the layout of `eth_wiznet_config_t`, so a chip config cast to this structure still
+ * works. `queued_min_len` then overlaps `custom_spi_driver.config`, which is NULL with the default SPI driver, so all
+ * transfers stay polled.
  */
 typedef struct {
     int int_gpio_num;                           /*!< Interrupt GPIO number (unused by SPI layer, but maintains struct layout) */
     uint32_t poll_period_ms;                    /*!< Poll period (unused by SPI layer, but maintains struct layout) */
     spi_host_device_t spi_host_id;              /*!< SPI peripheral */
     spi_device_interface_config_t *spi_devcfg;  /*!< SPI device configuration */
-    /* custom_spi_driver field not needed here - handled by chip-specific code */
+    uint32_t queued_min_len;                    /*!< Transfers of at least this many bytes are queued instead of polled, 0 to poll all transfers */
 } wiznet_spi_config_t;
 
 /**
@@ -16,6 +16,7 @@
 #include "esp_idf_version.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "driver/gpio.h"
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(6, 0, 0)
 #include "esp_private/gpio.h"
@@ -48,9 +49,21 @@ struct emac_wiznet_s {
     uint32_t poll_period_ms;        /*!< Poll period in milliseconds */
     uint8_t addr[ETH_ADDR_LEN];     /*!< MAC address */
     bool packets_remain;            /*!< Flag indicating more packets in RX buffer */
-    uint8_t *rx_buffer;             /*!< RX buffer for incoming frames */
+    uint8_t *rx_buffer;             /*!< Bounce buffer for receive() into a caller provided buffer */
+    eth_rx_pool_handle_t rx_pool;   /*!< Pool of frames passed to the stack, NULL to use heap */
     uint32_t tx_tmo;                /*!< TX timeout in microseconds (speed-dependent) */
     bool sock_started;              /*!< SOCK0 was opened by emac_wiznet_start() */
+    bool async_tx;                  /*!< Don't wait for SEND_OK in transmit() (ETH_WIZNET_FLAG_ASYNC_TX) */
+    bool tx_pending;                /*!< SEND was issued and its SEND_OK has not been consumed yet */
+    SemaphoreHandle_t tx_done_sem;  /*!< Given by the RX task on SEND_OK (asynchronous TX, interrupt mode only) */
+    uint16_t tx_pending_len;        /*!< Bytes of the outstanding SEND still occupying TX memory */
+    uint16_t tx_wr;                 /*!< Cached Sn_TX_WR (host byte order), valid if tx_wr_valid */
+    bool tx_wr_valid;               /*!< tx_wr is in sync with the chip */
+    uint16_t rx_rd;                 /*!< Cached Sn_RX_RD (host byte order), valid if rx_remain > 0 */
+    uint16_t rx_remain;             /*!< Bytes known to be in RX memory from rx_rd on, 0 = re-read registers */
+    uint16_t rx_next_len;           /*!< Header of the frame at rx_rd if already fetched, 0 otherwise */
+    wiznet_cmd_latency_stats_t cmd_stats; /*!< Socket command latency statistics */
+    portMUX_TYPE cmd_stats_lock;    /*!< Protects cmd_stats, commands are issued from TX and RX context */
     void *context;                  /*!< Chip-specific context data (size from ops->context_size) */
 };
 
@@ -149,6 +162,13 @@ esp_err_t emac_wiznet_start(esp_eth_mac_t *mac)
     ESP_GOTO_ON_ERROR(wiznet_send_command(emac, ops->cmd_open, WIZNET_SOCK_CMD_GUARD_MS),
                       err, emac->tag, "issue OPEN command failed");
     emac->sock_started = true;
+    /* a freshly opened socket has no SEND outstanding, resync TX pointers on the next transmit */
+    emac->tx_pending = false;
+    emac->tx_wr_valid = false;
+    emac->rx_remain = 0;
+    if (emac->tx_done_sem) {
+        xSemaphoreTake(emac->tx_done_sem, 0);
+    }
     /* enable interrupt for SOCK0 */
     uint8_t simr = ops->simr_sock0;
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_simr, &simr, sizeof(simr)), err, emac->tag, "write SIMR failed");
@@ -272,6 +292,28 @@ err:
     return ret;
 }
 
+esp_err_t emac_wiznet_custom_ioctl(esp_eth_mac_t *mac, int cmd, void *data)
+{
+    emac_wiznet_t *emac = __containerof(mac, emac_wiznet_t, parent);
+
+    switch (cmd) {
+    case ETH_MAC_WIZNET_CMD_G_CMD_LATENCY:
+        ESP_RETURN_ON_FALSE(data, ESP_ERR_INVALID_ARG, emac->tag, "command latency get invalid argument, can't be NULL");
+        portENTER_CRITICAL(&emac->cmd_stats_lock);
+        memcpy(data, &emac->cmd_stats, sizeof(emac->cmd_stats));
+        portEXIT_CRITICAL(&emac->cmd_stats_lock);
+        break;
+    case ETH_MAC_WIZNET_CMD_CLR_CMD_LATENCY:
+        portENTER_CRITICAL(&emac->cmd_stats_lock);
+        memset(&emac->cmd_stats, 0, sizeof(emac->cmd_stats));
+        portEXIT_CRITICAL(&emac->cmd_stats_lock);
+        break;
+    default:
+        ESP_RETURN_ON_ERROR(ESP_ERR_INVALID_ARG, emac->tag, "unknown io command: %i", cmd);
+    }
+    return ESP_OK;
+}
+
 esp_err_t emac_wiznet_init(esp_eth_mac_t *mac)
 {
     esp_err_t ret = ESP_OK;
@@ -395,13 +437,50 @@ esp_err_t wiznet_write(emac_wiznet_t *emac, uint32_t address, const void *data,
     return emac->spi.write(emac->spi.ctx, cmd, addr, data, len);
 }
 
+static void wiznet_cmd_record_latency(emac_wiznet_t *emac, uint8_t command, uint32_t latency_us)
+{
+    const wiznet_chip_ops_t *ops = emac->ops;
+    wiznet_cmd_latency_t *stats = &emac->cmd_stats.other;
+    if (command == ops->cmd_send) {
+        stats = &emac->cmd_stats.send;
+    } else if (command == ops->cmd_recv) {
+        stats = &emac->cmd_stats.recv;
+    }
+    uint32_t bucket = latency_us ? 32 - __builtin_clz(latency_us) : 0;
+    if (bucket >= WIZNET_CMD_LAT_BUCKETS) {
+        bucket = WIZNET_CMD_LAT_BUCKETS - 1;
+    }
+    portENTER_CRITICAL(&emac->cmd_stats_lock);
+    stats->count++;
+    stats->hist[bucket]++;
+    if (latency_us > stats->max_us) {
+        stats->max_us = latency_us;
+    }
+    portEXIT_CRITICAL(&emac->cmd_stats_lock);
+}
+
+/* Back off between polls of a command in progress: spin first, then yield, then sleep. */
+static void wiznet_cmd_backoff(uint64_t start)
+{
+    uint64_t elapsed = esp_timer_get_time() - start;
+    if (elapsed < WIZNET_SOCK_CMD_SPIN_US) {
+        return;
+    }
+    if (elapsed < WIZNET_SOCK_CMD_YIELD_US) {
+        taskYIELD();
+    } else {
+        vTaskDelay(1);
+    }
+}
+
 esp_err_t wiznet_send_command(emac_wiznet_t *emac, uint8_t command, uint32_t timeout_ms)
 {
     esp_err_t ret = ESP_OK;
     const wiznet_chip_ops_t *ops = emac->ops;
     uint8_t cr = command;
     uint8_t sr = 0;
-    uint64_t deadline = esp_timer_get_time() + (uint64_t)timeout_ms * 1000;
+    uint64_t start = esp_timer_get_time();
+    uint64_t deadline = start + (uint64_t)timeout_ms * 1000;
 
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_cr, &command, sizeof(command)),
                       err, emac->tag, "write SCR failed");
@@ -416,7 +495,7 @@ esp_err_t wiznet_send_command(emac_wiznet_t *emac, uint8_t command, uint32_t tim
         if (esp_timer_get_time() >= deadline) {
             ESP_GOTO_ON_FALSE(false, ESP_ERR_TIMEOUT, err, emac->tag, "command accept timeout");
         }
-        vTaskDelay(pdMS_TO_TICKS(1));
+        wiznet_cmd_backoff(start);
     } while (true);
 
     /* CLOSE: wait until Sn_SR reports SOCK_CLOSED (fixes W6100 stop under load). */
@@ -425,17 +504,18 @@ esp_err_t wiznet_send_command(emac_wiznet_t *emac, uint8_t command, uint32_t tim
             ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_sr, &sr, sizeof(sr)),
                               err, emac->tag, "read SOCK SR failed");
             if (sr == WIZNET_SOCK_SR_CLOSED) {
-                return ESP_OK;
+                break;
             }
             if (esp_timer_get_time() >= deadline) {
                 ESP_GOTO_ON_FALSE(false, ESP_ERR_TIMEOUT, err, emac->tag,
                                   "command complete timeout (Sn_SR=0x%02x, expected 0x%02x)", sr, WIZNET_SOCK_SR_CLOSED);
             }
-            vTaskDelay(pdMS_TO_TICKS(1));
+            wiznet_cmd_backoff(start);
         } while (true);
     }
 
     /* OPEN/RECV/SEND: Sn_CR accept is enough. */
+    wiznet_cmd_record_latency(emac, command, esp_timer_get_time() - start);
     return ESP_OK;
 err:
     return ret;
@@ -470,16 +550,24 @@ err:
     return ret;
 }
 
-static esp_err_t wiznet_get_rx_received_size(emac_wiznet_t *emac, uint16_t *size)
+/* Read RX_RSR and RX_RD in one burst, they are close to each other in the socket register block. */
+static esp_err_t wiznet_get_rx_state(emac_wiznet_t *emac, uint16_t *received, uint16_t *rd)
 {
     esp_err_t ret = ESP_OK;
     const wiznet_chip_ops_t *ops = emac->ops;
-    uint16_t received0, received1 = 0;
+    uint32_t rd_pos = (ops->reg_sock_rx_rd - ops->reg_sock_rx_rsr) >> WIZNET_ADDR_OFFSET;
+    uint32_t win_len = rd_pos + sizeof(uint16_t);
+    uint8_t win0[8] __attribute__((aligned(4)));
+    uint8_t win1[8] __attribute__((aligned(4)));
+
+    ESP_GOTO_ON_FALSE(win_len <= sizeof(win0), ESP_ERR_INVALID_STATE, err, emac->tag, "RX_RD too far from RX_RSR");
+    // read the window more than once, until RX_RSR is the same in both reads
     do {
-        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rsr, &received0, sizeof(received0)), err, emac->tag, "read RX RSR failed");
-        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rsr, &received1, sizeof(received1)), err, emac->tag, "read RX RSR failed");
-    } while (received0 != received1);
-    *size = __builtin_bswap16(received0);
+        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rsr, win0, win_len), err, emac->tag, "read RX RSR/RD failed");
+        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rsr, win1, win_len), err, emac->tag, "read RX RSR/RD failed");
+    } while (win0[0] != win1[0] || win0[1] != win1[1]);
+    *received = (win1[0] << 8) | win1[1];
+    *rd = (win1[rd_pos] << 8) | win1[rd_pos + 1];
 
 err:
     return ret;
@@ -507,6 +595,48 @@ err:
  * Common Transmit/Receive Implementation
  ******************************************************************************/
 
+/* Wait until the previously issued SEND is reported done by the chip. */
+static esp_err_t wiznet_wait_tx_done(emac_wiznet_t *emac)
+{
+    esp_err_t ret = ESP_OK;
+    const wiznet_chip_ops_t *ops = emac->ops;
+    uint8_t status = 0;
+
+    if (!emac->tx_pending) {
+        return ESP_OK;
+    }
+    if (emac->tx_done_sem) {
+        /* SEND_OK is handled by the RX task only, the common case is that it is long gone by now */
+        if (xSemaphoreTake(emac->tx_done_sem, pdMS_TO_TICKS(WIZNET_TX_DONE_TMO_MS)) != pdTRUE) {
+            /* the interrupt might have been missed, let the RX task check the chip once more before giving up */
+            xTaskNotifyGive(emac->rx_task_hdl);
+            if (xSemaphoreTake(emac->tx_done_sem, pdMS_TO_TICKS(WIZNET_TX_DONE_TMO_MS)) != pdTRUE) {
+                emac->tx_pending = false;
+                ESP_LOGE(emac->tag, "previous frame not sent");
+                return wiznet_is_link_up(emac) ? ESP_ERR_TIMEOUT : ESP_FAIL;
+            }
+        }
+        emac->tx_pending = false;
+        return ESP_OK;
+    } else {
+        /* polling the TX done event */
+        uint64_t start = esp_timer_get_time();
+        do {
+            if (!wiznet_is_link_up(emac) || (esp_timer_get_time() - start) > emac->tx_tmo) {
+                emac->tx_pending = false;
+                return ESP_FAIL;
+            }
+            ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_ir, &status, sizeof(status)), err, emac->tag, "read SOCK0 IR failed");
+        } while (!(status & ops->sir_send));
+        emac->tx_pending = false;
+    }
+    // clear the event bit
+    status = ops->sir_send;
+    ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_irclr, &status, sizeof(status)), err, emac->tag, "write SOCK0 IRCLR failed");
+err:
+    return ret;
+}
+
 esp_err_t emac_wiznet_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_t length)
 {
     esp_err_t ret = ESP_OK;
@@ -516,38 +646,47 @@ esp_err_t emac_wiznet_transmit(esp_eth_mac_t *mac, uint8_t *buf, uint32_t length
 
     ESP_GOTO_ON_FALSE(length <= ETH_MAX_PACKET_SIZE, ESP_ERR_INVALID_ARG, err,
                       emac->tag, "frame size is too big (actual %" PRIu32 ", maximum %u)", length, ETH_MAX_PACKET_SIZE);
-    // check if there's free memory to store this packet
-    uint16_t free_size = 0;
-    ESP_GOTO_ON_ERROR(wiznet_get_tx_free_size(emac, &free_size), err, emac->tag, "get free size failed");
-    ESP_GOTO_ON_FALSE(length <= free_size, ESP_ERR_NO_MEM, err, emac->tag, "free size (%" PRIu16 ") < send length (%" PRIu32 ")", free_size, length);
-    // get current write pointer
-    ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_tx_wr, &offset, sizeof(offset)), err, emac->tag, "read TX WR failed");
-    offset = __builtin_bswap16(offset);
-    // copy data to tx memory
+    if (!emac->tx_wr_valid) {
+        // nothing can be in flight when resyncing, the chip owns the TX pointers again
+        ESP_GOTO_ON_ERROR(wiznet_wait_tx_done(emac), err, emac->tag, "previous transmit failed");
+        // check if there's free memory to store this packet
+        uint16_t free_size = 0;
+        ESP_GOTO_ON_ERROR(wiznet_get_tx_free_size(emac, &free_size), err, emac->tag, "get free size failed");
+        ESP_GOTO_ON_FALSE(length <= free_size, ESP_ERR_NO_MEM, err, emac->tag, "free size (%" PRIu16 ") < send length (%" PRIu32 ")", free_size, length);
+        // get current write pointer
+        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_tx_wr, &offset, sizeof(offset)), err, emac->tag, "read TX WR failed");
+        emac->tx_wr = __builtin_bswap16(offset);
+        emac->tx_wr_valid = true;
+    }
+    // only the outstanding SEND occupies TX memory, TX_FSR equals the buffer size once it completes
+    ESP_GOTO_ON_FALSE(length + (emac->tx_pending ? emac->tx_pending_len : 0) <= WIZNET_SOCK_BUF_SIZE, ESP_ERR_NO_MEM, err,
+                      emac->tag, "no TX memory for send length (%" PRIu32 ")", length);
+    // copy data to tx memory behind the frame which may still be on the wire
+    offset = emac->tx_wr;
     ESP_GOTO_ON_ERROR(wiznet_write_buffer(emac, buf, length, offset), err, emac->tag, "write frame failed");
+    // the chip accepts only one SEND at a time, make sure the previous one is done
+    ESP_GOTO_ON_ERROR(wiznet_wait_tx_done(emac), err, emac->tag, "previous transmit failed");
     // update write pointer
     offset += length;
+    emac->tx_wr = offset;
     offset = __builtin_bswap16(offset);
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_tx_wr, &offset, sizeof(offset)), err, emac->tag, "write TX WR failed");
+    // nothing is in flight now, so a token is left only by a SEND given up on before, it must not complete the new one
+    if (emac->tx_done_sem) {
+        xSemaphoreTake(emac->tx_done_sem, 0);
+    }
     // issue SEND command
     ESP_GOTO_ON_ERROR(wiznet_send_command(emac, ops->cmd_send, 100), err, emac->tag, "issue SEND command failed");
+    emac->tx_pending = true;
+    emac->tx_pending_len = length;
 
-    // polling the TX done event
-    uint8_t status = 0;
-    uint64_t start = esp_timer_get_time();
-    uint64_t now = 0;
-    do {
-        now = esp_timer_get_time();
-        if (!wiznet_is_link_up(emac) || (now - start) > emac->tx_tmo) {
-            return ESP_FAIL;
-        }
-        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_ir, &status, sizeof(status)), err, emac->tag, "read SOCK0 IR failed");
-    } while (!(status & ops->sir_send));
-    // clear the event bit
-    status = ops->sir_send;
-    ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_irclr, &status, sizeof(status)), err, emac->tag, "write SOCK0 IRCLR failed");
-
+    if (!emac->async_tx) {
+        ret = wiznet_wait_tx_done(emac);
+    }
+    return ret;
 err:
+    // don't trust the cached pointer after a failure, read it back from the chip next time
+    emac->tx_wr_valid = false;
     return ret;
 }
 
@@ -555,7 +694,6 @@ typedef struct {
     uint32_t offset;
     uint32_t copy_len;
     uint32_t rx_len;
-    uint32_t remain;
 } __attribute__((packed)) emac_wiznet_auto_buf_info_t;
 
 #define WIZNET_ETH_MAC_RX_BUF_SIZE_AUTO (0)
@@ -567,6 +705,7 @@ static esp_err_t wiznet_drain_rx_buffer(emac_wiznet_t *emac)
     const wiznet_chip_ops_t *ops = emac->ops;
     uint16_t rx_wr = 0;
 
+    emac->rx_remain = 0;
     if (ops->reg_sock_rx_wr == 0) {
         return ESP_OK;
     }
@@ -582,36 +721,86 @@ err:
     return ret;
 }
 
-static esp_err_t emac_wiznet_alloc_recv_buf(emac_wiznet_t *emac, uint8_t **buf, uint32_t *length)
+/*
+ * Get position and length of the frame at RX_RD. Registers are read only when the bytes known to
+ * be in RX memory were all consumed, so the following frames of a burst are served from the cache.
+ * rx_len is 0 when no frame is waiting.
+ */
+static esp_err_t wiznet_rx_peek(emac_wiznet_t *emac, uint16_t *offset, uint16_t *rx_len, uint16_t *remain)
+{
+    esp_err_t ret = ESP_OK;
+    uint16_t header = 0;
+    *rx_len = 0;
+
+    if (emac->rx_remain == 0) {
+        ESP_GOTO_ON_ERROR(wiznet_get_rx_state(emac, &emac->rx_remain, &emac->rx_rd), err, emac->tag, "get RX state failed");
+        emac->rx_next_len = 0;
+        if (emac->rx_remain == 0) {
+            return ESP_OK;
+        }
+    }
+    if (emac->rx_next_len == 0) {
+        // read head
+        ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, &header, sizeof(header), emac->rx_rd), err, emac->tag, "read frame header failed");
+        emac->rx_next_len = __builtin_bswap16(header);
+    }
+    *rx_len = emac->rx_next_len - 2; // data size includes 2 bytes of header
+    /* Reject implausible frame length; triggers buffer drain in RX task. */
+    ESP_GOTO_ON_FALSE(*rx_len >= ETH_MIN_PACKET_SIZE - ETH_CRC_LEN && *rx_len <= ETH_MAX_PACKET_SIZE,
+                      ESP_ERR_INVALID_SIZE, err, emac->tag,
+                      "implausible frame length %" PRIu16 " from chip header", *rx_len);
+    *offset = emac->rx_rd;
+    *remain = emac->rx_remain;
+    return ESP_OK;
+err:
+    emac->rx_remain = 0;
+    return ret;
+}
+
+/* Release the frame at RX_RD to the chip. next_len is the already fetched header of the following frame, or 0. */
+static esp_err_t wiznet_rx_consume(emac_wiznet_t *emac, uint16_t frame_len, uint16_t next_len, uint32_t timeout_ms)
 {
     esp_err_t ret = ESP_OK;
     const wiznet_chip_ops_t *ops = emac->ops;
+    uint16_t offset = emac->rx_rd + frame_len;
+
+    // update read pointer
+    offset = __builtin_bswap16(offset);
+    ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_rx_rd, &offset, sizeof(offset)), err, emac->tag, "write RX RD failed");
+    /* issue RECV command */
+    ESP_GOTO_ON_ERROR(wiznet_send_command(emac, ops->cmd_recv, timeout_ms), err, emac->tag, "issue RECV command failed");
+    // check if there're more data need to process
+    emac->rx_rd += frame_len;
+    emac->rx_remain = emac->rx_remain > frame_len ? emac->rx_remain - frame_len : 0;
+    emac->rx_next_len = next_len;
+    emac->packets_remain = emac->rx_remain > 0;
+    return ESP_OK;
+err:
+    emac->rx_remain = 0;
+    return ret;
+}
+
+static esp_err_t emac_wiznet_alloc_recv_buf(emac_wiznet_t *emac, uint8_t **buf, uint32_t *length)
+{
+    esp_err_t ret = ESP_OK;
     uint16_t offset = 0;
     uint16_t rx_len = 0;
     uint32_t copy_len = 0;
     uint16_t remain_bytes = 0;
     *buf = NULL;
 
-    wiznet_get_rx_received_size(emac, &remain_bytes);
-    if (remain_bytes) {
-        // get current read pointer
-        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rd, &offset, sizeof(offset)), err, emac->tag, "read RX RD failed");
-        offset = __builtin_bswap16(offset);
-        // read head
-        ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, &rx_len, sizeof(rx_len), offset), err, emac->tag, "read frame header failed");
-        rx_len = __builtin_bswap16(rx_len) - 2; // data size includes 2 bytes of header
-        /* Reject implausible frame length; triggers buffer drain in RX task. */
-        ESP_GOTO_ON_FALSE(rx_len >= ETH_MIN_PACKET_SIZE - ETH_CRC_LEN && rx_len <= ETH_MAX_PACKET_SIZE,
-                          ESP_ERR_INVALID_SIZE, err, emac->tag,
-                          "implausible frame length %" PRIu16 " from chip header", rx_len);
+    ESP_GOTO_ON_ERROR(wiznet_rx_peek(emac, &offset, &rx_len, &remain_bytes), err, emac->tag, "peek frame failed");
+    if (rx_len) {
         copy_len = rx_len > *length ? *length : rx_len;
-        *buf = malloc(copy_len);
+        /* DMA capable, so the payload can be read by SPI straight into the buffer passed to the stack.
+         * The spare bytes receive the header of the next frame in the same transfer. */
+        *buf = emac->rx_pool ? eth_rx_pool_alloc(emac->rx_pool, copy_len + sizeof(uint16_t)) :
+               heap_caps_malloc(copy_len + sizeof(uint16_t), MALLOC_CAP_DMA);
         if (*buf != NULL) {
             emac_wiznet_auto_buf_info_t *buff_info = (emac_wiznet_auto_buf_info_t *)*buf;
             buff_info->offset = offset;
             buff_info->copy_len = copy_len;
             buff_info->rx_len = rx_len;
-            buff_info->remain = remain_bytes;
         } else {
             ret = ESP_ERR_NO_MEM;
             goto err;
@@ -626,56 +815,49 @@ esp_err_t emac_wiznet_receive(esp_eth_mac_t *mac, uint8_t *buf, uint32_t *length
 {
     esp_err_t ret = ESP_OK;
     emac_wiznet_t *emac = __containerof(mac, emac_wiznet_t, parent);
-    const wiznet_chip_ops_t *ops = emac->ops;
     uint16_t offset = 0;
     uint16_t rx_len = 0;
     uint16_t copy_len = 0;
     uint16_t remain_bytes = 0;
+    uint16_t next_len = 0;
     emac->packets_remain = false;
 
     if (*length != WIZNET_ETH_MAC_RX_BUF_SIZE_AUTO) {
-        wiznet_get_rx_received_size(emac, &remain_bytes);
-        if (remain_bytes) {
-            // get current read pointer
-            ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rd, &offset, sizeof(offset)), err, emac->tag, "read RX RD failed");
-            offset = __builtin_bswap16(offset);
-            // read head first
-            ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, &rx_len, sizeof(rx_len), offset), err, emac->tag, "read frame header failed");
-            rx_len = __builtin_bswap16(rx_len) - 2; // data size includes 2 bytes of header
-            /* Same check as emac_wiznet_alloc_recv_buf. */
-            ESP_GOTO_ON_FALSE(rx_len >= ETH_MIN_PACKET_SIZE - ETH_CRC_LEN && rx_len <= ETH_MAX_PACKET_SIZE,
-                              ESP_ERR_INVALID_SIZE, err, emac->tag,
-                              "implausible frame length %" PRIu16 " from chip header", rx_len);
-            copy_len = rx_len > *length ? *length : rx_len;
-        } else {
+        ESP_GOTO_ON_ERROR(wiznet_rx_peek(emac, &offset, &rx_len, &remain_bytes), err, emac->tag, "peek frame failed");
+        if (rx_len == 0) {
             // silently return when no frame is waiting
             goto err;
         }
+        copy_len = rx_len > *length ? *length : rx_len;
     } else {
         emac_wiznet_auto_buf_info_t *buff_info = (emac_wiznet_auto_buf_info_t *)buf;
         offset = buff_info->offset;
         copy_len = buff_info->copy_len;
         rx_len = buff_info->rx_len;
-        remain_bytes = buff_info->remain;
+        remain_bytes = emac->rx_remain;
     }
     // 2 bytes of header
     offset += 2;
     // read the payload
-    ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, emac->rx_buffer, copy_len, offset), err, emac->tag, "read payload failed, len=%" PRIu16 ", offset=%" PRIu16, rx_len, offset);
-    memcpy(buf, emac->rx_buffer, copy_len);
-    offset += rx_len;
-    // update read pointer
-    offset = __builtin_bswap16(offset);
-    ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_rx_rd, &offset, sizeof(offset)), err, emac->tag, "write RX RD failed");
-    /* issue RECV command */
-    ESP_GOTO_ON_ERROR(wiznet_send_command(emac, ops->cmd_recv, 100), err, emac->tag, "issue RECV command failed");
-    // check if there're more data need to process
-    remain_bytes -= rx_len + 2;
-    emac->packets_remain = remain_bytes > 0;
+    if (*length == WIZNET_ETH_MAC_RX_BUF_SIZE_AUTO) {
+        // buffer comes from emac_wiznet_alloc_recv_buf(), it is DMA capable so no bounce is needed,
+        // and it has room for the header of the next frame, if there is one, to be read in the same burst
+        bool fetch_next = copy_len == rx_len && remain_bytes >= rx_len + 2 * sizeof(uint16_t);
+        uint32_t read_len = copy_len + (fetch_next ? sizeof(uint16_t) : 0);
+        ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, buf, read_len, offset), err, emac->tag, "read payload failed, len=%" PRIu16 ", offset=%" PRIu16, rx_len, offset);
+        if (fetch_next) {
+            next_len = (buf[copy_len] << 8) | buf[copy_len + 1];
+        }
+    } else {
+        ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, emac->rx_buffer, copy_len, offset), err, emac->tag, "read payload failed, len=%" PRIu16 ", offset=%" PRIu16, rx_len, offset);
+        memcpy(buf, emac->rx_buffer, copy_len);
+    }
+    ESP_GOTO_ON_ERROR(wiznet_rx_consume(emac, rx_len + 2, next_len, 100), err, emac->tag, "release frame failed");
 
     *length = copy_len;
     return ret;
 err:
+    emac->rx_remain = 0;
     *length = 0;
     return ret;
 }
@@ -683,29 +865,14 @@ err:
 static esp_err_t emac_wiznet_flush_recv_frame(emac_wiznet_t *emac)
 {
     esp_err_t ret = ESP_OK;
-    const wiznet_chip_ops_t *ops = emac->ops;
     uint16_t offset = 0;
     uint16_t rx_len = 0;
     uint16_t remain_bytes = 0;
     emac->packets_remain = false;
 
-    wiznet_get_rx_received_size(emac, &remain_bytes);
-    if (remain_bytes) {
-        // get current read pointer
-        ESP_GOTO_ON_ERROR(wiznet_read(emac, ops->reg_sock_rx_rd, &offset, sizeof(offset)), err, emac->tag, "read RX RD failed");
-        offset = __builtin_bswap16(offset);
-        // read head first
-        ESP_GOTO_ON_ERROR(wiznet_read_buffer(emac, &rx_len, sizeof(rx_len), offset), err, emac->tag, "read frame header failed");
-        // update read pointer
-        rx_len = __builtin_bswap16(rx_len);
-        offset += rx_len;
-        offset = __builtin_bswap16(offset);
-        ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_sock_rx_rd, &offset, sizeof(offset)), err, emac->tag, "write RX RD failed");
-        /* issue RECV command */
-        ESP_GOTO_ON_ERROR(wiznet_send_command(emac, ops->cmd_recv, WIZNET_SOCK_CMD_GUARD_MS), err, emac->tag, "issue RECV command failed");
-        // check if there're more data need to process
-        remain_bytes -= rx_len;
-        emac->packets_remain = remain_bytes > 0;
+    ESP_GOTO_ON_ERROR(wiznet_rx_peek(emac, &offset, &rx_len, &remain_bytes), err, emac->tag, "peek frame failed");
+    if (rx_len) {
+        ESP_GOTO_ON_ERROR(wiznet_rx_consume(emac, rx_len + 2, 0, WIZNET_SOCK_CMD_GUARD_MS), err, emac->tag, "release frame failed");
     }
 err:
     return ret;
@@ -732,6 +899,12 @@ void emac_wiznet_task(void *arg)
         }
         /* read interrupt status */
         wiznet_read(emac, ops->reg_sock_ir, &status, sizeof(status));
+        /* previous frame sent (asynchronous TX in interrupt mode only) */
+        if (emac->tx_done_sem && (status & ops->sir_send)) {
+            uint8_t clr = ops->sir_send;
+            wiznet_write(emac, ops->reg_sock_irclr, &clr, sizeof(clr));
+            xSemaphoreGive(emac->tx_done_sem);
+        }
         /* packet received */
         if (status & ops->sir_recv) {
             /* clear interrupt status */
@@ -746,10 +919,10 @@ void emac_wiznet_task(void *arg)
                         buf_len = WIZNET_ETH_MAC_RX_BUF_SIZE_AUTO;
                         if (emac->parent.receive(&emac->parent, buffer, &buf_len) == ESP_OK) {
                             if (buf_len == 0) {
-                                free(buffer);
+                                eth_rx_pool_free(buffer);
                             } else if (frame_len > buf_len) {
                                 ESP_LOGE(emac->tag, "received frame was truncated");
-                                free(buffer);
+                                eth_rx_pool_free(buffer);
                             } else {
                                 ESP_LOGD(emac->tag, "receive len=%" PRIu32, buf_len);
                                 /* pass the buffer to stack (e.g. TCP/IP layer) */
@@ -757,7 +930,7 @@ void emac_wiznet_task(void *arg)
                             }
                         } else {
                             ESP_LOGE(emac->tag, "frame read from module failed");
-                            free(buffer);
+                            eth_rx_pool_free(buffer);
                         }
                     } else if (frame_len) {
                         ESP_LOGE(emac->tag, "invalid combination of frame_len(%" PRIu32 ") and buffer pointer(%p)", frame_len, buffer);
@@ -786,12 +959,12 @@ esp_err_t wiznet_setup_default(emac_wiznet_t *emac)
 {
     esp_err_t ret = ESP_OK;
     const wiznet_chip_ops_t *ops = emac->ops;
-    uint8_t reg_value = 16;
+    uint8_t reg_value = WIZNET_SOCK_BUF_SIZE_KB;
 
     /* Only SOCK0 can be used as MAC RAW mode, so we give the whole buffer
-     * (16KB TX and 16KB RX) to SOCK0, which doesn't have any effect for TX though.
-     * A larger TX buffer doesn't buy us pipelining - each SEND is one frame and
-     * must complete before the next. */
+     * (16KB TX and 16KB RX) to SOCK0. Each SEND is still one frame, but the TX
+     * memory lets transmit() upload the next frame while the previous SEND is
+     * on the wire. */
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->regs[WIZNET_REG_SOCK_RXBUF_SIZE], &reg_value, sizeof(reg_value)),
                       err, emac->tag, "set rx buffer size failed");
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->regs[WIZNET_REG_SOCK_TXBUF_SIZE], &reg_value, sizeof(reg_value)),
@@ -815,8 +988,11 @@ esp_err_t wiznet_setup_default(emac_wiznet_t *emac)
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->reg_simr, &reg_value, sizeof(reg_value)),
                       err, emac->tag, "write SIMR failed");
 
-    /* Enable receive event for SOCK0 */
+    /* Enable receive event for SOCK0, and the send event when the RX task completes TX asynchronously */
     reg_value = ops->sir_recv;
+    if (emac->tx_done_sem) {
+        reg_value |= ops->sir_send;
+    }
     ESP_GOTO_ON_ERROR(wiznet_write(emac, ops->regs[WIZNET_REG_SOCK_IMR], &reg_value, sizeof(reg_value)),
                       err, emac->tag, "write SOCK0 IMR failed");
 
@@ -857,6 +1033,10 @@ static void emac_wiznet_cleanup(emac_wiznet_t *emac)
         heap_caps_free(emac->rx_buffer);
         emac->rx_buffer = NULL;
     }
+    if (emac->tx_done_sem) {
+        vSemaphoreDelete(emac->tx_done_sem);
+        emac->tx_done_sem = NULL;
+    }
     if (emac->context) {
         free(emac->context);
         emac->context = NULL;
@@ -921,6 +1101,9 @@ emac_wiznet_t *emac_wiznet_new(const eth_wiznet_config_t *wiznet_config,
     emac->tx_tmo = WIZNET_100M_TX_TMO_US;  // default to 100Mbps timeout
     emac->int_gpio_num = wiznet_config->int_gpio_num;
     emac->poll_period_ms = wiznet_config->poll_period_ms;
+    emac->rx_pool = wiznet_config->rx_pool;
+    emac->async_tx = wiznet_config->flags & ETH_WIZNET_FLAG_ASYNC_TX;
+    portMUX_INITIALIZE(&emac->cmd_stats_lock);
     emac->parent.set_mediator = emac_wiznet_set_mediator;
     emac->parent.init = emac_wiznet_init;
     emac->parent.deinit = emac_wiznet_deinit;
@@ -939,6 +1122,7 @@ emac_wiznet_t *emac_wiznet_new(const eth_wiznet_config_t *wiznet_config,
     emac->parent.read_phy_reg = emac_wiznet_read_phy_reg;
     emac->parent.transmit = emac_wiznet_transmit;
     emac->parent.receive = emac_wiznet_receive;
+    emac->parent.custom_ioctl = emac_wiznet_custom_ioctl;
 #if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 5, 0)
     if (ops->add_mac_filter) {
         emac->parent.add_mac_filter = ops->add_mac_filter;
@@ -971,12 +1155,29 @@ emac_wiznet_t *emac_wiznet_new(const eth_wiznet_config_t *wiznet_config,
         emac->spi.read = wiznet_spi_read;
         emac->spi.write = wiznet_spi_write;
         /* SPI device init */
-        if ((emac->spi.ctx = emac->spi.init(wiznet_config)) == NULL) {
+        wiznet_spi_config_t spi_config = {
+            .int_gpio_num = wiznet_config->int_gpio_num,
+            .poll_period_ms = wiznet_config->poll_period_ms,
+            .spi_host_id = wiznet_config->spi_host_id,
+            .spi_devcfg = wiznet_config->spi_devcfg,
+            .queued_min_len = wiznet_config->spi_queued_min_len,
+        };
+        if ((emac->spi.ctx = emac->spi.init(&spi_config)) == NULL) {
             ESP_LOGE(tag, "SPI initialization failed");
             goto err;
         }
     }
 
+    /* in interrupt mode, SEND_OK of asynchronous TX is consumed by the RX task,
+     * in polling mode transmit() polls for it when the next frame is sent */
+    if (emac->async_tx && emac->int_gpio_num >= 0) {
+        emac->tx_done_sem = xSemaphoreCreateBinary();
+        if (!emac->tx_done_sem) {
+            ESP_LOGE(tag, "create TX done semaphore failed");
+            goto err;
+        }
+    }
+
     /* create rx task */
     BaseType_t core_num = tskNO_AFFINITY;
     if (mac_config->flags & ETH_MAC_FLAG_PIN_TO_CORE) {
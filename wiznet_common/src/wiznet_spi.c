@@ -11,6 +11,7 @@
 #include "freertos/FreeRTOS.h"
 #include "freertos/semphr.h"
 #include "wiznet_spi.h"
+#include "eth_spi_transmit.h"
 
 static const char *TAG = "wiznet.spi";
 
@@ -22,6 +23,7 @@ static const char *TAG = "wiznet.spi";
 typedef struct {
     spi_device_handle_t hdl;
     SemaphoreHandle_t lock;
+    uint32_t queued_min_len;
 } eth_spi_info_t;
 
 static inline bool wiznet_spi_lock(eth_spi_info_t *spi)
@@ -57,6 +59,7 @@ void *wiznet_spi_init(const void *spi_config)
     /* create mutex */
     spi->lock = xSemaphoreCreateMutex();
     ESP_GOTO_ON_FALSE(spi->lock, NULL, err, TAG, "create lock failed");
+    spi->queued_min_len = config->queued_min_len;
 
     ret = spi;
     return ret;
@@ -97,7 +100,7 @@ esp_err_t wiznet_spi_write(void *spi_ctx, uint32_t cmd, uint32_t addr, const voi
         .tx_buffer = value
     };
     if (wiznet_spi_lock(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -121,7 +124,7 @@ esp_err_t wiznet_spi_read(void *spi_ctx, uint32_t cmd, uint32_t addr, void *valu
         .rx_buffer = value
     };
     if (wiznet_spi_lock(spi)) {
-        if (spi_device_polling_transmit(spi->hdl, &trans) != ESP_OK) {
+        if (eth_spi_transmit(spi->hdl, &trans, len, spi->queued_min_len) != ESP_OK) {
             ESP_LOGE(TAG, "%s(%d): spi transmit failed", __FUNCTION__, __LINE__);
             ret = ESP_FAIL;
         }
@@ -0,0 +1,234 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include <inttypes.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "esp_eth_driver.h"
+#include "esp_eth_mac_w5500.h"
+#include "w5500_model.h"
+#include "eth_spi_model.h"
+#include "unity.h"
+
+#define TEST_INT_GPIO       (4)
+#define TEST_FRAME_LEN      (60)
+#define TEST_BURST_FRAMES   (16)
+#define TEST_RX_FRAMES      (8)
+
+static const char *TAG = "wiznet_model_test";
+
+static esp_eth_mac_t *test_mac_new(bool async_tx, bool auto_send_done)
+{
+    eth_spi_model_reset();
+    w5500_model_reset(auto_send_done);
+    eth_mac_config_t mac_config = ETH_MAC_DEFAULT_CONFIG();
+    eth_w5500_config_t w5500_config = ETH_W5500_DEFAULT_CONFIG(SPI2_HOST, NULL);
+    w5500_config.base.int_gpio_num = TEST_INT_GPIO;
+    w5500_config.base.custom_spi_driver = w5500_model_spi_driver();
+    w5500_config.base.flags = async_tx ? ETH_WIZNET_FLAG_ASYNC_TX : 0;
+    esp_eth_mac_t *mac = esp_eth_mac_new_w5500(&w5500_config, &mac_config);
+    TEST_ASSERT_NOT_NULL(mac);
+    TEST_ESP_OK(mac->set_mediator(mac, eth_spi_model_mediator()));
+    TEST_ESP_OK(mac->init(mac));
+    // init() configured INTn as input, the model drives it from now on
+    eth_spi_model_int_attach(TEST_INT_GPIO);
+    TEST_ESP_OK(mac->start(mac));
+    return mac;
+}
+
+static void test_mac_del(esp_eth_mac_t *mac)
+{
+    eth_spi_model_count_task(NULL);
+    // stop() waits for SEND_OK of a frame which might be left in flight on purpose
+    w5500_model_send_done();
+    TEST_ESP_OK(mac->deinit(mac));
+    TEST_ESP_OK(mac->del(mac));
+}
+
+static void test_fill_frame(uint8_t *frame, uint8_t seq)
+{
+    memset(frame, 0xFF, ETH_ADDR_LEN);
+    memset(frame + ETH_ADDR_LEN, seq, TEST_FRAME_LEN - ETH_ADDR_LEN);
+}
+
+/* SPI transactions per transmitted frame once the TX pointers are cached, the first frame also resyncs them */
+static uint32_t test_tx_spi_trans(bool async_tx)
+{
+    uint8_t frame[TEST_FRAME_LEN];
+    esp_eth_mac_t *mac = test_mac_new(async_tx, true);
+
+    test_fill_frame(frame, 0);
+    TEST_ESP_OK(mac->transmit(mac, frame, sizeof(frame)));
+    eth_spi_model_count_task(xTaskGetCurrentTaskHandle());
+    for (int i = 1; i <= TEST_BURST_FRAMES; i++) {
+        test_fill_frame(frame, i);
+        TEST_ESP_OK(mac->transmit(mac, frame, sizeof(frame)));
+        // let the RX task handle SEND_OK as it would between frames of a real traffic
+        vTaskDelay(1);
+    }
+    const w5500_model_stats_t *stats = w5500_model_get_stats();
+    uint32_t trans = eth_spi_model_trans();
+    TEST_ASSERT_EQUAL_UINT32(TEST_BURST_FRAMES + 1, stats->send_cmds);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->send_overlaps);
+    test_mac_del(mac);
+    return trans / TEST_BURST_FRAMES;
+}
+
+TEST_CASE("wiznet SPI transactions per frame, sync vs async TX", "[wiznet_model]")
+{
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    uint32_t sync_trans = test_tx_spi_trans(false);
+    uint32_t async_trans = test_tx_spi_trans(true);
+    ESP_LOGI(TAG, "SPI transactions issued by transmit() per frame: sync %" PRIu32 ", async %" PRIu32,
+             sync_trans, async_trans);
+    // async TX doesn't poll Sn_IR nor clear SEND_OK from the transmitting task
+    TEST_ASSERT_LESS_THAN_UINT32(sync_trans, async_trans);
+    gpio_uninstall_isr_service();
+}
+
+TEST_CASE("wiznet late SEND_OK of a given up SEND doesn't complete the next one", "[wiznet_model]")
+{
+    uint8_t frame[TEST_FRAME_LEN];
+    const w5500_model_stats_t *stats = w5500_model_get_stats();
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new(true, false);
+
+    test_fill_frame(frame, 1);
+    TEST_ESP_OK(mac->transmit(mac, frame, sizeof(frame)));
+    // SEND of frame 1 hangs, frame 2 gives up waiting for it
+    test_fill_frame(frame, 2);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, mac->transmit(mac, frame, sizeof(frame)));
+    // SEND_OK of frame 1 arrives late, the RX task signals it
+    w5500_model_send_done();
+    vTaskDelay(pdMS_TO_TICKS(50));
+    test_fill_frame(frame, 3);
+    TEST_ESP_OK(mac->transmit(mac, frame, sizeof(frame)));
+    // frame 3 is in flight, frame 4 must wait for it rather than consume the stale token of frame 1
+    test_fill_frame(frame, 4);
+    TEST_ASSERT_NOT_EQUAL(ESP_OK, mac->transmit(mac, frame, sizeof(frame)));
+    TEST_ASSERT_EQUAL_UINT32(2, stats->send_cmds);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->send_overlaps);
+
+    w5500_model_send_done();
+    TEST_ASSERT_EQUAL_UINT32(2, stats->sends_done);
+    TEST_ASSERT_EQUAL_UINT8(1, stats->sends[0].head[ETH_ADDR_LEN]);
+    TEST_ASSERT_EQUAL_UINT8(3, stats->sends[1].head[ETH_ADDR_LEN]);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
+
+TEST_CASE("wiznet numbered TX burst leaves the chip in order and intact", "[wiznet_model]")
+{
+    static uint8_t frame[ETH_MAX_PACKET_SIZE];
+    const w5500_model_stats_t *stats = w5500_model_get_stats();
+    uint32_t total_len = 0;
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new(true, false);
+    // the next frame is uploaded while the previous one is still on the wire
+    w5500_model_set_send_time(300);
+
+    for (int i = 0; i < W5500_MODEL_MAX_SENDS; i++) {
+        // vary the length so that the frames wrap around the 16 KB TX memory at different offsets
+        uint32_t len = TEST_FRAME_LEN + (i * 397) % (ETH_MAX_PACKET_SIZE - TEST_FRAME_LEN);
+        memset(frame, 0xFF, ETH_ADDR_LEN);
+        memset(frame + ETH_ADDR_LEN, i, len - ETH_ADDR_LEN);
+        frame[ETH_ADDR_LEN + 1] = ~i;
+        TEST_ESP_OK(mac->transmit(mac, frame, len));
+        total_len += len;
+    }
+    vTaskDelay(pdMS_TO_TICKS(10));
+    ESP_LOGI(TAG, "%" PRIu32 " bytes sent in %" PRIu32 " frames", total_len, stats->sends_done);
+    TEST_ASSERT_GREATER_THAN_UINT32(2 * 16 * 1024, total_len);
+    TEST_ASSERT_EQUAL_UINT32(W5500_MODEL_MAX_SENDS, stats->sends_done);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->send_overlaps);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->tx_overwrites);
+    for (int i = 0; i < W5500_MODEL_MAX_SENDS; i++) {
+        TEST_ASSERT_EQUAL_UINT16(TEST_FRAME_LEN + (i * 397) % (ETH_MAX_PACKET_SIZE - TEST_FRAME_LEN), stats->sends[i].len);
+        TEST_ASSERT_EQUAL_UINT8(i, stats->sends[i].head[ETH_ADDR_LEN]);
+        TEST_ASSERT_EQUAL_UINT8(~i, stats->sends[i].head[ETH_ADDR_LEN + 1]);
+    }
+    w5500_model_set_send_time(0);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
+
+TEST_CASE("wiznet SPI transactions per received frame of a burst", "[wiznet_model]")
+{
+    static uint8_t frame[ETH_MAX_PACKET_SIZE];
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new(false, true);
+
+    eth_spi_model_count_all();
+    // the whole burst is in RX memory by the time the driver gets the interrupt
+    for (int i = 0; i < TEST_RX_FRAMES; i++) {
+        uint16_t len = TEST_FRAME_LEN + i * 100;
+        memset(frame, 0xFF, ETH_ADDR_LEN);
+        memset(frame + ETH_ADDR_LEN, i, len - ETH_ADDR_LEN);
+        TEST_ASSERT_TRUE(w5500_model_inject_rx(frame, len, i == TEST_RX_FRAMES - 1));
+    }
+    vTaskDelay(pdMS_TO_TICKS(50));
+    uint32_t trans = eth_spi_model_trans();
+    eth_spi_model_count_task(NULL);
+
+    TEST_ASSERT_EQUAL_UINT32(TEST_RX_FRAMES, eth_spi_model_rx_count());
+    for (int i = 0; i < TEST_RX_FRAMES; i++) {
+        TEST_ASSERT_EQUAL_UINT8(i, eth_spi_model_rx_frame(i)->head[ETH_ADDR_LEN]);
+        TEST_ASSERT_EQUAL_UINT32(TEST_FRAME_LEN + i * 100, eth_spi_model_rx_frame(i)->len);
+    }
+    ESP_LOGI(TAG, "%" PRIu32 " SPI transactions for a burst of %d frames", trans, TEST_RX_FRAMES);
+    /* Sn_IR read and clear, RX_RSR/RX_RD and the first header once per burst, then per frame the payload
+     * together with the next header, RX_RD and RECV (write and read back of Sn_CR) */
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(5 + 5 * TEST_RX_FRAMES, trans);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
+
+static void test_send_latency(esp_eth_mac_t *mac, uint32_t cmd_time_us, wiznet_cmd_latency_t *send_stats)
+{
+    uint8_t frame[TEST_FRAME_LEN];
+    wiznet_cmd_latency_stats_t stats;
+    w5500_model_set_cmd_time(cmd_time_us);
+    TEST_ESP_OK(mac->custom_ioctl(mac, ETH_MAC_WIZNET_CMD_CLR_CMD_LATENCY, NULL));
+    for (int i = 0; i < TEST_BURST_FRAMES; i++) {
+        test_fill_frame(frame, i);
+        TEST_ESP_OK(mac->transmit(mac, frame, sizeof(frame)));
+    }
+    TEST_ESP_OK(mac->custom_ioctl(mac, ETH_MAC_WIZNET_CMD_G_CMD_LATENCY, &stats));
+    *send_stats = stats.send;
+    uint32_t hist_sum = 0;
+    for (int i = 0; i < WIZNET_CMD_LAT_BUCKETS; i++) {
+        hist_sum += stats.send.hist[i];
+    }
+    ESP_LOGI(TAG, "SEND accepted after %" PRIu32 " us by the model: count %" PRIu32 ", max %" PRIu32 " us",
+             cmd_time_us, stats.send.count, stats.send.max_us);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BURST_FRAMES, stats.send.count);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BURST_FRAMES, hist_sum);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(cmd_time_us, stats.send.max_us);
+}
+
+TEST_CASE("wiznet Sn_CR completion wait and latency histogram", "[wiznet_model]")
+{
+    wiznet_cmd_latency_t send_stats;
+    TEST_ESP_OK(gpio_install_isr_service(0));
+    esp_eth_mac_t *mac = test_mac_new(false, true);
+
+    // accepted within the spin phase, no tick is ever slept
+    test_send_latency(mac, 20, &send_stats);
+    TEST_ASSERT_LESS_THAN_UINT32(WIZNET_SOCK_CMD_YIELD_US, send_stats.max_us);
+    // accepted within the yield phase, still no tick is slept
+    test_send_latency(mac, WIZNET_SOCK_CMD_SPIN_US * 4, &send_stats);
+    TEST_ASSERT_LESS_THAN_UINT32(WIZNET_SOCK_CMD_YIELD_US, send_stats.max_us);
+    // slow commands sleep a tick between polls, they land in the last histogram bucket
+    test_send_latency(mac, 2 * WIZNET_SOCK_CMD_YIELD_US, &send_stats);
+    TEST_ASSERT_EQUAL_UINT32(TEST_BURST_FRAMES, send_stats.hist[WIZNET_CMD_LAT_BUCKETS - 1]);
+    TEST_ASSERT_LESS_THAN_UINT32(2 * WIZNET_SOCK_CMD_YIELD_US + 2 * portTICK_PERIOD_MS * 1000, send_stats.max_us);
+
+    w5500_model_set_cmd_time(0);
+    test_mac_del(mac);
+    gpio_uninstall_isr_service();
+}
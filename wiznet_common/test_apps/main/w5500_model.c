@@ -0,0 +1,307 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <string.h>
+#include "esp_timer.h"
+#include "w5500_model.h"
+
+/* The model is written against the datasheet, it intentionally doesn't share register definitions with the driver. */
+#define BSB_COM_REG       (0x00)
+#define BSB_SOCK0_REG     (0x01)
+#define BSB_SOCK0_TX_BUF  (0x02)
+#define BSB_SOCK0_RX_BUF  (0x03)
+
+#define COM_MR            (0x0000)
+#define COM_SIMR          (0x0018)
+#define COM_PHYCFGR       (0x002E)
+#define COM_VERSIONR      (0x0039)
+#define COM_SIZE          (0x0040)
+
+#define SOCK_CR           (0x0001)
+#define SOCK_IR           (0x0002)
+#define SOCK_SR           (0x0004)
+#define SOCK_TX_FSR       (0x0020)
+#define SOCK_TX_RD        (0x0022)
+#define SOCK_TX_WR        (0x0024)
+#define SOCK_RX_RSR       (0x0026)
+#define SOCK_RX_RD        (0x0028)
+#define SOCK_RX_WR        (0x002A)
+#define SOCK_IMR          (0x002C)
+#define SOCK_SIZE         (0x0030)
+
+#define CMD_OPEN          (0x01)
+#define CMD_CLOSE         (0x10)
+#define CMD_SEND          (0x20)
+#define CMD_RECV          (0x40)
+
+#define SIR_RECV          (1 << 2)
+#define SIR_SEND_OK       (1 << 4)
+#define SR_CLOSED         (0x00)
+#define SR_MACRAW         (0x42)
+#define PHYCFGR_100M_FD   (0x87)
+#define VERSION           (0x04)
+
+#define TX_BUF_SIZE       (16 * 1024)
+#define RX_BUF_SIZE       (16 * 1024)
+
+typedef struct {
+    esp_timer_handle_t send_timer;
+    uint32_t send_time_us;
+    uint32_t cmd_time_us;
+    int64_t cmd_start;
+    uint8_t cmd;
+    bool auto_send_done;
+    uint8_t com[COM_SIZE];
+    uint8_t sock[SOCK_SIZE];
+    uint8_t ir;
+    uint8_t sr;
+    uint16_t tx_rd;
+    bool send_in_flight;
+    uint16_t send_end;
+    uint8_t tx_mem[TX_BUF_SIZE];
+    uint16_t rx_rd;
+    uint16_t rx_wr;
+    uint8_t rx_mem[RX_BUF_SIZE];
+    w5500_model_stats_t stats;
+} w5500_model_t;
+
+static w5500_model_t s_model;
+
+static uint16_t model_get16(const uint8_t *reg)
+{
+    return (reg[0] << 8) | reg[1];
+}
+
+static void model_set16(uint8_t *reg, uint16_t value)
+{
+    reg[0] = value >> 8;
+    reg[1] = value & 0xFF;
+}
+
+static void model_update_int(void)
+{
+    eth_spi_model_int_set((s_model.ir & s_model.sock[SOCK_IMR]) && (s_model.com[COM_SIMR] & 0x01));
+}
+
+static void model_send_done_locked(void)
+{
+    if (!s_model.send_in_flight) {
+        return;
+    }
+    uint16_t len = s_model.send_end - s_model.tx_rd;
+    if (s_model.stats.sends_done < W5500_MODEL_MAX_SENDS) {
+        w5500_model_send_t *send = &s_model.stats.sends[s_model.stats.sends_done];
+        send->len = len;
+        for (int i = 0; i < sizeof(send->head); i++) {
+            send->head[i] = s_model.tx_mem[(uint16_t)(s_model.tx_rd + i) % TX_BUF_SIZE];
+        }
+    }
+    s_model.stats.sends_done++;
+    s_model.tx_rd = s_model.send_end;
+    s_model.send_in_flight = false;
+    s_model.ir |= SIR_SEND_OK;
+    model_update_int();
+}
+
+static void model_command(uint8_t cmd)
+{
+    s_model.cmd = cmd;
+    s_model.cmd_start = esp_timer_get_time();
+    switch (cmd) {
+    case CMD_OPEN:
+        s_model.sr = SR_MACRAW;
+        break;
+    case CMD_CLOSE:
+        s_model.sr = SR_CLOSED;
+        break;
+    case CMD_RECV:
+        // RX memory up to the new RX_RD is released
+        s_model.rx_rd = model_get16(&s_model.sock[SOCK_RX_RD]);
+        break;
+    case CMD_SEND:
+        s_model.stats.send_cmds++;
+        if (s_model.send_in_flight) {
+            // the real chip would start transmitting from the moved TX_RD, corrupting both frames
+            s_model.stats.send_overlaps++;
+        }
+        s_model.send_in_flight = true;
+        s_model.send_end = model_get16(&s_model.sock[SOCK_TX_WR]);
+        if (s_model.send_time_us) {
+            esp_timer_start_once(s_model.send_timer, s_model.send_time_us);
+        } else if (s_model.auto_send_done) {
+            model_send_done_locked();
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/* cmd is the 16-bit offset (address phase), addr the control phase with BSB in bits [7:3] */
+static esp_err_t model_spi_read(void *ctx, uint32_t cmd, uint32_t addr, void *data, uint32_t len)
+{
+    uint8_t *out = data;
+    uint8_t bsb = (addr >> 3) & 0x1F;
+    if (bsb == BSB_SOCK0_REG) {
+        // refresh the registers which the chip maintains itself
+        // Sn_CR clears once the chip accepted the command
+        if (s_model.cmd && esp_timer_get_time() - s_model.cmd_start >= s_model.cmd_time_us) {
+            s_model.cmd = 0;
+        }
+        s_model.sock[SOCK_CR] = s_model.cmd;
+        s_model.sock[SOCK_IR] = s_model.ir;
+        s_model.sock[SOCK_SR] = s_model.sr;
+        model_set16(&s_model.sock[SOCK_TX_FSR],
+                    TX_BUF_SIZE - (uint16_t)(model_get16(&s_model.sock[SOCK_TX_WR]) - s_model.tx_rd));
+        model_set16(&s_model.sock[SOCK_TX_RD], s_model.tx_rd);
+        model_set16(&s_model.sock[SOCK_RX_RSR], s_model.rx_wr - s_model.rx_rd);
+        model_set16(&s_model.sock[SOCK_RX_WR], s_model.rx_wr);
+    }
+    for (uint32_t i = 0; i < len; i++) {
+        uint16_t offset = cmd + i;
+        switch (bsb) {
+        case BSB_COM_REG:
+            if (offset == COM_MR) {
+                out[i] = 0; // reset completes immediately
+            } else if (offset == COM_PHYCFGR) {
+                out[i] = PHYCFGR_100M_FD;
+            } else if (offset == COM_VERSIONR) {
+                out[i] = VERSION;
+            } else {
+                out[i] = offset < COM_SIZE ? s_model.com[offset] : 0;
+            }
+            break;
+        case BSB_SOCK0_REG:
+            out[i] = offset < SOCK_SIZE ? s_model.sock[offset] : 0;
+            break;
+        case BSB_SOCK0_TX_BUF:
+            out[i] = s_model.tx_mem[offset % TX_BUF_SIZE];
+            break;
+        case BSB_SOCK0_RX_BUF:
+            out[i] = s_model.rx_mem[offset % RX_BUF_SIZE];
+            break;
+        default:
+            out[i] = 0; // other sockets are unused
+            break;
+        }
+    }
+    return ESP_OK;
+}
+
+static esp_err_t model_spi_write(void *ctx, uint32_t cmd, uint32_t addr, const void *data, uint32_t len)
+{
+    const uint8_t *in = data;
+    uint8_t bsb = (addr >> 3) & 0x1F;
+    for (uint32_t i = 0; i < len; i++) {
+        uint16_t offset = cmd + i;
+        switch (bsb) {
+        case BSB_COM_REG:
+            if (offset < COM_SIZE) {
+                s_model.com[offset] = in[i];
+            }
+            break;
+        case BSB_SOCK0_REG:
+            if (offset == SOCK_CR) {
+                model_command(in[i]);
+            } else if (offset == SOCK_IR) {
+                s_model.ir &= ~in[i]; // write 1 to clear
+            } else if (offset < SOCK_SIZE) {
+                s_model.sock[offset] = in[i];
+            }
+            break;
+        case BSB_SOCK0_TX_BUF:
+            // TX memory is addressed modulo its size, so the frame can be hit through any alias of its pointers
+            if (s_model.send_in_flight &&
+                    (uint16_t)(offset - s_model.tx_rd) % TX_BUF_SIZE < (uint16_t)(s_model.send_end - s_model.tx_rd)) {
+                s_model.stats.tx_overwrites++;
+            }
+            s_model.tx_mem[offset % TX_BUF_SIZE] = in[i];
+            break;
+        default:
+            break;
+        }
+    }
+    model_update_int();
+    return ESP_OK;
+}
+
+static const eth_spi_model_t s_spi_model = {
+    .read = model_spi_read,
+    .write = model_spi_write,
+};
+
+static void model_send_timer_cb(void *arg)
+{
+    w5500_model_send_done();
+}
+
+void w5500_model_reset(bool auto_send_done)
+{
+    if (!s_model.send_timer) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = model_send_timer_cb,
+            .name = "w5500_model",
+        };
+        esp_timer_create(&timer_args, &s_model.send_timer);
+    }
+    esp_timer_stop(s_model.send_timer);
+    esp_timer_handle_t send_timer = s_model.send_timer;
+    memset(&s_model, 0, sizeof(s_model));
+    s_model.send_timer = send_timer;
+    s_model.auto_send_done = auto_send_done;
+}
+
+void w5500_model_set_send_time(uint32_t send_time_us)
+{
+    eth_spi_model_lock();
+    s_model.send_time_us = send_time_us;
+    eth_spi_model_unlock();
+}
+
+void w5500_model_set_cmd_time(uint32_t cmd_time_us)
+{
+    eth_spi_model_lock();
+    s_model.cmd_time_us = cmd_time_us;
+    eth_spi_model_unlock();
+}
+
+void w5500_model_send_done(void)
+{
+    eth_spi_model_lock();
+    model_send_done_locked();
+    eth_spi_model_unlock();
+}
+
+bool w5500_model_inject_rx(const uint8_t *frame, uint16_t len, bool signal)
+{
+    bool ok = false;
+    uint16_t rx_len = len + 2; // MACRAW frames are prefixed by their length, the prefix included
+    eth_spi_model_lock();
+    if ((uint16_t)(s_model.rx_wr - s_model.rx_rd) + rx_len <= RX_BUF_SIZE) {
+        s_model.rx_mem[s_model.rx_wr % RX_BUF_SIZE] = rx_len >> 8;
+        s_model.rx_mem[(uint16_t)(s_model.rx_wr + 1) % RX_BUF_SIZE] = rx_len & 0xFF;
+        for (int i = 0; i < len; i++) {
+            s_model.rx_mem[(uint16_t)(s_model.rx_wr + 2 + i) % RX_BUF_SIZE] = frame[i];
+        }
+        s_model.rx_wr += rx_len;
+        ok = true;
+    }
+    if (signal) {
+        s_model.ir |= SIR_RECV;
+        model_update_int();
+    }
+    eth_spi_model_unlock();
+    return ok;
+}
+
+const w5500_model_stats_t *w5500_model_get_stats(void)
+{
+    return &s_model.stats;
+}
+
+eth_spi_custom_driver_config_t w5500_model_spi_driver(void)
+{
+    return eth_spi_model_driver(&s_spi_model);
+}
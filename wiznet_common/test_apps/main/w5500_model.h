@@ -0,0 +1,81 @@
+/*
+ * SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "eth_spi_model.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define W5500_MODEL_MAX_SENDS (64) /*!< Number of SEND commands recorded by the model */
+
+/**
+ * @brief Frame handed to the "wire" by a SEND command
+ */
+typedef struct {
+    uint16_t len;       /*!< Frame length */
+    uint8_t head[16];   /*!< First bytes of the frame, taken from TX memory when SEND completes */
+} w5500_model_send_t;
+
+/**
+ * @brief Statistics collected by the W5500 model
+ */
+typedef struct {
+    uint32_t send_cmds;                             /*!< SEND commands accepted */
+    uint32_t send_overlaps;                         /*!< SEND commands issued while the previous one was still in flight */
+    uint32_t tx_overwrites;                         /*!< Bytes written to TX memory still occupied by the SEND in flight */
+    w5500_model_send_t sends[W5500_MODEL_MAX_SENDS];/*!< Completed SENDs in the order they left the chip */
+    uint32_t sends_done;                            /*!< Number of completed SENDs */
+} w5500_model_stats_t;
+
+/**
+ * @brief Reset the model to the power on state, the INTn line is driven through eth_spi_model_int_attach()
+ *
+ * @param auto_send_done Complete every SEND right when it is issued, otherwise use w5500_model_send_done()
+ */
+void w5500_model_reset(bool auto_send_done);
+
+/**
+ * @brief Complete every SEND the given time after it is issued, as if the frame was on the wire meanwhile
+ *
+ * @param send_time_us Time on the wire, 0 to go back to the mode selected by w5500_model_reset()
+ */
+void w5500_model_set_send_time(uint32_t send_time_us);
+
+/**
+ * @brief Keep Sn_CR set for the given time after a command is written, 0 to accept commands right away
+ */
+void w5500_model_set_cmd_time(uint32_t cmd_time_us);
+
+/**
+ * @brief Complete the SEND in flight: the frame leaves, Sn_IR SEND_OK is set and INTn asserted if enabled
+ */
+void w5500_model_send_done(void);
+
+/**
+ * @brief Put a frame into RX memory as received from the wire
+ *
+ * @param signal Set Sn_IR RECV and assert INTn if enabled, so that the driver sees this and all earlier frames at once
+ * @return false when the frame doesn't fit into free RX memory
+ */
+bool w5500_model_inject_rx(const uint8_t *frame, uint16_t len, bool signal);
+
+/**
+ * @brief Get model statistics
+ */
+const w5500_model_stats_t *w5500_model_get_stats(void);
+
+/**
+ * @brief Custom SPI driver which accesses the model instead of the SPI bus
+ */
+eth_spi_custom_driver_config_t w5500_model_spi_driver(void);
+
+#ifdef __cplusplus
+}
+#endif
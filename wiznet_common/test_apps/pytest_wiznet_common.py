@@ -0,0 +1,23 @@
+# SPDX-FileCopyrightText: 2026 Espressif Systems (Shanghai) CO LTD
+# SPDX-License-Identifier: Apache-2.0
+"""
+WIZnet common driver tests against a W5500 register model, no Ethernet hardware is needed.
+"""
+
+import pytest
+
+from idf_build_apps.constants import IDF_VERSION
+from packaging.version import Version
+from pytest_embedded import Dut
+
+
+@pytest.mark.skipif(IDF_VERSION < Version('6.0'), reason='W5500 driver v2 requires IDF >= 6.0')
+@pytest.mark.parametrize(
+    'config, target',
+    [
+        pytest.param('default', 'esp32', marks=[pytest.mark.generic]),
+    ],
+    indirect=['target'],
+)
+def test_wiznet_common_model(dut: Dut) -> None:
+    dut.run_all_single_board_cases(group='wiznet_model')